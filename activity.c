@@ -483,6 +483,51 @@ struct activity queue_act = {
 	.bitmap		= NULL
 };
 
+/* Pressure stall information activity */
+struct activity psi_act = {
+	.id		= A_PSI,
+	.options	= AO_COLLECTED + AO_COUNTED,
+	.magic		= ACTIVITY_MAGIC_BASE,
+	.group		= G_DEFAULT,
+#ifdef SOURCE_SADC
+	.f_count_index	= 13,	/* wrap_get_psi_nr() */
+	.f_count2	= NULL,
+	.f_read		= wrap_read_psi,
+#endif
+#ifdef SOURCE_SAR
+	.f_print	= print_psi_stats,
+	.f_print_avg	= print_psi_stats,
+#endif
+#if defined(SOURCE_SAR) || defined(SOURCE_SADF)
+	.hdr_line	= "%scpu;%fcpu;%smem;%fmem;%sio;%fio",
+#endif
+	.gtypes_nr	= {STATS_PSI_ULL, STATS_PSI_UL, STATS_PSI_U},
+	.ftypes_nr	= {0, 0, 0},
+#ifdef SOURCE_SADF
+	.f_render	= render_psi_stats,
+	.f_xml_print	= xml_print_psi_stats,
+	.f_json_print	= json_print_psi_stats,
+	.f_svg_print	= svg_print_psi_stats,
+	.f_raw_print	= raw_print_psi_stats,
+	.f_count_new	= NULL,
+	.item_list	= NULL,
+	.desc		= "Pressure stall information",
+#endif
+	.name		= "A_PSI",
+	.item_list_sz	= 0,
+	.g_nr		= 3,
+	.nr_ini		= -1,
+	.nr2		= 1,
+	.nr_max		= 1,
+	.nr		= {-1, -1, -1},
+	.nr_allocated	= 0,
+	.fsize		= STATS_PSI_SIZE,
+	.msize		= STATS_PSI_SIZE,
+	.opt_flags	= 0,
+	.buf		= {NULL, NULL, NULL},
+	.bitmap		= NULL
+};
+
 /* Serial lines activity */
 struct activity serial_act = {
 	.id		= A_SERIAL,
@@ -532,7 +577,7 @@ struct activity serial_act = {
 /* Block devices activity */
 struct activity disk_act = {
 	.id		= A_DISK,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_COUNT_BY_READ + AO_GRAPH_PER_ITEM,
 	.magic		= ACTIVITY_MAGIC_BASE + 2,
 	.group		= G_DISK,
 #ifdef SOURCE_SADC
@@ -577,7 +622,7 @@ struct activity disk_act = {
 /* Network interfaces activity */
 struct activity net_dev_act = {
 	.id		= A_NET_DEV,
-	.options	= AO_COLLECTED + AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COLLECTED + AO_COUNTED + AO_COUNT_BY_READ + AO_GRAPH_PER_ITEM,
 	.magic		= ACTIVITY_MAGIC_BASE + 3,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -623,7 +668,7 @@ struct activity net_dev_act = {
 /* Network interfaces (errors) activity */
 struct activity net_edev_act = {
 	.id		= A_NET_EDEV,
-	.options	= AO_COLLECTED + AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COLLECTED + AO_COUNTED + AO_COUNT_BY_READ + AO_GRAPH_PER_ITEM,
 	.magic		= ACTIVITY_MAGIC_BASE + 2,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -1670,7 +1715,7 @@ struct activity pwr_wghfreq_act = {
 /* USB devices plugged into the system */
 struct activity pwr_usb_act = {
 	.id		= A_PWR_USB,
-	.options	= AO_COUNTED + AO_CLOSE_MARKUP,
+	.options	= AO_COUNTED + AO_COUNT_BY_READ + AO_CLOSE_MARKUP,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_POWER,
 #ifdef SOURCE_SADC
@@ -1715,7 +1760,7 @@ struct activity pwr_usb_act = {
 /* Filesystem usage activity */
 struct activity filesystem_act = {
 	.id		= A_FS,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_MULTIPLE_OUTPUTS,
+	.options	= AO_COUNTED + AO_COUNT_BY_READ + AO_GRAPH_PER_ITEM + AO_MULTIPLE_OUTPUTS,
 	.magic		= ACTIVITY_MAGIC_BASE + 1,
 	.group		= G_XDISK,
 #ifdef SOURCE_SADC
@@ -1727,9 +1772,14 @@ struct activity filesystem_act = {
 	.f_print	= print_filesystem_stats,
 	.f_print_avg	= print_avg_filesystem_stats,
 #endif
-#if defined(SOURCE_SAR) || defined(SOURCE_SADF)
+#ifdef SOURCE_SAR
 	.hdr_line	= "FILESYSTEM;MBfsfree;MBfsused;%fsused;%ufsused;Ifree;Iused;%Iused|"
 			  "MOUNTPOINT;MBfsfree;MBfsused;%fsused;%ufsused;Ifree;Iused;%Iused",
+#endif
+#ifdef SOURCE_SADF
+	/* sar displays stale filesystems with a mark after their name instead */
+	.hdr_line	= "FILESYSTEM;MBfsfree;MBfsused;%fsused;%ufsused;Ifree;Iused;%Iused;stale|"
+			  "MOUNTPOINT;MBfsfree;MBfsused;%fsused;%ufsused;Ifree;Iused;%Iused;stale",
 #endif
 	.gtypes_nr	= {STATS_FILESYSTEM_ULL, STATS_FILESYSTEM_UL, STATS_FILESYSTEM_U},
 	.ftypes_nr	= {0, 0, 0},
@@ -1761,7 +1811,7 @@ struct activity filesystem_act = {
 /* Fibre Channel HBA usage activity */
 struct activity fchost_act = {
 	.id		= A_NET_FC,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_COUNT_BY_READ + AO_GRAPH_PER_ITEM,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_DISK,
 #ifdef SOURCE_SADC
@@ -1849,6 +1899,97 @@ struct activity softnet_act = {
 	.bitmap		= &cpu_bitmap
 };
 
+/* Cgroup v2 activity */
+struct activity cgroup_act = {
+	.id		= A_CGROUP,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.magic		= ACTIVITY_MAGIC_BASE,
+	.group		= G_CGROUP,
+#ifdef SOURCE_SADC
+	.f_count_index	= 12,	/* wrap_get_cgroup_nr() */
+	.f_count2	= NULL,
+	.f_read		= wrap_read_cgroup,
+#endif
+#ifdef SOURCE_SAR
+	.f_print	= print_cgroup_stats,
+	.f_print_avg	= print_cgroup_stats,
+#endif
+#if defined(SOURCE_SAR) || defined(SOURCE_SADF)
+	.hdr_line	= "CGROUP;%usr;%system;%cpu;%thrtl;kbmem;kbanon;kbfile;"
+			  "rkB/s;wkB/s;rio/s;wio/s",
+#endif
+	.gtypes_nr	= {STATS_CGROUP_ULL, STATS_CGROUP_UL, STATS_CGROUP_U},
+	.ftypes_nr	= {0, 0, 0},
+#ifdef SOURCE_SADF
+	.f_render	= render_cgroup_stats,
+	.f_xml_print	= xml_print_cgroup_stats,
+	.f_json_print	= json_print_cgroup_stats,
+	.f_svg_print	= svg_print_cgroup_stats,
+	.f_raw_print	= raw_print_cgroup_stats,
+	.f_count_new	= count_new_cgroup,
+	.item_list	= NULL,
+	.desc		= "Cgroup statistics",
+#endif
+	.name		= "A_CGROUP",
+	.item_list_sz	= 0,
+	.g_nr		= 4,
+	.nr_ini		= -1,
+	.nr2		= 1,
+	.nr_max		= MAX_NR_CGROUPS,
+	.nr		= {-1, -1, -1},
+	.nr_allocated	= 0,
+	.fsize		= STATS_CGROUP_SIZE,
+	.msize		= STATS_CGROUP_SIZE,
+	.opt_flags	= 0,
+	.buf		= {NULL, NULL, NULL},
+	.bitmap		= NULL
+};
+
+/* sadc own collection cost activity */
+struct activity self_act = {
+	.id		= A_SELF,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.magic		= ACTIVITY_MAGIC_BASE,
+	.group		= G_SELF,
+#ifdef SOURCE_SADC
+	.f_count_index	= 11,	/* wrap_get_self_nr() */
+	.f_count2	= NULL,
+	.f_read		= wrap_read_self,
+#endif
+#ifdef SOURCE_SAR
+	.f_print	= print_self_stats,
+	.f_print_avg	= print_self_stats,
+#endif
+#if defined(SOURCE_SAR) || defined(SOURCE_SADF)
+	.hdr_line	= "ACTIVITY;rdtime;rdcpu;cnttime;cntcpu",
+#endif
+	.gtypes_nr	= {STATS_SELF_ULL, STATS_SELF_UL, STATS_SELF_U},
+	.ftypes_nr	= {0, 0, 0},
+#ifdef SOURCE_SADF
+	.f_render	= render_self_stats,
+	.f_xml_print	= xml_print_self_stats,
+	.f_json_print	= json_print_self_stats,
+	.f_svg_print	= svg_print_self_stats,
+	.f_raw_print	= raw_print_self_stats,
+	.f_count_new	= NULL,
+	.item_list	= NULL,
+	.desc		= "Collection cost statistics",
+#endif
+	.name		= "A_SELF",
+	.item_list_sz	= 0,
+	.g_nr		= 2,
+	.nr_ini		= -1,
+	.nr2		= 1,
+	.nr_max		= NR_ACT,
+	.nr		= {-1, -1, -1},
+	.nr_allocated	= 0,
+	.fsize		= STATS_SELF_SIZE,
+	.msize		= STATS_SELF_SIZE,
+	.opt_flags	= 0,
+	.buf		= {NULL, NULL, NULL},
+	.bitmap		= NULL
+};
+
 #ifdef SOURCE_SADC
 /*
  * Array of functions used to count number of items.
@@ -1864,7 +2005,10 @@ __nr_t (*f_count[NR_F_COUNT]) (struct activity *) = {
 	wrap_get_in_nr,
 	wrap_get_usb_nr,
 	wrap_get_filesystem_nr,
-	wrap_get_fchost_nr
+	wrap_get_fchost_nr,
+	wrap_get_self_nr,
+	wrap_get_cgroup_nr,
+	wrap_get_psi_nr
 };
 #endif
 
@@ -1883,6 +2027,7 @@ struct activity *act[NR_ACT] = {
 	&huge_act,
 	&ktables_act,
 	&queue_act,
+	&psi_act,
 	&serial_act,
 	&disk_act,
 	/* <network> */
@@ -1915,5 +2060,7 @@ struct activity *act[NR_ACT] = {
 	&pwr_wghfreq_act,
 	&pwr_usb_act,		/* AO_CLOSE_MARKUP */
 	/* </power-management> */
-	&filesystem_act
+	&filesystem_act,
+	&cgroup_act,
+	&self_act
 };
@@ -0,0 +1,782 @@
+/*
+ * arrow_ipc.c: Functions used by sadf to write statistics as Apache Arrow
+ * IPC streams.
+ * (C) 2019 by Sebastien GODARD (sysstat <at> orange.fr)
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ */
+
+/*
+ * The output of each activity is written as an Arrow IPC stream: A schema
+ * message, followed by record batch messages of at most ARROW_BATCH_ROWS
+ * rows, and an end-of-stream marker. The streams of the different
+ * activities are written one after the other.
+ * Each row contains the interval and the timestamp of the record, followed
+ * by the values that would have been displayed on a line by sadf -d. Column
+ * names are taken from the header line of the activity. Message metadata
+ * are FlatBuffers tables, which are written here from front to back: A
+ * table is always written before the tables, vectors and strings it
+ * refers to.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sa.h"
+#include "arrow_ipc.h"
+
+/* Activity whose output is being written, and its flags */
+static struct activity *arrow_act = NULL;
+static unsigned int arrow_opt_flags = 0;
+
+/* Interval, timestamp and hostname of current record */
+static double arrow_itv = 0.0;
+static unsigned long long arrow_time = 0;
+static char *arrow_nodename = "";
+
+/* Columns of current stream (first two are interval and timestamp) */
+static struct arrow_col *arrow_cols = NULL;
+static int arrow_col_nr = 0, arrow_col_alloc = 0;
+
+/* Number of rows in current record batch */
+static int arrow_row_nr = 0;
+/* TRUE if the schema message of current stream has been written */
+static int arrow_schema_written = FALSE;
+
+/* Values of current row */
+static struct arrow_cell *arrow_row = NULL;
+static int arrow_cell_nr = 0, arrow_cell_alloc = 0;
+static struct arrow_buf arrow_row_str;
+
+/* Buffers used to build messages */
+static struct arrow_buf arrow_meta, arrow_body;
+
+/*
+ ***************************************************************************
+ * Make sure that there is room for @len more bytes in a buffer.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @len		Number of bytes to add.
+ ***************************************************************************
+ */
+static void abuf_grow(struct arrow_buf *ab, size_t len)
+{
+	if (ab->len + len > ab->alloc) {
+		ab->alloc = (ab->len + len) * 2;
+		if (ab->alloc < 1024) {
+			ab->alloc = 1024;
+		}
+		SREALLOC(ab->buf, char, ab->alloc);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Append data to a buffer.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @data	Data to append.
+ * @len		Length of data.
+ ***************************************************************************
+ */
+static void abuf_append(struct arrow_buf *ab, const void *data, size_t len)
+{
+	if (!len)
+		return;
+
+	abuf_grow(ab, len);
+	memcpy(ab->buf + ab->len, data, len);
+	ab->len += len;
+}
+
+/*
+ ***************************************************************************
+ * Append zero bytes to a buffer until its length (plus @extra bytes) is a
+ * multiple of @align.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @align	Alignment (power of two).
+ * @extra	Number of bytes that will precede the aligned data.
+ ***************************************************************************
+ */
+static void abuf_pad(struct arrow_buf *ab, size_t align, size_t extra)
+{
+	size_t n = (align - ((ab->len + extra) & (align - 1))) & (align - 1);
+
+	if (!n)
+		return;
+
+	abuf_grow(ab, n);
+	memset(ab->buf + ab->len, 0, n);
+	ab->len += n;
+}
+
+/*
+ ***************************************************************************
+ * Reserve zeroed room in a FlatBuffers buffer.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @len		Number of bytes to reserve.
+ * @align	Alignment of the reserved area.
+ *
+ * RETURNS:
+ * Position of the reserved area in buffer.
+ ***************************************************************************
+ */
+static size_t fb_alloc(struct arrow_buf *ab, size_t len, size_t align)
+{
+	size_t pos;
+
+	abuf_pad(ab, align, 0);
+	pos = ab->len;
+	abuf_grow(ab, len);
+	memset(ab->buf + pos, 0, len);
+	ab->len += len;
+
+	return pos;
+}
+
+/*
+ ***************************************************************************
+ * Write a little-endian scalar value in a FlatBuffers buffer.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @pos		Position of value in buffer.
+ * @val		Value to write.
+ * @size	Size of value (in bytes).
+ ***************************************************************************
+ */
+static void fb_put(struct arrow_buf *ab, size_t pos, unsigned long long val, int size)
+{
+	int i;
+
+	for (i = 0; i < size; i++) {
+		ab->buf[pos + i] = (char) ((val >> (8 * i)) & 0xff);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Make a field of a table (or an element of a vector) refer to an object
+ * located after it in buffer.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @at		Position of the field.
+ * @target	Position of the object.
+ ***************************************************************************
+ */
+static void fb_link(struct arrow_buf *ab, size_t at, size_t target)
+{
+	fb_put(ab, at, target - at, 4);
+}
+
+/*
+ ***************************************************************************
+ * Write a table and its vtable in a FlatBuffers buffer. Fields are laid
+ * out in the order of their slots, each one aligned on its size.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @nr		Number of slots of the table.
+ * @sizes	Size of the field in each slot (0 if the field is absent).
+ *
+ * OUT:
+ * @pos		Position of each field in buffer.
+ *
+ * RETURNS:
+ * Position of the table in buffer.
+ ***************************************************************************
+ */
+static size_t fb_table(struct arrow_buf *ab, int nr, const int sizes[], size_t pos[])
+{
+	int i, off = 4, foff[8];
+	size_t vt, tbl;
+
+	for (i = 0; i < nr; i++) {
+		if (!sizes[i]) {
+			foff[i] = 0;
+			continue;
+		}
+		off = (off + sizes[i] - 1) & ~(sizes[i] - 1);
+		foff[i] = off;
+		off += sizes[i];
+	}
+
+	vt = fb_alloc(ab, 4 + 2 * nr, 2);
+	fb_put(ab, vt, 4 + 2 * nr, 2);
+	fb_put(ab, vt + 2, off, 2);
+	for (i = 0; i < nr; i++) {
+		fb_put(ab, vt + 4 + 2 * i, foff[i], 2);
+	}
+
+	/* The vtable is located at table position minus this offset */
+	tbl = fb_alloc(ab, off, 8);
+	fb_put(ab, tbl, tbl - vt, 4);
+
+	for (i = 0; i < nr; i++) {
+		pos[i] = tbl + foff[i];
+	}
+
+	return tbl;
+}
+
+/*
+ ***************************************************************************
+ * Write a vector in a FlatBuffers buffer. Its elements are zeroed.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @nr		Number of elements.
+ * @size	Size of each element (4 for offsets to tables, 16 for
+ *		FieldNode or Buffer structs).
+ *
+ * RETURNS:
+ * Position of the vector in buffer. Elements are located right after
+ * its length.
+ ***************************************************************************
+ */
+static size_t fb_vector(struct arrow_buf *ab, int nr, int size)
+{
+	size_t pos;
+
+	abuf_pad(ab, size < 4 ? 4 : size, 4);
+	pos = ab->len;
+	abuf_grow(ab, 4 + (size_t) nr * size);
+	memset(ab->buf + pos, 0, 4 + (size_t) nr * size);
+	ab->len += 4 + (size_t) nr * size;
+	fb_put(ab, pos, nr, 4);
+
+	return pos;
+}
+
+/*
+ ***************************************************************************
+ * Write a string in a FlatBuffers buffer and make a field refer to it.
+ *
+ * IN:
+ * @ab		Buffer.
+ * @at		Position of the field referring to the string.
+ * @str		String to write.
+ ***************************************************************************
+ */
+static void fb_string(struct arrow_buf *ab, size_t at, const char *str)
+{
+	size_t pos, len = strlen(str);
+
+	pos = fb_alloc(ab, 4 + len + 1, 4);
+	fb_put(ab, pos, len, 4);
+	memcpy(ab->buf + pos + 4, str, len);
+	fb_link(ab, at, pos);
+}
+
+/*
+ ***************************************************************************
+ * Start a Message table in the metadata buffer.
+ *
+ * IN:
+ * @htype	Type of message header (ARROW_MSG_...).
+ *
+ * OUT:
+ * @body_len	Position of the bodyLength field, which should be set once
+ *		the body of the message is known.
+ *
+ * RETURNS:
+ * Position of the field referring to the message header.
+ ***************************************************************************
+ */
+static size_t fb_message(int htype, size_t *body_len)
+{
+	/* Slots: version, header_type, header, bodyLength */
+	const int sizes[] = {2, 1, 4, 8};
+	size_t root, pos[4];
+
+	arrow_meta.len = 0;
+	root = fb_alloc(&arrow_meta, 4, 4);
+	fb_link(&arrow_meta, root, fb_table(&arrow_meta, 4, sizes, pos));
+	fb_put(&arrow_meta, pos[0], ARROW_METADATA_V5, 2);
+	fb_put(&arrow_meta, pos[1], htype, 1);
+	*body_len = pos[3];
+
+	return pos[2];
+}
+
+/*
+ ***************************************************************************
+ * Write a KeyValue table (custom metadata) in the metadata buffer.
+ *
+ * IN:
+ * @at		Position of the vector element referring to the table.
+ * @key		Key.
+ * @value	Value.
+ ***************************************************************************
+ */
+static void fb_key_value(size_t at, const char *key, const char *value)
+{
+	/* Slots: key, value */
+	const int sizes[] = {4, 4};
+	size_t pos[2];
+
+	fb_link(&arrow_meta, at, fb_table(&arrow_meta, 2, sizes, pos));
+	fb_string(&arrow_meta, pos[0], key);
+	fb_string(&arrow_meta, pos[1], value);
+}
+
+/*
+ ***************************************************************************
+ * Write a Field table (column description) in the metadata buffer.
+ *
+ * IN:
+ * @at		Position of the vector element referring to the table.
+ * @col		Column.
+ ***************************************************************************
+ */
+static void fb_field(size_t at, struct arrow_col *col)
+{
+	/* Slots: name, nullable, type_type, type, dictionary, children */
+	const int sizes[] = {4, 1, 1, 4, 0, 4};
+	/* Type tables. Int: bitWidth, is_signed. Timestamp: unit, timezone */
+	const int int_sizes[] = {4, 1}, float_sizes[] = {2}, ts_sizes[] = {2, 4};
+	size_t pos[6], tpos[2];
+
+	fb_link(&arrow_meta, at, fb_table(&arrow_meta, 6, sizes, pos));
+	fb_string(&arrow_meta, pos[0], col->name);
+
+	switch (col->type) {
+
+	case ARROW_U64:
+		fb_put(&arrow_meta, pos[2], ARROW_TYPE_INT, 1);
+		fb_link(&arrow_meta, pos[3], fb_table(&arrow_meta, 2, int_sizes, tpos));
+		fb_put(&arrow_meta, tpos[0], 64, 4);
+		break;
+
+	case ARROW_F64:
+		fb_put(&arrow_meta, pos[2], ARROW_TYPE_FLOAT, 1);
+		fb_link(&arrow_meta, pos[3], fb_table(&arrow_meta, 1, float_sizes, tpos));
+		fb_put(&arrow_meta, tpos[0], ARROW_DOUBLE, 2);
+		break;
+
+	case ARROW_UTF8:
+		fb_put(&arrow_meta, pos[2], ARROW_TYPE_UTF8, 1);
+		fb_link(&arrow_meta, pos[3], fb_table(&arrow_meta, 0, NULL, tpos));
+		break;
+
+	case ARROW_TSTAMP:
+		/* Milliseconds since the epoch, UTC */
+		fb_put(&arrow_meta, pos[2], ARROW_TYPE_TSTAMP, 1);
+		fb_link(&arrow_meta, pos[3], fb_table(&arrow_meta, 2, ts_sizes, tpos));
+		fb_put(&arrow_meta, tpos[0], ARROW_MILLISECOND, 2);
+		fb_string(&arrow_meta, tpos[1], "UTC");
+		break;
+	}
+
+	/* No children (but the vector is expected to be present) */
+	fb_link(&arrow_meta, pos[5], fb_vector(&arrow_meta, 0, 4));
+}
+
+/*
+ ***************************************************************************
+ * Write an encapsulated message (metadata then body) on standard output.
+ ***************************************************************************
+ */
+static void write_message(void)
+{
+	char prefix[8];
+	struct arrow_buf pf = {prefix, 0, sizeof(prefix)};
+
+	/* Metadata are padded so that the body is aligned on 8 bytes */
+	abuf_pad(&arrow_meta, 8, 0);
+
+	fb_put(&pf, 0, ARROW_CONTINUATION, 4);
+	fb_put(&pf, 4, arrow_meta.len, 4);
+	fwrite(prefix, 1, sizeof(prefix), stdout);
+	fwrite(arrow_meta.buf, 1, arrow_meta.len, stdout);
+	if (arrow_body.len) {
+		fwrite(arrow_body.buf, 1, arrow_body.len, stdout);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write the schema message of current stream.
+ ***************************************************************************
+ */
+static void write_schema(void)
+{
+	/* Slots: endianness, fields, custom_metadata */
+	const int sizes[] = {2, 4, 4};
+	unsigned int one = 1;
+	size_t hdr, pos[3], fields, kv, body_len;
+	int i;
+
+	arrow_body.len = 0;
+	hdr = fb_message(ARROW_MSG_SCHEMA, &body_len);
+	fb_link(&arrow_meta, hdr, fb_table(&arrow_meta, 3, sizes, pos));
+
+	/* Body buffers are written with the endianness of current machine */
+	fb_put(&arrow_meta, pos[0], *((unsigned char *) &one) ? 0 : 1, 2);
+
+	fields = fb_vector(&arrow_meta, arrow_col_nr, 4);
+	fb_link(&arrow_meta, pos[1], fields);
+	kv = fb_vector(&arrow_meta, 2, 4);
+	fb_link(&arrow_meta, pos[2], kv);
+
+	for (i = 0; i < arrow_col_nr; i++) {
+		fb_field(fields + 4 + 4 * i, &arrow_cols[i]);
+	}
+	fb_key_value(kv + 4, "activity", arrow_act->name);
+	fb_key_value(kv + 8, "hostname", arrow_nodename);
+
+	write_message();
+	arrow_schema_written = TRUE;
+}
+
+/*
+ ***************************************************************************
+ * Add a buffer to the body of a record batch.
+ *
+ * IN:
+ * @buffers	Position of the Buffer structs vector in metadata buffer.
+ * @bn		Number of buffers already added.
+ * @data	Buffer contents (may be NULL if @len is 0).
+ * @len		Buffer length.
+ * @zero	TRUE if an int32 0 should be written before contents (first
+ *		offset of a strings column).
+ ***************************************************************************
+ */
+static void add_body_buffer(size_t buffers, int *bn, const char *data, size_t len, int zero)
+{
+	int z = 0;
+	size_t pos = buffers + 4 + 16 * (*bn)++;
+
+	fb_put(&arrow_meta, pos, arrow_body.len, 8);
+	fb_put(&arrow_meta, pos + 8, len + (zero ? sizeof(z) : 0), 8);
+
+	if (zero) {
+		abuf_append(&arrow_body, &z, sizeof(z));
+	}
+	if (len) {
+		abuf_append(&arrow_body, data, len);
+	}
+	abuf_pad(&arrow_body, 8, 0);
+}
+
+/*
+ ***************************************************************************
+ * Write the rows of current record batch, then empty it.
+ ***************************************************************************
+ */
+static void write_batch(void)
+{
+	/* Slots: length, nodes, buffers */
+	const int sizes[] = {8, 4, 4};
+	struct arrow_col *col;
+	size_t hdr, pos[3], nodes, buffers, body_len;
+	int i, bn = 0, buf_nr = 0;
+
+	if (!arrow_schema_written) {
+		write_schema();
+	}
+
+	for (i = 0; i < arrow_col_nr; i++) {
+		/* Validity bitmap (always empty: no nulls) then values (and offsets) */
+		buf_nr += (arrow_cols[i].type == ARROW_UTF8) ? 3 : 2;
+	}
+
+	arrow_body.len = 0;
+	hdr = fb_message(ARROW_MSG_BATCH, &body_len);
+	fb_link(&arrow_meta, hdr, fb_table(&arrow_meta, 3, sizes, pos));
+	fb_put(&arrow_meta, pos[0], arrow_row_nr, 8);
+
+	nodes = fb_vector(&arrow_meta, arrow_col_nr, 16);
+	fb_link(&arrow_meta, pos[1], nodes);
+	buffers = fb_vector(&arrow_meta, buf_nr, 16);
+	fb_link(&arrow_meta, pos[2], buffers);
+
+	for (i = 0; i < arrow_col_nr; i++) {
+		col = &arrow_cols[i];
+
+		/* FieldNode: length, null_count */
+		fb_put(&arrow_meta, nodes + 4 + 16 * i, arrow_row_nr, 8);
+
+		add_body_buffer(buffers, &bn, NULL, 0, FALSE);
+		if (col->type == ARROW_UTF8) {
+			add_body_buffer(buffers, &bn, col->offs.buf, col->offs.len, TRUE);
+		}
+		add_body_buffer(buffers, &bn, col->data.buf, col->data.len, FALSE);
+
+		col->data.len = col->offs.len = 0;
+	}
+
+	fb_put(&arrow_meta, body_len, arrow_body.len, 8);
+
+	write_message();
+	arrow_row_nr = 0;
+}
+
+/*
+ ***************************************************************************
+ * Terminate current stream: Write the rows not written yet, and the
+ * end-of-stream marker. Should be called when the output of an activity
+ * is complete, and before standard output is redirected.
+ ***************************************************************************
+ */
+void arrow_end_stream(void)
+{
+	char eos[8];
+	struct arrow_buf pf = {eos, 0, sizeof(eos)};
+	int i;
+
+	if (arrow_row_nr) {
+		write_batch();
+	}
+	if (arrow_schema_written) {
+		fb_put(&pf, 0, ARROW_CONTINUATION, 4);
+		fb_put(&pf, 4, 0, 4);
+		fwrite(eos, 1, sizeof(eos), stdout);
+	}
+
+	for (i = 0; i < arrow_col_nr; i++) {
+		free(arrow_cols[i].name);
+		arrow_cols[i].name = NULL;
+	}
+	arrow_col_nr = 0;
+	arrow_schema_written = FALSE;
+}
+
+/*
+ ***************************************************************************
+ * Save interval and timestamp of the record whose statistics are about to
+ * be written.
+ *
+ * IN:
+ * @itv		Interval of time with preceding record (in seconds).
+ * @ust_msec	Timestamp of record (in milliseconds since the epoch).
+ * @nodename	Name of the host where the file was created.
+ ***************************************************************************
+ */
+void arrow_set_record(double itv, unsigned long long ust_msec, char *nodename)
+{
+	arrow_itv = itv;
+	arrow_time = ust_msec;
+	arrow_nodename = nodename;
+}
+
+/*
+ ***************************************************************************
+ * Set the activity whose statistics are about to be written. A new stream
+ * is started if this is not the same output as before.
+ *
+ * IN:
+ * @a		Activity structure.
+ ***************************************************************************
+ */
+void arrow_set_activity(struct activity *a)
+{
+	if ((a != arrow_act) || (a->opt_flags != arrow_opt_flags)) {
+		arrow_end_stream();
+		arrow_act = a;
+		arrow_opt_flags = a->opt_flags;
+	}
+	arrow_cell_nr = 0;
+	arrow_row_str.len = 0;
+}
+
+/*
+ ***************************************************************************
+ * Get a new cell for current row.
+ *
+ * IN:
+ * @type	Type of the value (ARROW_...).
+ *
+ * RETURNS:
+ * Pointer on the cell.
+ ***************************************************************************
+ */
+static struct arrow_cell *new_cell(int type)
+{
+	if (arrow_cell_nr >= arrow_cell_alloc) {
+		arrow_cell_alloc = arrow_cell_alloc ? arrow_cell_alloc * 2 : 32;
+		SREALLOC(arrow_row, struct arrow_cell,
+			 (size_t) arrow_cell_alloc * sizeof(struct arrow_cell));
+	}
+	arrow_row[arrow_cell_nr].type = type;
+
+	return &arrow_row[arrow_cell_nr++];
+}
+
+/*
+ ***************************************************************************
+ * Add a value to current row.
+ *
+ * IN:
+ * @val		Value (counter, string, or other value).
+ ***************************************************************************
+ */
+void arrow_add_u64(unsigned long long val)
+{
+	new_cell(ARROW_U64)->u = val;
+}
+
+void arrow_add_f64(double val)
+{
+	new_cell(ARROW_F64)->d = val;
+}
+
+void arrow_add_str(const char *val)
+{
+	struct arrow_cell *c = new_cell(ARROW_UTF8);
+
+	c->soff = arrow_row_str.len;
+	c->slen = strlen(val);
+	abuf_append(&arrow_row_str, val, c->slen);
+}
+
+/*
+ ***************************************************************************
+ * Set the columns of a new stream from the values of current row. Column
+ * names are the fields of the header line of current output of activity,
+ * as displayed by sadf -d.
+ ***************************************************************************
+ */
+static void set_columns(void)
+{
+	struct activity *a = arrow_act;
+	char hline[HEADER_LINE_LEN], name[32];
+	char *hl = hline, *fld, *amp;
+	unsigned int msk = 1;
+	int i;
+
+	arrow_col_nr = arrow_cell_nr + 2;
+	if (arrow_col_nr > arrow_col_alloc) {
+		SREALLOC(arrow_cols, struct arrow_col,
+			 (size_t) arrow_col_nr * sizeof(struct arrow_col));
+		memset(arrow_cols + arrow_col_alloc, 0,
+		       (size_t) (arrow_col_nr - arrow_col_alloc) * sizeof(struct arrow_col));
+		arrow_col_alloc = arrow_col_nr;
+	}
+
+	arrow_cols[0].name = strdup("interval");
+	arrow_cols[0].type = ARROW_F64;
+	arrow_cols[1].name = strdup("timestamp");
+	arrow_cols[1].type = ARROW_TSTAMP;
+
+	strncpy(hline, a->hdr_line, HEADER_LINE_LEN - 1);
+	hline[HEADER_LINE_LEN - 1] = '\0';
+
+	if (HAS_MULTIPLE_OUTPUTS(a->options)) {
+		/* Look for the header line of current output */
+		for (hl = strtok(hline, "|"); hl && !((a->opt_flags & 0xff) & msk);
+		     hl = strtok(NULL, "|"), msk <<= 1);
+
+		if (hl && ((amp = strchr(hl, '&')) != NULL)) {
+			/* Keep the second part of the header line only if requested */
+			*amp = ((a->opt_flags & 0xff00) & (msk << 8)) ? ';' : '\0';
+		}
+	}
+
+	fld = hl ? strtok(hl, ";") : NULL;
+	for (i = 2; i < arrow_col_nr; i++) {
+		if (fld) {
+			arrow_cols[i].name = strdup(fld);
+			fld = strtok(NULL, ";");
+		}
+		else {
+			/* Should not happen: More values than fields in header line */
+			snprintf(name, sizeof(name), "field%d", i - 1);
+			arrow_cols[i].name = strdup(name);
+		}
+		if (!arrow_cols[i].name) {
+			perror("strdup");
+			exit(4);
+		}
+		arrow_cols[i].type = arrow_row[i - 2].type;
+	}
+	if (!arrow_cols[0].name || !arrow_cols[1].name) {
+		perror("strdup");
+		exit(4);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Terminate current row and append it to current record batch. A new
+ * stream is started if the row doesn't match the schema of current one.
+ ***************************************************************************
+ */
+void arrow_end_row(void)
+{
+	struct arrow_col *col;
+	struct arrow_cell *c;
+	int i, off;
+
+	if (arrow_col_nr) {
+		/* Check that current row matches the schema of the stream */
+		if (arrow_cell_nr + 2 != arrow_col_nr) {
+			arrow_end_stream();
+		}
+		else {
+			for (i = 0; i < arrow_cell_nr; i++) {
+				if (arrow_row[i].type != arrow_cols[i + 2].type) {
+					arrow_end_stream();
+					break;
+				}
+			}
+		}
+	}
+	if (!arrow_col_nr) {
+		set_columns();
+	}
+
+	abuf_append(&arrow_cols[0].data, &arrow_itv, sizeof(arrow_itv));
+	abuf_append(&arrow_cols[1].data, &arrow_time, sizeof(arrow_time));
+
+	for (i = 0; i < arrow_cell_nr; i++) {
+		c = &arrow_row[i];
+		col = &arrow_cols[i + 2];
+
+		switch (c->type) {
+
+		case ARROW_U64:
+			abuf_append(&col->data, &c->u, sizeof(c->u));
+			break;
+
+		case ARROW_F64:
+			abuf_append(&col->data, &c->d, sizeof(c->d));
+			break;
+
+		case ARROW_UTF8:
+			abuf_append(&col->data, arrow_row_str.buf + c->soff, c->slen);
+			off = (int) col->data.len;
+			abuf_append(&col->offs, &off, sizeof(off));
+			break;
+		}
+	}
+
+	arrow_cell_nr = 0;
+	arrow_row_str.len = 0;
+
+	if (++arrow_row_nr >= ARROW_BATCH_ROWS) {
+		write_batch();
+	}
+}
@@ -0,0 +1,92 @@
+/*
+ * arrow_ipc.h: Include file used to write system statistics as Apache Arrow
+ * IPC streams.
+ * (C) 2019 by Sebastien Godard (sysstat <at> orange.fr)
+ */
+
+#ifndef _ARROW_IPC_H
+#define _ARROW_IPC_H
+
+/*
+ ***************************************************************************
+ * Definitions for Arrow output.
+ ***************************************************************************
+ */
+
+/*
+ * Value of the "isdb" parameter given to the functions used to display
+ * statistics in db or ppc format (see rndr_stats.c) so that values are
+ * saved in record batches instead of being printed.
+ */
+#define RENDER_ARROW	2
+
+/* Maximum number of rows in a record batch */
+#define ARROW_BATCH_ROWS	4096
+
+/* Arrow column types */
+#define ARROW_U64	0
+#define ARROW_F64	1
+#define ARROW_UTF8	2
+#define ARROW_TSTAMP	3
+
+/* Arrow IPC format constants (see Message.fbs and Schema.fbs) */
+#define ARROW_CONTINUATION	0xffffffff
+#define ARROW_METADATA_V5	4
+#define ARROW_MSG_SCHEMA	1
+#define ARROW_MSG_BATCH		3
+#define ARROW_TYPE_INT		2
+#define ARROW_TYPE_FLOAT	3
+#define ARROW_TYPE_UTF8		5
+#define ARROW_TYPE_TSTAMP	10
+#define ARROW_DOUBLE		2
+#define ARROW_MILLISECOND	1
+
+/* Growable buffer */
+struct arrow_buf {
+	char *buf;
+	size_t len;
+	size_t alloc;
+};
+
+/* Column of a record batch */
+struct arrow_col {
+	char *name;
+	int type;
+	/* Values (or characters for strings) */
+	struct arrow_buf data;
+	/* End offsets of strings */
+	struct arrow_buf offs;
+};
+
+/* Value of a row not yet appended to the columns of the batch */
+struct arrow_cell {
+	int type;
+	unsigned long long u;
+	double d;
+	/* Position and length of string in row buffer */
+	size_t soff;
+	size_t slen;
+};
+
+/*
+ ***************************************************************************
+ * Prototypes for functions used to write statistics in Arrow format.
+ ***************************************************************************
+ */
+
+void arrow_set_record
+	(double, unsigned long long, char *);
+void arrow_set_activity
+	(struct activity *);
+void arrow_add_u64
+	(unsigned long long);
+void arrow_add_f64
+	(double);
+void arrow_add_str
+	(const char *);
+void arrow_end_row
+	(void);
+void arrow_end_stream
+	(void);
+
+#endif  /* _ARROW_IPC_H */
@@ -32,6 +32,8 @@
 #include <dirent.h>
 #include <ctype.h>
 #include <libgen.h>
+#include <math.h>
+#include <langinfo.h>
 
 #include "version.h"
 #include "common.h"
@@ -68,6 +70,9 @@ char sc_normal[MAX_SGR_LEN] = C_NORMAL;
 /* Type of persistent device names used in sar and iostat */
 char persistent_name_type[MAX_FILE_LEN];
 
+/* TRUE if JSON output should be written without indentation nor newlines */
+int json_compact = FALSE;
+
 /*
  ***************************************************************************
  * Print sysstat version number and exit.
@@ -107,27 +112,48 @@ time_t get_localtime(struct tm *rectime, int d_off)
 
 /*
  ***************************************************************************
- * Get date and time expressed in UTC.
+ * Get date and time and take into account <ENV_TIME_DEFTM> variable.
+ * Also get the microseconds part of current time.
  *
  * IN:
  * @d_off	Day offset (number of days to go back in the past).
  *
  * OUT:
- * @rectime	Current date and time expressed in UTC.
+ * @rectime	Current date and time.
+ * @usec	Microseconds part of current time (0-999999). May be NULL.
  *
  * RETURNS:
  * Value of time in seconds since the Epoch.
  ***************************************************************************
  */
-time_t get_gmtime(struct tm *rectime, int d_off)
+time_t get_time_usec(struct tm *rectime, int d_off, unsigned int *usec)
 {
-	time_t timer;
+	static int utc = 0;
+	struct timespec ts;
+	char *e;
 
-	time(&timer);
-	timer -= SEC_PER_DAY * d_off;
-	gmtime_r(&timer, rectime);
+	if (!utc) {
+		/* Read environment variable value once */
+		if ((e = getenv(ENV_TIME_DEFTM)) != NULL) {
+			utc = !strcmp(e, K_UTC);
+		}
+		utc++;
+	}
 
-	return timer;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec -= SEC_PER_DAY * d_off;
+
+	if (utc == 2) {
+		gmtime_r(&ts.tv_sec, rectime);
+	}
+	else {
+		localtime_r(&ts.tv_sec, rectime);
+	}
+	if (usec) {
+		*usec = (unsigned int) (ts.tv_nsec / 1000);
+	}
+
+	return ts.tv_sec;
 }
 
 /*
@@ -146,21 +172,7 @@ time_t get_gmtime(struct tm *rectime, int d_off)
  */
 time_t get_time(struct tm *rectime, int d_off)
 {
-	static int utc = 0;
-	char *e;
-
-	if (!utc) {
-		/* Read environment variable value once */
-		if ((e = getenv(ENV_TIME_DEFTM)) != NULL) {
-			utc = !strcmp(e, K_UTC);
-		}
-		utc++;
-	}
-
-	if (utc == 2)
-		return get_gmtime(rectime, d_off);
-	else
-		return get_localtime(rectime, d_off);
+	return get_time_usec(rectime, d_off, NULL);
 }
 
 #ifdef USE_NLS
@@ -269,6 +281,120 @@ void sysstat_panic(const char *function, int error_code)
 	exit(1);
 }
 
+/*
+ ***************************************************************************
+ * Parse an interval given on the command line. The interval is a number of
+ * seconds, possibly with a fractional part (eg. "2", "0.25" or "1.5").
+ *
+ * IN:
+ * @str		String to parse.
+ *
+ * RETURNS:
+ * Interval in microseconds, or -1 if the string is not a valid interval.
+ ***************************************************************************
+ */
+long long parse_interval(char *str)
+{
+	long long sec = 0, usec = 0;
+	long long scale = 100000;
+	char *c = str;
+
+	if (!isdigit((unsigned char) *c))
+		return -1;
+
+	while (isdigit((unsigned char) *c)) {
+		sec = sec * 10 + (*c++ - '0');
+		if (sec > MAX_INTERVAL_SEC)
+			return -1;
+	}
+	if (*c == '.') {
+		c++;
+		if (!isdigit((unsigned char) *c))
+			return -1;
+		while (isdigit((unsigned char) *c)) {
+			if (!scale)
+				/* No more than microsecond resolution */
+				return -1;
+			usec += (*c++ - '0') * scale;
+			scale /= 10;
+		}
+	}
+	if (*c != '\0')
+		return -1;
+
+	return sec * 1000000 + usec;
+}
+
+/*
+ ***************************************************************************
+ * Start a sampling timer. The first deadline is set one period from now.
+ * Deadlines are absolute values on CLOCK_MONOTONIC, so that samples don't
+ * drift whatever the time spent between two of them, and aren't affected
+ * by changes of the system time.
+ *
+ * IN:
+ * @st		Sampling timer.
+ * @period_us	Sampling period in microseconds.
+ *
+ * OUT:
+ * @st		Sampling timer, armed.
+ ***************************************************************************
+ */
+void start_sample_timer(struct sample_timer *st, unsigned long long period_us)
+{
+	clock_gettime(CLOCK_MONOTONIC, &st->deadline);
+	st->period_us = period_us;
+	st->late_us = 0;
+	TS_ADD_USEC(st->deadline, period_us);
+}
+
+/*
+ ***************************************************************************
+ * Sleep until next deadline of a sampling timer, then set the following
+ * one. If we woke up so late that one or more deadlines have already
+ * passed, they are skipped: next deadline stays in phase with the first
+ * one.
+ *
+ * IN:
+ * @st		Sampling timer.
+ *
+ * OUT:
+ * @st		Sampling timer with next deadline set and lateness of current
+ *		sample saved in @st->late_us.
+ *
+ * RETURNS:
+ * 0 when deadline has been reached, -1 if the sleep has been interrupted
+ * by a signal (the deadline is then left unchanged).
+ ***************************************************************************
+ */
+int wait_sample_timer(struct sample_timer *st)
+{
+	struct timespec now;
+	unsigned long long late, missed;
+	int rc;
+
+	rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &st->deadline, NULL);
+	if (rc == EINTR)
+		return -1;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if ((now.tv_sec > st->deadline.tv_sec) ||
+	    ((now.tv_sec == st->deadline.tv_sec) && (now.tv_nsec > st->deadline.tv_nsec))) {
+		late = (now.tv_sec - st->deadline.tv_sec) * 1000000ULL +
+		       (now.tv_nsec - st->deadline.tv_nsec) / 1000;
+	}
+	else {
+		late = 0;
+	}
+	st->late_us = late;
+
+	/* Skip deadlines that have already passed */
+	missed = st->period_us ? late / st->period_us : 0;
+	TS_ADD_USEC(st->deadline, (missed + 1) * st->period_us);
+
+	return 0;
+}
+
 #ifndef SOURCE_SADC
 /*
  ***************************************************************************
@@ -515,6 +641,512 @@ void xprintf(int nr_tab, const char *fmtf, ...)
 	printf("%s\n", buf);
 }
 
+/*
+ * Buffer where JSON output is formatted before being written on standard
+ * output, and cache of the formats compiled by jprintf().
+ */
+static char json_buf[JSON_BUF_LEN];
+static int json_len = 0;
+static struct json_fmt json_fmt_cache[JSON_FMT_CACHE];
+
+/*
+ ***************************************************************************
+ * Write the contents of the JSON output buffer on standard output.
+ ***************************************************************************
+*/
+static void json_flush(void)
+{
+	if (json_len) {
+		fwrite(json_buf, 1, json_len, stdout);
+		json_len = 0;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Append a string to the JSON output buffer.
+ *
+ * IN:
+ * @str		String to append.
+ * @len		Length of the string.
+ ***************************************************************************
+*/
+static void json_append(const char *str, int len)
+{
+	if (json_len + len > JSON_BUF_LEN) {
+		json_flush();
+		if (len > JSON_BUF_LEN) {
+			fwrite(str, 1, len, stdout);
+			return;
+		}
+	}
+	memcpy(json_buf + json_len, str, len);
+	json_len += len;
+}
+
+/*
+ ***************************************************************************
+ * Make sure there is enough room in the JSON output buffer to write a
+ * numerical value.
+ *
+ * RETURNS:
+ * Pointer on the first free byte of the buffer.
+ ***************************************************************************
+*/
+static char *json_reserve(void)
+{
+	if (json_len + 64 > JSON_BUF_LEN) {
+		json_flush();
+	}
+	return json_buf + json_len;
+}
+
+/*
+ ***************************************************************************
+ * Tell if a character of JSON text should be kept in compact mode, i.e.
+ * if it is not a whitespace outside a string.
+ *
+ * IN:
+ * @c		Character to test.
+ * @in_str	TRUE if we are inside a string.
+ * @esc		TRUE if previous character was a backslash inside a string.
+ *
+ * OUT:
+ * @in_str	Updated string status.
+ * @esc		Updated escape status.
+ *
+ * RETURNS:
+ * TRUE if the character should be kept.
+ ***************************************************************************
+*/
+static int json_keep_char(char c, int *in_str, int *esc)
+{
+	if (*in_str) {
+		if (*esc) {
+			*esc = FALSE;
+		}
+		else if (c == '\\') {
+			*esc = TRUE;
+		}
+		else if (c == '"') {
+			*in_str = FALSE;
+		}
+		return TRUE;
+	}
+	if (c == '"') {
+		*in_str = TRUE;
+	}
+
+	return !isspace((unsigned char) c);
+}
+
+/*
+ ***************************************************************************
+ * Compile a JSON printf() format into a list of literal texts followed by
+ * a conversion. In compact mode, whitespaces found outside strings in the
+ * literal texts are removed here once and for all.
+ *
+ * IN:
+ * @fmtf	printf() format.
+ *
+ * RETURNS:
+ * Compiled format, or NULL if the format uses conversions not supported
+ * by jprintf().
+ ***************************************************************************
+*/
+static struct json_seg *json_compile(const char *fmtf)
+{
+	struct json_seg *seg = NULL;
+	const char *p = fmtf;
+	char *text;
+	int nr = 0, len = 0, start, lmod, prec;
+	int in_str = FALSE, esc = FALSE;
+
+	if ((text = (char *) malloc(strlen(fmtf) + 1)) == NULL) {
+		perror("malloc");
+		exit(4);
+	}
+
+	while (TRUE) {
+		/* Copy literal text up to next conversion */
+		start = len;
+		while (*p && ((*p != '%') || (*(p + 1) == '%'))) {
+			if (*p == '%') {
+				/* "%%" */
+				p++;
+			}
+			if (!json_compact || json_keep_char(*p, &in_str, &esc)) {
+				text[len++] = *p;
+			}
+			p++;
+		}
+
+		SREALLOC(seg, struct json_seg, (nr + 1) * sizeof(struct json_seg));
+		seg[nr].text = text + start;
+		seg[nr].len = len - start;
+		seg[nr].prec = 0;
+
+		if (!*p) {
+			seg[nr].conv = JC_END;
+			return seg;
+		}
+
+		/* Parse conversion */
+		p++;
+		if (*p == '.') {
+			for (prec = 0, p++; isdigit((unsigned char) *p) && (prec < 10); p++) {
+				prec = prec * 10 + *p - '0';
+			}
+			if (*p != 'f')
+				goto unsupported;
+			seg[nr].conv = JC_FIXED;
+			seg[nr].prec = prec;
+		}
+		else {
+			for (lmod = 0; (*p == 'l') && (lmod < 2); p++, lmod++);
+
+			switch (*p) {
+			case 'd':
+				seg[nr].conv = JC_INT + 2 * lmod;
+				break;
+			case 'u':
+				seg[nr].conv = JC_UINT + 2 * lmod;
+				break;
+			case 'x':
+				seg[nr].conv = JC_HEX;
+				break;
+			case 'c':
+				seg[nr].conv = JC_CHAR;
+				break;
+			case 's':
+				seg[nr].conv = JC_STR;
+				break;
+			default:
+				goto unsupported;
+			}
+			if (lmod && (seg[nr].conv >= JC_HEX))
+				goto unsupported;
+		}
+		p++;
+		nr++;
+	}
+
+unsupported:
+	free(seg);
+	free(text);
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Get the compiled version of a JSON format. Formats are identified by
+ * their address: They are all string literals, compiled on first use.
+ *
+ * IN:
+ * @fmtf	printf() format.
+ *
+ * RETURNS:
+ * Compiled format, or NULL if it cannot be compiled or if the cache is
+ * full.
+ ***************************************************************************
+*/
+static struct json_seg *json_get_fmt(const char *fmtf)
+{
+	unsigned long h;
+	int i;
+
+	h = ((unsigned long) fmtf >> 3) * 2654435761UL;
+
+	for (i = 0; i < JSON_FMT_CACHE; i++) {
+		struct json_fmt *jf = &json_fmt_cache[(h + i) % JSON_FMT_CACHE];
+
+		if (jf->fmtf == fmtf)
+			return jf->seg;
+
+		if (jf->fmtf == NULL) {
+			jf->fmtf = fmtf;
+			jf->seg = json_compile(fmtf);
+			return jf->seg;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Write a signed integer value in the JSON output buffer.
+ *
+ * IN:
+ * @val		Value to write.
+ ***************************************************************************
+*/
+static void json_put_int(long long val)
+{
+	char *buf = json_reserve();
+	int len = 0;
+
+	if (val < 0) {
+		buf[len++] = '-';
+		json_len += len + sprint_u64(buf + len, -(unsigned long long) val);
+	}
+	else {
+		json_len += sprint_u64(buf, val);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Format JSON output and write it on standard output. Indentation and
+ * newline are omitted in compact mode.
+ *
+ * IN:
+ * @nr_tab	Number of tabs to print.
+ * @eol		TRUE if a newline should be printed at the end of the line.
+ * @fmtf	printf() format.
+ * @args	Arguments for the format.
+ ***************************************************************************
+*/
+static void json_vprintf(int nr_tab, int eol, const char *fmtf, va_list args)
+{
+	static const char tabs[JSON_MAX_TABS] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+	struct json_seg *seg;
+	const char *s;
+	char *buf;
+	int i, len;
+
+	if (!json_compact) {
+		for (; nr_tab > 0; nr_tab -= JSON_MAX_TABS) {
+			json_append(tabs, nr_tab < JSON_MAX_TABS ? nr_tab : JSON_MAX_TABS);
+		}
+	}
+
+	if ((seg = json_get_fmt(fmtf)) != NULL) {
+		for (; ; seg++) {
+			json_append(seg->text, seg->len);
+
+			switch (seg->conv) {
+			case JC_END:
+				goto end;
+			case JC_INT:
+				json_put_int(va_arg(args, int));
+				break;
+			case JC_UINT:
+				json_len += sprint_u64(json_reserve(), va_arg(args, unsigned int));
+				break;
+			case JC_LONG:
+				json_put_int(va_arg(args, long));
+				break;
+			case JC_ULONG:
+				json_len += sprint_u64(json_reserve(), va_arg(args, unsigned long));
+				break;
+			case JC_LLONG:
+				json_put_int(va_arg(args, long long));
+				break;
+			case JC_ULLONG:
+				json_len += sprint_u64(json_reserve(), va_arg(args, unsigned long long));
+				break;
+			case JC_HEX:
+				buf = json_reserve();
+				len = snprintf(buf, 16, "%x", va_arg(args, unsigned int));
+				json_len += len;
+				break;
+			case JC_CHAR:
+				buf = json_reserve();
+				*buf = (char) va_arg(args, int);
+				json_len++;
+				break;
+			case JC_STR:
+				if ((s = va_arg(args, const char *)) == NULL) {
+					s = "(null)";
+				}
+				json_append(s, strlen(s));
+				break;
+			case JC_FIXED:
+				json_len += sprint_fixed(json_reserve(), va_arg(args, double), seg->prec);
+				break;
+			}
+		}
+	}
+	else {
+		/* Format cannot be compiled: Use vsnprintf() */
+		char line[1024];
+		int in_str = FALSE, esc = FALSE;
+
+		len = vsnprintf(line, sizeof(line), fmtf, args);
+		if (len >= (int) sizeof(line)) {
+			len = sizeof(line) - 1;
+		}
+		if (json_compact) {
+			for (i = 0; i < len; i++) {
+				if (json_keep_char(line[i], &in_str, &esc)) {
+					json_append(line + i, 1);
+				}
+			}
+		}
+		else {
+			json_append(line, len);
+		}
+	}
+
+end:
+	if (eol && !json_compact) {
+		json_append("\n", 1);
+	}
+	json_flush();
+}
+
+/*
+ ***************************************************************************
+ * printf() function modified for JSON output. Don't print a CR at the end
+ * of the line.
+ *
+ * IN:
+ * @nr_tab	Number of tabs to print.
+ * @fmtf	printf() format. Must be a string literal.
+ ***************************************************************************
+ */
+void jprintf0(int nr_tab, const char *fmtf, ...)
+{
+	va_list args;
+
+	va_start(args, fmtf);
+	json_vprintf(nr_tab, FALSE, fmtf, args);
+	va_end(args);
+}
+
+/*
+ ***************************************************************************
+ * printf() function modified for JSON output. Print a CR at the end of
+ * the line, unless in compact mode.
+ *
+ * IN:
+ * @nr_tab	Number of tabs to print.
+ * @fmtf	printf() format. Must be a string literal.
+ ***************************************************************************
+ */
+void jprintf(int nr_tab, const char *fmtf, ...)
+{
+	va_list args;
+
+	va_start(args, fmtf);
+	json_vprintf(nr_tab, TRUE, fmtf, args);
+	va_end(args);
+}
+
+/*
+ ***************************************************************************
+ * Terminate JSON output. In compact mode, the whole document has been
+ * written on a single line which is now terminated.
+ ***************************************************************************
+ */
+void jprintf_end(void)
+{
+	if (json_compact) {
+		printf("\n");
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write an unsigned integer value into a string. This is equivalent to
+ * sprintf(buf, "%llu", val), but faster.
+ *
+ * IN:
+ * @buf		String where the value will be written. Should be at least
+ *		21 bytes long.
+ * @val		Value to write.
+ *
+ * RETURNS:
+ * Number of characters written (not including the terminating null byte).
+ ***************************************************************************
+ */
+int sprint_u64(char *buf, unsigned long long val)
+{
+	char tmp[24];
+	int i = 0, len;
+
+	do {
+		tmp[i++] = '0' + (val % 10);
+		val /= 10;
+	}
+	while (val);
+
+	len = i;
+	while (i > 0) {
+		*buf++ = tmp[--i];
+	}
+	*buf = '\0';
+
+	return len;
+}
+
+/*
+ ***************************************************************************
+ * Write a double value with a fixed number of decimal places into a
+ * string. This is equivalent to sprintf(buf, "%.*f", wd, val), but faster.
+ * Values which cannot be rounded safely (values too high, negative values,
+ * or values close to a tie) are still written with snprintf() so that the
+ * result is always the same. So are values for locales whose decimal point
+ * is not a single character.
+ *
+ * IN:
+ * @buf		String where the value will be written. Should be at least
+ *		64 bytes long (longer values are truncated).
+ * @val		Value to write.
+ * @wd		Number of decimal places.
+ *
+ * RETURNS:
+ * Number of characters written (not including the terminating null byte).
+ ***************************************************************************
+ */
+int sprint_fixed(char *buf, double val, int wd)
+{
+	static const double pwr[] = {1.0, 10.0, 100.0, 1000.0, 10000.0};
+	unsigned long long n, e;
+	double r, frac;
+	char *dp = ".";
+	int i, len;
+
+	if (wd > 0) {
+		/* Decimal point depends on LC_NUMERIC */
+		dp = nl_langinfo(RADIXCHAR);
+	}
+
+	/* Negative or NaN values are written with snprintf() */
+	if ((wd >= 0) && (wd <= 4) && (val >= 0.0) && !signbit(val) &&
+	    dp[0] && !dp[1] && ((r = val * pwr[wd]) < 1e12)) {
+		/* Here the rounding error on r is lower than 1e-3 */
+		n = (unsigned long long) r;
+		frac = r - (double) n;
+
+		/* If close to a tie then let snprintf() round the exact binary value */
+		if ((frac < 0.499) || (frac > 0.501)) {
+			if (frac > 0.5) {
+				n++;
+			}
+			e = (unsigned long long) pwr[wd];
+			len = sprint_u64(buf, n / e);
+			if (wd) {
+				n %= e;
+				buf[len] = dp[0];
+				for (i = len + wd; i > len; i--) {
+					buf[i] = '0' + (n % 10);
+					n /= 10;
+				}
+				len += wd + 1;
+				buf[len] = '\0';
+			}
+
+			return len;
+		}
+	}
+
+	len = snprintf(buf, 64, "%.*f", wd, val);
+
+	return (len < 64 ? len : 63);
+}
+
 /*
  ***************************************************************************
  * Get report date as a string of characters.
@@ -581,16 +1213,16 @@ int print_gal_header(struct tm *rectime, char *sysname, char *release,
 	}
 	else {
 		/* JSON output */
-		xprintf(0, "{\"sysstat\": {");
-		xprintf(1, "\"hosts\": [");
-		xprintf(2, "{");
-		xprintf(3, "\"nodename\": \"%s\",", nodename);
-		xprintf(3, "\"sysname\": \"%s\",", sysname);
-		xprintf(3, "\"release\": \"%s\",", release);
-		xprintf(3, "\"machine\": \"%s\",", machine);
-		xprintf(3, "\"number-of-cpus\": %d,", cpu_nr);
-		xprintf(3, "\"date\": \"%s\",", cur_date);
-		xprintf(3, "\"statistics\": [");
+		jprintf(0, "{\"sysstat\": {");
+		jprintf(1, "\"hosts\": [");
+		jprintf(2, "{");
+		jprintf(3, "\"nodename\": \"%s\",", nodename);
+		jprintf(3, "\"sysname\": \"%s\",", sysname);
+		jprintf(3, "\"release\": \"%s\",", release);
+		jprintf(3, "\"machine\": \"%s\",", machine);
+		jprintf(3, "\"number-of-cpus\": %d,", cpu_nr);
+		jprintf(3, "\"date\": \"%s\",", cur_date);
+		jprintf(3, "\"statistics\": [");
 	}
 
 	return rc;
@@ -1037,10 +1669,79 @@ void init_colors(void)
 	}
 }
 
+/*
+ * Buffer where the values displayed by the cprintf_*() functions are
+ * formatted before being written on standard output.
+ */
+static char cp_buf[1024];
+static int cp_len = 0;
+
+/*
+ ***************************************************************************
+ * Write the contents of the cprintf_*() functions buffer on standard
+ * output.
+ ***************************************************************************
+*/
+static void cp_flush(void)
+{
+	if (cp_len) {
+		fwrite(cp_buf, 1, cp_len, stdout);
+		cp_len = 0;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Append a string to the cprintf_*() functions buffer.
+ *
+ * IN:
+ * @str		String to append.
+ * @len		Length of the string.
+ ***************************************************************************
+*/
+static void cp_append(const char *str, int len)
+{
+	if (cp_len + len > (int) sizeof(cp_buf)) {
+		cp_flush();
+		if (len > (int) sizeof(cp_buf)) {
+			fwrite(str, 1, len, stdout);
+			return;
+		}
+	}
+	memcpy(cp_buf + cp_len, str, len);
+	cp_len += len;
+}
+
+/*
+ ***************************************************************************
+ * Append a value to the cprintf_*() functions buffer, preceded by a space
+ * and right-justified in a field of @wi characters (like " %*s").
+ *
+ * IN:
+ * @num		Value (as a string).
+ * @len		Length of the string.
+ * @wi		Output width.
+ ***************************************************************************
+*/
+static void cp_append_field(const char *num, int len, int wi)
+{
+	char pad[32];
+	int n = (wi > len) ? wi - len + 1 : 1;
+
+	memset(pad, ' ', sizeof(pad));
+	while (n > 0) {
+		cp_append(pad, n < (int) sizeof(pad) ? n : (int) sizeof(pad));
+		n -= sizeof(pad);
+	}
+	cp_append(num, len);
+}
+
 /*
  ***************************************************************************
  * Print a value in human readable format. Such a value is a decimal number
  * followed by a unit (B, k, M, etc.)
+ * NB: The value is only appended to the cprintf_*() functions buffer. It
+ * is actually written on standard output when the buffer is flushed.
  *
  * IN:
  * @unit	Default value unit.
@@ -1050,6 +1751,9 @@ void init_colors(void)
 */
 void cprintf_unit(int unit, int wi, double dval)
 {
+	char num[64];
+	int len;
+
 	if (wi < 4) {
 		/* E.g. 1.3M */
 		wi = 4;
@@ -1063,14 +1767,15 @@ void cprintf_unit(int unit, int wi, double dval)
 		dval /= 1024;
 		unit++;
 	}
-	printf(" %*.*f", wi - 1, dplaces_nr ? 1 : 0, dval);
-	printf("%s", sc_normal);
+	len = sprint_fixed(num, dval, dplaces_nr ? 1 : 0);
+	cp_append_field(num, len, wi - 1);
+	cp_append(sc_normal, strlen(sc_normal));
 
 	/* Display unit */
 	if (unit >= NR_UNITS) {
 		unit = NR_UNITS - 1;
 	}
-	printf("%c", units[unit]);
+	cp_append(&units[unit], 1);
 }
 
 /*
@@ -1085,8 +1790,9 @@ void cprintf_unit(int unit, int wi, double dval)
 */
 void cprintf_u64(int unit, int num, int wi, ...)
 {
-	int i;
+	int i, len;
 	uint64_t val;
+	char str[64];
 	va_list args;
 
 	va_start(args, wi);
@@ -1094,14 +1800,15 @@ void cprintf_u64(int unit, int num, int wi, ...)
 	for (i = 0; i < num; i++) {
 		val = va_arg(args, unsigned long long);
 		if (!val) {
-			printf("%s", sc_zero_int_stat);
+			cp_append(sc_zero_int_stat, strlen(sc_zero_int_stat));
 		}
 		else {
-			printf("%s", sc_int_stat);
+			cp_append(sc_int_stat, strlen(sc_int_stat));
 		}
 		if (unit < 0) {
-			printf(" %*"PRIu64, wi, val);
-			printf("%s", sc_normal);
+			len = sprint_u64(str, val);
+			cp_append_field(str, len, wi);
+			cp_append(sc_normal, strlen(sc_normal));
 		}
 		else {
 			cprintf_unit(unit, wi, (double) val);
@@ -1109,6 +1816,7 @@ void cprintf_u64(int unit, int num, int wi, ...)
 	}
 
 	va_end(args);
+	cp_flush();
 }
 
 /*
@@ -1152,8 +1860,9 @@ void cprintf_x(int num, int wi, ...)
 */
 void cprintf_f(int unit, int num, int wi, int wd, ...)
 {
-	int i;
-	double val, lim = 0.005;;
+	int i, len;
+	double val, lim = 0.005;
+	char str[64];
 	va_list args;
 
 	/*
@@ -1175,15 +1884,16 @@ void cprintf_f(int unit, int num, int wi, int wd, ...)
 		val = va_arg(args, double);
 		if (((wd > 0) && (val < lim) && (val > (lim * -1))) ||
 		    ((wd == 0) && (val <= 0.5) && (val >= -0.5))) {	/* "Round half to even" law */
-			printf("%s", sc_zero_int_stat);
+			cp_append(sc_zero_int_stat, strlen(sc_zero_int_stat));
 		}
 		else {
-			printf("%s", sc_int_stat);
+			cp_append(sc_int_stat, strlen(sc_int_stat));
 		}
 
 		if (unit < 0) {
-			printf(" %*.*f", wi, wd, val);
-			printf("%s", sc_normal);
+			len = sprint_fixed(str, val, wd);
+			cp_append_field(str, len, wi);
+			cp_append(sc_normal, strlen(sc_normal));
 		}
 		else {
 			cprintf_unit(unit, wi, val);
@@ -1191,6 +1901,7 @@ void cprintf_f(int unit, int num, int wi, int wd, ...)
 	}
 
 	va_end(args);
+	cp_flush();
 }
 
 /*
@@ -1207,8 +1918,9 @@ void cprintf_f(int unit, int num, int wi, int wd, ...)
 */
 void cprintf_pc(int human, int num, int wi, int wd, ...)
 {
-	int i;
+	int i, len;
 	double val, lim = 0.005;
+	char str[64];
 	va_list args;
 
 	/*
@@ -1245,24 +1957,26 @@ void cprintf_pc(int human, int num, int wi, int wd, ...)
 	for (i = 0; i < num; i++) {
 		val = va_arg(args, double);
 		if (val >= PERCENT_LIMIT_HIGH) {
-			printf("%s", sc_percent_high);
+			cp_append(sc_percent_high, strlen(sc_percent_high));
 		}
 		else if (val >= PERCENT_LIMIT_LOW) {
-			printf("%s", sc_percent_low);
+			cp_append(sc_percent_low, strlen(sc_percent_low));
 		}
 		else if (((wd > 0) && (val < lim)) ||
 			 ((wd == 0) && (val <= 0.5))) {	/* "Round half to even" law */
-			printf("%s", sc_zero_int_stat);
+			cp_append(sc_zero_int_stat, strlen(sc_zero_int_stat));
 		}
 		else {
-			printf("%s", sc_int_stat);
+			cp_append(sc_int_stat, strlen(sc_int_stat));
 		}
-		printf(" %*.*f", wi, wd, val);
-		printf("%s", sc_normal);
-		if (human > 0) printf("%%");
+		len = sprint_fixed(str, val, wd);
+		cp_append_field(str, len, wi);
+		cp_append(sc_normal, strlen(sc_normal));
+		if (human > 0) cp_append("%", 1);
 	}
 
 	va_end(args);
+	cp_flush();
 }
 
 /*
@@ -65,6 +65,7 @@
 #define K_LOWERALL	"all"
 #define K_UTC		"UTC"
 #define K_JSON		"JSON"
+#define K_JSON_COMPACT	"JSON-compact"
 
 /* Files */
 #define STAT			"/proc/stat"
@@ -87,11 +88,16 @@
 #define SYSFS_MANUFACTURER	"manufacturer"
 #define SYSFS_PRODUCT		"product"
 #define SYSFS_FCHOST		"/sys/class/fc_host"
+#define SYSFS_CGROUP		"/sys/fs/cgroup"
+#define SYSFS_CGROUP_HYBRID	"/sys/fs/cgroup/unified"
 
 #define MAX_FILE_LEN		512
 #define MAX_PF_NAME		1024
 #define MAX_NAME_LEN		128
 
+/* Max interval between two samples, in seconds (about 68 years) */
+#define MAX_INTERVAL_SEC	((long long) INT_MAX)
+
 #define IGNORE_VIRTUAL_DEVICES	FALSE
 #define ACCEPT_VIRTUAL_DEVICES	TRUE
 
@@ -147,6 +153,11 @@
 #define S_VALUE(m,n,p)		(((double) ((n) - (m))) / (p) * 100)
 /* Define SP_VALUE() to normalize to % */
 #define SP_VALUE(m,n,p)		(((double) ((n) - (m))) / (p) * 100)
+/* Define E_VALUE() to get the mean value per event (@p, @q being the numbers of events) */
+#define E_VALUE(m,n,p,q)	((q) == (p) ? 0.0 : ((double) ((n) - (m))) / ((q) - (p)))
+/* Get time in us elapsed between two struct timespec */
+#define TS_DIFF_USEC(b,e)	((((e).tv_sec - (b).tv_sec) * 1000000000ULL +	\
+				  (e).tv_nsec - (b).tv_nsec) / 1000)
 
 /*
  * Under very special circumstances, STDOUT may become unavailable.
@@ -159,6 +170,16 @@
 				 	}				\
 				} while (0)
 
+/* Add a number of microseconds to a struct timespec */
+#define TS_ADD_USEC(ts, us)	do {							\
+					(ts).tv_sec += (us) / 1000000;			\
+					(ts).tv_nsec += ((us) % 1000000) * 1000;	\
+					if ((ts).tv_nsec >= 1000000000) {		\
+						(ts).tv_sec++;				\
+						(ts).tv_nsec -= 1000000000;		\
+					}						\
+				} while (0)
+
 #define MINIMUM(a,b)	((a) < (b) ? (a) : (b))
 
 #define PANIC(m)	sysstat_panic(__FUNCTION__, m)
@@ -180,6 +201,9 @@ extern unsigned int kb_shift;
 /* Type of persistent device names used in sar and iostat */
 extern char persistent_name_type[MAX_FILE_LEN];
 
+/* TRUE if JSON output should be written without indentation nor newlines */
+extern int json_compact;
+
 /*
  ***************************************************************************
  * Colors definitions
@@ -206,12 +230,59 @@ extern char persistent_name_type[MAX_FILE_LEN];
 #define IS_COMMENT	3
 #define IS_ZERO		4
 
+/* Number of formats that can be compiled by jprintf() */
+#define JSON_FMT_CACHE	512
+/* Size of the buffer where JSON output is formatted */
+#define JSON_BUF_LEN	4096
+/* Maximum number of tabs written at once */
+#define JSON_MAX_TABS	16
+
+/* Conversions supported in compiled JSON formats */
+#define JC_END		0	/* No conversion: end of format */
+#define JC_INT		1	/* %d */
+#define JC_UINT		2	/* %u */
+#define JC_LONG		3	/* %ld */
+#define JC_ULONG	4	/* %lu */
+#define JC_LLONG	5	/* %lld */
+#define JC_ULLONG	6	/* %llu */
+#define JC_HEX		7	/* %x */
+#define JC_CHAR		8	/* %c */
+#define JC_STR		9	/* %s */
+#define JC_FIXED	10	/* %.<n>f */
+
 /*
  ***************************************************************************
  * Structures definitions
  ***************************************************************************
  */
 
+/* Sampling timer, firing on absolute CLOCK_MONOTONIC deadlines */
+struct sample_timer {
+	struct timespec deadline;
+	unsigned long long period_us;
+	/* Lateness of current sample, in microseconds */
+	unsigned long long late_us;
+};
+
+/*
+ * Segment of a compiled JSON format: literal text (already stripped of
+ * whitespaces in compact mode) followed by a conversion.
+ */
+struct json_seg {
+	const char *text;
+	int len;
+	int conv;
+	/* Number of decimal places for JC_FIXED */
+	int prec;
+};
+
+/* Entry of the cache of compiled JSON formats */
+struct json_fmt {
+	const char *fmtf;
+	/* Compiled format, or NULL if it cannot be compiled */
+	struct json_seg *seg;
+};
+
 /* Structure used for extended disk statistics */
 struct ext_disk_stats {
 	double util;
@@ -234,12 +305,20 @@ time_t get_localtime
 	(struct tm *, int);
 time_t get_time
 	(struct tm *, int);
+time_t get_time_usec
+	(struct tm *, int, unsigned int *);
 void init_nls
 	(void);
 int is_device
 	(char *, int);
+long long parse_interval
+	(char *);
+void start_sample_timer
+	(struct sample_timer *, unsigned long long);
 void sysstat_panic
 	(const char *, int);
+int wait_sample_timer
+	(struct sample_timer *);
 
 #ifndef SOURCE_SADC
 int count_bits
@@ -280,12 +359,22 @@ double ll_sp_value
 	(unsigned long long, unsigned long long, unsigned long long);
 int is_iso_time_fmt
 	(void);
+void jprintf
+	(int, const char *, ...);
+void jprintf0
+	(int, const char *, ...);
+void jprintf_end
+	(void);
 int parse_values
 	(char *, unsigned char[], int, const char *);
 int print_gal_header
 	(struct tm *, char *, char *, char *, char *, int, int);
 int set_report_date
 	(struct tm *, char[], int);
+int sprint_fixed
+	(char *, double, int);
+int sprint_u64
+	(char *, unsigned long long);
 char *strtolower
 	(char *);
 void xprintf
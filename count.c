@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "common.h"
@@ -350,6 +351,13 @@ __nr_t get_iface_nr(void)
 	char line[128];
 	__nr_t iface = 0;
 
+	/* Count interfaces using netlink if possible */
+	if ((iface = read_link_snapshot()) >= 0) {
+		release_link_snapshot();
+		return iface;
+	}
+	iface = 0;
+
 	if ((fp = fopen(NET_DEV, "r")) == NULL)
 		return 0;	/* No network device file */
 
@@ -466,7 +474,7 @@ __nr_t get_filesystem_nr(void)
 	char line[512], fs_name[MAX_FS_LEN], mountp[256], type[128];
 	char *pos = 0, *pos2 = 0;
 	__nr_t fs = 0;
-	int skip = 0, skip_next = 0;
+	int skip = 0, skip_next = 0, stale;
 	struct statvfs buf;
 
 	if ((fp = fopen(MTAB, "r")) == NULL)
@@ -512,7 +520,7 @@ __nr_t get_filesystem_nr(void)
 			oct2chr(mountp);
 
 			/* Check that total size is not zero */
-			if (statvfs(mountp, &buf) < 0)
+			if (statvfs_timeout(mountp, &buf, &stale) < 0)
 				continue;
 
 			if (buf.f_blocks) {
@@ -559,5 +567,70 @@ __nr_t get_fchost_nr(void)
 	return fc;
 }
 
+/*
+ ***************************************************************************
+ * Count number of cgroups located below a given cgroup directory.
+ *
+ * IN:
+ * @dfd		File descriptor of cgroup directory. Closed on return.
+ * @depth	Depth of the cgroup in the hierarchy.
+ *
+ * RETURNS:
+ * Number of cgroups.
+ ***************************************************************************
+ */
+static __nr_t count_cgroup_dir(int dfd, int depth)
+{
+	DIR *dir;
+	struct dirent *drd;
+	__nr_t cg = 0;
+	int cfd;
+
+	if ((dir = fdopendir(dfd)) == NULL) {
+		close(dfd);
+		return 0;
+	}
+
+	while ((drd = readdir(dir)) != NULL) {
+
+		if ((drd->d_type != DT_DIR) || (drd->d_name[0] == '.'))
+			continue;
+
+		cg++;
+
+		if ((depth + 1 < MAX_CG_DEPTH) &&
+		    ((cfd = openat(dirfd(dir), drd->d_name,
+				   O_RDONLY | O_DIRECTORY | O_CLOEXEC)) >= 0)) {
+			cg += count_cgroup_dir(cfd, depth + 1);
+		}
+	}
+
+	closedir(dir);
+
+	return cg;
+}
+
+/*
+ ***************************************************************************
+ * Find number of cgroups in the cgroup v2 hierarchy (root cgroup excluded).
+ *
+ * RETURNS:
+ * Number of cgroups.
+ * Return -1 if there is no cgroup v2 hierarchy.
+ ***************************************************************************
+ */
+__nr_t get_cgroup_nr(void)
+{
+	char *root;
+	int dfd;
+
+	if (((root = get_cgroup_root()) == NULL) ||
+	    ((dfd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0))
+		/* No cgroup v2 hierarchy */
+		return -1;
+
+	return count_cgroup_dir(dfd, 0);
+}
+
 /*------------------ END: FUNCTIONS USED BY SADC ONLY ---------------------*/
 #endif /* SOURCE_SADC */
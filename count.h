@@ -37,5 +37,7 @@ __nr_t get_filesystem_nr
 	(void);
 __nr_t get_fchost_nr
 	(void);
+__nr_t get_cgroup_nr
+	(void);
 
 #endif /* _COUNT_H */
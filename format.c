@@ -153,6 +153,19 @@ struct report_format pcp_fmt = {
 	.f_comment	= NULL
 };
 
+/*
+ * Apache Arrow IPC streams.
+ */
+struct report_format arrow_fmt = {
+	.id		= F_ARROW_OUTPUT,
+	.options	= FO_GROUPED_STATS,
+	.f_header	= NULL,
+	.f_statistics	= NULL,
+	.f_timestamp	= print_arrow_timestamp,
+	.f_restart	= NULL,
+	.f_comment	= NULL
+};
+
 /*
  * Array of output formats.
  */
@@ -165,7 +178,8 @@ struct report_format *fmt[NR_FMT] = {
 	&conv_fmt,
 	&svg_fmt,
 	&raw_fmt,
-	&pcp_fmt
+	&pcp_fmt,
+	&arrow_fmt
 };
 #endif
 
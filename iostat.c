@@ -68,11 +68,13 @@ int group_nr = 0;	/* Nb of device groups */
 int cpu_nr = 0;		/* Nb of processors on the machine */
 int flags = 0;		/* Flag for common options and system state */
 unsigned int dm_major;	/* Device-mapper major number */
+/* /proc/diskstats file, kept open between samples */
+struct src_file diskstats_file = SRC_FILE_INIT(DISKSTATS);
 
-long interval = 0;
+long long interval = 0;
 char timestamp[TIMESTAMP_LEN];
 
-struct sigaction alrm_act, int_act;
+struct sigaction int_act;
 int sigint_caught = 0;
 
 /*
@@ -91,14 +93,14 @@ void usage(char *progname)
 	fprintf(stderr, _("Options are:\n"
 			  "[ -c ] [ -d ] [ -h ] [ -k | -m ] [ -N ] [ -s ] [ -t ] [ -V ] [ -x ] [ -y ] [ -z ]\n"
 			  "[ -j { ID | LABEL | PATH | UUID | ... } ]\n"
-			  "[ --dec={ 0 | 1 | 2 } ] [ --human ] [ -o JSON ]\n"
+			  "[ --dec={ 0 | 1 | 2 } ] [ --human ] [ -o { JSON | JSON-compact } ]\n"
 			  "[ [ -H ] -g <group_name> ] [ -p [ <device> [,...] | ALL ] ]\n"
 			  "[ <device> [...] | ALL ] [ --debuginfo ]\n"));
 #else
 	fprintf(stderr, _("Options are:\n"
 			  "[ -c ] [ -d ] [ -h ] [ -k | -m ] [ -N ] [ -s ] [ -t ] [ -V ] [ -x ] [ -y ] [ -z ]\n"
 			  "[ -j { ID | LABEL | PATH | UUID | ... } ]\n"
-			  "[ --dec={ 0 | 1 | 2 } ] [ --human ] [ -o JSON ]\n"
+			  "[ --dec={ 0 | 1 | 2 } ] [ --human ] [ -o { JSON | JSON-compact } ]\n"
 			  "[ [ -H ] -g <group_name> ] [ -p [ <device> [,...] | ALL ] ]\n"
 			  "[ <device> [...] | ALL ]\n"));
 #endif
@@ -124,19 +126,6 @@ void set_disk_output_unit(void)
 	}
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to reset the handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * SIGINT signal handler.
@@ -725,7 +714,7 @@ void read_sysfs_stat(int curr, int iodev_nr)
  */
 void read_diskstats_stat(int curr, int iodev_nr, int dlist_idx)
 {
-	FILE *fp;
+	const char *pos;
 	char line[256], dev_name[MAX_NAME_LEN];
 	char *dm_name;
 	struct io_stats sdev;
@@ -734,6 +723,7 @@ void read_diskstats_stat(int curr, int iodev_nr, int dlist_idx)
 	unsigned long rd_ios, rd_merges_or_rd_sec, rd_ticks_or_wr_sec, wr_ios;
 	unsigned long wr_merges, rd_sec_or_wr_ios, wr_sec;
 	unsigned long dc_ios, dc_merges, dc_sec, dc_ticks;
+	unsigned long long val[DISKSTATS_FIELDS];
 	char *ioc_dname;
 	unsigned int major, minor;
 
@@ -742,17 +732,33 @@ void read_diskstats_stat(int curr, int iodev_nr, int dlist_idx)
 	/* Every I/O device entry is potentially unregistered */
 	set_entries_unregistered(iodev_nr, st_hdr_iodev);
 
-	if ((fp = fopen(DISKSTATS, "r")) == NULL)
+	if ((pos = read_src_file(&diskstats_file)) == NULL)
 		return;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		/* major minor name rio rmerge rsect ruse wio wmerge wsect wuse running use aveq dcio dcmerge dcsect dcuse*/
-		i = sscanf(line, "%u %u %s %lu %lu %lu %lu %lu %lu %lu %u %u %u %u %lu %lu %lu %lu",
-			   &major, &minor, dev_name,
-			   &rd_ios, &rd_merges_or_rd_sec, &rd_sec_or_wr_ios, &rd_ticks_or_wr_sec,
-			   &wr_ios, &wr_merges, &wr_sec, &wr_ticks, &ios_pgr, &tot_ticks, &rq_ticks,
-			   &dc_ios, &dc_merges, &dc_sec, &dc_ticks);
+		memset(val, 0, sizeof(val));
+		if ((i = parse_diskstats_line(line, &major, &minor, dev_name,
+					      sizeof(dev_name), val)) < 0)
+			continue;
+		rd_ios              = val[0];
+		rd_merges_or_rd_sec = val[1];
+		rd_sec_or_wr_ios    = val[2];
+		rd_ticks_or_wr_sec  = val[3];
+		wr_ios    = val[4];
+		wr_merges = val[5];
+		wr_sec    = val[6];
+		wr_ticks  = val[7];
+		ios_pgr   = val[8];
+		tot_ticks = val[9];
+		rq_ticks  = val[10];
+		dc_ios    = val[11];
+		dc_merges = val[12];
+		dc_sec    = val[13];
+		dc_ticks  = val[14];
+		/* Number of fields read, including major, minor and device name */
+		i += 3;
 
 		if (i >= 14) {
 			/* Device or partition */
@@ -820,7 +826,6 @@ void read_diskstats_stat(int curr, int iodev_nr, int dlist_idx)
 
 		save_stats(dev_name, curr, &sdev, iodev_nr, st_hdr_iodev);
 	}
-	fclose(fp);
 
 	/* Free structures corresponding to unregistered devices */
 	free_unregistered_entries(iodev_nr, st_hdr_iodev);
@@ -898,7 +903,7 @@ void write_sample_timestamp(int tab, struct tm *rectime)
 		strftime(timestamp, sizeof(timestamp), "%x %X", rectime);
 	}
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		xprintf(tab, "\"timestamp\": \"%s\",", timestamp);
+		jprintf(tab, "\"timestamp\": \"%s\",", timestamp);
 	}
 	else {
 		printf("%s\n", timestamp);
@@ -953,7 +958,7 @@ void write_plain_cpu_stat(int curr, unsigned long long deltot_jiffies)
  */
 void write_json_cpu_stat(int tab, int curr, unsigned long long deltot_jiffies)
 {
-	xprintf0(tab, "\"avg-cpu\":  {\"user\": %.2f, \"nice\": %.2f, \"system\": %.2f,"
+	jprintf0(tab, "\"avg-cpu\":  {\"user\": %.2f, \"nice\": %.2f, \"system\": %.2f,"
 		      " \"iowait\": %.2f, \"steal\": %.2f, \"idle\": %.2f}",
 		 ll_sp_value(st_cpu[!curr]->cpu_user, st_cpu[curr]->cpu_user, deltot_jiffies),
 		 ll_sp_value(st_cpu[!curr]->cpu_nice, st_cpu[curr]->cpu_nice, deltot_jiffies),
@@ -1044,7 +1049,7 @@ void write_disk_stat_header(int *fctr, int *tab, int hpart)
 	char *units, *spc;
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		xprintf((*tab)++, "\"disk\": [");
+		jprintf((*tab)++, "\"disk\": [");
 		return;
 	}
 
@@ -1287,76 +1292,78 @@ void write_json_ext_stat(int tab, unsigned long long itv, int fctr,
 			 struct io_stats *ioj, char *devname, struct ext_disk_stats *xds,
 			 struct ext_io_stats *xios)
 {
-	char line[256];
+	double rsectors, wsectors, dsectors;
 
-	xprintf0(tab,
+	jprintf0(tab,
 		 "{\"disk_device\": \"%s\", ",
 		 devname);
 
 	if (DISPLAY_SHORT_OUTPUT(flags)) {
-		printf("\"tps\": %.2f, \"",
-		       S_VALUE(ioj->rd_ios + ioj->wr_ios + ioj->dc_ios,
-			       ioi->rd_ios + ioi->wr_ios + ioi->dc_ios, itv));
+		jprintf0(0, "\"tps\": %.2f, ",
+			 S_VALUE(ioj->rd_ios + ioj->wr_ios + ioj->dc_ios,
+				 ioi->rd_ios + ioi->wr_ios + ioi->dc_ios, itv));
 		if (DISPLAY_MEGABYTES(flags)) {
-			printf("MB/s");
+			jprintf0(0, "\"MB/s\": %.2f, ", xios->sectors /= fctr);
 		}
 		else if (DISPLAY_KILOBYTES(flags)) {
-			printf("kB/s");
+			jprintf0(0, "\"kB/s\": %.2f, ", xios->sectors /= fctr);
 		}
 		else {
-			printf("sec/s");
+			jprintf0(0, "\"sec/s\": %.2f, ", xios->sectors /= fctr);
 		}
-		printf("\": %.2f, \"rqm/s\": %.2f, \"await\": %.2f, "
-		       "\"areq-sz\": %.2f, \"aqu-sz\": %.2f, ",
-		       xios->sectors /= fctr,
-		       S_VALUE(ioj->rd_merges + ioj->wr_merges + ioj->dc_merges,
-			       ioi->rd_merges + ioi->wr_merges + ioi->dc_merges, itv),
-		       xds->await,
-		       xds->arqsz / 2,
-		       S_VALUE(ioj->rq_ticks, ioi->rq_ticks, itv) / 1000.0);
+		jprintf0(0, "\"rqm/s\": %.2f, \"await\": %.2f, "
+			 "\"areq-sz\": %.2f, \"aqu-sz\": %.2f, ",
+			 S_VALUE(ioj->rd_merges + ioj->wr_merges + ioj->dc_merges,
+				 ioi->rd_merges + ioi->wr_merges + ioi->dc_merges, itv),
+			 xds->await,
+			 xds->arqsz / 2,
+			 S_VALUE(ioj->rq_ticks, ioi->rq_ticks, itv) / 1000.0);
 	}
 	else {
-		printf("\"r/s\": %.2f, \"w/s\": %.2f, \"d/s\": %.2f, ",
-		       S_VALUE(ioj->rd_ios, ioi->rd_ios, itv),
-		       S_VALUE(ioj->wr_ios, ioi->wr_ios, itv),
-		       S_VALUE(ioj->dc_ios, ioi->dc_ios, itv));
+		jprintf0(0, "\"r/s\": %.2f, \"w/s\": %.2f, \"d/s\": %.2f, ",
+			 S_VALUE(ioj->rd_ios, ioi->rd_ios, itv),
+			 S_VALUE(ioj->wr_ios, ioi->wr_ios, itv),
+			 S_VALUE(ioj->dc_ios, ioi->dc_ios, itv));
+		rsectors = xios->rsectors /= fctr;
+		wsectors = xios->wsectors /= fctr;
+		dsectors = xios->dsectors /= fctr;
 		if (DISPLAY_MEGABYTES(flags)) {
-			sprintf(line, "\"rMB/s\": %%.2f, \"wMB/s\": %%.2f, \"dMB/s\": %%.2f, ");
+			jprintf0(0, "\"rMB/s\": %.2f, \"wMB/s\": %.2f, \"dMB/s\": %.2f, ",
+				 rsectors, wsectors, dsectors);
 		}
 		else if (DISPLAY_KILOBYTES(flags)) {
-			sprintf(line, "\"rkB/s\": %%.2f, \"wkB/s\": %%.2f, \"dkB/s\": %%.2f, ");
+			jprintf0(0, "\"rkB/s\": %.2f, \"wkB/s\": %.2f, \"dkB/s\": %.2f, ",
+				 rsectors, wsectors, dsectors);
 		}
 		else {
-			sprintf(line, "\"rsec/s\": %%.2f, \"wsec/s\": %%.2f, \"dsec/s\": %%.2f, ");
-		}
-		printf(line,
-		       xios->rsectors /= fctr,
-		       xios->wsectors /= fctr,
-		       xios->dsectors /= fctr);
-		printf("\"rrqm/s\": %.2f, \"wrqm/s\": %.2f, \"drqm/s\": %.2f, "
-		       "\"rrqm\": %.2f, \"wrqm\": %.2f, \"drqm\": %.2f, "
-		       "\"r_await\": %.2f, \"w_await\": %.2f, \"d_await\": %.2f, "
-		       "\"rareq-sz\": %.2f, \"wareq-sz\": %.2f, \"dareq-sz\": %.2f, "
-		       "\"aqu-sz\": %.2f, ",
-		       S_VALUE(ioj->rd_merges, ioi->rd_merges, itv),
-		       S_VALUE(ioj->wr_merges, ioi->wr_merges, itv),
-		       S_VALUE(ioj->dc_merges, ioi->dc_merges, itv),
-		       xios->rrqm_pc,
-		       xios->wrqm_pc,
-		       xios->drqm_pc,
-		       xios->r_await,
-		       xios->w_await,
-		       xios->d_await,
-		       xios->rarqsz / 2,
-		       xios->warqsz / 2,
-		       xios->darqsz / 2,
-		       S_VALUE(ioj->rq_ticks, ioi->rq_ticks, itv) / 1000.0);
-	}
-	printf("\"util\": %.2f}",
+			jprintf0(0, "\"rsec/s\": %.2f, \"wsec/s\": %.2f, \"dsec/s\": %.2f, ",
+				 rsectors, wsectors, dsectors);
+		}
+		jprintf0(0, "\"rrqm/s\": %.2f, \"wrqm/s\": %.2f, \"drqm/s\": %.2f, "
+			 "\"rrqm\": %.2f, \"wrqm\": %.2f, \"drqm\": %.2f, "
+			 "\"r_await\": %.2f, \"w_await\": %.2f, \"d_await\": %.2f, "
+			 "\"rareq-sz\": %.2f, \"wareq-sz\": %.2f, \"dareq-sz\": %.2f, "
+			 "\"aqu-sz\": %.2f, ",
+			 S_VALUE(ioj->rd_merges, ioi->rd_merges, itv),
+			 S_VALUE(ioj->wr_merges, ioi->wr_merges, itv),
+			 S_VALUE(ioj->dc_merges, ioi->dc_merges, itv),
+			 xios->rrqm_pc,
+			 xios->wrqm_pc,
+			 xios->drqm_pc,
+			 xios->r_await,
+			 xios->w_await,
+			 xios->d_await,
+			 xios->rarqsz / 2,
+			 xios->warqsz / 2,
+			 xios->darqsz / 2,
+			 S_VALUE(ioj->rq_ticks, ioi->rq_ticks, itv) / 1000.0);
+	}
+	jprintf0(0, "\"util\": %.2f}",
 		 shi->used ? xds->util / 10.0 / (double) shi->used
 			   : xds->util / 10.0);	/* shi->used should never be zero here */
 }
 
+
 /*
  ***************************************************************************
  * Display extended stats, read from /proc/{diskstats,partitions} or /sys,
@@ -1582,32 +1589,36 @@ void write_json_basic_stat(int tab, unsigned long long itv, int fctr,
 			   char *devname, unsigned long long rd_sec,
 			   unsigned long long wr_sec, unsigned long long dc_sec)
 {
-	char line[256];
+	double rd_rate, wr_rate, dc_rate;
 
-	xprintf0(tab,
+	jprintf0(tab,
 		 "{\"disk_device\": \"%s\", \"tps\": %.2f, ",
 		 devname,
 		 S_VALUE(ioj->rd_ios + ioj->wr_ios + ioj->dc_ios,
 			 ioi->rd_ios + ioi->wr_ios + ioi->dc_ios, itv));
+
+	rd_rate = S_VALUE(ioj->rd_sectors, ioi->rd_sectors, itv) / fctr;
+	wr_rate = S_VALUE(ioj->wr_sectors, ioi->wr_sectors, itv) / fctr;
+	dc_rate = S_VALUE(ioj->dc_sectors, ioi->dc_sectors, itv) / fctr;
+	rd_sec /= fctr;
+	wr_sec /= fctr;
+	dc_sec /= fctr;
+
 	if (DISPLAY_KILOBYTES(flags)) {
-		sprintf(line, "\"kB_read/s\": %%.2f, \"kB_wrtn/s\": %%.2f, \"kB_dscd/s\": %%.2f, "
-			"\"kB_read\": %%llu, \"kB_wrtn\": %%llu, \"kB_dscd\": %%llu}");
+		jprintf0(0, "\"kB_read/s\": %.2f, \"kB_wrtn/s\": %.2f, \"kB_dscd/s\": %.2f, "
+			 "\"kB_read\": %llu, \"kB_wrtn\": %llu, \"kB_dscd\": %llu}",
+			 rd_rate, wr_rate, dc_rate, rd_sec, wr_sec, dc_sec);
 	}
 	else if (DISPLAY_MEGABYTES(flags)) {
-		sprintf(line, "\"MB_read/s\": %%.2f, \"MB_wrtn/s\": %%.2f, \"MB_dscd/s\": %%.2f, "
-			"\"MB_read\": %%llu, \"MB_wrtn\": %%llu, \"MB_dscd\": %%llu}");
+		jprintf0(0, "\"MB_read/s\": %.2f, \"MB_wrtn/s\": %.2f, \"MB_dscd/s\": %.2f, "
+			 "\"MB_read\": %llu, \"MB_wrtn\": %llu, \"MB_dscd\": %llu}",
+			 rd_rate, wr_rate, dc_rate, rd_sec, wr_sec, dc_sec);
 	}
 	else {
-		sprintf(line, "\"Blk_read/s\": %%.2f, \"Blk_wrtn/s\": %%.2f, \"Blk_dscd/s\": %%.2f, "
-			"\"Blk_read\": %%llu, \"Blk_wrtn\": %%llu, \"Blk_dscd\": %%llu}");
-	}
-	printf(line,
-	       S_VALUE(ioj->rd_sectors, ioi->rd_sectors, itv) / fctr,
-	       S_VALUE(ioj->wr_sectors, ioi->wr_sectors, itv) / fctr,
-	       S_VALUE(ioj->dc_sectors, ioi->dc_sectors, itv) / fctr,
-	       (unsigned long long) rd_sec / fctr,
-	       (unsigned long long) wr_sec / fctr,
-	       (unsigned long long) dc_sec / fctr);
+		jprintf0(0, "\"Blk_read/s\": %.2f, \"Blk_wrtn/s\": %.2f, \"Blk_dscd/s\": %.2f, "
+			 "\"Blk_read\": %llu, \"Blk_wrtn\": %llu, \"Blk_dscd\": %llu}",
+			 rd_rate, wr_rate, dc_rate, rd_sec, wr_sec, dc_sec);
+	}
 }
 
 /*
@@ -1685,7 +1696,7 @@ void write_stats(int curr, struct tm *rectime, int iodev_nr, int dlist_idx)
 	TEST_STDOUT(STDOUT_FILENO);
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		xprintf(tab++, "{");
+		jprintf(tab++, "{");
 	}
 
 	/* Print time stamp */
@@ -1704,9 +1715,9 @@ void write_stats(int curr, struct tm *rectime, int iodev_nr, int dlist_idx)
 
 		if (DISPLAY_JSON_OUTPUT(flags)) {
 			if (DISPLAY_DISK(flags)) {
-				printf(",");
+				jprintf0(0, ",");
 			}
-			printf("\n");
+			jprintf0(0, "\n");
 		}
 	}
 
@@ -1803,7 +1814,7 @@ void write_stats(int curr, struct tm *rectime, int iodev_nr, int dlist_idx)
 #endif
 
 					if (DISPLAY_JSON_OUTPUT(flags) && next) {
-						printf(",\n");
+						jprintf0(0, ",\n");
 					}
 					next = TRUE;
 
@@ -1820,13 +1831,13 @@ void write_stats(int curr, struct tm *rectime, int iodev_nr, int dlist_idx)
 			}
 		}
 		if (DISPLAY_JSON_OUTPUT(flags)) {
-			printf("\n");
-			xprintf(--tab, "]");
+			jprintf0(0, "\n");
+			jprintf(--tab, "]");
 		}
 	}
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		xprintf0(--tab, "}");
+		jprintf0(--tab, "}");
 	}
 	else {
 		printf("\n");
@@ -1848,17 +1859,15 @@ void rw_io_stat_loop(long int count, struct tm *rectime, int iodev_nr, int dlist
 {
 	int curr = 1;
 	int skip = 0;
+	struct sample_timer sample_tm;
 
 	/* Should we skip first report? */
 	if (DISPLAY_OMIT_SINCE_BOOT(flags) && interval > 0) {
 		skip = 1;
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Start sampling timer */
+	start_sample_timer(&sample_tm, (unsigned long long) interval);
 
 	/* Set a handler for SIGINT */
 	memset(&int_act, 0, sizeof(int_act));
@@ -1924,22 +1933,32 @@ void rw_io_stat_loop(long int count, struct tm *rectime, int iodev_nr, int dlist
 
 		if (count) {
 			curr ^= 1;
-			pause();
+			/* Wait for next sampling time, or until SIGINT is received */
+			while ((wait_sample_timer(&sample_tm) < 0) && !sigint_caught);
 
 			if (sigint_caught) {
 				/* SIGINT signal caught => Terminate JSON output properly */
 				count = 0;
 			}
 			else if (DISPLAY_JSON_OUTPUT(flags) && count) {
-				printf(",");
+				jprintf0(0, ",");
 			}
 		}
-		printf("\n");
+		if (DISPLAY_JSON_OUTPUT(flags)) {
+			jprintf0(0, "\n");
+		}
+		else {
+			printf("\n");
+		}
 	}
 	while (count);
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		printf("\t\t\t]\n\t\t}\n\t]\n}}\n");
+		jprintf(3, "]");
+		jprintf(2, "}");
+		jprintf(1, "]");
+		jprintf(0, "}}");
+		jprintf_end();
 	}
 }
 
@@ -2081,6 +2100,11 @@ int main(int argc, char **argv)
 				flags |= I_D_JSON_OUTPUT;
 				opt++;
 			}
+			else if (argv[opt] && !strcmp(argv[opt], K_JSON_COMPACT)) {
+				flags |= I_D_JSON_OUTPUT;
+				json_compact = TRUE;
+				opt++;
+			}
 			else {
 				usage(argv[0]);
 			}
@@ -2211,7 +2235,7 @@ int main(int argc, char **argv)
 		}
 
 		else if (!it) {
-			interval = atol(argv[opt++]);
+			interval = parse_interval(argv[opt++]);
 			if (interval < 0) {
 				usage(argv[0]);
 			}
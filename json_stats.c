@@ -36,6 +36,7 @@
 #endif
 
 extern unsigned int flags;
+extern struct activity *act[];
 
 /*
  ***************************************************************************
@@ -56,12 +57,12 @@ void json_markup_network(int tab, int action)
 
 	if (action == OPEN_JSON_MARKUP) {
 		/* Open markup */
-		xprintf(tab, "\"network\": {");
+		jprintf(tab, "\"network\": {");
 	}
 	else {
 		/* Close markup */
-		printf("\n");
-		xprintf0(tab, "}");
+		jprintf0(0, "\n");
+		jprintf0(tab, "}");
 	}
 }
 
@@ -84,12 +85,12 @@ void json_markup_power_management(int tab, int action)
 
 	if (action == OPEN_JSON_MARKUP) {
 		/* Open markup */
-		xprintf(tab, "\"power-management\": {");
+		jprintf(tab, "\"power-management\": {");
 	}
 	else {
 		/* Close markup */
-		printf("\n");
-		xprintf0(tab, "}");
+		jprintf0(0, "\n");
+		jprintf0(tab, "}");
 	}
 }
 
@@ -115,7 +116,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 	unsigned char offline_cpu_bitmap[BITMAP_SIZE(NR_CPUS)] = {0};
 	char cpuno[16];
 
-	xprintf(tab++, "\"cpu-load\": [");
+	jprintf(tab++, "\"cpu-load\": [");
 
 	/* @nr[curr] cannot normally be greater than @nr_ini */
 	if (a->nr[curr] > a->nr_ini) {
@@ -143,7 +144,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 		scp = (struct stats_cpu *) ((char *) a->buf[!curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
@@ -175,7 +176,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 			if (!deltot_jiffies) {
 				/* Current CPU is tickless */
 				if (DISPLAY_CPU_DEF(a->opt_flags)) {
-					xprintf0(tab, "{\"cpu\": \"%d\", "
+					jprintf0(tab, "{\"cpu\": \"%d\", "
 						 "\"user\": %.2f, "
 						 "\"nice\": %.2f, "
 						 "\"system\": %.2f, "
@@ -185,7 +186,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 						 i - 1, 0.0, 0.0, 0.0, 0.0, 0.0, 100.0);
 				}
 				else if (DISPLAY_CPU_ALL(a->opt_flags)) {
-					xprintf0(tab, "{\"cpu\": \"%d\", "
+					jprintf0(tab, "{\"cpu\": \"%d\", "
 						 "\"usr\": %.2f, "
 						 "\"nice\": %.2f, "
 						 "\"sys\": %.2f, "
@@ -204,7 +205,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 		}
 
 		if (DISPLAY_CPU_DEF(a->opt_flags)) {
-			xprintf0(tab, "{\"cpu\": \"%s\", "
+			jprintf0(tab, "{\"cpu\": \"%s\", "
 				 "\"user\": %.2f, "
 				 "\"nice\": %.2f, "
 				 "\"system\": %.2f, "
@@ -224,7 +225,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 				 ll_sp_value(scp->cpu_idle, scc->cpu_idle, deltot_jiffies));
 		}
 		else if (DISPLAY_CPU_ALL(a->opt_flags)) {
-			xprintf0(tab, "{\"cpu\": \"%s\", "
+			jprintf0(tab, "{\"cpu\": \"%s\", "
 				 "\"usr\": %.2f, "
 				 "\"nice\": %.2f, "
 				 "\"sys\": %.2f, "
@@ -257,8 +258,8 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 		}
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -280,7 +281,7 @@ __print_funct_t json_print_pcsw_stats(struct activity *a, int curr, int tab,
 		*spp = (struct stats_pcsw *) a->buf[!curr];
 
 	/* proc/s and cswch/s */
-	xprintf0(tab, "\"process-and-context-switch\": {"
+	jprintf0(tab, "\"process-and-context-switch\": {"
 		 "\"proc\": %.2f, "
 		 "\"cswch\": %.2f}",
 		 S_VALUE(spp->processes, spc->processes, itv),
@@ -306,7 +307,7 @@ __print_funct_t json_print_irq_stats(struct activity *a, int curr, int tab,
 	int sep = FALSE;
 	char irqno[16];
 
-	xprintf(tab++, "\"interrupts\": [");
+	jprintf(tab++, "\"interrupts\": [");
 
 	for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -319,7 +320,7 @@ __print_funct_t json_print_irq_stats(struct activity *a, int curr, int tab,
 			/* Yes: Display it */
 
 			if (sep) {
-				printf(",\n");
+				jprintf0(0, ",\n");
 			}
 			sep = TRUE;
 
@@ -331,15 +332,15 @@ __print_funct_t json_print_irq_stats(struct activity *a, int curr, int tab,
 				sprintf(irqno, "%d", i - 1);
 			}
 
-			xprintf0(tab, "{\"intr\": \"%s\", "
+			jprintf0(tab, "{\"intr\": \"%s\", "
 				 "\"value\": %.2f}",
 				 irqno,
 				 S_VALUE(sip->irq_nr, sic->irq_nr, itv));
 		}
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -360,7 +361,7 @@ __print_funct_t json_print_swap_stats(struct activity *a, int curr, int tab,
 		*ssc = (struct stats_swap *) a->buf[curr],
 		*ssp = (struct stats_swap *) a->buf[!curr];
 
-	xprintf0(tab, "\"swap-pages\": {"
+	jprintf0(tab, "\"swap-pages\": {"
 		 "\"pswpin\": %.2f, "
 		 "\"pswpout\": %.2f}",
 		 S_VALUE(ssp->pswpin,  ssc->pswpin,  itv),
@@ -385,7 +386,7 @@ __print_funct_t json_print_paging_stats(struct activity *a, int curr, int tab,
 		*spc = (struct stats_paging *) a->buf[curr],
 		*spp = (struct stats_paging *) a->buf[!curr];
 
-	xprintf0(tab, "\"paging\": {"
+	jprintf0(tab, "\"paging\": {"
 		 "\"pgpgin\": %.2f, "
 		 "\"pgpgout\": %.2f, "
 		 "\"fault\": %.2f, "
@@ -428,7 +429,7 @@ __print_funct_t json_print_io_stats(struct activity *a, int curr, int tab,
 		*sic = (struct stats_io *) a->buf[curr],
 		*sip = (struct stats_io *) a->buf[!curr];
 
-	xprintf0(tab, "\"io\": {"
+	jprintf0(tab, "\"io\": {"
 		 "\"tps\": %.2f, "
 		 "\"io-reads\": {"
 		 "\"rtps\": %.2f, "
@@ -480,7 +481,7 @@ __print_funct_t json_print_memory_stats(struct activity *a, int curr, int tab,
 	int sep = FALSE;
 	unsigned long long nousedmem;
 
-	xprintf0(tab, "\"memory\": {");
+	jprintf0(tab, "\"memory\": {");
 
 	if (DISPLAY_MEMORY(a->opt_flags)) {
 
@@ -491,72 +492,72 @@ __print_funct_t json_print_memory_stats(struct activity *a, int curr, int tab,
 			nousedmem = smc->tlmkb;
 		}
 
-		printf("\"memfree\": %llu, "
-		       "\"avail\": %llu, "
-		       "\"memused\": %llu, "
-		       "\"memused-percent\": %.2f, "
-		       "\"buffers\": %llu, "
-		       "\"cached\": %llu, "
-		       "\"commit\": %llu, "
-		       "\"commit-percent\": %.2f, "
-		       "\"active\": %llu, "
-		       "\"inactive\": %llu, "
-		       "\"dirty\": %llu",
-		       smc->frmkb,
-		       smc->availablekb,
-		       smc->tlmkb - nousedmem,
-		       smc->tlmkb ?
-		       SP_VALUE(nousedmem, smc->tlmkb, smc->tlmkb) :
-		       0.0,
-		       smc->bufkb,
-		       smc->camkb,
-		       smc->comkb,
-		       (smc->tlmkb + smc->tlskb) ?
-		       SP_VALUE(0, smc->comkb, smc->tlmkb + smc->tlskb) :
-		       0.0,
-		       smc->activekb,
-		       smc->inactkb,
-		       smc->dirtykb);
+		jprintf0(0, "\"memfree\": %llu, "
+		            "\"avail\": %llu, "
+		            "\"memused\": %llu, "
+		            "\"memused-percent\": %.2f, "
+		            "\"buffers\": %llu, "
+		            "\"cached\": %llu, "
+		            "\"commit\": %llu, "
+		            "\"commit-percent\": %.2f, "
+		            "\"active\": %llu, "
+		            "\"inactive\": %llu, "
+		            "\"dirty\": %llu",
+		            smc->frmkb,
+		            smc->availablekb,
+		            smc->tlmkb - nousedmem,
+		            smc->tlmkb ?
+		            SP_VALUE(nousedmem, smc->tlmkb, smc->tlmkb) :
+		            0.0,
+		            smc->bufkb,
+		            smc->camkb,
+		            smc->comkb,
+		            (smc->tlmkb + smc->tlskb) ?
+		            SP_VALUE(0, smc->comkb, smc->tlmkb + smc->tlskb) :
+		            0.0,
+		            smc->activekb,
+		            smc->inactkb,
+		            smc->dirtykb);
 
 		if (DISPLAY_MEM_ALL(a->opt_flags)) {
 			/* Display extended memory stats */
-			printf(", \"anonpg\": %llu, "
-			       "\"slab\": %llu, "
-			       "\"kstack\": %llu, "
-			       "\"pgtbl\": %llu, "
-			       "\"vmused\": %llu",
-			       smc->anonpgkb,
-			       smc->slabkb,
-			       smc->kstackkb,
-			       smc->pgtblkb,
-			       smc->vmusedkb);
+			jprintf0(0, ", \"anonpg\": %llu, "
+			            "\"slab\": %llu, "
+			            "\"kstack\": %llu, "
+			            "\"pgtbl\": %llu, "
+			            "\"vmused\": %llu",
+			            smc->anonpgkb,
+			            smc->slabkb,
+			            smc->kstackkb,
+			            smc->pgtblkb,
+			            smc->vmusedkb);
 		}
 	}
 
 	if (DISPLAY_SWAP(a->opt_flags)) {
 
 		if (sep) {
-			printf(", ");
+			jprintf0(0, ", ");
 		}
 		sep = TRUE;
 
-		printf("\"swpfree\": %llu, "
-		       "\"swpused\": %llu, "
-		       "\"swpused-percent\": %.2f, "
-		       "\"swpcad\": %llu, "
-		       "\"swpcad-percent\": %.2f",
-		       smc->frskb,
-		       smc->tlskb - smc->frskb,
-		       smc->tlskb ?
-		       SP_VALUE(smc->frskb, smc->tlskb, smc->tlskb) :
-		       0.0,
-		       smc->caskb,
-		       (smc->tlskb - smc->frskb) ?
-		       SP_VALUE(0, smc->caskb, smc->tlskb - smc->frskb) :
-		       0.0);
+		jprintf0(0, "\"swpfree\": %llu, "
+		            "\"swpused\": %llu, "
+		            "\"swpused-percent\": %.2f, "
+		            "\"swpcad\": %llu, "
+		            "\"swpcad-percent\": %.2f",
+		            smc->frskb,
+		            smc->tlskb - smc->frskb,
+		            smc->tlskb ?
+		            SP_VALUE(smc->frskb, smc->tlskb, smc->tlskb) :
+		            0.0,
+		            smc->caskb,
+		            (smc->tlskb - smc->frskb) ?
+		            SP_VALUE(0, smc->caskb, smc->tlskb - smc->frskb) :
+		            0.0);
 	}
 
-	printf("}");
+	jprintf0(0, "}");
 }
 
 /*
@@ -576,7 +577,7 @@ __print_funct_t json_print_ktables_stats(struct activity *a, int curr, int tab,
 	struct stats_ktables
 		*skc = (struct stats_ktables *) a->buf[curr];
 
-	xprintf0(tab, "\"kernel\": {"
+	jprintf0(tab, "\"kernel\": {"
 		 "\"dentunusd\": %llu, "
 		 "\"file-nr\": %llu, "
 		 "\"inode-nr\": %llu, "
@@ -604,7 +605,7 @@ __print_funct_t json_print_queue_stats(struct activity *a, int curr, int tab,
 	struct stats_queue
 		*sqc = (struct stats_queue *) a->buf[curr];
 
-	xprintf0(tab, "\"queue\": {"
+	jprintf0(tab, "\"queue\": {"
 		 "\"runq-sz\": %llu, "
 		 "\"plist-sz\": %llu, "
 		 "\"ldavg-1\": %.2f, "
@@ -619,6 +620,39 @@ __print_funct_t json_print_queue_stats(struct activity *a, int curr, int tab,
 		 sqc->procs_blocked);
 }
 
+/*
+ ***************************************************************************
+ * Display pressure stall information in JSON.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @tab		Indentation in output.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t json_print_psi_stats(struct activity *a, int curr, int tab,
+				     unsigned long long itv)
+{
+	struct stats_psi
+		*spc = (struct stats_psi *) a->buf[curr],
+		*spp = (struct stats_psi *) a->buf[!curr];
+
+	jprintf0(tab, "\"psi\": {"
+		 "\"scpu\": %.2f, "
+		 "\"fcpu\": %.2f, "
+		 "\"smem\": %.2f, "
+		 "\"fmem\": %.2f, "
+		 "\"sio\": %.2f, "
+		 "\"fio\": %.2f}",
+		 S_VALUE(spp->some_cpu_total, spc->some_cpu_total, itv) / 10000,
+		 S_VALUE(spp->full_cpu_total, spc->full_cpu_total, itv) / 10000,
+		 S_VALUE(spp->some_mem_total, spc->some_mem_total, itv) / 10000,
+		 S_VALUE(spp->full_mem_total, spc->full_mem_total, itv) / 10000,
+		 S_VALUE(spp->some_io_total, spc->some_io_total, itv) / 10000,
+		 S_VALUE(spp->full_io_total, spc->full_io_total, itv) / 10000);
+}
+
 /*
  ***************************************************************************
  * Display serial lines statistics in JSON.
@@ -637,7 +671,7 @@ __print_funct_t json_print_serial_stats(struct activity *a, int curr, int tab,
 	struct stats_serial *ssc, *ssp;
 	int sep = FALSE;
 
-	xprintf(tab++, "\"serial\": [");
+	jprintf(tab++, "\"serial\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -672,11 +706,11 @@ __print_funct_t json_print_serial_stats(struct activity *a, int curr, int tab,
 			continue;
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"line\": %d, "
+		jprintf0(tab, "{\"line\": %d, "
 			 "\"rcvin\": %.2f, "
 			 "\"xmtin\": %.2f, "
 			 "\"framerr\": %.2f, "
@@ -692,8 +726,8 @@ __print_funct_t json_print_serial_stats(struct activity *a, int curr, int tab,
 			 S_VALUE(ssp->overrun, ssc->overrun, itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -718,7 +752,7 @@ __print_funct_t json_print_disk_stats(struct activity *a, int curr, int tab,
 
 	memset(&sdpzero, 0, STATS_DISK_SIZE);
 
-	xprintf(tab++, "\"disk\": [");
+	jprintf(tab++, "\"disk\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -747,11 +781,11 @@ __print_funct_t json_print_disk_stats(struct activity *a, int curr, int tab,
 		compute_ext_disk_stats(sdc, sdp, itv, &xds);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"disk-device\": \"%s\", "
+		jprintf0(tab, "{\"disk-device\": \"%s\", "
 			 "\"tps\": %.2f, "
 			 "\"rd_sec\": %.2f, "
 			 "\"wr_sec\": %.2f, "
@@ -783,8 +817,8 @@ __print_funct_t json_print_disk_stats(struct activity *a, int curr, int tab,
 			 xds.util / 10.0);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -814,7 +848,7 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"net-dev\": [");
+	jprintf(tab++, "\"net-dev\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -837,7 +871,7 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 		}
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
@@ -845,7 +879,7 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 		txkb = S_VALUE(sndp->tx_bytes, sndc->tx_bytes, itv);
 		ifutil = compute_ifutil(sndc, rxkb, txkb);
 
-		xprintf0(tab, "{\"iface\": \"%s\", "
+		jprintf0(tab, "{\"iface\": \"%s\", "
 			 "\"rxpck\": %.2f, "
 			 "\"txpck\": %.2f, "
 			 "\"rxkB\": %.2f, "
@@ -865,8 +899,8 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 			 ifutil);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 
 	tab--;
 
@@ -902,7 +936,7 @@ __print_funct_t json_print_net_edev_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"net-edev\": [");
+	jprintf(tab++, "\"net-edev\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -925,11 +959,11 @@ __print_funct_t json_print_net_edev_stats(struct activity *a, int curr, int tab,
 		}
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"iface\": \"%s\", "
+		jprintf0(tab, "{\"iface\": \"%s\", "
 			 "\"rxerr\": %.2f, "
 			 "\"txerr\": %.2f, "
 			 "\"coll\": %.2f, "
@@ -951,8 +985,8 @@ __print_funct_t json_print_net_edev_stats(struct activity *a, int curr, int tab,
 			 S_VALUE(snedp->tx_fifo_errors,    snedc->tx_fifo_errors,    itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 
 	tab--;
 
@@ -986,7 +1020,7 @@ __print_funct_t json_print_net_nfs_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-nfs\": {"
+	jprintf0(tab, "\"net-nfs\": {"
 		 "\"call\": %.2f, "
 		 "\"retrans\": %.2f, "
 		 "\"read\": %.2f, "
@@ -1031,7 +1065,7 @@ __print_funct_t json_print_net_nfsd_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-nfsd\": {"
+	jprintf0(tab, "\"net-nfsd\": {"
 		 "\"scall\": %.2f, "
 		 "\"badcall\": %.2f, "
 		 "\"packet\": %.2f, "
@@ -1085,7 +1119,7 @@ __print_funct_t json_print_net_sock_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-sock\": {"
+	jprintf0(tab, "\"net-sock\": {"
 		 "\"totsck\": %u, "
 		 "\"tcpsck\": %u, "
 		 "\"udpsck\": %u, "
@@ -1130,7 +1164,7 @@ __print_funct_t json_print_net_ip_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-ip\": {"
+	jprintf0(tab, "\"net-ip\": {"
 		 "\"irec\": %.2f, "
 		 "\"fwddgm\": %.2f, "
 		 "\"idel\": %.2f, "
@@ -1179,7 +1213,7 @@ __print_funct_t json_print_net_eip_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eip\": {"
+	jprintf0(tab, "\"net-eip\": {"
 		 "\"ihdrerr\": %.2f, "
 		 "\"iadrerr\": %.2f, "
 		 "\"iukwnpr\": %.2f, "
@@ -1228,7 +1262,7 @@ __print_funct_t json_print_net_icmp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-icmp\": {"
+	jprintf0(tab, "\"net-icmp\": {"
 		 "\"imsg\": %.2f, "
 		 "\"omsg\": %.2f, "
 		 "\"iech\": %.2f, "
@@ -1289,7 +1323,7 @@ __print_funct_t json_print_net_eicmp_stats(struct activity *a, int curr, int tab
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eicmp\": {"
+	jprintf0(tab, "\"net-eicmp\": {"
 		 "\"ierr\": %.2f, "
 		 "\"oerr\": %.2f, "
 		 "\"idstunr\": %.2f, "
@@ -1346,7 +1380,7 @@ __print_funct_t json_print_net_tcp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-tcp\": {"
+	jprintf0(tab, "\"net-tcp\": {"
 		 "\"active\": %.2f, "
 		 "\"passive\": %.2f, "
 		 "\"iseg\": %.2f, "
@@ -1387,7 +1421,7 @@ __print_funct_t json_print_net_etcp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-etcp\": {"
+	jprintf0(tab, "\"net-etcp\": {"
 		 "\"atmptf\": %.2f, "
 		 "\"estres\": %.2f, "
 		 "\"retrans\": %.2f, "
@@ -1430,7 +1464,7 @@ __print_funct_t json_print_net_udp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-udp\": {"
+	jprintf0(tab, "\"net-udp\": {"
 		 "\"idgm\": %.2f, "
 		 "\"odgm\": %.2f, "
 		 "\"noport\": %.2f, "
@@ -1470,7 +1504,7 @@ __print_funct_t json_print_net_sock6_stats(struct activity *a, int curr, int tab
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-sock6\": {"
+	jprintf0(tab, "\"net-sock6\": {"
 		 "\"tcp6sck\": %u, "
 		 "\"udp6sck\": %u, "
 		 "\"raw6sck\": %u, "
@@ -1511,7 +1545,7 @@ __print_funct_t json_print_net_ip6_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-ip6\": {"
+	jprintf0(tab, "\"net-ip6\": {"
 		 "\"irec6\": %.2f, "
 		 "\"fwddgm6\": %.2f, "
 		 "\"idel6\": %.2f, "
@@ -1564,7 +1598,7 @@ __print_funct_t json_print_net_eip6_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eip6\": {"
+	jprintf0(tab, "\"net-eip6\": {"
 		 "\"ihdrer6\": %.2f, "
 		 "\"iadrer6\": %.2f, "
 		 "\"iukwnp6\": %.2f, "
@@ -1619,7 +1653,7 @@ __print_funct_t json_print_net_icmp6_stats(struct activity *a, int curr, int tab
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-icmp6\": {"
+	jprintf0(tab, "\"net-icmp6\": {"
 		 "\"imsg6\": %.2f, "
 		 "\"omsg6\": %.2f, "
 		 "\"iech6\": %.2f, "
@@ -1686,7 +1720,7 @@ __print_funct_t json_print_net_eicmp6_stats(struct activity *a, int curr, int ta
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eicmp6\": {"
+	jprintf0(tab, "\"net-eicmp6\": {"
 		 "\"ierr6\": %.2f, "
 		 "\"idtunr6\": %.2f, "
 		 "\"odtunr6\": %.2f, "
@@ -1741,7 +1775,7 @@ __print_funct_t json_print_net_udp6_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-udp6\": {"
+	jprintf0(tab, "\"net-udp6\": {"
 		 "\"idgm6\": %.2f, "
 		 "\"odgm6\": %.2f, "
 		 "\"noport6\": %.2f, "
@@ -1783,7 +1817,7 @@ __print_funct_t json_print_pwr_cpufreq_stats(struct activity *a, int curr, int t
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"cpu-frequency\": [");
+	jprintf(tab++, "\"cpu-frequency\": [");
 
 	for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -1803,18 +1837,18 @@ __print_funct_t json_print_pwr_cpufreq_stats(struct activity *a, int curr, int t
 		}
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": \"%s\", "
+		jprintf0(tab, "{\"number\": \"%s\", "
 			 "\"frequency\": %.2f}",
 			 cpuno,
 			 ((double) spc->cpufreq) / 100);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1847,17 +1881,17 @@ __print_funct_t json_print_pwr_fan_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"fan-speed\": [");
+	jprintf(tab++, "\"fan-speed\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		spc = (struct stats_pwr_fan *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": %d, "
+		jprintf0(tab, "{\"number\": %d, "
 			 "\"rpm\": %llu, "
 			 "\"drpm\": %llu, "
 			 "\"device\": \"%s\"}",
@@ -1867,8 +1901,8 @@ __print_funct_t json_print_pwr_fan_stats(struct activity *a, int curr, int tab,
 			 spc->device);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1901,17 +1935,17 @@ __print_funct_t json_print_pwr_temp_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"temperature\": [");
+	jprintf(tab++, "\"temperature\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		spc = (struct stats_pwr_temp *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": %d, "
+		jprintf0(tab, "{\"number\": %d, "
 			 "\"degC\": %.2f, "
 			 "\"percent-temp\": %.2f, "
 			 "\"device\": \"%s\"}",
@@ -1923,8 +1957,8 @@ __print_funct_t json_print_pwr_temp_stats(struct activity *a, int curr, int tab,
 			 spc->device);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1957,17 +1991,17 @@ __print_funct_t json_print_pwr_in_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"voltage-input\": [");
+	jprintf(tab++, "\"voltage-input\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		spc = (struct stats_pwr_in *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": %d, "
+		jprintf0(tab, "{\"number\": %d, "
 			 "\"inV\": %.2f, "
 			 "\"percent-in\": %.2f, "
 			 "\"device\": \"%s\"}",
@@ -1979,8 +2013,8 @@ __print_funct_t json_print_pwr_in_stats(struct activity *a, int curr, int tab,
 			 spc->device);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -2006,7 +2040,7 @@ __print_funct_t json_print_huge_stats(struct activity *a, int curr, int tab,
 	struct stats_huge
 		*smc = (struct stats_huge *) a->buf[curr];
 
-	xprintf0(tab, "\"hugepages\": {"
+	jprintf0(tab, "\"hugepages\": {"
 		 "\"hugfree\": %llu, "
 		 "\"hugused\": %llu, "
 		 "\"hugused-percent\": %.2f, "
@@ -2046,7 +2080,7 @@ __print_funct_t json_print_pwr_wghfreq_stats(struct activity *a, int curr, int t
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"cpu-weighted-frequency\": [");
+	jprintf(tab++, "\"cpu-weighted-frequency\": [");
 
 	for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -2082,18 +2116,18 @@ __print_funct_t json_print_pwr_wghfreq_stats(struct activity *a, int curr, int t
 		}
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": \"%s\", "
+		jprintf0(tab, "{\"number\": \"%s\", "
 			 "\"weighted-frequency\": %.2f}",
 			 cpuno,
 			 tis ? ((double) tisfreq) / tis : 0.0);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -2126,17 +2160,17 @@ __print_funct_t json_print_pwr_usb_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"usb-devices\": [");
+	jprintf(tab++, "\"usb-devices\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		suc = (struct stats_pwr_usb *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"bus_number\": %d, "
+		jprintf0(tab, "{\"bus_number\": %d, "
 			 "\"idvendor\": \"%x\", "
 			 "\"idprod\": \"%x\", "
 			 "\"maxpower\": %u, "
@@ -2150,8 +2184,8 @@ __print_funct_t json_print_pwr_usb_stats(struct activity *a, int curr, int tab,
 			 suc->product);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -2178,7 +2212,7 @@ __print_funct_t json_print_filesystem_stats(struct activity *a, int curr, int ta
 	struct stats_filesystem *sfc;
 	int sep = FALSE;
 
-	xprintf(tab++, "\"filesystems\": [");
+	jprintf(tab++, "\"filesystems\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		sfc = (struct stats_filesystem *) ((char *) a->buf[curr] + i * a->msize);
@@ -2192,18 +2226,19 @@ __print_funct_t json_print_filesystem_stats(struct activity *a, int curr, int ta
 		}
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"%s\": \"%s\", "
+		jprintf0(tab, "{\"%s\": \"%s\", "
 			 "\"MBfsfree\": %.0f, "
 			 "\"MBfsused\": %.0f, "
 			 "\"%%fsused\": %.2f, "
 			 "\"%%ufsused\": %.2f, "
 			 "\"Ifree\": %llu, "
 			 "\"Iused\": %llu, "
-			 "\"%%Iused\": %.2f}",
+			 "\"%%Iused\": %.2f, "
+			 "\"stale\": %u}",
 			 DISPLAY_MOUNT(a->opt_flags) ? "mountpoint" : "filesystem",
 			 DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name,
 			 (double) sfc->f_bfree / 1024 / 1024,
@@ -2215,11 +2250,12 @@ __print_funct_t json_print_filesystem_stats(struct activity *a, int curr, int ta
 			 sfc->f_ffree,
 			 sfc->f_files - sfc->f_ffree,
 			 sfc->f_files ? SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files)
-				    : 0.0);
+				    : 0.0,
+			 sfc->stale);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -2246,7 +2282,7 @@ __print_funct_t json_print_fchost_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"fchosts\": [");
+	jprintf(tab++, "\"fchosts\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -2281,11 +2317,11 @@ __print_funct_t json_print_fchost_stats(struct activity *a, int curr, int tab,
 			continue;
 
 		if (sep)
-			printf(",\n");
+			jprintf0(0, ",\n");
 
 		sep = TRUE;
 
-		xprintf0(tab, "{\"fchost\": \"%s\", "
+		jprintf0(tab, "{\"fchost\": \"%s\", "
 			 "\"fch_rxf\": %.2f, "
 			 "\"fch_txf\": %.2f, "
 			 "\"fch_rxw\": %.2f, "
@@ -2297,8 +2333,8 @@ __print_funct_t json_print_fchost_stats(struct activity *a, int curr, int tab,
 			 S_VALUE(sfcp->f_txwords,  sfcc->f_txwords,  itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 
 	tab --;
 
@@ -2334,7 +2370,7 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"softnet\": [");
+	jprintf(tab++, "\"softnet\": [");
 
 	/* @nr[curr] cannot normally be greater than @nr_ini */
 	if (a->nr[curr] > a->nr_ini) {
@@ -2369,7 +2405,7 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
                 ssnp = (struct stats_softnet *) ((char *) a->buf[!curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		sep = TRUE;
 
@@ -2381,7 +2417,7 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
 			sprintf(cpuno, "%d", i - 1);
 		}
 
-		xprintf0(tab, "{\"cpu\": \"%s\", "
+		jprintf0(tab, "{\"cpu\": \"%s\", "
 			 "\"total\": %.2f, "
 			 "\"dropd\": %.2f, "
 			 "\"squeezd\": %.2f, "
@@ -2395,8 +2431,8 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
 			 S_VALUE(ssnp->flow_limit,   ssnc->flow_limit,   itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 
 	tab --;
 
@@ -2405,3 +2441,142 @@ close_json_markup:
 		json_markup_network(tab, CLOSE_JSON_MARKUP);
 	}
 }
+
+/*
+ ***************************************************************************
+ * Display sadc own collection cost statistics in JSON.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @tab		Indentation in output.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t json_print_self_stats(struct activity *a, int curr, int tab,
+				      unsigned long long itv)
+{
+	int i, j, j0, found;
+	struct stats_self *sscc, *sscp;
+	char *name;
+	int sep = FALSE;
+
+	jprintf(tab++, "\"collection-cost\": [");
+
+	for (i = 0; i < a->nr[curr]; i++) {
+
+		found = FALSE;
+		sscc = (struct stats_self *) ((char *) a->buf[curr] + i * a->msize);
+
+		if ((name = get_activity_name(act, sscc->id)) == NULL)
+			continue;
+
+		if (a->nr[!curr] > 0) {
+			/* Look for corresponding structure in previous iteration */
+			j = i;
+
+			if (j >= a->nr[!curr]) {
+				j = a->nr[!curr] - 1;
+			}
+
+			j0 = j;
+
+			do {
+				sscp = (struct stats_self *) ((char *) a->buf[!curr] + j * a->msize);
+				if (sscc->id == sscp->id) {
+					found = TRUE;
+					break;
+				}
+				if (++j >= a->nr[!curr]) {
+					j = 0;
+				}
+			}
+			while (j != j0);
+		}
+
+		if (!found)
+			continue;
+
+		if (sep)
+			jprintf0(0, ",\n");
+
+		sep = TRUE;
+
+		jprintf0(tab, "{\"activity\": \"%s\", "
+			 "\"rdtime\": %.2f, "
+			 "\"rdcpu\": %.2f, "
+			 "\"cnttime\": %.2f, "
+			 "\"cntcpu\": %.2f}",
+			 name,
+			 E_VALUE(sscp->read_wall, sscc->read_wall, sscp->nr_read, sscc->nr_read),
+			 E_VALUE(sscp->read_cpu,  sscc->read_cpu,  sscp->nr_read, sscc->nr_read),
+			 (double) sscc->count_wall,
+			 (double) sscc->count_cpu);
+	}
+
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
+}
+
+/*
+ ***************************************************************************
+ * Display cgroup statistics in JSON.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @tab		Indentation in output.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t json_print_cgroup_stats(struct activity *a, int curr, int tab,
+					unsigned long long itv)
+{
+	int i;
+	struct stats_cgroup *scgc, *scgp;
+	int sep = FALSE;
+
+	/* Index cgroups from previous sample by name */
+	index_cgroups(a, !curr);
+
+	jprintf(tab++, "\"cgroups\": [");
+
+	for (i = 0; i < a->nr[curr]; i++) {
+
+		scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+		scgp = get_prev_cgroup(a, !curr, scgc);
+
+		if (sep)
+			jprintf0(0, ",\n");
+
+		sep = TRUE;
+
+		jprintf0(tab, "{\"cgroup\": \"%s\", "
+			 "\"usr\": %.2f, "
+			 "\"system\": %.2f, "
+			 "\"cpu\": %.2f, "
+			 "\"thrtl\": %.2f, "
+			 "\"kbmem\": %llu, "
+			 "\"kbanon\": %llu, "
+			 "\"kbfile\": %llu, "
+			 "\"rkB\": %.2f, "
+			 "\"wkB\": %.2f, "
+			 "\"rio\": %.2f, "
+			 "\"wio\": %.2f}",
+			 scgc->cg_name,
+			 S_VALUE(scgp->user_usec,      scgc->user_usec,      itv) / 10000,
+			 S_VALUE(scgp->system_usec,    scgc->system_usec,    itv) / 10000,
+			 S_VALUE(scgp->usage_usec,     scgc->usage_usec,     itv) / 10000,
+			 S_VALUE(scgp->throttled_usec, scgc->throttled_usec, itv) / 10000,
+			 scgc->mem_current / 1024,
+			 scgc->mem_anon / 1024,
+			 scgc->mem_file / 1024,
+			 S_VALUE(scgp->io_rbytes, scgc->io_rbytes, itv) / 1024,
+			 S_VALUE(scgp->io_wbytes, scgc->io_wbytes, itv) / 1024,
+			 S_VALUE(scgp->io_rios,   scgc->io_rios,   itv),
+			 S_VALUE(scgp->io_wios,   scgc->io_wios,   itv));
+	}
+
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
+}
@@ -93,5 +93,11 @@ __print_funct_t json_print_fchost_stats
 	(struct activity *, int, int, unsigned long long);
 __print_funct_t json_print_softnet_stats
 	(struct activity *, int, int, unsigned long long);
+__print_funct_t json_print_self_stats
+	(struct activity *, int, int, unsigned long long);
+__print_funct_t json_print_cgroup_stats
+	(struct activity *, int, int, unsigned long long);
+__print_funct_t json_print_psi_stats
+	(struct activity *, int, int, unsigned long long);
 
 #endif /* _JSON_STATS_H */
@@ -71,6 +71,10 @@ struct stats_irq *st_irq[3];
 struct stats_irqcpu *st_irqcpu[3];
 struct stats_irqcpu *st_softirqcpu[3];
 
+/* /proc/interrupts and /proc/softirqs files, kept open between samples */
+struct src_file interrupts_file = SRC_FILE_INIT(INTERRUPTS);
+struct src_file softirqs_file = SRC_FILE_INIT(SOFTIRQS);
+
 /*
  * Number of CPU per node, e.g.:
  * cpu_per_node[0]: total nr of CPU (this is node "all")
@@ -93,7 +97,8 @@ unsigned int actflags = 0;
 unsigned int flags = 0;
 
 /* Interval and count parameters */
-long interval = -1, count = 0;
+long long interval = -1;
+long count = 0;
 /* Number of decimal places */
 int dplaces_nr = -1;
 
@@ -116,7 +121,7 @@ int irqcpu_nr = 0;
 /* Nb of soft interrupts per processor */
 int softirqcpu_nr = 0;
 
-struct sigaction alrm_act, int_act;
+struct sigaction int_act;
 int sigint_caught = 0;
 
 /*
@@ -135,23 +140,11 @@ void usage(char *progname)
 	fprintf(stderr, _("Options are:\n"
 			  "[ -A ] [ -n ] [ -u ] [ -V ]\n"
 			  "[ -I { SUM | CPU | SCPU | ALL } ] [ -N { <node_list> | ALL } ]\n"
-			  "[ --dec={ 0 | 1 | 2 } ] [ -o JSON ] [ -P { <cpu_list> | ALL } ]\n"));
+			  "[ --dec={ 0 | 1 | 2 } ] [ -o { JSON | JSON-compact } ]\n"
+			  "[ -P { <cpu_list> | ALL } ]\n"));
 	exit(1);
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to reset the handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * SIGINT signal handler.
@@ -655,7 +648,7 @@ void write_json_cpu_stats(int tab, unsigned long long deltot_jiffies, int prev,
 	char cpu_name[16];
 	struct stats_cpu *scc, *scp;
 
-	xprintf(tab++, "\"cpu-load\": [");
+	jprintf(tab++, "\"cpu-load\": [");
 
 	/*
 	 * Now display CPU statistics (including CPU "all"),
@@ -672,7 +665,7 @@ void write_json_cpu_stats(int tab, unsigned long long deltot_jiffies, int prev,
 		scp = st_cpu[prev] + i;
 
 		if (next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		next = TRUE;
 
@@ -693,17 +686,17 @@ void write_json_cpu_stats(int tab, unsigned long long deltot_jiffies, int prev,
 				 * If the CPU is tickless then there is no change in CPU values
 				 * but the sum of values is not zero.
 				 */
-				xprintf0(tab, "{\"cpu\": \"%d\", \"usr\": 0.00, \"nice\": 0.00, "
+				jprintf0(tab, "{\"cpu\": \"%d\", \"usr\": 0.00, \"nice\": 0.00, "
 					 "\"sys\": 0.00, \"iowait\": 0.00, \"irq\": 0.00, "
 					 "\"soft\": 0.00, \"steal\": 0.00, \"guest\": 0.00, "
 					 "\"gnice\": 0.00, \"idle\": 100.00}", i - 1);
-				printf("\n");
+				jprintf0(0, "\n");
 
 				continue;
 			}
 		}
 
-		xprintf0(tab, "{\"cpu\": \"%s\", \"usr\": %.2f, \"nice\": %.2f, \"sys\": %.2f, "
+		jprintf0(tab, "{\"cpu\": \"%s\", \"usr\": %.2f, \"nice\": %.2f, \"sys\": %.2f, "
 			 "\"iowait\": %.2f, \"irq\": %.2f, \"soft\": %.2f, \"steal\": %.2f, "
 			 "\"guest\": %.2f, \"gnice\": %.2f, \"idle\": %.2f}", cpu_name,
 			 (scc->cpu_user - scc->cpu_guest) < (scp->cpu_user - scp->cpu_guest) ?
@@ -734,8 +727,8 @@ void write_json_cpu_stats(int tab, unsigned long long deltot_jiffies, int prev,
 				     scc->cpu_idle, deltot_jiffies));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -774,7 +767,7 @@ void write_cpu_stats(int dis, unsigned long long deltot_jiffies, int prev, int c
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
 		if (*next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		*next = TRUE;
 		write_json_cpu_stats(tab, deltot_jiffies, prev, curr,
@@ -917,7 +910,7 @@ void write_json_node_stats(int tab, unsigned long long deltot_jiffies,
 	int cpu, node, next = FALSE;
 	char node_name[16];
 
-	xprintf(tab++, "\"node-load\": [");
+	jprintf(tab++, "\"node-load\": [");
 
 	for (node = 0; node <= node_nr + 1; node++) {
 
@@ -933,7 +926,7 @@ void write_json_node_stats(int tab, unsigned long long deltot_jiffies,
 			continue;
 
 		if (next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		next = TRUE;
 
@@ -963,7 +956,7 @@ void write_json_node_stats(int tab, unsigned long long deltot_jiffies,
 
 			if (!deltot_jiffies) {
 				/* All CPU in node are tickless and/or offline */
-				xprintf0(tab, "{\"node\": \"%d\", \"usr\": 0.00, \"nice\": 0.00, \"sys\": 0.00, "
+				jprintf0(tab, "{\"node\": \"%d\", \"usr\": 0.00, \"nice\": 0.00, \"sys\": 0.00, "
 			      "\"iowait\": 0.00, \"irq\": 0.00, \"soft\": 0.00, \"steal\": 0.00, "
 			      "\"guest\": 0.00, \"gnice\": 0.00, \"idle\": 100.00}", node - 1);
 
@@ -971,7 +964,7 @@ void write_json_node_stats(int tab, unsigned long long deltot_jiffies,
 			}
 		}
 
-		xprintf0(tab, "{\"node\": \"%s\", \"usr\": %.2f, \"nice\": %.2f, \"sys\": %.2f, "
+		jprintf0(tab, "{\"node\": \"%s\", \"usr\": %.2f, \"nice\": %.2f, \"sys\": %.2f, "
 			      "\"iowait\": %.2f, \"irq\": %.2f, \"soft\": %.2f, \"steal\": %.2f, "
 			      "\"guest\": %.2f, \"gnice\": %.2f, \"idle\": %.2f}", node_name,
 			 (snc->cpu_user - snc->cpu_guest) < (snp->cpu_user - snp->cpu_guest) ?
@@ -1001,8 +994,8 @@ void write_json_node_stats(int tab, unsigned long long deltot_jiffies,
 			 ll_sp_value(snp->cpu_idle,
 				     snc->cpu_idle, deltot_jiffies));
 	}
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -1038,7 +1031,7 @@ void write_node_stats(int dis, unsigned long long deltot_jiffies, int prev, int
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
 		if (*next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		*next = TRUE;
 		write_json_node_stats(tab, deltot_jiffies, prev, curr);
@@ -1149,13 +1142,13 @@ void write_json_isumcpu_stats(int tab, unsigned long long itv, int prev, int cur
 	unsigned long long pc_itv;
 	int cpu, next = FALSE;
 
-	xprintf(tab++, "\"sum-interrupts\": [");
+	jprintf(tab++, "\"sum-interrupts\": [");
 
 	if (*cpu_bitmap & 1) {
 
 		next = TRUE;
 		/* Print total number of interrupts among all cpu */
-		xprintf0(tab, "{\"cpu\": \"all\", \"intr\": %.2f}",
+		jprintf0(tab, "{\"cpu\": \"all\", \"intr\": %.2f}",
 			 S_VALUE(st_irq[prev]->irq_nr, st_irq[curr]->irq_nr, itv));
 	}
 
@@ -1172,7 +1165,7 @@ void write_json_isumcpu_stats(int tab, unsigned long long itv, int prev, int cur
 			continue;
 
 		if (next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		next = TRUE;
 
@@ -1189,18 +1182,18 @@ void write_json_isumcpu_stats(int tab, unsigned long long itv, int prev, int cur
 
 		if (!pc_itv) {
 			/* This is a tickless CPU: Value displayed is 0.00 */
-			xprintf0(tab, "{\"cpu\": \"%d\", \"intr\": 0.00}",
+			jprintf0(tab, "{\"cpu\": \"%d\", \"intr\": 0.00}",
 				 cpu - 1);
 		}
 		else {
 			/* Display total number of interrupts for current CPU */
-			xprintf0(tab, "{\"cpu\": \"%d\", \"intr\": %.2f}",
+			jprintf0(tab, "{\"cpu\": \"%d\", \"intr\": %.2f}",
 				 cpu - 1,
 				 S_VALUE(sip->irq_nr, sic->irq_nr, itv));
 		}
 	}
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -1230,7 +1223,7 @@ void write_isumcpu_stats(int dis, unsigned long long itv, int prev, int curr,
 {
 	if (DISPLAY_JSON_OUTPUT(flags)) {
 		if (*next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		*next = TRUE;
 		write_json_isumcpu_stats(tab, itv, prev, curr);
@@ -1415,10 +1408,10 @@ void write_json_irqcpu_stats(int tab, struct stats_irqcpu *st_ic[], int ic_nr,
 	int nextcpu = FALSE, nextirq;
 
 	if (type == M_D_IRQ_CPU) {
-		xprintf(tab++, "\"individual-interrupts\": [");
+		jprintf(tab++, "\"individual-interrupts\": [");
 	}
 	else {
-		xprintf(tab++, "\"soft-interrupts\": [");
+		jprintf(tab++, "\"soft-interrupts\": [");
 	}
 
 	for (cpu = 1; cpu <= cpu_nr; cpu++) {
@@ -1440,11 +1433,11 @@ void write_json_irqcpu_stats(int tab, struct stats_irqcpu *st_ic[], int ic_nr,
 			continue;
 
 		if (nextcpu) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		nextcpu = TRUE;
 		nextirq = FALSE;
-		xprintf(tab++, "{\"cpu\": \"%d\", \"intr\": [", cpu - 1);
+		jprintf(tab++, "{\"cpu\": \"%d\", \"intr\": [", cpu - 1);
 
 		for (j = 0; j < ic_nr; j++) {
 
@@ -1461,7 +1454,7 @@ void write_json_irqcpu_stats(int tab, struct stats_irqcpu *st_ic[], int ic_nr,
 			offset = j;
 
 			if (nextirq) {
-				printf(",\n");
+				jprintf0(0, ",\n");
 			}
 			nextirq = TRUE;
 
@@ -1484,7 +1477,7 @@ void write_json_irqcpu_stats(int tab, struct stats_irqcpu *st_ic[], int ic_nr,
 
 			if (!strcmp(p0->irq_name, q0->irq_name) || !interval) {
 				q = st_ic[prev] + (cpu - 1) * ic_nr + offset;
-				xprintf0(tab, "{\"name\": \"%s\", \"value\": %.2f}",
+				jprintf0(tab, "{\"name\": \"%s\", \"value\": %.2f}",
 					 p0->irq_name,
 					 S_VALUE(q->interrupt, p->interrupt, itv));
 			}
@@ -1493,16 +1486,16 @@ void write_json_irqcpu_stats(int tab, struct stats_irqcpu *st_ic[], int ic_nr,
 				 * Instead of printing "N/A", assume that previous value
 				 * for this new interrupt was zero.
 				 */
-				xprintf0(tab, "{\"name\": \"%s\", \"value\": %.2f}",
+				jprintf0(tab, "{\"name\": \"%s\", \"value\": %.2f}",
 					 p0->irq_name,
 					 S_VALUE(0, p->interrupt, itv));
 			}
 		}
-		printf("\n");
-		xprintf0(--tab, "] }");
+		jprintf0(0, "\n");
+		jprintf0(--tab, "] }");
 	}
-	printf("\n");
-	xprintf0(--tab, "]");
+	jprintf0(0, "\n");
+	jprintf0(--tab, "]");
 }
 
 /*
@@ -1537,7 +1530,7 @@ void write_irqcpu_stats(struct stats_irqcpu *st_ic[], int ic_nr, int dis,
 {
 	if (DISPLAY_JSON_OUTPUT(flags)) {
 		if (*next) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
 		*next = TRUE;
 		write_json_irqcpu_stats(tab, st_ic, ic_nr, itv, prev, curr, type);
@@ -1583,8 +1576,8 @@ void write_stats_core(int prev, int curr, int dis,
 	deltot_jiffies = get_global_cpu_mpstats(prev, curr, offline_cpu_bitmap);
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		xprintf(tab++, "{");
-		xprintf(tab, "\"timestamp\": \"%s\",", curr_string);
+		jprintf(tab++, "{");
+		jprintf(tab, "\"timestamp\": \"%s\",", curr_string);
 	}
 
 	/* Get time interval */
@@ -1620,8 +1613,8 @@ void write_stats_core(int prev, int curr, int dis,
 	}
 
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		printf("\n");
-		xprintf0(--tab, "}");
+		jprintf0(0, "\n");
+		jprintf0(--tab, "}");
 	}
 }
 
@@ -1680,7 +1673,7 @@ void write_stats(int curr, int dis)
  * Read stats from /proc/interrupts or /proc/softirqs.
  *
  * IN:
- * @file	/proc file to read (interrupts or softirqs).
+ * @sf		/proc file to read (interrupts or softirqs).
  * @ic_nr	Number of interrupts (hard or soft) per CPU.
  * @curr	Position in array where current statistics will be saved.
  *
@@ -1688,9 +1681,9 @@ void write_stats(int curr, int dis)
  * @st_ic	Array for per-CPU interrupts statistics.
  ***************************************************************************
  */
-void read_interrupts_stat(char *file, struct stats_irqcpu *st_ic[], int ic_nr, int curr)
+void read_interrupts_stat(struct src_file *sf, struct stats_irqcpu *st_ic[], int ic_nr, int curr)
 {
-	FILE *fp;
+	const char *pos;
 	struct stats_irq *st_irq_i;
 	struct stats_irqcpu *p;
 	char *line = NULL, *li;
@@ -1705,14 +1698,14 @@ void read_interrupts_stat(char *file, struct stats_irqcpu *st_ic[], int ic_nr, i
 		st_irq_i->irq_nr = 0;
 	}
 
-	if ((fp = fopen(file, "r")) != NULL) {
+	if ((pos = read_src_file(sf)) != NULL) {
 
 		SREALLOC(line, char, INTERRUPTS_LINE + 11 * cpu_nr);
 
 		/*
 		 * Parse header line to see which CPUs are online
 		 */
-		while (fgets(line, INTERRUPTS_LINE + 11 * cpu_nr, fp) != NULL) {
+		while (src_gets(line, INTERRUPTS_LINE + 11 * cpu_nr, &pos) != NULL) {
 			next = line;
 			while (((cp = strstr(next, "CPU")) != NULL) && (index < cpu_nr)) {
 				cpu = strtol(cp + 3, &next, 10);
@@ -1724,7 +1717,7 @@ void read_interrupts_stat(char *file, struct stats_irqcpu *st_ic[], int ic_nr, i
 		}
 
 		/* Parse each line of interrupts statistics data */
-		while ((fgets(line, INTERRUPTS_LINE + 11 * cpu_nr, fp) != NULL) &&
+		while ((src_gets(line, INTERRUPTS_LINE + 11 * cpu_nr, &pos) != NULL) &&
 		       (irq < ic_nr)) {
 
 			/* Skip over "<irq>:" */
@@ -1765,8 +1758,6 @@ void read_interrupts_stat(char *file, struct stats_irqcpu *st_ic[], int ic_nr, i
 			irq++;
 		}
 
-		fclose(fp);
-
 		free(line);
 	}
 
@@ -1793,12 +1784,14 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 	int i;
 	int curr = 1, dis = 1;
 	unsigned long lines = rows;
+	struct sample_timer sample_tm;
 
 	/* Dont buffer data if redirected to a pipe */
 	setbuf(stdout, NULL);
 
 	/* Read system uptime and CPU stats */
 	read_uptime(&(uptime_cs[0]));
+	read_stat_snapshot();
 	read_stat_cpu(st_cpu[0], cpu_nr + 1);
 
 	/*
@@ -1832,6 +1825,7 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 	if (DISPLAY_IRQ_SUM(actflags)) {
 		read_stat_irq(st_irq[0], 1);
 	}
+	release_stat_snapshot();
 
 	/*
 	 * Read number of interrupts received by each CPU, for each interrupt,
@@ -1839,10 +1833,10 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 	 */
 	if (DISPLAY_IRQ_SUM(actflags) || DISPLAY_IRQ_CPU(actflags)) {
 		/* Read this file to display int per CPU or total nr of int per CPU */
-		read_interrupts_stat(INTERRUPTS, st_irqcpu, irqcpu_nr, 0);
+		read_interrupts_stat(&interrupts_file, st_irqcpu, irqcpu_nr, 0);
 	}
 	if (DISPLAY_SOFTIRQS(actflags)) {
-		read_interrupts_stat(SOFTIRQS, st_softirqcpu, softirqcpu_nr, 0);
+		read_interrupts_stat(&softirqs_file, st_softirqcpu, softirqcpu_nr, 0);
 	}
 
 	if (!interval) {
@@ -1857,16 +1851,18 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 		}
 		write_stats(0, DISP_HDR);
 		if (DISPLAY_JSON_OUTPUT(flags)) {
-			printf("\n\t\t\t]\n\t\t}\n\t]\n}}\n");
+			jprintf0(0, "\n");
+			jprintf(3, "]");
+			jprintf(2, "}");
+			jprintf(1, "]");
+			jprintf(0, "}}");
+			jprintf_end();
 		}
 		exit(0);
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Start sampling timer */
+	start_sample_timer(&sample_tm, (unsigned long long) interval);
 
 	/* Save the first stats collected. Will be used to compute the average */
 	mp_tstamp[2] = mp_tstamp[0];
@@ -1885,7 +1881,8 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 	int_act.sa_handler = int_handler;
 	sigaction(SIGINT, &int_act, NULL);
 
-	pause();
+	/* Wait for next sampling time, or until SIGINT is received */
+	while ((wait_sample_timer(&sample_tm) < 0) && !sigint_caught);
 
 	if (sigint_caught)
 		/* SIGINT signal caught during first interval: Exit immediately */
@@ -1905,22 +1902,24 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 
 		/* Read uptime and CPU stats */
 		read_uptime(&(uptime_cs[curr]));
+		read_stat_snapshot();
 		read_stat_cpu(st_cpu[curr], cpu_nr + 1);
 
 		/* Read total number of interrupts received among all CPU */
 		if (DISPLAY_IRQ_SUM(actflags)) {
 			read_stat_irq(st_irq[curr], 1);
 		}
+		release_stat_snapshot();
 
 		/*
 		 * Read number of interrupts received by each CPU, for each interrupt,
 		 * and compute the total number of interrupts received by each CPU.
 		 */
 		if (DISPLAY_IRQ_SUM(actflags) || DISPLAY_IRQ_CPU(actflags)) {
-			read_interrupts_stat(INTERRUPTS, st_irqcpu, irqcpu_nr, curr);
+			read_interrupts_stat(&interrupts_file, st_irqcpu, irqcpu_nr, curr);
 		}
 		if (DISPLAY_SOFTIRQS(actflags)) {
-			read_interrupts_stat(SOFTIRQS, st_softirqcpu, softirqcpu_nr, curr);
+			read_interrupts_stat(&softirqs_file, st_softirqcpu, softirqcpu_nr, curr);
 		}
 
 		/* Write stats */
@@ -1939,7 +1938,7 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 
 		if (count) {
 
-			pause();
+			while ((wait_sample_timer(&sample_tm) < 0) && !sigint_caught);
 
 			if (sigint_caught) {
 				/* SIGINT signal caught => Display average stats */
@@ -1947,7 +1946,7 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 			}
 			else {
 				if (DISPLAY_JSON_OUTPUT(flags)) {
-					printf(",\n");
+					jprintf0(0, ",\n");
 				}
 				curr ^= 1;
 			}
@@ -1957,7 +1956,12 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 
 	/* Write stats average */
 	if (DISPLAY_JSON_OUTPUT(flags)) {
-		printf("\n\t\t\t]\n\t\t}\n\t]\n}}\n");
+		jprintf0(0, "\n");
+		jprintf(3, "]");
+		jprintf(2, "}");
+		jprintf(1, "]");
+		jprintf(0, "}}");
+		jprintf_end();
 	}
 	else {
 		write_stats_avg(curr, dis_hdr);
@@ -2050,6 +2054,10 @@ int main(int argc, char **argv)
 			if (argv[++opt] && !strcmp(argv[opt], K_JSON)) {
 				flags |= F_JSON_OUTPUT;
 			}
+			else if (argv[opt] && !strcmp(argv[opt], K_JSON_COMPACT)) {
+				flags |= F_JSON_OUTPUT;
+				json_compact = TRUE;
+			}
 			else {
 				usage(argv[0]);
 			}
@@ -2127,10 +2135,7 @@ int main(int argc, char **argv)
 
 		else if (interval < 0) {
 			/* Get interval */
-			if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
-				usage(argv[0]);
-			}
-			interval = atol(argv[opt]);
+			interval = parse_interval(argv[opt]);
 			if (interval < 0) {
 				usage(argv[0]);
 			}
@@ -66,13 +66,13 @@ int show_threads = FALSE;
 unsigned int pid_nr = 0;	/* Nb of PID to display */
 int cpu_nr = 0;			/* Nb of processors on the machine */
 unsigned long tlmkb;		/* Total memory in kB */
-long interval = -1;
+long long interval = -1;
 long count = 0;
 unsigned int pidflag = 0;	/* General flags */
 unsigned int tskflag = 0;	/* TASK/CHILD stats */
 unsigned int actflag = 0;	/* Activity flag */
 
-struct sigaction alrm_act, int_act, chld_act;
+struct sigaction int_act, chld_act;
 int signal_caught = 0;
 
 int dplaces_nr = -1;		/* Number of decimal places */
@@ -98,19 +98,6 @@ void usage(char *progname)
 	exit(1);
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to reset the handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * SIGINT and SIGCHLD signals handler.
@@ -2477,6 +2464,7 @@ void rw_pidstat_loop(int dis_hdr, int rows, unsigned int pid_array_nr)
 	int curr = 1, dis = 1;
 	int again;
 	unsigned long lines = rows;
+	struct sample_timer sample_tm;
 
 	/* Don't buffer data if redirected to a pipe */
 	setbuf(stdout, NULL);
@@ -2498,11 +2486,8 @@ void rw_pidstat_loop(int dis_hdr, int rows, unsigned int pid_array_nr)
 		exit(0);
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Start sampling timer */
+	start_sample_timer(&sample_tm, (unsigned long long) interval);
 
 	/* Save the first stats collected. Will be used to compute the average */
 	ps_tstamp[2] = ps_tstamp[0];
@@ -2515,8 +2500,8 @@ void rw_pidstat_loop(int dis_hdr, int rows, unsigned int pid_array_nr)
 	int_act.sa_handler = sig_handler;
 	sigaction(SIGINT, &int_act, NULL);
 
-	/* Wait for SIGALRM (or possibly SIGINT) signal */
-	pause();
+	/* Wait for next sampling time (or possibly SIGINT/SIGCHLD signal) */
+	while ((wait_sample_timer(&sample_tm) < 0) && !signal_caught);
 
 	if (signal_caught)
 		/* SIGINT/SIGCHLD signals caught during first interval: Exit immediately */
@@ -2552,7 +2537,7 @@ void rw_pidstat_loop(int dis_hdr, int rows, unsigned int pid_array_nr)
 
 		if (count) {
 
-			pause();
+			while ((wait_sample_timer(&sample_tm) < 0) && !signal_caught);
 
 			if (signal_caught) {
 				/* SIGINT/SIGCHLD signals caught => Display average stats */
@@ -2870,10 +2855,7 @@ int main(int argc, char **argv)
 		}
 
 		else if (interval < 0) {	/* Get interval */
-			if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
-				usage(argv[0]);
-			}
-			interval = atol(argv[opt++]);
+			interval = parse_interval(argv[opt++]);
 			if (interval < 0) {
 				usage(argv[0]);
 			}
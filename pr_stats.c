@@ -40,6 +40,7 @@ extern unsigned int flags;
 extern int  dish;
 extern char timestamp[][TIMESTAMP_LEN];
 extern unsigned long avg_count;
+extern struct activity *act[];
 
 /*
  ***************************************************************************
@@ -915,6 +916,44 @@ __print_funct_t print_avg_queue_stats(struct activity *a, int prev, int curr,
 	stub_print_queue_stats(a, curr, TRUE);
 }
 
+/*
+ ***************************************************************************
+ * Display pressure stall information. This function is used to display
+ * instantaneous and average statistics.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @prev	Index in array where stats used as reference are.
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t print_psi_stats(struct activity *a, int prev, int curr,
+				unsigned long long itv)
+{
+	struct stats_psi
+		*spc = (struct stats_psi *) a->buf[curr],
+		*spp = (struct stats_psi *) a->buf[prev];
+
+	if (dish) {
+		print_hdr_line(timestamp[!curr], a, FIRST, 0, 9);
+	}
+
+	if (a->nr[curr] <= 0)
+		/* PSI not available */
+		return;
+
+	printf("%-11s", timestamp[curr]);
+	cprintf_pc(DISPLAY_UNIT(flags), 6, 9, 2,
+		   S_VALUE(spp->some_cpu_total, spc->some_cpu_total, itv) / 10000,
+		   S_VALUE(spp->full_cpu_total, spc->full_cpu_total, itv) / 10000,
+		   S_VALUE(spp->some_mem_total, spc->some_mem_total, itv) / 10000,
+		   S_VALUE(spp->full_mem_total, spc->full_mem_total, itv) / 10000,
+		   S_VALUE(spp->some_io_total,  spc->some_io_total,  itv) / 10000,
+		   S_VALUE(spp->full_io_total,  spc->full_io_total,  itv) / 10000);
+	printf("\n");
+}
+
 /*
  ***************************************************************************
  * Display serial lines statistics.
@@ -2794,8 +2833,13 @@ __print_funct_t stub_print_filesystem_stats(struct activity *a, int prev, int cu
 			cprintf_pc(DISPLAY_UNIT(flags), 1, 9, 2,
 				   sfc->f_files ? SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files)
 				   : 0.0);
-			cprintf_in(IS_STR, " %s\n",
+			cprintf_in(IS_STR, " %s",
 				   DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name, 0);
+			if (sfc->stale && !dispavg) {
+				/* Filesystem didn't answer: Values are the last known ones */
+				printf(" %s", _("(stale)"));
+			}
+			printf("\n");
 		}
 
 		if (!dispavg) {
@@ -3016,3 +3060,144 @@ __print_funct_t print_softnet_stats(struct activity *a, int prev, int curr,
 		printf("\n");
 	}
 }
+
+/*
+ ***************************************************************************
+ * Display sadc own collection cost statistics. This function is used to
+ * display instantaneous and average statistics.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @prev	Index in array where stats used as reference are.
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t print_self_stats(struct activity *a, int prev, int curr,
+				 unsigned long long itv)
+{
+	int i, j, j0, found;
+	struct stats_self *sscc, *sscp;
+	char *name;
+
+	if (dish) {
+		print_hdr_line(timestamp[!curr], a, FIRST, -1, 9);
+	}
+
+	for (i = 0; i < a->nr[curr]; i++) {
+		sscc = (struct stats_self *) ((char *) a->buf[curr] + i * a->msize);
+
+		if ((name = get_activity_name(act, sscc->id)) == NULL)
+			/* Activity unknown to this version of sysstat */
+			continue;
+
+		if (WANT_SINCE_BOOT(flags)) {
+			sscp = (struct stats_self *) ((char *) a->buf[prev]);
+			found = TRUE;
+		}
+		else {
+			found = FALSE;
+
+			if (a->nr[prev] > 0) {
+				/* Look for corresponding structure in previous iteration */
+				j = i;
+
+				if (j >= a->nr[prev]) {
+					j = a->nr[prev] - 1;
+				}
+
+				j0 = j;
+
+				do {
+					sscp = (struct stats_self *) ((char *) a->buf[prev] + j * a->msize);
+					if (sscc->id == sscp->id) {
+						found = TRUE;
+						break;
+					}
+
+					if (++j >= a->nr[prev]) {
+						j = 0;
+					}
+				}
+				while (j != j0);
+			}
+		}
+
+		if (!found)
+			continue;
+
+		printf("%-11s", timestamp[curr]);
+		cprintf_f(NO_UNIT, 4, 9, 2,
+			  E_VALUE(sscp->read_wall, sscc->read_wall, sscp->nr_read, sscc->nr_read),
+			  E_VALUE(sscp->read_cpu,  sscc->read_cpu,  sscp->nr_read, sscc->nr_read),
+			  (double) sscc->count_wall,
+			  (double) sscc->count_cpu);
+		cprintf_in(IS_STR, " %s\n", name, 0);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Display cgroup statistics. This function is used to display
+ * instantaneous and average statistics. Memory usage displayed as
+ * average statistics is the last value read.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @prev	Index in array where stats used as reference are.
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t print_cgroup_stats(struct activity *a, int prev, int curr,
+				   unsigned long long itv)
+{
+	int i;
+	struct stats_cgroup *scgc, *scgp, scgzero;
+	int unit = NO_UNIT;
+
+	memset(&scgzero, 0, STATS_CGROUP_SIZE);
+
+	if (DISPLAY_UNIT(flags)) {
+		/* Default values unit is kB */
+		unit = UNIT_KILOBYTE;
+	}
+
+	if (dish) {
+		print_hdr_line(timestamp[!curr], a, FIRST, -1, 9);
+	}
+
+	if (!WANT_SINCE_BOOT(flags)) {
+		/* Index cgroups from previous sample by name */
+		index_cgroups(a, prev);
+	}
+
+	for (i = 0; i < a->nr[curr]; i++) {
+		scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+
+		if (WANT_SINCE_BOOT(flags)) {
+			scgp = &scgzero;
+		}
+		else {
+			scgp = get_prev_cgroup(a, prev, scgc);
+		}
+
+		printf("%-11s", timestamp[curr]);
+		cprintf_pc(DISPLAY_UNIT(flags), 4, 9, 2,
+			   S_VALUE(scgp->user_usec,      scgc->user_usec,      itv) / 10000,
+			   S_VALUE(scgp->system_usec,    scgc->system_usec,    itv) / 10000,
+			   S_VALUE(scgp->usage_usec,     scgc->usage_usec,     itv) / 10000,
+			   S_VALUE(scgp->throttled_usec, scgc->throttled_usec, itv) / 10000);
+		cprintf_u64(unit, 3, 9,
+			    scgc->mem_current / 1024,
+			    scgc->mem_anon / 1024,
+			    scgc->mem_file / 1024);
+		cprintf_f(unit, 2, 9, 2,
+			  S_VALUE(scgp->io_rbytes, scgc->io_rbytes, itv) / 1024,
+			  S_VALUE(scgp->io_wbytes, scgc->io_wbytes, itv) / 1024);
+		cprintf_f(NO_UNIT, 2, 9, 2,
+			  S_VALUE(scgp->io_rios, scgc->io_rios, itv),
+			  S_VALUE(scgp->io_wios, scgc->io_wios, itv));
+		cprintf_in(IS_STR, " %s\n", scgc->cg_name, 0);
+	}
+}
@@ -29,6 +29,7 @@
 #include "raw_stats.h"
 
 extern unsigned int flags;
+extern struct activity *act[];
 
 /*
  ***************************************************************************
@@ -439,6 +440,37 @@ __print_funct_t raw_print_queue_stats(struct activity *a, char *timestr, int cur
 	printf("\n");
 }
 
+/*
+ ***************************************************************************
+ * Display pressure stall information in raw format.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @timestr	Time for current statistics sample.
+ * @curr	Index in array for current sample statistics.
+ ***************************************************************************
+ */
+__print_funct_t raw_print_psi_stats(struct activity *a, char *timestr, int curr)
+{
+	struct stats_psi
+		*spc = (struct stats_psi *) a->buf[curr],
+		*spp = (struct stats_psi *) a->buf[!curr];
+
+	printf("%s; %s", timestr, pfield(a->hdr_line, FIRST));
+	pval(spp->some_cpu_total, spc->some_cpu_total);
+	printf(" %s", pfield(NULL, 0));
+	pval(spp->full_cpu_total, spc->full_cpu_total);
+	printf(" %s", pfield(NULL, 0));
+	pval(spp->some_mem_total, spc->some_mem_total);
+	printf(" %s", pfield(NULL, 0));
+	pval(spp->full_mem_total, spc->full_mem_total);
+	printf(" %s", pfield(NULL, 0));
+	pval(spp->some_io_total, spc->some_io_total);
+	printf(" %s", pfield(NULL, 0));
+	pval(spp->full_io_total, spc->full_io_total);
+	printf("\n");
+}
+
 /*
  ***************************************************************************
  * Display serial lines statistics in raw format.
@@ -1516,7 +1548,10 @@ __print_funct_t raw_print_filesystem_stats(struct activity *a, char *timestr, in
 		pfield(NULL, 0); /* Skip %fsused */
 		pfield(NULL, 0); /* Skip %ufsused */
 		printf(" %s; %llu;", pfield(NULL, 0), sfc->f_ffree);
-		printf(" f_files; %llu;\n", sfc->f_files);
+		printf(" f_files; %llu;", sfc->f_files);
+		pfield(NULL, 0); /* Skip Iused */
+		pfield(NULL, 0); /* Skip %Iused */
+		printf(" %s; %u;\n", pfield(NULL, 0), sfc->stale);
 
 	}
 }
@@ -1650,3 +1685,67 @@ __print_funct_t raw_print_softnet_stats(struct activity *a, char *timestr, int c
 		printf("\n");
 	}
 }
+
+/*
+ ***************************************************************************
+ * Display sadc own collection cost statistics in raw format.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @timestr	Time for current statistics sample.
+ * @curr	Index in array for current sample statistics.
+ ***************************************************************************
+ */
+__print_funct_t raw_print_self_stats(struct activity *a, char *timestr, int curr)
+{
+	int i;
+	struct stats_self *ssc;
+	char *name;
+
+	for (i = 0; i < a->nr[curr]; i++) {
+		ssc = (struct stats_self *) ((char *) a->buf[curr] + i * a->msize);
+
+		if ((name = get_activity_name(act, ssc->id)) == NULL)
+			continue;
+
+		printf("%s; %s; %s;", timestr, pfield(a->hdr_line, FIRST), name);
+		printf(" nr_read; %llu;", ssc->nr_read);
+		printf(" read_wall; %llu;", ssc->read_wall);
+		printf(" read_cpu; %llu;", ssc->read_cpu);
+		printf(" count_wall; %llu;", ssc->count_wall);
+		printf(" count_cpu; %llu;\n", ssc->count_cpu);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Display cgroup statistics in raw format.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @timestr	Time for current statistics sample.
+ * @curr	Index in array for current sample statistics.
+ ***************************************************************************
+ */
+__print_funct_t raw_print_cgroup_stats(struct activity *a, char *timestr, int curr)
+{
+	int i;
+	struct stats_cgroup *scgc;
+
+	for (i = 0; i < a->nr[curr]; i++) {
+		scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+
+		printf("%s; %s; %s;", timestr, pfield(a->hdr_line, FIRST), scgc->cg_name);
+		printf(" usage_usec; %llu;", scgc->usage_usec);
+		printf(" user_usec; %llu;", scgc->user_usec);
+		printf(" system_usec; %llu;", scgc->system_usec);
+		printf(" throttled_usec; %llu;", scgc->throttled_usec);
+		printf(" mem_current; %llu;", scgc->mem_current);
+		printf(" mem_anon; %llu;", scgc->mem_anon);
+		printf(" mem_file; %llu;", scgc->mem_file);
+		printf(" io_rbytes; %llu;", scgc->io_rbytes);
+		printf(" io_wbytes; %llu;", scgc->io_wbytes);
+		printf(" io_rios; %llu;", scgc->io_rios);
+		printf(" io_wios; %llu;\n", scgc->io_wios);
+	}
+}
@@ -92,5 +92,11 @@ __print_funct_t raw_print_fchost_stats
 	(struct activity *, char *, int);
 __print_funct_t raw_print_softnet_stats
 	(struct activity *, char *, int);
+__print_funct_t raw_print_self_stats
+	(struct activity *, char *, int);
+__print_funct_t raw_print_cgroup_stats
+	(struct activity *, char *, int);
+__print_funct_t raw_print_psi_stats
+	(struct activity *, char *, int);
 
 #endif /* _RAW_STATS_H */
@@ -28,7 +28,16 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
 
 #include "common.h"
 #include "rd_stats.h"
@@ -41,6 +50,418 @@
 #define _(string) (string)
 #endif
 
+/*
+ * Statistics files read by the functions below. They are opened once and
+ * kept open between samples: Their contents are then read with pread().
+ */
+#define SRC_STAT		0
+#define SRC_UPTIME		1
+#define SRC_MEMINFO		2
+#define SRC_LOADAVG		3
+#define SRC_VMSTAT		4
+#define SRC_DISKSTATS		5
+#define SRC_SERIAL		6
+#define SRC_FDENTRY_STATE	7
+#define SRC_FFILE_NR		8
+#define SRC_FINODE_STATE	9
+#define SRC_PTY_NR		10
+#define SRC_NET_DEV		11
+#define SRC_NET_RPC_NFS		12
+#define SRC_NET_RPC_NFSD	13
+#define SRC_NET_SOCKSTAT	14
+#define SRC_NET_SNMP		15
+#define SRC_NET_SOCKSTAT6	16
+#define SRC_NET_SNMP6		17
+#define SRC_CPUINFO		18
+#define SRC_MTAB		19
+#define SRC_NET_SOFTNET		20
+#define SRC_PSI_CPU		21
+#define SRC_PSI_MEMORY		22
+#define SRC_PSI_IO		23
+#define NR_SRC			24
+
+/*
+ * Files are opened once per thread, since sadc may read
+ * several activities at the same time.
+ */
+static __thread struct src_file src_files[NR_SRC] = {
+	SRC_FILE_INIT(STAT),
+	SRC_FILE_INIT(UPTIME),
+	SRC_FILE_INIT(MEMINFO),
+	SRC_FILE_INIT(LOADAVG),
+	SRC_FILE_INIT(VMSTAT),
+	SRC_FILE_INIT(DISKSTATS),
+	SRC_FILE_INIT(SERIAL),
+	SRC_FILE_INIT(FDENTRY_STATE),
+	SRC_FILE_INIT(FFILE_NR),
+	SRC_FILE_INIT(FINODE_STATE),
+	SRC_FILE_INIT(PTY_NR),
+	SRC_FILE_INIT(NET_DEV),
+	SRC_FILE_INIT(NET_RPC_NFS),
+	SRC_FILE_INIT(NET_RPC_NFSD),
+	SRC_FILE_INIT(NET_SOCKSTAT),
+	SRC_FILE_INIT(NET_SNMP),
+	SRC_FILE_INIT(NET_SOCKSTAT6),
+	SRC_FILE_INIT(NET_SNMP6),
+	SRC_FILE_INIT(CPUINFO),
+	SRC_FILE_INIT(MTAB),
+	SRC_FILE_INIT(NET_SOFTNET),
+	SRC_FILE_INIT(PSI_CPU),
+	SRC_FILE_INIT(PSI_MEMORY),
+	SRC_FILE_INIT(PSI_IO)
+};
+
+/*
+ * Snapshot of /proc/stat contents. This file is read only once per sample
+ * and then shared by all the functions that decode it. The snapshot is
+ * only taken and released by the main thread (see read_stat_snapshot()):
+ * Worker threads read it but never set it.
+ */
+static char *stat_snap = NULL;
+
+/*
+ ***************************************************************************
+ * Open a statistics file and keep its file descriptor.
+ *
+ * IN:
+ * @sf		Statistics file.
+ *
+ * RETURNS:
+ * 1 on success, 0 otherwise.
+ ***************************************************************************
+ */
+int open_src_file(struct src_file *sf)
+{
+	if (sf->fd < 0) {
+		sf->fd = open(sf->name, O_RDONLY | O_CLOEXEC);
+	}
+
+	return (sf->fd >= 0);
+}
+
+/*
+ ***************************************************************************
+ * Close a statistics file.
+ *
+ * IN:
+ * @sf		Statistics file.
+ ***************************************************************************
+ */
+void close_src_file(struct src_file *sf)
+{
+	if (sf->fd >= 0) {
+		close(sf->fd);
+		sf->fd = -1;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Read the whole contents of a statistics file with pread(). The file is
+ * opened if necessary. It is reopened if its descriptor has become stale
+ * (e.g. file removed then created again).
+ * The buffer is kept allocated between samples and grown on demand.
+ *
+ * IN:
+ * @sf		Statistics file.
+ *
+ * OUT:
+ * @sf		Statistics file with buffer filled.
+ *
+ * RETURNS:
+ * Pointer on buffer (terminated with a null byte), or NULL if the file
+ * couldn't be read.
+ ***************************************************************************
+ */
+char *read_src_file(struct src_file *sf)
+{
+	size_t len = 0;
+	ssize_t n;
+	int reopened = FALSE;
+
+	if (!open_src_file(sf))
+		return NULL;
+
+	if (!sf->size) {
+		sf->size = SRC_BUF_INIT_SIZE;
+		SREALLOC(sf->buf, char, sf->size);
+	}
+
+	do {
+		if (len + 1 >= sf->size) {
+			/* Buffer too small: Double its size */
+			sf->size *= 2;
+			SREALLOC(sf->buf, char, sf->size);
+		}
+		n = pread(sf->fd, sf->buf + len, sf->size - len - 1, (off_t) len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			if (!reopened && !len &&
+			    ((errno == ENOENT) || (errno == ESTALE) || (errno == ENODEV))) {
+				/* Descriptor is stale: Reopen file and try again */
+				close_src_file(sf);
+				reopened = TRUE;
+				if (open_src_file(sf))
+					continue;
+			}
+			return NULL;
+		}
+		len += n;
+	}
+	while (n > 0);
+
+	sf->buf[len] = '\0';
+
+	return sf->buf;
+}
+
+/*
+ ***************************************************************************
+ * Get next line from a buffer containing the contents of a statistics
+ * file. Behaves like fgets(): At most @size - 1 characters are copied,
+ * and the next call resumes where the previous one stopped.
+ *
+ * IN:
+ * @line	Buffer where the line will be saved.
+ * @size	Size of @line buffer.
+ * @pos		Current position in statistics buffer.
+ *
+ * OUT:
+ * @line	Line read from buffer.
+ * @pos		Position of next line in statistics buffer.
+ *
+ * RETURNS:
+ * @line, or NULL if end of buffer has been reached.
+ ***************************************************************************
+ */
+char *src_gets(char *line, size_t size, const char **pos)
+{
+	const char *p = *pos;
+	size_t len = 0;
+
+	if (!*p)
+		return NULL;
+
+	while (*p && (len < size - 1)) {
+		line[len++] = *p;
+		if (*(p++) == '\n')
+			break;
+	}
+	line[len] = '\0';
+	*pos = p;
+
+	return line;
+}
+
+/*
+ ***************************************************************************
+ * Convert a sequence of unsigned decimal numbers separated by white
+ * spaces. This is a lightweight replacement for sscanf("%llu %llu ...")
+ * used to parse the biggest /proc files: No locale handling and no
+ * format string to interpret.
+ * Conversion stops at the first field which is not a number.
+ *
+ * IN:
+ * @str		String containing the numbers.
+ * @n		Maximum number of fields to convert.
+ *
+ * OUT:
+ * @out		Array containing the converted values.
+ * @end		Position in @str following the last converted field.
+ *		May be NULL.
+ *
+ * RETURNS:
+ * Number of fields actually converted.
+ ***************************************************************************
+ */
+int parse_u64_fields(const char *str, int n, unsigned long long out[],
+		     const char **end)
+{
+	const char *p = str;
+	unsigned long long val;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/* Skip heading white spaces */
+		while ((*p == ' ') || ((*p >= '\t') && (*p <= '\r'))) {
+			p++;
+		}
+		if ((*p < '0') || (*p > '9'))
+			break;
+
+		val = 0;
+		do {
+			val = val * 10 + (unsigned long long) (*(p++) - '0');
+		}
+		while ((*p >= '0') && (*p <= '9'));
+
+		out[i] = val;
+	}
+
+	if (end) {
+		*end = p;
+	}
+
+	return i;
+}
+
+/*
+ ***************************************************************************
+ * Copy next white space separated word from a string.
+ *
+ * IN:
+ * @str		String containing the word.
+ * @len		Size of @word buffer.
+ *
+ * OUT:
+ * @word	Word read from @str (truncated to @len - 1 characters).
+ *
+ * RETURNS:
+ * Position in @str following the word, or NULL if no word was found.
+ ***************************************************************************
+ */
+const char *parse_word_field(const char *str, char *word, size_t len)
+{
+	const char *p = str;
+	size_t i = 0;
+
+	while ((*p == ' ') || ((*p >= '\t') && (*p <= '\r'))) {
+		p++;
+	}
+	if (!*p)
+		return NULL;
+
+	while (*p && (*p != ' ') && ((*p < '\t') || (*p > '\r'))) {
+		if (i < len - 1) {
+			word[i++] = *p;
+		}
+		p++;
+	}
+	word[i] = '\0';
+
+	return p;
+}
+
+/*
+ ***************************************************************************
+ * Parse a line from /proc/diskstats.
+ *
+ * IN:
+ * @line	Line to parse.
+ * @len		Size of @dev_name buffer.
+ *
+ * OUT:
+ * @major	Major number of the device.
+ * @minor	Minor number of the device.
+ * @dev_name	Name of the device.
+ * @fields	Statistics following the device name (rd_ios, rd_merges,
+ *		rd_sectors, etc.). Array should have DISKSTATS_FIELDS entries.
+ *
+ * RETURNS:
+ * Number of statistics read after the device name, or -1 if the line
+ * couldn't be parsed.
+ ***************************************************************************
+ */
+int parse_diskstats_line(const char *line, unsigned int *major, unsigned int *minor,
+			 char *dev_name, size_t len, unsigned long long fields[])
+{
+	unsigned long long mm[2];
+	const char *p;
+
+	if (parse_u64_fields(line, 2, mm, &p) < 2)
+		return -1;
+	if ((p = parse_word_field(p, dev_name, len)) == NULL)
+		return -1;
+
+	*major = (unsigned int) mm[0];
+	*minor = (unsigned int) mm[1];
+
+	return parse_u64_fields(p, DISKSTATS_FIELDS, fields, NULL);
+}
+
+/*
+ ***************************************************************************
+ * Open all the statistics files read by functions from this file.
+ * Files that don't exist are ignored: They will be opened (if possible)
+ * when they are actually read.
+ ***************************************************************************
+ */
+void open_src_files(void)
+{
+	int i;
+
+	for (i = 0; i < NR_SRC; i++) {
+		open_src_file(&src_files[i]);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Close all the statistics files opened by open_src_files() and free their
+ * buffers. Must be called by each thread having read statistics files
+ * before it terminates.
+ ***************************************************************************
+ */
+void close_src_files(void)
+{
+	int i;
+
+	for (i = 0; i < NR_SRC; i++) {
+		close_src_file(&src_files[i]);
+		free(src_files[i].buf);
+		src_files[i].buf = NULL;
+		src_files[i].size = 0;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Read the whole contents of /proc/stat into the snapshot buffer.
+ * The snapshot is then used by read_stat_cpu(), read_stat_irq(),
+ * read_stat_pcsw() and read_loadavg() until release_stat_snapshot() is
+ * called. Must be called by the main thread, while no worker threads are
+ * reading activities.
+ *
+ * RETURNS:
+ * 1 on success, 0 otherwise.
+ ***************************************************************************
+ */
+int read_stat_snapshot(void)
+{
+	stat_snap = read_src_file(&src_files[SRC_STAT]);
+
+	return (stat_snap != NULL);
+}
+
+/*
+ ***************************************************************************
+ * Release current /proc/stat snapshot. Next call to a function reading
+ * /proc/stat will read the file again.
+ ***************************************************************************
+ */
+void release_stat_snapshot(void)
+{
+	stat_snap = NULL;
+}
+
+/*
+ ***************************************************************************
+ * Get the contents of /proc/stat: Use current snapshot if one is held,
+ * else read the file into the buffer of current thread.
+ *
+ * RETURNS:
+ * Contents of /proc/stat, or NULL if the file couldn't be read.
+ ***************************************************************************
+ */
+static const char *get_stat_contents(void)
+{
+	if (stat_snap)
+		return stat_snap;
+
+	return read_src_file(&src_files[SRC_STAT]);
+}
+
 /*
  ***************************************************************************
  * Read CPU statistics.
@@ -64,19 +485,20 @@
  */
 __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 {
-	FILE *fp;
 	struct stats_cpu *st_cpu_i;
 	struct stats_cpu sc;
 	char line[8192];
+	const char *pos;
+	unsigned long long val[11];
 	int proc_nr;
 	__nr_t cpu_read = 0;
 
-	if ((fp = fopen(STAT, "r")) == NULL) {
+	if ((pos = get_stat_contents()) == NULL) {
 		fprintf(stderr, _("Cannot open %s: %s\n"), STAT, strerror(errno));
 		exit(2);
 	}
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "cpu ", 4)) {
 
@@ -91,17 +513,18 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 			 * (user, nice, etc.) among all proc. CPU usage is not reduced
 			 * to one processor to avoid rounding problems.
 			 */
-			sscanf(line + 5, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-			       &st_cpu->cpu_user,
-			       &st_cpu->cpu_nice,
-			       &st_cpu->cpu_sys,
-			       &st_cpu->cpu_idle,
-			       &st_cpu->cpu_iowait,
-			       &st_cpu->cpu_hardirq,
-			       &st_cpu->cpu_softirq,
-			       &st_cpu->cpu_steal,
-			       &st_cpu->cpu_guest,
-			       &st_cpu->cpu_guest_nice);
+			memset(val, 0, sizeof(val));
+			parse_u64_fields(line + 5, 10, val, NULL);
+			st_cpu->cpu_user       = val[0];
+			st_cpu->cpu_nice       = val[1];
+			st_cpu->cpu_sys        = val[2];
+			st_cpu->cpu_idle       = val[3];
+			st_cpu->cpu_iowait     = val[4];
+			st_cpu->cpu_hardirq    = val[5];
+			st_cpu->cpu_softirq    = val[6];
+			st_cpu->cpu_steal      = val[7];
+			st_cpu->cpu_guest      = val[8];
+			st_cpu->cpu_guest_nice = val[9];
 
 			if (!cpu_read) {
 				cpu_read = 1;
@@ -114,24 +537,25 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 
 		else if (!strncmp(line, "cpu", 3)) {
 			/* All the fields don't necessarily exist */
-			memset(&sc, 0, STATS_CPU_SIZE);
+			memset(val, 0, sizeof(val));
 			/*
 			 * Read the number of jiffies spent in the different modes
 			 * (user, nice, etc) for current proc.
 			 * This is done only on SMP machines.
 			 */
-			sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-			       &proc_nr,
-			       &sc.cpu_user,
-			       &sc.cpu_nice,
-			       &sc.cpu_sys,
-			       &sc.cpu_idle,
-			       &sc.cpu_iowait,
-			       &sc.cpu_hardirq,
-			       &sc.cpu_softirq,
-			       &sc.cpu_steal,
-			       &sc.cpu_guest,
-			       &sc.cpu_guest_nice);
+			if (parse_u64_fields(line + 3, 11, val, NULL) < 1)
+				continue;
+			proc_nr           = (int) val[0];
+			sc.cpu_user       = val[1];
+			sc.cpu_nice       = val[2];
+			sc.cpu_sys        = val[3];
+			sc.cpu_idle       = val[4];
+			sc.cpu_iowait     = val[5];
+			sc.cpu_hardirq    = val[6];
+			sc.cpu_softirq    = val[7];
+			sc.cpu_steal      = val[8];
+			sc.cpu_guest      = val[9];
+			sc.cpu_guest_nice = val[10];
 
 			if (proc_nr + 2 > nr_alloc) {
 				cpu_read = -1;
@@ -147,7 +571,6 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 		}
 	}
 
-	fclose(fp);
 	return cpu_read;
 }
 
@@ -170,17 +593,17 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
  */
 __nr_t read_stat_irq(struct stats_irq *st_irq, __nr_t nr_alloc)
 {
-	FILE *fp;
 	struct stats_irq *st_irq_i;
 	char line[8192];
+	const char *snap_pos;
 	int i, pos;
 	unsigned long long irq_nr;
 	__nr_t irq_read = 0;
 
-	if ((fp = fopen(STAT, "r")) == NULL)
+	if ((snap_pos = get_stat_contents()) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &snap_pos) != NULL) {
 
 		if (!strncmp(line, "intr ", 5)) {
 			/* Read total number of interrupts received since system boot */
@@ -213,7 +636,6 @@ __nr_t read_stat_irq(struct stats_irq *st_irq, __nr_t nr_alloc)
 		}
 	}
 
-	fclose(fp);
 	return irq_read;
 }
 
@@ -233,13 +655,13 @@ __nr_t read_stat_irq(struct stats_irq *st_irq, __nr_t nr_alloc)
  */
 __nr_t read_meminfo(struct stats_memory *st_memory)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(MEMINFO, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_MEMINFO])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "MemTotal:", 9)) {
 			/* Read the total amount of memory in kB */
@@ -311,7 +733,6 @@ __nr_t read_meminfo(struct stats_memory *st_memory)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -325,15 +746,11 @@ __nr_t read_meminfo(struct stats_memory *st_memory)
  */
 void read_uptime(unsigned long long *uptime)
 {
-	FILE *fp = NULL;
-	char line[128];
+	char *line;
 	unsigned long up_sec, up_cent;
 	int err = FALSE;
 
-	if ((fp = fopen(UPTIME, "r")) == NULL) {
-		err = TRUE;
-	}
-	else if (fgets(line, sizeof(line), fp) == NULL) {
+	if ((line = read_src_file(&src_files[SRC_UPTIME])) == NULL) {
 		err = TRUE;
 	}
 	else if (sscanf(line, "%lu.%lu", &up_sec, &up_cent) == 2) {
@@ -344,9 +761,6 @@ void read_uptime(unsigned long long *uptime)
 		err = TRUE;
 	}
 
-	if (fp != NULL) {
-		fclose(fp);
-	}
 	if (err) {
 		fprintf(stderr, _("Cannot read %s\n"), UPTIME);
 		exit(2);
@@ -509,13 +923,13 @@ void oct2chr(char *str)
  */
 __nr_t read_stat_pcsw(struct stats_pcsw *st_pcsw)
 {
-	FILE *fp;
 	char line[8192];
+	const char *pos;
 
-	if ((fp = fopen(STAT, "r")) == NULL)
+	if ((pos = get_stat_contents()) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "ctxt ", 5)) {
 			/* Read number of context switches */
@@ -528,7 +942,6 @@ __nr_t read_stat_pcsw(struct stats_pcsw *st_pcsw)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -548,24 +961,22 @@ __nr_t read_stat_pcsw(struct stats_pcsw *st_pcsw)
  */
 __nr_t read_loadavg(struct stats_queue *st_queue)
 {
-	FILE *fp;
 	char line[8192];
+	const char *pos;
 	unsigned int load_tmp[3];
 	int rc;
 
-	if ((fp = fopen(LOADAVG, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_LOADAVG])) == NULL)
 		return 0;
 
 	/* Read load averages and queue length */
-	rc = fscanf(fp, "%u.%u %u.%u %u.%u %llu/%llu %*d\n",
+	rc = sscanf(pos, "%u.%u %u.%u %u.%u %llu/%llu %*d\n",
 		    &load_tmp[0], &st_queue->load_avg_1,
 		    &load_tmp[1], &st_queue->load_avg_5,
 		    &load_tmp[2], &st_queue->load_avg_15,
 		    &st_queue->nr_running,
 		    &st_queue->nr_threads);
 
-	fclose(fp);
-
 	if (rc < 8)
 		return 0;
 
@@ -579,10 +990,10 @@ __nr_t read_loadavg(struct stats_queue *st_queue)
 	}
 
 	/* Read nr of tasks blocked from /proc/stat */
-	if ((fp = fopen(STAT, "r")) == NULL)
+	if ((pos = get_stat_contents()) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "procs_blocked ", 14)) {
 			/* Read number of processes blocked */
@@ -591,7 +1002,77 @@ __nr_t read_loadavg(struct stats_queue *st_queue)
 		}
 	}
 
-	fclose(fp);
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Read "some" and "full" total stall times from a pressure file.
+ *
+ * IN:
+ * @sf		Pressure file (/proc/pressure/{cpu,memory,io}).
+ *
+ * OUT:
+ * @some	Total stall time for "some" tasks.
+ * @full	Total stall time for "all" tasks (left unchanged if not
+ *		available, e.g. "full" line for CPU on kernels < 5.13).
+ *
+ * RETURNS:
+ * 1 on success, 0 otherwise.
+ ***************************************************************************
+ */
+static int read_psi_file(struct src_file *sf, unsigned long long *some,
+			 unsigned long long *full)
+{
+	char line[256];
+	const char *pos;
+	char *t;
+
+	if ((pos = read_src_file(sf)) == NULL)
+		return 0;
+
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
+
+		if ((t = strstr(line, "total=")) == NULL)
+			continue;
+
+		if (!strncmp(line, "some ", 5)) {
+			sscanf(t + 6, "%llu", some);
+		}
+		else if (!strncmp(line, "full ", 5)) {
+			sscanf(t + 6, "%llu", full);
+		}
+	}
+
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Read pressure stall information from /proc/pressure.
+ *
+ * IN:
+ * @st_psi	Structure where stats will be saved.
+ *
+ * OUT:
+ * @st_psi	Structure with statistics.
+ *
+ * RETURNS:
+ * 1 on success, 0 otherwise.
+ ***************************************************************************
+ */
+__nr_t read_psi(struct stats_psi *st_psi)
+{
+	if (!read_psi_file(&src_files[SRC_PSI_CPU],
+			   &st_psi->some_cpu_total, &st_psi->full_cpu_total))
+		/* PSI not available (kernel < 4.20, or psi=0 on boot command line) */
+		return 0;
+
+	read_psi_file(&src_files[SRC_PSI_MEMORY],
+		      &st_psi->some_mem_total, &st_psi->full_mem_total);
+	read_psi_file(&src_files[SRC_PSI_IO],
+		      &st_psi->some_io_total, &st_psi->full_io_total);
+
 	return 1;
 }
 
@@ -611,13 +1092,13 @@ __nr_t read_loadavg(struct stats_queue *st_queue)
  */
 __nr_t read_vmstat_swap(struct stats_swap *st_swap)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(VMSTAT, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_VMSTAT])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "pswpin ", 7)) {
 			/* Read number of swap pages brought in */
@@ -629,7 +1110,6 @@ __nr_t read_vmstat_swap(struct stats_swap *st_swap)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -649,17 +1129,17 @@ __nr_t read_vmstat_swap(struct stats_swap *st_swap)
  */
 __nr_t read_vmstat_paging(struct stats_paging *st_paging)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 	unsigned long pgtmp;
 
-	if ((fp = fopen(VMSTAT, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_VMSTAT])) == NULL)
 		return 0;
 
 	st_paging->pgsteal = 0;
 	st_paging->pgscan_kswapd = st_paging->pgscan_direct = 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "pgpgin ", 7)) {
 			/* Read number of pages the system paged in */
@@ -698,7 +1178,6 @@ __nr_t read_vmstat_paging(struct stats_paging *st_paging)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -718,17 +1197,17 @@ __nr_t read_vmstat_paging(struct stats_paging *st_paging)
  */
 __nr_t read_diskstats_io(struct stats_io *st_io)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	char dev_name[MAX_NAME_LEN];
 	unsigned int major, minor;
 	unsigned long rd_ios, wr_ios, dc_ios;
 	unsigned long rd_sec, wr_sec, dc_sec;
 
-	if ((fp = fopen(DISKSTATS, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_DISKSTATS])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		/* Discard I/O stats may be not available */
 		dc_ios = dc_sec = 0;
@@ -762,7 +1241,6 @@ __nr_t read_diskstats_io(struct stats_io *st_io)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -787,33 +1265,43 @@ __nr_t read_diskstats_io(struct stats_io *st_io)
 __nr_t read_diskstats_disk(struct stats_disk *st_disk, __nr_t nr_alloc,
 			   int read_part)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	char dev_name[MAX_NAME_LEN];
 	struct stats_disk *st_disk_i;
 	unsigned int major, minor, rd_ticks, wr_ticks, dc_ticks, tot_ticks, rq_ticks;
 	unsigned long rd_ios, wr_ios, dc_ios, rd_sec, wr_sec, dc_sec;
+	unsigned long long val[DISKSTATS_FIELDS];
+	int nf;
 	__nr_t dsk_read = 0;
 
-	if ((fp = fopen(DISKSTATS, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_DISKSTATS])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		/* Discard I/O stats may be not available */
 		dc_ios = dc_sec = dc_ticks = 0;
 
-		if (sscanf(line,
-			   "%u %u %s "
-			   "%lu %*u %lu %u "
-			   "%lu %*u %lu %u "
-			   "%*u %u %u "
-			   "%lu %*u %lu %u",
-			   &major, &minor, dev_name,
-			   &rd_ios, &rd_sec, &rd_ticks,
-			   &wr_ios, &wr_sec, &wr_ticks,
-			   &tot_ticks, &rq_ticks,
-			   &dc_ios, &dc_sec, &dc_ticks) >= 11) {
+		/*
+		 * Fields are: rd_ios rd_merges rd_sec rd_ticks wr_ios wr_merges wr_sec
+		 * wr_ticks ios_pgr tot_ticks rq_ticks dc_ios dc_merges dc_sec dc_ticks
+		 */
+		nf = parse_diskstats_line(line, &major, &minor, dev_name, sizeof(dev_name), val);
+		if (nf >= 11) {
+			rd_ios    = val[0];
+			rd_sec    = val[2];
+			rd_ticks  = val[3];
+			wr_ios    = val[4];
+			wr_sec    = val[6];
+			wr_ticks  = val[7];
+			tot_ticks = val[9];
+			rq_ticks  = val[10];
+			if (nf >= 15) {
+				dc_ios   = val[11];
+				dc_sec   = val[13];
+				dc_ticks = val[14];
+			}
 
 			if (!rd_ios && !wr_ios && !dc_ios)
 				/* Unused device: Ignore it */
@@ -843,7 +1331,6 @@ __nr_t read_diskstats_disk(struct stats_disk *st_disk, __nr_t nr_alloc,
 		}
 	}
 
-	fclose(fp);
 	return dsk_read;
 }
 
@@ -865,16 +1352,16 @@ __nr_t read_diskstats_disk(struct stats_disk *st_disk, __nr_t nr_alloc,
  */
 __nr_t read_tty_driver_serial(struct stats_serial *st_serial, __nr_t nr_alloc)
 {
-	FILE *fp;
+	const char *pos;
 	struct stats_serial *st_serial_i;
 	char line[256];
 	char *p;
 	__nr_t sl_read = 0;
 
-	if ((fp = fopen(SERIAL, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_SERIAL])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL ) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if ((p = strstr(line, "tx:")) != NULL) {
 
@@ -909,7 +1396,6 @@ __nr_t read_tty_driver_serial(struct stats_serial *st_serial, __nr_t nr_alloc)
 		}
 	}
 
-	fclose(fp);
 	return sl_read;
 }
 
@@ -929,25 +1415,23 @@ __nr_t read_tty_driver_serial(struct stats_serial *st_serial, __nr_t nr_alloc)
  */
 __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 {
-	FILE *fp;
+	char *buf;
 	unsigned long long parm;
 	int rc = 0;
 
-	/* Open /proc/sys/fs/dentry-state file */
-	if ((fp = fopen(FDENTRY_STATE, "r")) != NULL) {
-		rc = fscanf(fp, "%*d %llu",
+	/* Read /proc/sys/fs/dentry-state file */
+	if ((buf = read_src_file(&src_files[SRC_FDENTRY_STATE])) != NULL) {
+		rc = sscanf(buf, "%*d %llu",
 			    &st_ktables->dentry_stat);
-		fclose(fp);
 		if (rc == 0) {
 			st_ktables->dentry_stat = 0;
 		}
 	}
 
-	/* Open /proc/sys/fs/file-nr file */
-	if ((fp = fopen(FFILE_NR, "r")) != NULL) {
-		rc = fscanf(fp, "%llu %llu",
+	/* Read /proc/sys/fs/file-nr file */
+	if ((buf = read_src_file(&src_files[SRC_FFILE_NR])) != NULL) {
+		rc = sscanf(buf, "%llu %llu",
 			    &st_ktables->file_used, &parm);
-		fclose(fp);
 		/*
 		 * The number of used handles is the number of allocated ones
 		 * minus the number of free ones.
@@ -960,11 +1444,10 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 		}
 	}
 
-	/* Open /proc/sys/fs/inode-state file */
-	if ((fp = fopen(FINODE_STATE, "r")) != NULL) {
-		rc = fscanf(fp, "%llu %llu",
+	/* Read /proc/sys/fs/inode-state file */
+	if ((buf = read_src_file(&src_files[SRC_FINODE_STATE])) != NULL) {
+		rc = sscanf(buf, "%llu %llu",
 			    &st_ktables->inode_used, &parm);
-		fclose(fp);
 		/*
 		 * The number of inuse inodes is the number of allocated ones
 		 * minus the number of free ones.
@@ -977,11 +1460,10 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 		}
 	}
 
-	/* Open /proc/sys/kernel/pty/nr file */
-	if ((fp = fopen(PTY_NR, "r")) != NULL) {
-		rc = fscanf(fp, "%llu",
+	/* Read /proc/sys/kernel/pty/nr file */
+	if ((buf = read_src_file(&src_files[SRC_PTY_NR])) != NULL) {
+		rc = sscanf(buf, "%llu",
 			    &st_ktables->pty_nr);
-		fclose(fp);
 		if (rc == 0) {
 			st_ktables->pty_nr = 0;
 		}
@@ -990,9 +1472,393 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 	return 1;
 }
 
+/*
+ * Snapshot of the list of network interfaces with their statistics, as
+ * returned by a RTM_GETLINK netlink dump. It is shared by A_NET_DEV and
+ * A_NET_EDEV activities, and used to count network interfaces.
+ */
+static char *link_snap_buf = NULL;
+static size_t link_snap_size = 0;
+static size_t link_snap_len = 0;
+static int link_snap_held = FALSE;
+static int nl_fd = -1;
+static unsigned int nl_seq = 0;
+
+/*
+ ***************************************************************************
+ * Close netlink socket used to read network interfaces statistics.
+ *
+ * IN:
+ * @unavailable	TRUE if netlink should not be used any more.
+ ***************************************************************************
+ */
+static void close_nl_socket(int unavailable)
+{
+	if (nl_fd >= 0) {
+		close(nl_fd);
+	}
+	nl_fd = unavailable ? NL_UNAVAILABLE : -1;
+}
+
+/*
+ ***************************************************************************
+ * Get the list of network interfaces along with their statistics using
+ * a single RTM_GETLINK netlink dump. The snapshot is then used by
+ * read_net_dev() and read_net_edev() until release_link_snapshot() is
+ * called.
+ *
+ * RETURNS:
+ * Number of network interfaces found, or -1 if netlink couldn't be used
+ * (in this case statistics are read from /proc/net/dev).
+ ***************************************************************************
+ */
+__nr_t read_link_snapshot(void)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct ifinfomsg ifm;
+	} req;
+	struct nlmsghdr *nlh;
+	ssize_t n;
+	int len, done = FALSE;
+	__nr_t if_nr = 0;
+
+	if (nl_fd == NL_UNAVAILABLE)
+		return -1;
+
+	if (nl_fd < 0) {
+		if ((nl_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+			/* Netlink not available: Use /proc/net/dev instead */
+			close_nl_socket(TRUE);
+			return -1;
+		}
+	}
+
+	memset(&req, 0, sizeof(req));
+	req.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+	req.nlh.nlmsg_type = RTM_GETLINK;
+	req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	req.nlh.nlmsg_seq = ++nl_seq;
+	req.ifm.ifi_family = AF_UNSPEC;
+
+	if (send(nl_fd, &req, req.nlh.nlmsg_len, 0) < 0) {
+		close_nl_socket(errno != EINTR);
+		return -1;
+	}
+
+	link_snap_len = 0;
+	while (!done) {
+		if (link_snap_size - link_snap_len < NL_RECV_SIZE) {
+			link_snap_size = link_snap_len + 2 * NL_RECV_SIZE;
+			SREALLOC(link_snap_buf, char, link_snap_size);
+		}
+
+		n = recv(nl_fd, link_snap_buf + link_snap_len, NL_RECV_SIZE, 0);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (!n)
+			break;
+
+		len = (int) n;
+		for (nlh = (struct nlmsghdr *) (link_snap_buf + link_snap_len);
+		     NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+
+			if (nlh->nlmsg_seq != nl_seq)
+				continue;
+
+			if (nlh->nlmsg_type == NLMSG_DONE) {
+				done = TRUE;
+				break;
+			}
+			if (nlh->nlmsg_type == NLMSG_ERROR) {
+				n = -1;
+				break;
+			}
+			if (nlh->nlmsg_type == RTM_NEWLINK) {
+				if_nr++;
+			}
+		}
+		if (n < 0)
+			break;
+
+		link_snap_len += n;
+	}
+
+	if (!done) {
+		/*
+		 * Dump failed: Close the socket so that no stale messages
+		 * are read next time.
+		 */
+		link_snap_len = 0;
+		close_nl_socket(FALSE);
+		return -1;
+	}
+
+	link_snap_held = TRUE;
+
+	return if_nr;
+}
+
+/*
+ ***************************************************************************
+ * Release current network interfaces snapshot.
+ ***************************************************************************
+ */
+void release_link_snapshot(void)
+{
+	link_snap_held = FALSE;
+}
+
+/*
+ ***************************************************************************
+ * Get next network interface from netlink snapshot.
+ *
+ * IN:
+ * @pos		Current position in snapshot buffer.
+ *
+ * OUT:
+ * @pos		Position of next message in snapshot buffer.
+ * @iface	Name of the network interface.
+ * @st		Statistics for the network interface.
+ * @if_flags	Interface flags (IFF_UP, etc.)
+ *
+ * RETURNS:
+ * 1 if a network interface has been found, 0 if end of snapshot has been
+ * reached.
+ ***************************************************************************
+ */
+static int next_link_snapshot(size_t *pos, char *iface, struct rtnl_link_stats64 *st,
+			      unsigned int *if_flags)
+{
+	struct nlmsghdr *nlh;
+	struct ifinfomsg *ifm;
+	struct rtattr *rta;
+	struct rtnl_link_stats st32;
+	int len, stats_found;
+
+	while (*pos + NLMSG_HDRLEN <= link_snap_len) {
+		nlh = (struct nlmsghdr *) (link_snap_buf + *pos);
+		if ((nlh->nlmsg_len < NLMSG_HDRLEN) || (*pos + nlh->nlmsg_len > link_snap_len))
+			break;
+		*pos += NLMSG_ALIGN(nlh->nlmsg_len);
+
+		if ((nlh->nlmsg_type != RTM_NEWLINK) || (nlh->nlmsg_seq != nl_seq) ||
+		    (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifinfomsg))))
+			continue;
+
+		ifm = (struct ifinfomsg *) NLMSG_DATA(nlh);
+		*if_flags = ifm->ifi_flags;
+		iface[0] = '\0';
+		stats_found = 0;
+		memset(st, 0, sizeof(struct rtnl_link_stats64));
+
+		len = IFLA_PAYLOAD(nlh);
+		for (rta = IFLA_RTA(ifm); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+
+			switch (rta->rta_type) {
+
+			case IFLA_IFNAME:
+				strncpy(iface, (char *) RTA_DATA(rta),
+					MINIMUM(RTA_PAYLOAD(rta), MAX_IFACE_LEN - 1));
+				iface[MINIMUM(RTA_PAYLOAD(rta), MAX_IFACE_LEN - 1)] = '\0';
+				break;
+
+			case IFLA_STATS64:
+				/* Attribute may not be aligned on 8 bytes: Copy it */
+				memcpy(st, RTA_DATA(rta),
+				       MINIMUM(RTA_PAYLOAD(rta), sizeof(struct rtnl_link_stats64)));
+				stats_found = 2;
+				break;
+
+			case IFLA_STATS:
+				if (stats_found)
+					/* 64-bit stats already found */
+					break;
+				memset(&st32, 0, sizeof(st32));
+				memcpy(&st32, RTA_DATA(rta),
+				       MINIMUM(RTA_PAYLOAD(rta), sizeof(struct rtnl_link_stats)));
+				st->rx_packets	      = st32.rx_packets;
+				st->tx_packets	      = st32.tx_packets;
+				st->rx_bytes	      = st32.rx_bytes;
+				st->tx_bytes	      = st32.tx_bytes;
+				st->rx_errors	      = st32.rx_errors;
+				st->tx_errors	      = st32.tx_errors;
+				st->rx_dropped	      = st32.rx_dropped;
+				st->tx_dropped	      = st32.tx_dropped;
+				st->multicast	      = st32.multicast;
+				st->collisions	      = st32.collisions;
+				st->rx_length_errors  = st32.rx_length_errors;
+				st->rx_over_errors    = st32.rx_over_errors;
+				st->rx_crc_errors     = st32.rx_crc_errors;
+				st->rx_frame_errors   = st32.rx_frame_errors;
+				st->rx_fifo_errors    = st32.rx_fifo_errors;
+				st->rx_missed_errors  = st32.rx_missed_errors;
+				st->tx_aborted_errors = st32.tx_aborted_errors;
+				st->tx_carrier_errors = st32.tx_carrier_errors;
+				st->tx_fifo_errors    = st32.tx_fifo_errors;
+				st->tx_heartbeat_errors = st32.tx_heartbeat_errors;
+				st->tx_window_errors  = st32.tx_window_errors;
+				st->rx_compressed     = st32.rx_compressed;
+				st->tx_compressed     = st32.tx_compressed;
+				stats_found = 1;
+				break;
+			}
+		}
+
+		if (iface[0] && stats_found)
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Read duplex and speed data for a network interface card using the
+ * SIOCETHTOOL ioctl. This replaces reading the two corresponding sysfs
+ * files when statistics are read using netlink.
+ *
+ * IN:
+ * @st_net_dev_i	Structure where stats will be saved.
+ *
+ * OUT:
+ * @st_net_dev_i	Structure with duplex and speed data.
+ ***************************************************************************
+ */
+static void read_if_link_settings(struct stats_net_dev *st_net_dev_i)
+{
+	struct ifreq ifr;
+	struct ethtool_cmd ecmd;
+
+	memset(&ifr, 0, sizeof(ifr));
+	memset(&ecmd, 0, sizeof(ecmd));
+	ecmd.cmd = ETHTOOL_GSET;
+	strncpy(ifr.ifr_name, st_net_dev_i->interface, IFNAMSIZ - 1);
+	ifr.ifr_data = (void *) &ecmd;
+
+	if (ioctl(nl_fd, SIOCETHTOOL, &ifr) < 0)
+		/* Cannot read NIC duplex */
+		return;
+
+	if (ecmd.duplex == DUPLEX_FULL) {
+		st_net_dev_i->duplex = C_DUPLEX_FULL;
+	}
+	else if (ecmd.duplex == DUPLEX_HALF) {
+		st_net_dev_i->duplex = C_DUPLEX_HALF;
+	}
+	else
+		return;
+
+	st_net_dev_i->speed = ethtool_cmd_speed(&ecmd);
+}
+
 /*
  ***************************************************************************
- * Read network interfaces statistics from /proc/net/dev.
+ * Read network interfaces statistics from netlink snapshot.
+ * Counters are computed the same way as in /proc/net/dev.
+ *
+ * IN:
+ * @st_net_dev	Structure where stats will be saved.
+ * @nr_alloc	Total number of structures allocated. Value is >= 1.
+ *
+ * OUT:
+ * @st_net_dev	Structure with statistics.
+ *
+ * RETURNS:
+ * Number of interfaces read, or -1 if the buffer was too small and
+ * needs to be reallocated.
+ ***************************************************************************
+ */
+static __nr_t read_net_dev_nl(struct stats_net_dev *st_net_dev, __nr_t nr_alloc)
+{
+	struct stats_net_dev *st_net_dev_i;
+	struct rtnl_link_stats64 st;
+	char iface[MAX_IFACE_LEN];
+	unsigned int if_flags;
+	size_t pos = 0;
+	__nr_t dev_read = 0;
+
+	while (next_link_snapshot(&pos, iface, &st, &if_flags)) {
+
+		if (dev_read + 1 > nr_alloc)
+			return -1;
+
+		st_net_dev_i = st_net_dev + dev_read++;
+		strcpy(st_net_dev_i->interface, iface);
+		st_net_dev_i->rx_bytes      = st.rx_bytes;
+		st_net_dev_i->rx_packets    = st.rx_packets;
+		st_net_dev_i->rx_compressed = st.rx_compressed;
+		st_net_dev_i->multicast     = st.multicast;
+		st_net_dev_i->tx_bytes      = st.tx_bytes;
+		st_net_dev_i->tx_packets    = st.tx_packets;
+		st_net_dev_i->tx_compressed = st.tx_compressed;
+
+		/* Duplex and speed are available only if interface is up */
+		if (if_flags & IFF_UP) {
+			read_if_link_settings(st_net_dev_i);
+		}
+	}
+
+	return dev_read;
+}
+
+/*
+ ***************************************************************************
+ * Read network interfaces errors statistics from netlink snapshot.
+ * Counters are computed the same way as in /proc/net/dev.
+ *
+ * IN:
+ * @st_net_edev	Structure where stats will be saved.
+ * @nr_alloc	Total number of structures allocated. Value is >= 1.
+ *
+ * OUT:
+ * @st_net_edev	Structure with statistics.
+ *
+ * RETURNS:
+ * Number of interfaces read, or -1 if the buffer was too small and
+ * needs to be reallocated.
+ ***************************************************************************
+ */
+static __nr_t read_net_edev_nl(struct stats_net_edev *st_net_edev, __nr_t nr_alloc)
+{
+	struct stats_net_edev *st_net_edev_i;
+	struct rtnl_link_stats64 st;
+	char iface[MAX_IFACE_LEN];
+	unsigned int if_flags;
+	size_t pos = 0;
+	__nr_t dev_read = 0;
+
+	while (next_link_snapshot(&pos, iface, &st, &if_flags)) {
+
+		if (dev_read + 1 > nr_alloc)
+			return -1;
+
+		st_net_edev_i = st_net_edev + dev_read++;
+		strcpy(st_net_edev_i->interface, iface);
+		st_net_edev_i->rx_errors         = st.rx_errors;
+		st_net_edev_i->rx_dropped        = st.rx_dropped + st.rx_missed_errors;
+		st_net_edev_i->rx_fifo_errors    = st.rx_fifo_errors;
+		st_net_edev_i->rx_frame_errors   = st.rx_length_errors + st.rx_over_errors +
+						   st.rx_crc_errors + st.rx_frame_errors;
+		st_net_edev_i->tx_errors         = st.tx_errors;
+		st_net_edev_i->tx_dropped        = st.tx_dropped;
+		st_net_edev_i->tx_fifo_errors    = st.tx_fifo_errors;
+		st_net_edev_i->collisions        = st.collisions;
+		st_net_edev_i->tx_carrier_errors = st.tx_carrier_errors + st.tx_aborted_errors +
+						   st.tx_window_errors + st.tx_heartbeat_errors;
+	}
+
+	return dev_read;
+}
+
+/*
+ ***************************************************************************
+ * Read network interfaces statistics, including duplex and speed data.
+ * Statistics are read using netlink, or from /proc/net/dev if netlink is
+ * not available.
  *
  * IN:
  * @st_net_dev	Structure where stats will be saved.
@@ -1008,17 +1874,27 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
  */
 __nr_t read_net_dev(struct stats_net_dev *st_net_dev, __nr_t nr_alloc)
 {
-	FILE *fp;
+	const char *src_pos;
 	struct stats_net_dev *st_net_dev_i;
 	char line[256];
 	char iface[MAX_IFACE_LEN];
+	unsigned long long val[NET_DEV_FIELDS];
 	__nr_t dev_read = 0;
-	int pos;
+	int pos, held = link_snap_held;
 
-	if ((fp = fopen(NET_DEV, "r")) == NULL)
+	/* Use netlink if possible */
+	if (held || (read_link_snapshot() >= 0)) {
+		dev_read = read_net_dev_nl(st_net_dev, nr_alloc);
+		if (!held) {
+			release_link_snapshot();
+		}
+		return dev_read;
+	}
+
+	if ((src_pos = read_src_file(&src_files[SRC_NET_DEV])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &src_pos) != NULL) {
 
 		pos = strcspn(line, ":");
 		if (pos < strlen(line)) {
@@ -1032,19 +1908,23 @@ __nr_t read_net_dev(struct stats_net_dev *st_net_dev, __nr_t nr_alloc)
 			strncpy(iface, line, MINIMUM(pos, MAX_IFACE_LEN - 1));
 			iface[MINIMUM(pos, MAX_IFACE_LEN - 1)] = '\0';
 			sscanf(iface, "%s", st_net_dev_i->interface); /* Skip heading spaces */
-			sscanf(line + pos + 1, "%llu %llu %*u %*u %*u %*u %llu %llu %llu %llu "
-			       "%*u %*u %*u %*u %*u %llu",
-			       &st_net_dev_i->rx_bytes,
-			       &st_net_dev_i->rx_packets,
-			       &st_net_dev_i->rx_compressed,
-			       &st_net_dev_i->multicast,
-			       &st_net_dev_i->tx_bytes,
-			       &st_net_dev_i->tx_packets,
-			       &st_net_dev_i->tx_compressed);
+			memset(val, 0, sizeof(val));
+			parse_u64_fields(line + pos + 1, NET_DEV_FIELDS, val, NULL);
+			st_net_dev_i->rx_bytes      = val[0];
+			st_net_dev_i->rx_packets    = val[1];
+			st_net_dev_i->rx_compressed = val[6];
+			st_net_dev_i->multicast     = val[7];
+			st_net_dev_i->tx_bytes      = val[8];
+			st_net_dev_i->tx_packets    = val[9];
+			st_net_dev_i->tx_compressed = val[15];
 		}
 	}
 
-	fclose(fp);
+	if (dev_read > 0) {
+		/* Read duplex and speed info for each interface */
+		read_if_info(st_net_dev, dev_read);
+	}
+
 	return dev_read;
 }
 
@@ -1115,7 +1995,8 @@ void read_if_info(struct stats_net_dev *st_net_dev, int nbr)
 
 /*
  ***************************************************************************
- * Read network interfaces errors statistics from /proc/net/dev.
+ * Read network interfaces errors statistics using netlink, or from
+ * /proc/net/dev if netlink is not available.
  *
  * IN:
  * @st_net_edev	Structure where stats will be saved.
@@ -1131,17 +2012,27 @@ void read_if_info(struct stats_net_dev *st_net_dev, int nbr)
  */
 __nr_t read_net_edev(struct stats_net_edev *st_net_edev, __nr_t nr_alloc)
 {
-	FILE *fp;
+	const char *src_pos;
 	struct stats_net_edev *st_net_edev_i;
 	static char line[256];
 	char iface[MAX_IFACE_LEN];
+	unsigned long long val[NET_DEV_FIELDS];
 	__nr_t dev_read = 0;
-	int pos;
+	int pos, held = link_snap_held;
 
-	if ((fp = fopen(NET_DEV, "r")) == NULL)
+	/* Use netlink if possible */
+	if (held || (read_link_snapshot() >= 0)) {
+		dev_read = read_net_edev_nl(st_net_edev, nr_alloc);
+		if (!held) {
+			release_link_snapshot();
+		}
+		return dev_read;
+	}
+
+	if ((src_pos = read_src_file(&src_files[SRC_NET_DEV])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &src_pos) != NULL) {
 
 		pos = strcspn(line, ":");
 		if (pos < strlen(line)) {
@@ -1155,21 +2046,20 @@ __nr_t read_net_edev(struct stats_net_edev *st_net_edev, __nr_t nr_alloc)
 			strncpy(iface, line, MINIMUM(pos, MAX_IFACE_LEN - 1));
 			iface[MINIMUM(pos, MAX_IFACE_LEN - 1)] = '\0';
 			sscanf(iface, "%s", st_net_edev_i->interface); /* Skip heading spaces */
-			sscanf(line + pos + 1, "%*u %*u %llu %llu %llu %llu %*u %*u %*u %*u "
-			       "%llu %llu %llu %llu %llu",
-			       &st_net_edev_i->rx_errors,
-			       &st_net_edev_i->rx_dropped,
-			       &st_net_edev_i->rx_fifo_errors,
-			       &st_net_edev_i->rx_frame_errors,
-			       &st_net_edev_i->tx_errors,
-			       &st_net_edev_i->tx_dropped,
-			       &st_net_edev_i->tx_fifo_errors,
-			       &st_net_edev_i->collisions,
-			       &st_net_edev_i->tx_carrier_errors);
+			memset(val, 0, sizeof(val));
+			parse_u64_fields(line + pos + 1, NET_DEV_FIELDS, val, NULL);
+			st_net_edev_i->rx_errors         = val[2];
+			st_net_edev_i->rx_dropped        = val[3];
+			st_net_edev_i->rx_fifo_errors    = val[4];
+			st_net_edev_i->rx_frame_errors   = val[5];
+			st_net_edev_i->tx_errors         = val[10];
+			st_net_edev_i->tx_dropped        = val[11];
+			st_net_edev_i->tx_fifo_errors    = val[12];
+			st_net_edev_i->collisions        = val[13];
+			st_net_edev_i->tx_carrier_errors = val[14];
 		}
 	}
 
-	fclose(fp);
 	return dev_read;
 }
 
@@ -1189,16 +2079,16 @@ __nr_t read_net_edev(struct stats_net_edev *st_net_edev, __nr_t nr_alloc)
  */
 __nr_t read_net_nfs(struct stats_net_nfs *st_net_nfs)
 {
-	FILE *fp;
+	const char *pos;
 	char line[256];
 	unsigned int getattcnt = 0, accesscnt = 0, readcnt = 0, writecnt = 0;
 
-	if ((fp = fopen(NET_RPC_NFS, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_RPC_NFS])) == NULL)
 		return 0;
 
 	memset(st_net_nfs, 0, STATS_NET_NFS_SIZE);
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "rpc ", 4)) {
 			sscanf(line + 4, "%u %u",
@@ -1225,7 +2115,6 @@ __nr_t read_net_nfs(struct stats_net_nfs *st_net_nfs)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1245,16 +2134,16 @@ __nr_t read_net_nfs(struct stats_net_nfs *st_net_nfs)
  */
 __nr_t read_net_nfsd(struct stats_net_nfsd *st_net_nfsd)
 {
-	FILE *fp;
+	const char *pos;
 	char line[256];
 	unsigned int getattcnt = 0, accesscnt = 0, readcnt = 0, writecnt = 0;
 
-	if ((fp = fopen(NET_RPC_NFSD, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_RPC_NFSD])) == NULL)
 		return 0;
 
 	memset(st_net_nfsd, 0, STATS_NET_NFSD_SIZE);
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "rc ", 3)) {
 			sscanf(line + 3, "%u %u",
@@ -1293,7 +2182,6 @@ __nr_t read_net_nfsd(struct stats_net_nfsd *st_net_nfsd)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1313,14 +2201,14 @@ __nr_t read_net_nfsd(struct stats_net_nfsd *st_net_nfsd)
  */
 __nr_t read_net_sock(struct stats_net_sock *st_net_sock)
 {
-	FILE *fp;
+	const char *pos;
 	char line[96];
 	char *p;
 
-	if ((fp = fopen(NET_SOCKSTAT, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SOCKSTAT])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "sockets:", 8)) {
 			/* Sockets */
@@ -1347,7 +2235,6 @@ __nr_t read_net_sock(struct stats_net_sock *st_net_sock)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1367,14 +2254,14 @@ __nr_t read_net_sock(struct stats_net_sock *st_net_sock)
  */
 __nr_t read_net_ip(struct stats_net_ip *st_net_ip)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Ip:", 3)) {
 			if (sw) {
@@ -1397,7 +2284,6 @@ __nr_t read_net_ip(struct stats_net_ip *st_net_ip)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1417,14 +2303,14 @@ __nr_t read_net_ip(struct stats_net_ip *st_net_ip)
  */
 __nr_t read_net_eip(struct stats_net_eip *st_net_eip)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Ip:", 3)) {
 			if (sw) {
@@ -1447,7 +2333,6 @@ __nr_t read_net_eip(struct stats_net_eip *st_net_eip)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1467,15 +2352,15 @@ __nr_t read_net_eip(struct stats_net_eip *st_net_eip)
  */
 __nr_t read_net_icmp(struct stats_net_icmp *st_net_icmp)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	static char format[256] = "";
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Icmp:", 5)) {
 			if (sw) {
@@ -1523,7 +2408,6 @@ __nr_t read_net_icmp(struct stats_net_icmp *st_net_icmp)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1543,14 +2427,14 @@ __nr_t read_net_icmp(struct stats_net_icmp *st_net_icmp)
  */
 __nr_t read_net_eicmp(struct stats_net_eicmp *st_net_eicmp)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Icmp:", 5)) {
 			if (sw) {
@@ -1577,7 +2461,6 @@ __nr_t read_net_eicmp(struct stats_net_eicmp *st_net_eicmp)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1597,14 +2480,14 @@ __nr_t read_net_eicmp(struct stats_net_eicmp *st_net_eicmp)
  */
 __nr_t read_net_tcp(struct stats_net_tcp *st_net_tcp)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Tcp:", 4)) {
 			if (sw) {
@@ -1623,7 +2506,6 @@ __nr_t read_net_tcp(struct stats_net_tcp *st_net_tcp)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1643,14 +2525,14 @@ __nr_t read_net_tcp(struct stats_net_tcp *st_net_tcp)
  */
 __nr_t read_net_etcp(struct stats_net_etcp *st_net_etcp)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Tcp:", 4)) {
 			if (sw) {
@@ -1670,7 +2552,6 @@ __nr_t read_net_etcp(struct stats_net_etcp *st_net_etcp)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1690,14 +2571,14 @@ __nr_t read_net_etcp(struct stats_net_etcp *st_net_etcp)
  */
 __nr_t read_net_udp(struct stats_net_udp *st_net_udp)
 {
-	FILE *fp;
+	const char *pos;
 	char line[1024];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Udp:", 4)) {
 			if (sw) {
@@ -1715,7 +2596,6 @@ __nr_t read_net_udp(struct stats_net_udp *st_net_udp)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1735,13 +2615,13 @@ __nr_t read_net_udp(struct stats_net_udp *st_net_udp)
  */
 __nr_t read_net_sock6(struct stats_net_sock6 *st_net_sock6)
 {
-	FILE *fp;
+	const char *pos;
 	char line[96];
 
-	if ((fp = fopen(NET_SOCKSTAT6, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SOCKSTAT6])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "TCP6:", 5)) {
 			/* TCPv6 sockets */
@@ -1761,7 +2641,6 @@ __nr_t read_net_sock6(struct stats_net_sock6 *st_net_sock6)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1781,13 +2660,13 @@ __nr_t read_net_sock6(struct stats_net_sock6 *st_net_sock6)
  */
 __nr_t read_net_ip6(struct stats_net_ip6 *st_net_ip6)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP6])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Ip6InReceives ", 14)) {
 			sscanf(line + 14, "%llu", &st_net_ip6->InReceives6);
@@ -1821,7 +2700,6 @@ __nr_t read_net_ip6(struct stats_net_ip6 *st_net_ip6)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1841,13 +2719,13 @@ __nr_t read_net_ip6(struct stats_net_ip6 *st_net_ip6)
  */
 __nr_t read_net_eip6(struct stats_net_eip6 *st_net_eip6)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP6])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Ip6InHdrErrors ", 15)) {
 			sscanf(line + 15, "%llu", &st_net_eip6->InHdrErrors6);
@@ -1884,7 +2762,6 @@ __nr_t read_net_eip6(struct stats_net_eip6 *st_net_eip6)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1904,13 +2781,13 @@ __nr_t read_net_eip6(struct stats_net_eip6 *st_net_eip6)
  */
 __nr_t read_net_icmp6(struct stats_net_icmp6 *st_net_icmp6)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP6])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Icmp6InMsgs ", 12)) {
 			sscanf(line + 12, "%lu", &st_net_icmp6->InMsgs6);
@@ -1965,7 +2842,6 @@ __nr_t read_net_icmp6(struct stats_net_icmp6 *st_net_icmp6)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -1985,13 +2861,13 @@ __nr_t read_net_icmp6(struct stats_net_icmp6 *st_net_icmp6)
  */
 __nr_t read_net_eicmp6(struct stats_net_eicmp6 *st_net_eicmp6)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP6])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Icmp6InErrors ", 14)) {
 			sscanf(line + 14, "%lu", &st_net_eicmp6->InErrors6);
@@ -2028,7 +2904,6 @@ __nr_t read_net_eicmp6(struct stats_net_eicmp6 *st_net_eicmp6)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -2048,13 +2923,13 @@ __nr_t read_net_eicmp6(struct stats_net_eicmp6 *st_net_eicmp6)
  */
 __nr_t read_net_udp6(struct stats_net_udp6 *st_net_udp6)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_NET_SNMP6])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "Udp6InDatagrams ", 16)) {
 			sscanf(line + 16, "%lu", &st_net_udp6->InDatagrams6);
@@ -2070,7 +2945,6 @@ __nr_t read_net_udp6(struct stats_net_udp6 *st_net_udp6)
 		}
 	}
 
-	fclose(fp);
 	return 1;
 }
 
@@ -2093,19 +2967,19 @@ __nr_t read_net_udp6(struct stats_net_udp6 *st_net_udp6)
  */
 __nr_t read_cpuinfo(struct stats_pwr_cpufreq *st_pwr_cpufreq, __nr_t nr_alloc)
 {
-	FILE *fp;
+	const char *pos;
 	struct stats_pwr_cpufreq *st_pwr_cpufreq_i;
 	char line[1024];
 	int nr = 0;
 	__nr_t cpu_read = 1;	/* For CPU "all" */
 	unsigned int proc_nr = 0, ifreq, dfreq;
 
-	if ((fp = fopen(CPUINFO, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_CPUINFO])) == NULL)
 		return 0;
 
 	st_pwr_cpufreq->cpufreq = 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "processor\t", 10)) {
 			sscanf(strchr(line, ':') + 1, "%u", &proc_nr);
@@ -2135,7 +3009,6 @@ __nr_t read_cpuinfo(struct stats_pwr_cpufreq *st_pwr_cpufreq, __nr_t nr_alloc)
 		}
 	}
 
-	fclose(fp);
 
 	if (nr) {
 		/* Compute average CPU frequency for this machine */
@@ -2160,14 +3033,14 @@ __nr_t read_cpuinfo(struct stats_pwr_cpufreq *st_pwr_cpufreq, __nr_t nr_alloc)
  */
 __nr_t read_meminfo_huge(struct stats_huge *st_huge)
 {
-	FILE *fp;
+	const char *pos;
 	char line[128];
 	unsigned long szhkb = 0;
 
-	if ((fp = fopen(MEMINFO, "r")) == NULL)
+	if ((pos = read_src_file(&src_files[SRC_MEMINFO])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &pos) != NULL) {
 
 		if (!strncmp(line, "HugePages_Total:", 16)) {
 			/* Read the total number of huge pages */
@@ -2191,7 +3064,6 @@ __nr_t read_meminfo_huge(struct stats_huge *st_huge)
 		}
 	}
 
-	fclose(fp);
 
 	/* We want huge pages stats in kB and not expressed in a number of pages */
 	st_huge->tlhkb *= szhkb;
@@ -2445,6 +3317,350 @@ __nr_t read_bus_usb_dev(struct stats_pwr_usb *st_pwr_usb, __nr_t nr_alloc)
 	return usb_read;
 }
 
+/*
+ * State of the mount points statvfs() has been called on.
+ * statvfs() is called by a helper thread so that a hung filesystem (eg.
+ * an unreachable NFS server) cannot block sadc. If it doesn't answer in
+ * time, the helper thread is left blocked in statvfs() and the mount
+ * point is marked stale until the call finally returns. A new helper
+ * thread is then started for the next mount points.
+ * Mount points are found with a hash index. Those which are no longer
+ * mounted are removed from the list once no statvfs() call is pending on
+ * them.
+ */
+struct fs_mount {
+	char mountp[256];
+	struct statvfs buf;
+	/* TRUE if buf contains the result of a successful statvfs() call */
+	int valid;
+	/* TRUE while statvfs() is in progress */
+	int pending;
+	/* TRUE if mount point has been used since the list was last pruned */
+	int used;
+};
+
+struct fs_helper {
+	/* Mount point to call statvfs() on, or NULL if none */
+	struct fs_mount *req;
+	/* TRUE if helper thread should exit once current request is done */
+	int abandoned;
+	pthread_cond_t req_cond;
+};
+
+static pthread_mutex_t fs_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t fs_done_cond = PTHREAD_COND_INITIALIZER;
+static struct fs_mount **fs_mounts = NULL;
+static int fs_mounts_nr = 0;
+static struct fs_helper *fs_helper = NULL;
+/* Hash index of fs_mounts[] (0 for a free slot, or position + 1) */
+static int *fs_index = NULL;
+static unsigned int fs_index_sz = 0;
+
+/*
+ ***************************************************************************
+ * Main function of the thread calling statvfs() on behalf of
+ * statvfs_timeout().
+ *
+ * IN:
+ * @arg		Helper thread structure.
+ ***************************************************************************
+ */
+static void *fs_helper_main(void *arg)
+{
+	struct fs_helper *fh = (struct fs_helper *) arg;
+	struct fs_mount *fm;
+	struct statvfs buf;
+	int rc;
+
+	pthread_mutex_lock(&fs_lock);
+
+	while (!fh->abandoned) {
+		if ((fm = fh->req) == NULL) {
+			pthread_cond_wait(&fh->req_cond, &fs_lock);
+			continue;
+		}
+
+		/* Mount point name doesn't change while request is pending */
+		pthread_mutex_unlock(&fs_lock);
+		rc = statvfs(fm->mountp, &buf);
+		pthread_mutex_lock(&fs_lock);
+
+		fm->valid = (rc == 0);
+		if (fm->valid) {
+			fm->buf = buf;
+		}
+		fm->pending = FALSE;
+		fh->req = NULL;
+		pthread_cond_broadcast(&fs_done_cond);
+	}
+
+	pthread_mutex_unlock(&fs_lock);
+
+	pthread_cond_destroy(&fh->req_cond);
+	free(fh);
+
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Start a new statvfs() helper thread. Signals are blocked in this thread.
+ * Must be called with fs_lock held.
+ *
+ * RETURNS:
+ * 0 on success, -1 if the thread couldn't be created.
+ ***************************************************************************
+ */
+static int start_fs_helper(void)
+{
+	pthread_t tid;
+	pthread_attr_t attr;
+	sigset_t set, old_set;
+	int rc;
+
+	if ((fs_helper = (struct fs_helper *) calloc(1, sizeof(struct fs_helper))) == NULL)
+		return -1;
+	pthread_cond_init(&fs_helper->req_cond, NULL);
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	sigfillset(&set);
+	pthread_sigmask(SIG_BLOCK, &set, &old_set);
+	rc = pthread_create(&tid, &attr, fs_helper_main, fs_helper);
+	pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+
+	pthread_attr_destroy(&attr);
+
+	if (rc) {
+		pthread_cond_destroy(&fs_helper->req_cond);
+		free(fs_helper);
+		fs_helper = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Compute hash value of a mount point name (FNV-1a).
+ *
+ * IN:
+ * @mountp	Mount point.
+ *
+ * RETURNS:
+ * Hash value.
+ ***************************************************************************
+ */
+static unsigned int hash_mountp(const char *mountp)
+{
+	unsigned int h = 2166136261U;
+
+	while (*mountp) {
+		h ^= (unsigned char) *(mountp++);
+		h *= 16777619U;
+	}
+
+	return h;
+}
+
+/*
+ ***************************************************************************
+ * Build the hash index of the list of mount points. Must be called with
+ * fs_lock held.
+ *
+ * RETURNS:
+ * 0 on success, -1 if the index couldn't be allocated.
+ ***************************************************************************
+ */
+static int index_fs_mounts(void)
+{
+	unsigned int sz = 16, h;
+	int *idx, i;
+
+	while (sz < 2 * (unsigned int) fs_mounts_nr) {
+		sz <<= 1;
+	}
+	if (sz > fs_index_sz) {
+		if ((idx = (int *) realloc(fs_index, sz * sizeof(int))) == NULL)
+			return -1;
+		fs_index = idx;
+		fs_index_sz = sz;
+	}
+	memset(fs_index, 0, fs_index_sz * sizeof(int));
+
+	for (i = 0; i < fs_mounts_nr; i++) {
+		/* Linear probing */
+		for (h = hash_mountp(fs_mounts[i]->mountp) & (fs_index_sz - 1);
+		     fs_index[h];
+		     h = (h + 1) & (fs_index_sz - 1));
+		fs_index[h] = i + 1;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Find the state of a mount point, or create it if it doesn't exist yet.
+ * Must be called with fs_lock held.
+ *
+ * IN:
+ * @mountp	Mount point.
+ *
+ * RETURNS:
+ * Pointer on mount point state, or NULL if it couldn't be allocated.
+ ***************************************************************************
+ */
+static struct fs_mount *get_fs_mount(const char *mountp)
+{
+	struct fs_mount *fm, **fms;
+	unsigned int h;
+
+	if (fs_index_sz) {
+		for (h = hash_mountp(mountp) & (fs_index_sz - 1);
+		     fs_index[h];
+		     h = (h + 1) & (fs_index_sz - 1)) {
+
+			fm = fs_mounts[fs_index[h] - 1];
+			if (!strcmp(fm->mountp, mountp)) {
+				fm->used = TRUE;
+				return fm;
+			}
+		}
+	}
+
+	if ((fms = (struct fs_mount **) realloc(fs_mounts,
+						sizeof(struct fs_mount *) * (fs_mounts_nr + 1))) == NULL)
+		return NULL;
+	fs_mounts = fms;
+
+	if ((fm = (struct fs_mount *) calloc(1, sizeof(struct fs_mount))) == NULL)
+		return NULL;
+	strncpy(fm->mountp, mountp, sizeof(fm->mountp) - 1);
+	fm->used = TRUE;
+	fs_mounts[fs_mounts_nr++] = fm;
+
+	if (index_fs_mounts() < 0) {
+		/* Mount point cannot be found again: Forget it */
+		fs_mounts_nr--;
+		free(fm);
+		return NULL;
+	}
+
+	return fm;
+}
+
+/*
+ ***************************************************************************
+ * Remove from the list the mount points which have not been used since
+ * the list was last pruned (they are no longer mounted), unless a
+ * statvfs() call is still pending on them.
+ ***************************************************************************
+ */
+static void prune_fs_mounts(void)
+{
+	int i, j;
+
+	pthread_mutex_lock(&fs_lock);
+
+	for (i = j = 0; i < fs_mounts_nr; i++) {
+		if (!fs_mounts[i]->used && !fs_mounts[i]->pending) {
+			free(fs_mounts[i]);
+			continue;
+		}
+		fs_mounts[i]->used = FALSE;
+		fs_mounts[j++] = fs_mounts[i];
+	}
+
+	if (j < fs_mounts_nr) {
+		fs_mounts_nr = j;
+		/* Index cannot be bigger than before: This won't fail */
+		index_fs_mounts();
+	}
+
+	pthread_mutex_unlock(&fs_lock);
+}
+
+/*
+ ***************************************************************************
+ * Call statvfs() on a mount point, giving up if it doesn't answer within
+ * STATVFS_TIMEOUT milliseconds. A mount point which didn't answer in time
+ * is stale: No new statvfs() call is made on it until the previous one
+ * has returned, and the last values known for it are returned instead.
+ *
+ * IN:
+ * @mountp	Mount point.
+ *
+ * OUT:
+ * @buf		Filesystem statistics.
+ * @stale	TRUE if @buf contains the last values known for a stale
+ *		mount point.
+ *
+ * RETURNS:
+ * 0 if @buf has been filled, -1 otherwise.
+ ***************************************************************************
+ */
+int statvfs_timeout(const char *mountp, struct statvfs *buf, int *stale)
+{
+	struct fs_mount *fm;
+	struct timespec deadline;
+	int rc = 0;
+
+	*stale = FALSE;
+
+	pthread_mutex_lock(&fs_lock);
+
+	if ((fm = get_fs_mount(mountp)) == NULL)
+		goto sync_call;
+
+	if (!fm->pending) {
+		if (!fs_helper && (start_fs_helper() < 0))
+			goto sync_call;
+
+		fm->pending = TRUE;
+		fs_helper->req = fm;
+		pthread_cond_signal(&fs_helper->req_cond);
+
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		TS_ADD_USEC(deadline, STATVFS_TIMEOUT * 1000ULL);
+
+		while (fm->pending && (rc != ETIMEDOUT)) {
+			rc = pthread_cond_timedwait(&fs_done_cond, &fs_lock, &deadline);
+		}
+
+		if (!fm->pending) {
+			rc = fm->valid ? 0 : -1;
+			if (!rc) {
+				*buf = fm->buf;
+			}
+			pthread_mutex_unlock(&fs_lock);
+			return rc;
+		}
+
+		/*
+		 * Timeout: Leave the helper thread blocked in statvfs().
+		 * It will exit once the call has returned.
+		 */
+		fs_helper->abandoned = TRUE;
+		fs_helper = NULL;
+	}
+
+	/* Stale mount point: Use last known values if any */
+	*stale = TRUE;
+	rc = fm->valid ? 0 : -1;
+	if (!rc) {
+		*buf = fm->buf;
+	}
+	pthread_mutex_unlock(&fs_lock);
+	return rc;
+
+sync_call:
+	pthread_mutex_unlock(&fs_lock);
+	return statvfs(mountp, buf) < 0 ? -1 : 0;
+}
+
 /*
  ***************************************************************************
  * Read filesystems statistics.
@@ -2463,18 +3679,19 @@ __nr_t read_bus_usb_dev(struct stats_pwr_usb *st_pwr_usb, __nr_t nr_alloc)
  */
 __nr_t read_filesystem(struct stats_filesystem *st_filesystem, __nr_t nr_alloc)
 {
-	FILE *fp;
+	const char *src_pos;
 	char line[512], fs_name[MAX_FS_LEN], mountp[256], type[128];
 	int skip = 0, skip_next = 0;
 	char *pos = 0, *pos2 = 0;
 	__nr_t fs_read = 0;
+	int stale;
 	struct stats_filesystem *st_filesystem_i;
 	struct statvfs buf;
 
-	if ((fp = fopen(MTAB, "r")) == NULL)
+	if ((src_pos = read_src_file(&src_files[SRC_MTAB])) == NULL)
 		return 0;
 
-	while (fgets(line, sizeof(line), fp) != NULL) {
+	while (src_gets(line, sizeof(line), &src_pos) != NULL) {
 		/*
 		 * Ignore line if the preceding line did not contain '\n'.
 		 * (Some very long lines may be found for instance when
@@ -2524,7 +3741,7 @@ __nr_t read_filesystem(struct stats_filesystem *st_filesystem, __nr_t nr_alloc)
 			 * It's important to have read the whole mount point name
 			 * for statvfs() to work properly (see above).
 			 */
-			if ((statvfs(mountp, &buf) < 0) || (!buf.f_blocks))
+			if ((statvfs_timeout(mountp, &buf, &stale) < 0) || (!buf.f_blocks))
 				continue;
 
 			if (fs_read + 1 > nr_alloc) {
@@ -2538,6 +3755,7 @@ __nr_t read_filesystem(struct stats_filesystem *st_filesystem, __nr_t nr_alloc)
 			st_filesystem_i->f_bavail = (unsigned long long) buf.f_bavail * (unsigned long long) buf.f_frsize;
 			st_filesystem_i->f_files  = (unsigned long long) buf.f_files;
 			st_filesystem_i->f_ffree  = (unsigned long long) buf.f_ffree;
+			st_filesystem_i->stale    = stale;
 			strncpy(st_filesystem_i->fs_name, fs_name, MAX_FS_LEN);
 			st_filesystem_i->fs_name[MAX_FS_LEN - 1] = '\0';
 			strncpy(st_filesystem_i->mountp, mountp, MAX_FS_LEN);
@@ -2545,7 +3763,11 @@ __nr_t read_filesystem(struct stats_filesystem *st_filesystem, __nr_t nr_alloc)
 		}
 	}
 
-	fclose(fp);
+	if (fs_read >= 0) {
+		/* The whole list of mount points has been read */
+		prune_fs_mounts();
+	}
+
 	return fs_read;
 }
 
@@ -2644,6 +3866,245 @@ __nr_t read_fchost(struct stats_fchost *st_fc, __nr_t nr_alloc)
 	return fch_read;
 }
 
+/*
+ ***************************************************************************
+ * Get the mount point of the cgroup v2 hierarchy. This is /sys/fs/cgroup
+ * on systems using the unified hierarchy, or /sys/fs/cgroup/unified on
+ * systems using the hybrid one.
+ *
+ * RETURNS:
+ * Mount point of the cgroup v2 hierarchy, or NULL if not found.
+ ***************************************************************************
+ */
+char *get_cgroup_root(void)
+{
+	char filename[MAX_PF_NAME];
+
+	snprintf(filename, MAX_PF_NAME, CG_CONTROLLERS, SYSFS_CGROUP);
+	if (!access(filename, F_OK))
+		return SYSFS_CGROUP;
+
+	snprintf(filename, MAX_PF_NAME, CG_CONTROLLERS, SYSFS_CGROUP_HYBRID);
+	if (!access(filename, F_OK))
+		return SYSFS_CGROUP_HYBRID;
+
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Read the contents of a file located in a cgroup directory.
+ *
+ * IN:
+ * @dfd		File descriptor of cgroup directory.
+ * @name	Name of the file to read.
+ * @buf		Buffer where file contents will be saved.
+ * @size	Size of @buf.
+ *
+ * RETURNS:
+ * @buf (terminated with a null byte), or NULL if the file doesn't exist
+ * or couldn't be read (e.g. controller not enabled for this cgroup).
+ ***************************************************************************
+ */
+static char *read_cgroup_file(int dfd, const char *name, char *buf, size_t size)
+{
+	int fd;
+	ssize_t n;
+	size_t len = 0;
+
+	if ((fd = openat(dfd, name, O_RDONLY | O_CLOEXEC)) < 0)
+		return NULL;
+
+	while ((len < size - 1) &&
+	       ((n = read(fd, buf + len, size - len - 1)) != 0)) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			close(fd);
+			return NULL;
+		}
+		len += n;
+	}
+	close(fd);
+	buf[len] = '\0';
+
+	return buf;
+}
+
+/*
+ ***************************************************************************
+ * Read statistics of a cgroup from the files located in its directory.
+ *
+ * IN:
+ * @dfd		File descriptor of cgroup directory.
+ * @st_cg_i	Structure where stats will be saved.
+ *
+ * OUT:
+ * @st_cg_i	Structure with statistics.
+ ***************************************************************************
+ */
+static void read_cgroup_stats(int dfd, struct stats_cgroup *st_cg_i)
+{
+	char buf[4096], line[256];
+	const char *pos;
+	unsigned long long rbytes, wbytes, rios, wios;
+
+	if ((pos = read_cgroup_file(dfd, CG_CPU_STAT, buf, sizeof(buf))) != NULL) {
+		while (src_gets(line, sizeof(line), &pos) != NULL) {
+			if (!strncmp(line, "usage_usec ", 11)) {
+				sscanf(line + 11, "%llu", &st_cg_i->usage_usec);
+			}
+			else if (!strncmp(line, "user_usec ", 10)) {
+				sscanf(line + 10, "%llu", &st_cg_i->user_usec);
+			}
+			else if (!strncmp(line, "system_usec ", 12)) {
+				sscanf(line + 12, "%llu", &st_cg_i->system_usec);
+			}
+			else if (!strncmp(line, "throttled_usec ", 15)) {
+				sscanf(line + 15, "%llu", &st_cg_i->throttled_usec);
+			}
+		}
+	}
+
+	if (read_cgroup_file(dfd, CG_MEM_CURRENT, buf, sizeof(buf)) != NULL) {
+		sscanf(buf, "%llu", &st_cg_i->mem_current);
+	}
+
+	if ((pos = read_cgroup_file(dfd, CG_MEM_STAT, buf, sizeof(buf))) != NULL) {
+		while (src_gets(line, sizeof(line), &pos) != NULL) {
+			if (!strncmp(line, "anon ", 5)) {
+				sscanf(line + 5, "%llu", &st_cg_i->mem_anon);
+			}
+			else if (!strncmp(line, "file ", 5)) {
+				sscanf(line + 5, "%llu", &st_cg_i->mem_file);
+			}
+		}
+	}
+
+	/* Structure may contain values from a previous attempt to read stats */
+	st_cg_i->io_rbytes = st_cg_i->io_wbytes = 0;
+	st_cg_i->io_rios = st_cg_i->io_wios = 0;
+
+	if ((pos = read_cgroup_file(dfd, CG_IO_STAT, buf, sizeof(buf))) != NULL) {
+		/* One line per device, e.g. "8:0 rbytes=.. wbytes=.. rios=.. wios=.. ..." */
+		while (src_gets(line, sizeof(line), &pos) != NULL) {
+			if (sscanf(line, "%*u:%*u rbytes=%llu wbytes=%llu rios=%llu wios=%llu",
+				   &rbytes, &wbytes, &rios, &wios) == 4) {
+				st_cg_i->io_rbytes += rbytes;
+				st_cg_i->io_wbytes += wbytes;
+				st_cg_i->io_rios   += rios;
+				st_cg_i->io_wios   += wios;
+			}
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Read statistics of the cgroups located below a given cgroup directory,
+ * walking the hierarchy recursively.
+ *
+ * IN:
+ * @dfd		File descriptor of cgroup directory. Closed on return.
+ * @path	Path of the cgroup relative to the mount point of the
+ *		hierarchy (empty string for the root cgroup).
+ * @depth	Depth of the cgroup in the hierarchy.
+ * @st_cg	Structure where stats will be saved.
+ * @nr_alloc	Total number of structures allocated. Value is >= 0.
+ * @cg_read	Number of cgroups already read.
+ *
+ * OUT:
+ * @st_cg	Structure with statistics.
+ *
+ * RETURNS:
+ * Number of cgroups read (including those already read), or -1 if the
+ * buffer was too small and needs to be reallocated.
+ ***************************************************************************
+ */
+static __nr_t read_cgroup_dir(int dfd, char *path, int depth,
+			      struct stats_cgroup *st_cg, __nr_t nr_alloc, __nr_t cg_read)
+{
+	DIR *dir;
+	struct dirent *drd;
+	struct stats_cgroup *st_cg_i;
+	char cg_path[MAX_PF_NAME];
+	int cfd;
+
+	if ((dir = fdopendir(dfd)) == NULL) {
+		close(dfd);
+		return cg_read;
+	}
+
+	while ((drd = readdir(dir)) != NULL) {
+
+		if ((drd->d_type != DT_DIR) || (drd->d_name[0] == '.'))
+			continue;
+
+		if (cg_read + 1 > nr_alloc) {
+			cg_read = -1;
+			break;
+		}
+
+		if ((cfd = openat(dirfd(dir), drd->d_name,
+				  O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+			/* Cgroup has just been removed */
+			continue;
+
+		snprintf(cg_path, sizeof(cg_path), "%s%s%s",
+			 path, *path ? "/" : "", drd->d_name);
+
+		st_cg_i = st_cg + cg_read++;
+		memset(st_cg_i, 0, STATS_CGROUP_SIZE);
+		read_cgroup_stats(cfd, st_cg_i);
+		strncpy(st_cg_i->cg_name, cg_path, MAX_CG_LEN);
+		st_cg_i->cg_name[MAX_CG_LEN - 1] = '\0';
+
+		if (depth + 1 < MAX_CG_DEPTH) {
+			/* Now read child cgroups (this closes @cfd) */
+			if ((cg_read = read_cgroup_dir(cfd, cg_path, depth + 1,
+						       st_cg, nr_alloc, cg_read)) < 0)
+				break;
+		}
+		else {
+			close(cfd);
+		}
+	}
+
+	closedir(dir);
+	return cg_read;
+}
+
+/*
+ ***************************************************************************
+ * Read cgroup v2 statistics. The hierarchy is walked once, and CPU, memory
+ * and I/O statistics are read for every cgroup (but the root one).
+ *
+ * IN:
+ * @st_cg	Structure where stats will be saved.
+ * @nr_alloc	Total number of structures allocated. Value is >= 0.
+ *
+ * OUT:
+ * @st_cg	Structure with statistics.
+ *
+ * RETURNS:
+ * Number of cgroups read, or -1 if the buffer was too small and needs to
+ * be reallocated.
+ ***************************************************************************
+ */
+__nr_t read_cgroup(struct stats_cgroup *st_cg, __nr_t nr_alloc)
+{
+	char *root;
+	int dfd;
+
+	if ((root = get_cgroup_root()) == NULL)
+		return 0; /* No cgroup v2 hierarchy */
+
+	if ((dfd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+		return 0;
+
+	return read_cgroup_dir(dfd, "", 0, st_cg, nr_alloc, 0);
+}
+
 /*
  ***************************************************************************
  * Read softnet statistics.
@@ -2664,13 +4125,13 @@ __nr_t read_fchost(struct stats_fchost *st_fc, __nr_t nr_alloc)
 int read_softnet(struct stats_softnet *st_softnet, __nr_t nr_alloc,
 		  unsigned char online_cpu_bitmap[])
 {
-	FILE *fp;
+	const char *pos;
 	struct stats_softnet *st_softnet_i;
 	char line[1024];
 	int cpu;
 
-	/* Open /proc/net/softnet_stat file */
-	if ((fp = fopen(NET_SOFTNET, "r")) == NULL)
+	/* Read /proc/net/softnet_stat file */
+	if ((pos = read_src_file(&src_files[SRC_NET_SOFTNET])) == NULL)
 		return 0;
 
 	for (cpu = 1; cpu < nr_alloc; cpu++) {
@@ -2678,7 +4139,7 @@ int read_softnet(struct stats_softnet *st_softnet, __nr_t nr_alloc,
 			/* CPU is offline */
 			continue;
 
-		if (fgets(line, sizeof(line), fp) == NULL)
+		if (src_gets(line, sizeof(line), &pos) == NULL)
 			break;
 
 		st_softnet_i = st_softnet + cpu;
@@ -2690,7 +4151,6 @@ int read_softnet(struct stats_softnet *st_softnet, __nr_t nr_alloc,
 		       &st_softnet_i->flow_limit);
 	}
 
-	fclose(fp);
 	return 1;
 }
 
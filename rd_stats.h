@@ -14,6 +14,7 @@
 
 /* Get IFNAMSIZ */
 #include <net/if.h>
+#include <sys/statvfs.h>
 #ifndef IFNAMSIZ
 #define IFNAMSIZ	16
 #endif
@@ -30,6 +31,13 @@
 #define MAX_FS_LEN	128
 /* Maximum length of FC host name */
 #define MAX_FCH_LEN	16
+/* Maximum length of cgroup path (relative to the cgroup v2 mount point) */
+#define MAX_CG_LEN	256
+/* Maximum depth of cgroup hierarchy walked by sadc */
+#define MAX_CG_DEPTH	32
+
+/* Time given to statvfs() to answer before a filesystem is marked stale (ms) */
+#define STATVFS_TIMEOUT	500
 
 #define CNT_PART	1
 #define CNT_ALL_DEV	0
@@ -41,6 +49,19 @@
 #define C_DUPLEX_HALF	1
 #define C_DUPLEX_FULL	2
 
+/* Number of statistics fields following the device name in /proc/diskstats */
+#define DISKSTATS_FIELDS	15
+/* Number of statistics fields following the interface name in /proc/net/dev */
+#define NET_DEV_FIELDS		16
+
+/* Initial size of the buffer containing the contents of a statistics file */
+#define SRC_BUF_INIT_SIZE	4096
+
+/* Size of the buffer used to receive netlink messages */
+#define NL_RECV_SIZE		32768
+/* Netlink socket value meaning that netlink cannot be used */
+#define NL_UNAVAILABLE		-2
+
 /* Type for all functions counting items. Value can be negative (-1) */
 #define __nr_t		int
 
@@ -69,12 +90,20 @@
 #define NET_SNMP6	"/proc/net/snmp6"
 #define CPUINFO		"/proc/cpuinfo"
 #define MTAB		"/etc/mtab"
+#define PSI_CPU		"/proc/pressure/cpu"
+#define PSI_MEMORY	"/proc/pressure/memory"
+#define PSI_IO		"/proc/pressure/io"
 #define IF_DUPLEX	"/sys/class/net/%s/duplex"
 #define IF_SPEED	"/sys/class/net/%s/speed"
 #define FC_RX_FRAMES	"%s/%s/statistics/rx_frames"
 #define FC_TX_FRAMES	"%s/%s/statistics/tx_frames"
 #define FC_RX_WORDS	"%s/%s/statistics/rx_words"
 #define FC_TX_WORDS	"%s/%s/statistics/tx_words"
+#define CG_CONTROLLERS	"%s/cgroup.controllers"
+#define CG_CPU_STAT	"cpu.stat"
+#define CG_MEM_CURRENT	"memory.current"
+#define CG_MEM_STAT	"memory.stat"
+#define CG_IO_STAT	"io.stat"
 
 /*
  ***************************************************************************
@@ -663,6 +692,8 @@ struct stats_filesystem {
 	unsigned long long f_bavail;
 	unsigned long long f_files;
 	unsigned long long f_ffree;
+	/* TRUE if filesystem didn't answer in time: Values are the last known ones */
+	unsigned int	   stale;
 	char 		   fs_name[MAX_FS_LEN];
 	char 		   mountp[MAX_FS_LEN];
 };
@@ -671,7 +702,7 @@ struct stats_filesystem {
 #define STATS_FILESYSTEM_SIZE2CMP	(STATS_FILESYSTEM_SIZE - 2 * MAX_FS_LEN)
 #define STATS_FILESYSTEM_ULL		5
 #define STATS_FILESYSTEM_UL		0
-#define STATS_FILESYSTEM_U		0
+#define STATS_FILESYSTEM_U		1
 
 /* Structure for Fibre Channel HBA statistics */
 struct stats_fchost {
@@ -701,6 +732,83 @@ struct stats_softnet {
 #define STATS_SOFTNET_UL	0
 #define STATS_SOFTNET_U		5
 
+/*
+ * Structure for cgroup v2 statistics.
+ * CPU times are in microseconds, memory sizes and I/O amounts in bytes.
+ * I/O statistics are summed over all the devices.
+ */
+struct stats_cgroup {
+	unsigned long long usage_usec;
+	unsigned long long user_usec;
+	unsigned long long system_usec;
+	unsigned long long throttled_usec;
+	unsigned long long mem_current;
+	unsigned long long mem_anon;
+	unsigned long long mem_file;
+	unsigned long long io_rbytes;
+	unsigned long long io_wbytes;
+	unsigned long long io_rios;
+	unsigned long long io_wios;
+	char		   cg_name[MAX_CG_LEN];
+};
+
+#define STATS_CGROUP_SIZE	(sizeof(struct stats_cgroup))
+#define STATS_CGROUP_ULL	11
+#define STATS_CGROUP_UL		0
+#define STATS_CGROUP_U		0
+
+/*
+ * Structure for pressure stall information (PSI).
+ * Values are the total stall times in microseconds when some (or all)
+ * non-idle tasks were delayed waiting for the given resource.
+ */
+struct stats_psi {
+	unsigned long long some_cpu_total;
+	unsigned long long full_cpu_total;
+	unsigned long long some_mem_total;
+	unsigned long long full_mem_total;
+	unsigned long long some_io_total;
+	unsigned long long full_io_total;
+};
+
+#define STATS_PSI_SIZE	(sizeof(struct stats_psi))
+#define STATS_PSI_ULL	6
+#define STATS_PSI_UL	0
+#define STATS_PSI_U	0
+
+/*
+ * Structure for sadc own collection cost statistics.
+ * Durations are cumulative and expressed in microseconds.
+ */
+struct stats_self {
+	unsigned long long nr_read;
+	unsigned long long read_wall;
+	unsigned long long read_cpu;
+	unsigned long long count_wall;
+	unsigned long long count_cpu;
+	/* Identification value of the activity */
+	unsigned int	   id;
+};
+
+#define STATS_SELF_SIZE		(sizeof(struct stats_self))
+#define STATS_SELF_ULL		5
+#define STATS_SELF_UL		0
+#define STATS_SELF_U		1
+
+/*
+ * Statistics file kept open between samples.
+ * Its contents are read with pread() into a buffer reused from one
+ * sample to the next.
+ */
+struct src_file {
+	const char *name;
+	char	   *buf;
+	size_t	    size;
+	int	    fd;
+};
+
+#define SRC_FILE_INIT(f)	{.name = (f), .buf = NULL, .size = 0, .fd = -1}
+
 /*
  ***************************************************************************
  * Prototypes for functions used to read system statistics
@@ -712,6 +820,29 @@ void compute_ext_disk_stats
 	 struct ext_disk_stats *);
 unsigned long long get_per_cpu_interval
 	(struct stats_cpu *, struct stats_cpu *);
+int open_src_file
+	(struct src_file *);
+void close_src_file
+	(struct src_file *);
+char *read_src_file
+	(struct src_file *);
+char *src_gets
+	(char *, size_t, const char **);
+int parse_u64_fields
+	(const char *, int, unsigned long long [], const char **);
+const char *parse_word_field
+	(const char *, char *, size_t);
+int parse_diskstats_line
+	(const char *, unsigned int *, unsigned int *, char *, size_t,
+	 unsigned long long []);
+void open_src_files
+	(void);
+void close_src_files
+	(void);
+int read_stat_snapshot
+	(void);
+void release_stat_snapshot
+	(void);
 __nr_t read_stat_cpu
 	(struct stats_cpu *, __nr_t);
 __nr_t read_stat_irq
@@ -720,6 +851,10 @@ __nr_t read_meminfo
 	(struct stats_memory *);
 void read_uptime
 	(unsigned long long *);
+__nr_t read_link_snapshot
+	(void);
+void release_link_snapshot
+	(void);
 #ifdef SOURCE_SADC
 void oct2chr
 	(char *);
@@ -727,6 +862,8 @@ __nr_t read_stat_pcsw
 	(struct stats_pcsw *);
 __nr_t read_loadavg
 	(struct stats_queue *);
+__nr_t read_psi
+	(struct stats_psi *);
 __nr_t read_vmstat_swap
 	(struct stats_swap *);
 __nr_t read_vmstat_paging
@@ -789,8 +926,14 @@ __nr_t read_filesystem
 	(struct stats_filesystem *, __nr_t);
 __nr_t read_fchost
 	(struct stats_fchost *, __nr_t);
+char *get_cgroup_root
+	(void);
+__nr_t read_cgroup
+	(struct stats_cgroup *, __nr_t);
 int read_softnet
 	(struct stats_softnet *, __nr_t, unsigned char []);
+int statvfs_timeout
+	(const char *, struct statvfs *, int *);
 #endif /* SOURCE_SADC */
 
 #endif /* _RD_STATS_H */
@@ -26,6 +26,7 @@
 #include "sa.h"
 #include "ioconf.h"
 #include "rndr_stats.h"
+#include "arrow_ipc.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -38,6 +39,47 @@
 char *seps[] =  {"\t", ";"};
 
 extern unsigned int flags;
+extern struct activity *act[];
+
+/* Buffer where current output line is formatted */
+static char line[8192];
+static size_t line_len = 0;
+
+/*
+ ***************************************************************************
+ * Write current output line (or the part of it formatted so far) on
+ * standard output.
+ ***************************************************************************
+ */
+static void line_flush(void)
+{
+	if (line_len) {
+		fwrite(line, 1, line_len, stdout);
+		line_len = 0;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Append a string to current output line.
+ *
+ * IN:
+ * @str		String to append.
+ * @len		Length of the string.
+ ***************************************************************************
+ */
+static void line_append(const char *str, size_t len)
+{
+	if (line_len + len > sizeof(line)) {
+		line_flush();
+		if (len > sizeof(line)) {
+			fwrite(str, 1, len, stdout);
+			return;
+		}
+	}
+	memcpy(line + line_len, str, len);
+	line_len += len;
+}
 
 /*
  ***************************************************************************
@@ -84,7 +126,8 @@ static Cons *cons(tcons t, ...)
  ***************************************************************************
  * render():
  *
- * given:    isdb - flag, true if db printing, false if ppc printing
+ * given:    isdb - flag, true if db printing, false if ppc printing,
+ *		   RENDER_ARROW if values should be saved for Arrow output
  *	     pre  - prefix string for output entries
  *	     rflags - PT_.... rendering flags
  *	     pptxt - printf-format text required for ppc output (may be null)
@@ -96,6 +139,9 @@ static Cons *cons(tcons t, ...)
  *
  * does:     print [pre<sep>]([dbtxt,arg,arg<sep>]|[pptxt,arg,arg<sep>]) \
  *                     (luval|dval)(<sep>|\n)
+ *	     Output is formatted in a buffer, written once the line is
+ *	     complete (or at once if stats are displayed horizontally since
+ *	     the line is then terminated by someone else).
  *
  * return:   void.
  ***************************************************************************
@@ -106,10 +152,46 @@ static void render(int isdb, char *pre, int rflags, const char *pptxt,
 {
 	static int newline = 1;
 	const char *txt[]  = {pptxt, dbtxt};
+	char key[512], num[64];
+	int len = 0;
+
+	if (isdb == RENDER_ARROW) {
+		/* Save values as they would have been printed in db format */
+		if (dbtxt) {
+			if (mid) {
+				switch(mid->t) {
+				case iv:
+					snprintf(key, sizeof(key), dbtxt, mid->a.i, mid->b.i);
+					break;
+				case sv:
+					snprintf(key, sizeof(key), dbtxt, mid->a.s, mid->b.s);
+					break;
+				}
+				arrow_add_str(key);
+			}
+			else {
+				arrow_add_str(dbtxt);
+			}
+		}
+
+		if (rflags & PT_USEINT) {
+			arrow_add_u64(lluval);
+		}
+		else if (rflags & PT_USESTR) {
+			arrow_add_str(sval);
+		}
+		else {
+			arrow_add_f64(dval);
+		}
+		if (rflags & PT_NEWLIN) {
+			arrow_end_row();
+		}
+		return;
+	}
 
 	/* Start a new line? */
 	if (newline && !DISPLAY_HORIZONTALLY(flags)) {
-		printf("%s", pre);
+		line_append(pre, strlen(pre));
 	}
 
 	/* Terminate this one ? ppc always gets a newline */
@@ -118,38 +200,43 @@ static void render(int isdb, char *pre, int rflags, const char *pptxt,
 	if (txt[isdb]) {
 		/* pp/dbtxt? */
 
-		printf("%s", seps[isdb]);	/* Only if something actually gets printed */
+		line_append(seps[isdb], 1);	/* Only if something actually gets printed */
 
 		if (mid) {
 			/* Got format args? */
 			switch(mid->t) {
 			case iv:
-				printf(txt[isdb], mid->a.i, mid->b.i);
+				len = snprintf(key, sizeof(key), txt[isdb], mid->a.i, mid->b.i);
 				break;
 			case sv:
-				printf(txt[isdb], mid->a.s, mid->b.s);
+				len = snprintf(key, sizeof(key), txt[isdb], mid->a.s, mid->b.s);
 				break;
 			}
+			line_append(key, len < (int) sizeof(key) ? len : sizeof(key) - 1);
 		}
 		else {
-			printf("%s", txt[isdb]);
+			line_append(txt[isdb], strlen(txt[isdb]));
 		}
 	}
 
+	line_append(seps[isdb], 1);
 	if (rflags & PT_USEINT) {
-		printf("%s%llu", seps[isdb], lluval);
+		len = sprint_u64(num, lluval);
+		line_append(num, len);
 	}
 	else if (rflags & PT_USESTR) {
-		printf("%s%s", seps[isdb], sval);
-	}
-	else if (rflags & PT_USERND) {
-		printf("%s%.0f", seps[isdb], dval);
+		line_append(sval, strlen(sval));
 	}
 	else {
-		printf("%s%.2f", seps[isdb], dval);
+		len = sprint_fixed(num, dval, (rflags & PT_USERND) ? 0 : 2);
+		line_append(num, len);
 	}
 	if (newline) {
-		printf("\n");
+		line_append("\n", 1);
+	}
+
+	if (newline || DISPLAY_HORIZONTALLY(flags)) {
+		line_flush();
 	}
 }
 
@@ -957,6 +1044,64 @@ __print_funct_t render_queue_stats(struct activity *a, int isdb, char *pre,
 	       sqc->procs_blocked, DNOVAL, NULL);
 }
 
+/*
+ ***************************************************************************
+ * Display pressure stall information in selected format.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @isdb	Flag, true if db printing, false if ppc printing.
+ * @pre		Prefix string for output entries
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t render_psi_stats(struct activity *a, int isdb, char *pre,
+				 int curr, unsigned long long itv)
+{
+	struct stats_psi
+		*spc = (struct stats_psi *) a->buf[curr],
+		*spp = (struct stats_psi *) a->buf[!curr];
+	int pt_newlin
+		= (DISPLAY_HORIZONTALLY(flags) ? PT_NOFLAG : PT_NEWLIN);
+
+	render(isdb, pre, PT_NOFLAG,
+	       "-\t%scpu", NULL, NULL,
+	       NOVAL,
+	       S_VALUE(spp->some_cpu_total, spc->some_cpu_total, itv) / 10000,
+	       NULL);
+
+	render(isdb, pre, PT_NOFLAG,
+	       "-\t%fcpu", NULL, NULL,
+	       NOVAL,
+	       S_VALUE(spp->full_cpu_total, spc->full_cpu_total, itv) / 10000,
+	       NULL);
+
+	render(isdb, pre, PT_NOFLAG,
+	       "-\t%smem", NULL, NULL,
+	       NOVAL,
+	       S_VALUE(spp->some_mem_total, spc->some_mem_total, itv) / 10000,
+	       NULL);
+
+	render(isdb, pre, PT_NOFLAG,
+	       "-\t%fmem", NULL, NULL,
+	       NOVAL,
+	       S_VALUE(spp->full_mem_total, spc->full_mem_total, itv) / 10000,
+	       NULL);
+
+	render(isdb, pre, PT_NOFLAG,
+	       "-\t%sio", NULL, NULL,
+	       NOVAL,
+	       S_VALUE(spp->some_io_total, spc->some_io_total, itv) / 10000,
+	       NULL);
+
+	render(isdb, pre, pt_newlin,
+	       "-\t%fio", NULL, NULL,
+	       NOVAL,
+	       S_VALUE(spp->full_io_total, spc->full_io_total, itv) / 10000,
+	       NULL);
+}
+
 /*
  ***************************************************************************
  * Display serial lines statistics in selected format.
@@ -2971,8 +3116,7 @@ __print_funct_t render_filesystem_stats(struct activity *a, int isdb, char *pre,
 		       NOVAL,
 		       NULL);
 
-		render(isdb, pre,
-		       (DISPLAY_HORIZONTALLY(flags) ? PT_NOFLAG : PT_NEWLIN),
+		render(isdb, pre, PT_NOFLAG,
 		       "%s\t%%Iused",
 		       NULL,
 		       cons(sv, DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name, NOVAL),
@@ -2980,6 +3124,15 @@ __print_funct_t render_filesystem_stats(struct activity *a, int isdb, char *pre,
 		       sfc->f_files ? SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files)
 				    : 0.0,
 		       NULL);
+
+		render(isdb, pre,
+		       PT_USEINT | (DISPLAY_HORIZONTALLY(flags) ? PT_NOFLAG : PT_NEWLIN),
+		       "%s\tstale",
+		       NULL,
+		       cons(sv, DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name, NOVAL),
+		       sfc->stale,
+		       NOVAL,
+		       NULL);
 	}
 }
 
@@ -3189,3 +3342,176 @@ __print_funct_t render_softnet_stats(struct activity *a, int isdb, char *pre,
 		}
 	}
 }
+
+/*
+ ***************************************************************************
+ * Display sadc own collection cost statistics in selected format.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @isdb	Flag, true if db printing, false if ppc printing.
+ * @pre		Prefix string for output entries
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t render_self_stats(struct activity *a, int isdb, char *pre,
+				  int curr, unsigned long long itv)
+{
+	int i, j, j0, found;
+	struct stats_self *sscc, *sscp;
+	char *name;
+
+	for (i = 0; i < a->nr[curr]; i++) {
+
+		found = FALSE;
+		sscc = (struct stats_self *) ((char *) a->buf[curr] + i * a->msize);
+
+		if ((name = get_activity_name(act, sscc->id)) == NULL)
+			continue;
+
+		if (a->nr[!curr] > 0) {
+			/* Look for corresponding structure in previous iteration */
+			j = i;
+
+			if (j >= a->nr[!curr]) {
+				j = a->nr[!curr] - 1;
+			}
+
+			j0 = j;
+
+			do {
+				sscp = (struct stats_self *) ((char *) a->buf[!curr] + j * a->msize);
+				if (sscc->id == sscp->id) {
+					found = TRUE;
+					break;
+				}
+				if (++j >= a->nr[!curr]) {
+					j = 0;
+				}
+			}
+			while (j != j0);
+		}
+
+		if (!found)
+			continue;
+
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\trdtime",
+		       "%s",
+		       cons(sv, name, NOVAL),
+		       NOVAL,
+		       E_VALUE(sscp->read_wall, sscc->read_wall, sscp->nr_read, sscc->nr_read),
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\trdcpu", NULL,
+		       cons(sv, name, NULL),
+		       NOVAL,
+		       E_VALUE(sscp->read_cpu, sscc->read_cpu, sscp->nr_read, sscc->nr_read),
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\tcnttime", NULL,
+		       cons(sv, name, NULL),
+		       NOVAL,
+		       (double) sscc->count_wall,
+		       NULL);
+		render(isdb, pre,
+		       (DISPLAY_HORIZONTALLY(flags) ? PT_NOFLAG : PT_NEWLIN),
+		       "%s\tcntcpu", NULL,
+		       cons(sv, name, NULL),
+		       NOVAL,
+		       (double) sscc->count_cpu,
+		       NULL);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Display cgroup statistics in selected format.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @isdb	Flag, true if db printing, false if ppc printing.
+ * @pre		Prefix string for output entries
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t render_cgroup_stats(struct activity *a, int isdb, char *pre,
+				    int curr, unsigned long long itv)
+{
+	int i;
+	struct stats_cgroup *scgc, *scgp;
+
+	/* Index cgroups from previous sample by name */
+	index_cgroups(a, !curr);
+
+	for (i = 0; i < a->nr[curr]; i++) {
+
+		scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+		scgp = get_prev_cgroup(a, !curr, scgc);
+
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\t%%usr",
+		       "%s",
+		       cons(sv, scgc->cg_name, NOVAL),
+		       NOVAL,
+		       S_VALUE(scgp->user_usec, scgc->user_usec, itv) / 10000,
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\t%%system", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->system_usec, scgc->system_usec, itv) / 10000,
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\t%%cpu", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->usage_usec, scgc->usage_usec, itv) / 10000,
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\t%%thrtl", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->throttled_usec, scgc->throttled_usec, itv) / 10000,
+		       NULL);
+		render(isdb, pre, PT_USEINT,
+		       "%s\tkbmem", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       scgc->mem_current / 1024, DNOVAL, NULL);
+		render(isdb, pre, PT_USEINT,
+		       "%s\tkbanon", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       scgc->mem_anon / 1024, DNOVAL, NULL);
+		render(isdb, pre, PT_USEINT,
+		       "%s\tkbfile", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       scgc->mem_file / 1024, DNOVAL, NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\trkB/s", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->io_rbytes, scgc->io_rbytes, itv) / 1024,
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\twkB/s", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->io_wbytes, scgc->io_wbytes, itv) / 1024,
+		       NULL);
+		render(isdb, pre, PT_NOFLAG,
+		       "%s\trio/s", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->io_rios, scgc->io_rios, itv),
+		       NULL);
+		render(isdb, pre,
+		       (DISPLAY_HORIZONTALLY(flags) ? PT_NOFLAG : PT_NEWLIN),
+		       "%s\twio/s", NULL,
+		       cons(sv, scgc->cg_name, NULL),
+		       NOVAL,
+		       S_VALUE(scgp->io_wios, scgc->io_wios, itv),
+		       NULL);
+	}
+}
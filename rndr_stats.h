@@ -124,5 +124,11 @@ __print_funct_t render_fchost_stats
 	(struct activity *, int, char *, int, unsigned long long);
 __print_funct_t render_softnet_stats
 	(struct activity *, int, char *, int, unsigned long long);
+__print_funct_t render_self_stats
+	(struct activity *, int, char *, int, unsigned long long);
+__print_funct_t render_cgroup_stats
+	(struct activity *, int, char *, int, unsigned long long);
+__print_funct_t render_psi_stats
+	(struct activity *, int, char *, int, unsigned long long);
 
 #endif /* _RNDR_STATS_H */
@@ -19,12 +19,12 @@
  */
 
 /* Number of activities */
-#define NR_ACT		39
+#define NR_ACT		42
 /* The value below is used for sanity check */
 #define MAX_NR_ACT	256
 
 /* Number of functions used to count items */
-#define NR_F_COUNT	11
+#define NR_F_COUNT	14
 
 /* Activities */
 #define A_CPU		1
@@ -66,6 +66,9 @@
 #define A_FS		37
 #define A_NET_FC	38
 #define A_NET_SOFT	39
+#define A_SELF		40
+#define A_CGROUP	41
+#define A_PSI		42
 
 
 /* Macro used to flag an activity that should be collected */
@@ -111,6 +114,9 @@
 #define S_F_ZERO_OMIT		0x02000000
 #define S_F_SVG_SHOW_TOC	0x04000000
 #define S_F_FDATASYNC		0x08000000
+#define S_F_DELTA_ENC		0x10000000
+#define S_F_BLK_COMPRESS	0x20000000
+#define S_F_SUBSEC_TIME		0x40000000
 
 #define WANT_SINCE_BOOT(m)		(((m) & S_F_SINCE_BOOT)   == S_F_SINCE_BOOT)
 #define WANT_SA_ROTAT(m)		(((m) & S_F_SA_ROTAT)     == S_F_SA_ROTAT)
@@ -141,6 +147,9 @@
 #define DISPLAY_HUMAN_READ(m)		(((m) & S_F_HUMAN_READ) == S_F_HUMAN_READ)
 #define DISPLAY_TOC(m)			(((m) & S_F_SVG_SHOW_TOC) == S_F_SVG_SHOW_TOC)
 #define FDATASYNC(m)			(((m) & S_F_FDATASYNC)    == S_F_FDATASYNC)
+#define WANT_DELTA_ENC(m)		(((m) & S_F_DELTA_ENC)    == S_F_DELTA_ENC)
+#define WANT_BLK_COMPRESS(m)		(((m) & S_F_BLK_COMPRESS) == S_F_BLK_COMPRESS)
+#define DISPLAY_SUBSEC_TIME(m)		(((m) & S_F_SUBSEC_TIME)  == S_F_SUBSEC_TIME)
 
 #define AO_F_NULL		0x00000000
 
@@ -208,6 +217,7 @@
 #define K_MOUNT		"MOUNT"
 #define K_FC		"FC"
 #define K_SOFT		"SOFT"
+#define K_PSI		"PSI"
 
 #define K_INT		"INT"
 #define K_DISK		"DISK"
@@ -216,6 +226,8 @@
 #define K_IPV6		"IPV6"
 #define K_POWER		"POWER"
 #define K_USB		"USB"
+#define K_SELF		"SELF"
+#define K_CGROUP	"CGROUP"
 
 #define K_SKIP_EMPTY	"skipempty"
 #define K_AUTOSCALE	"autoscale"
@@ -229,6 +241,7 @@
 #define K_CUSTOMCOL	"customcol"
 #define K_BWCOL		"bwcol"
 #define K_PCPARCHIVE	"pcparchive="
+#define K_COMPACT	"compact"
 
 /* Environment variables */
 #define ENV_COLORS_PALETTE	"S_COLORS_PALETTE"
@@ -241,10 +254,15 @@
 #define G_IPV6		0x08
 #define G_POWER		0x10
 #define G_XDISK		0x20
+#define G_SELF		0x40
+#define G_CGROUP	0x80
 
 /* sadc program */
 #define SADC		"sadc"
 
+/* Max number of threads used by sadc to read activities (option -P) */
+#define MAX_NR_THREADS	64
+
 /* Time must have the format HH:MM:SS with HH in 24-hour format */
 #define DEF_TMSTART	"08:00:00"
 #define DEF_TMEND	"18:00:00"
@@ -267,11 +285,19 @@
 #define MAX_NR_USB		65536
 #define MAX_NR_FS		(65536 * 4096)
 #define MAX_NR_FCHOSTS		65536
+#define MAX_NR_CGROUPS		65536
 
 /* NR_MAX is the upper limit used for unknown activities */
 #define NR_MAX		(65536 * 4096)
 #define NR2_MAX		1024
 
+/*
+ * Value saved in place of the number of items for an activity which is not
+ * due in current record (see @period in file_activity structure below).
+ * No statistics structures follow it.
+ */
+#define NR_NOT_DUE	(-1)
+
 /* Maximum number of args that can be passed to sadc */
 #define MAX_ARGV_NR	32
 
@@ -317,16 +343,54 @@
 
 /* Structure for SVG specific parameters */
 struct svg_parm {
-	unsigned long long dt;			/* Interval of time for current sample */
+	unsigned long long dt;			/* Interval of time for current sample (in 1/timetag_hz s) */
 	unsigned long long ust_time_ref;	/* X axis start time in seconds since the epoch */
 	unsigned long long ust_time_end;	/* X axis end time in seconds since the epoch */
-	unsigned long long ust_time_first;	/* Time (in seconds since the epoch) for first sample */
+	unsigned long long timetag_first;	/* X coordinate of first sample (see SVG_TIMETAG()) */
+	unsigned int ust_usec_end;		/* Microseconds part of X axis end time */
+	unsigned int timetag_hz;		/* Units of X axis per second (1000 with sub-second records) */
 	int graph_no;				/* Total number of views already displayed */
 	int restart;				/* TRUE if we have just met a RESTART record */
 	int nr_act_dispd;			/* Number of activities that will be displayed */
+	double dec_xfactor;			/* Scaling factor on X axis used to decimate graphs (0 if not decimated) */
 	struct file_header *file_hdr;		/* Pointer on file header structure */
 };
 
+/*
+ * X coordinate of a record in SVG graphs: Time elapsed since the start of
+ * the X axis, in 1/timetag_hz second.
+ */
+#define SVG_TIMETAG(p, r)	(((r)->ust_time - (p)->ust_time_ref) * (p)->timetag_hz + \
+				 (r)->ust_usec * (p)->timetag_hz / 1000000)
+
+/* Point of a line graph kept in a pixel column of a decimated graph */
+struct svg_point {
+	unsigned long long timetag;	/* X coordinate */
+	union {
+		double d;
+		unsigned long long u;
+	} value;			/* Y coordinate */
+	unsigned int rank;		/* Rank of the point in its pixel column */
+	char cmd;			/* 'M' (first point after a RESTART) or 'L' */
+	char integer;			/* TRUE if Y coordinate is an integer value */
+};
+
+/*
+ * Size of an array of chars containing the definition of an SVG graph,
+ * and points of the pixel column being decimated (see SVG_POINTS_PER_PX).
+ */
+struct svg_outsize {
+	int alloc;	/* Size allocated for the array */
+	int len;	/* Length of the graph definition saved in the array */
+	double xfactor;	/* Scaling factor on X axis used to decimate graph (0 if not decimated) */
+	long col;	/* Pixel column being decimated, or -1 if none */
+	int col_type;	/* Type of graph (SVG_LINE_GRAPH, SVG_BAR_GRAPH) of the pixel column */
+	unsigned int col_nr;		/* Number of points found in the pixel column */
+	struct svg_point pt[4];		/* First, min, max and last points of a line graph */
+	unsigned long long x0, xend;	/* Start and end of the rectangles of a bar graph */
+	double y0, h0;			/* Position and height of the highest of them */
+};
+
 /* Structure used when displaying SVG header */
 struct svg_hdr_parm {
 	int graph_nr;	   /* Number of rows of views to display or canvas height entered on the command line */
@@ -384,6 +448,31 @@ struct svg_hdr_parm {
  * read atomically and the number of items (e.g. network interfaces) may have
  * varied in between.
  *
+ * If FH_F_DELTA flag is set in file header, then every group of statistics
+ * structures (when <count> is not 0) is replaced with an unsigned int
+ * giving the size of the encoded block that follows, then the block itself:
+ * A byte telling whether it is a keyframe (ENC_KEYFRAME) or not (ENC_DELTA),
+ * followed by every numerical field of each structure saved as a zigzag
+ * varint of its difference with the same field of the same item in the
+ * previous record where the activity has been saved (or with 0 for a
+ * keyframe). Remaining bytes of each structure (e.g. names) are preceded
+ * by a byte set to 1, or replaced with a byte set to 0 if they have not
+ * changed. See encode_act_stats().
+ *
+ * If FH_F_COMPRESS flag is set in file header, then records are not saved
+ * as is after the list of activities: They are grouped in blocks, each
+ * block being a blk_header structure followed by its contents compressed
+ * with lz_compress(). A block always contains whole records and can be
+ * decompressed independently of the others (in a delta encoded file, the
+ * first record of each block is encoded as a keyframe). Block headers,
+ * which give the compressed size of each block and the timestamps of its
+ * first and last records, make up a directory of the file which can be
+ * walked without decompressing anything.
+ * The block being filled by sadc is saved again each time a record is added
+ * to it: Its new version is written past the previous one, then the header
+ * of the block is replaced with a header whose magic number is BLK_SKIP_MAGIC
+ * and which tells readers to skip the area containing older versions.
+ *
  * If the record header's type is R_COMMENT then we find only a comment
  * following the record_header structure.
  * If the record_header's type is R_RESTART then we find only the number of CPU
@@ -403,7 +492,7 @@ struct svg_hdr_parm {
  * Modified to indicate that the format of the file is
  * no longer compatible with that of previous sysstat versions.
  */
-#define FORMAT_MAGIC	0x2175
+#define FORMAT_MAGIC	0x2176
 #define FORMAT_MAGIC_SWAPPED	(((FORMAT_MAGIC << 8) | (FORMAT_MAGIC >> 8)) & 0xffff)
 
 /* Previous datafile format magic numbers used by older sysstat versions */
@@ -411,6 +500,17 @@ struct svg_hdr_parm {
 #define FORMAT_MAGIC_2171_SWAPPED	(((FORMAT_MAGIC_2171 << 8) | (FORMAT_MAGIC_2171 >> 8)) & 0xffff)
 #define FORMAT_MAGIC_2173		0x2173
 #define FORMAT_MAGIC_2173_SWAPPED	(((FORMAT_MAGIC_2173 << 8) | (FORMAT_MAGIC_2173 >> 8)) & 0xffff)
+/*
+ * Files with format 0x2175 only have smaller file_header, file_activity and
+ * record_header structures. sar and sadf read them as they are (their
+ * structures are remapped), but sadc cannot append data to them.
+ */
+#define FORMAT_MAGIC_2175		0x2175
+#define FORMAT_MAGIC_2175_SWAPPED	(((FORMAT_MAGIC_2175 << 8) | (FORMAT_MAGIC_2175 >> 8)) & 0xffff)
+
+/* TRUE if a file with format magic number @m can be read without being converted */
+#define IS_READABLE_FORMAT(m)	(((m) == FORMAT_MAGIC) || ((m) == FORMAT_MAGIC_SWAPPED) || \
+				 ((m) == FORMAT_MAGIC_2175) || ((m) == FORMAT_MAGIC_2175_SWAPPED))
 
 /* Padding in file_magic structure. See below. */
 #define FILE_MAGIC_PADDING	48
@@ -500,6 +600,10 @@ struct file_header {
 	 */
 	unsigned int act_size;
 	unsigned int rec_size;
+	/*
+	 * File flags (FH_F_...), e.g. how statistics are encoded in file.
+	 */
+	unsigned int sa_flags;
 	/*
 	 * Current day and month.
 	 * No need to save DST (Daylight Saving Time) flag, since it is not taken
@@ -533,11 +637,225 @@ struct file_header {
 #define FILE_HEADER_SIZE	(sizeof(struct file_header))
 #define FILE_HEADER_ULL_NR	1	/* Nr of unsigned long long in file_header structure */
 #define FILE_HEADER_UL_NR	1	/* Nr of unsigned long in file_header structure */
-#define FILE_HEADER_U_NR	11	/* Nr of [unsigned] int in file_header structure */
+#define FILE_HEADER_U_NR	12	/* Nr of [unsigned] int in file_header structure */
 /* The values below are used for sanity check */
 #define MIN_FILE_HEADER_SIZE	0
 #define MAX_FILE_HEADER_SIZE	8192
 
+/* File flags (@sa_flags field in file_header structure) */
+/*
+ * Statistics are delta encoded against those of the previous record.
+ */
+#define FH_F_DELTA		0x00000001
+/*
+ * Records are grouped in compressed blocks.
+ */
+#define FH_F_COMPRESS		0x00000002
+/*
+ * sadc has saved records less than a second apart (sub-second interval).
+ */
+#define FH_F_SUBSEC		0x00000004
+/* All the flags known by current sysstat version */
+#define FH_F_KNOWN		(FH_F_DELTA | FH_F_COMPRESS | FH_F_SUBSEC)
+
+#define IS_DELTA_ENCODED(m)	(((m) & FH_F_DELTA)    == FH_F_DELTA)
+#define IS_COMPRESSED(m)	(((m) & FH_F_COMPRESS) == FH_F_COMPRESS)
+#define HAS_SUBSEC_RECORDS(m)	(((m) & FH_F_SUBSEC)   == FH_F_SUBSEC)
+
+/* TRUE if interval @i (in microseconds) is a sub-second one */
+#define IS_SUBSEC_INTERVAL(i)	(((i) > 0) && ((i) < 1000000))
+
+/* Types of encoded blocks of statistics (see FH_F_DELTA) */
+#define ENC_KEYFRAME	0
+#define ENC_DELTA	1
+
+/*
+ * Number of records between two keyframes in a delta encoded file.
+ * A keyframe is also written at the beginning of each file and each
+ * time sadc is started.
+ */
+#define ENC_KEYFRAME_INTERVAL	60
+
+/* Header of a block of records in a compressed file (see FH_F_COMPRESS) */
+struct blk_header {
+	/*
+	 * Timestamps (number of seconds since the epoch)
+	 * of first and last records in block.
+	 */
+	unsigned long long first_ust_time	__attribute__ ((aligned (8)));
+	unsigned long long last_ust_time	__attribute__ ((aligned (8)));
+	/*
+	 * Magic number (BLK_MAGIC).
+	 */
+	unsigned int blk_magic;
+	/*
+	 * Size of block contents once decompressed.
+	 */
+	unsigned int raw_size;
+	/*
+	 * Size of compressed contents following the header.
+	 */
+	unsigned int comp_size;
+	/*
+	 * Number of records in block.
+	 */
+	unsigned int rec_nr;
+};
+
+#define BLK_HEADER_SIZE		(sizeof(struct blk_header))
+#define BLK_HEADER_ULL_NR	2	/* Nr of unsigned long long in blk_header structure */
+#define BLK_HEADER_UL_NR	0	/* Nr of unsigned long in blk_header structure */
+#define BLK_HEADER_U_NR		4	/* Nr of [unsigned] int in blk_header structure */
+
+#define BLK_MAGIC		0x5a1b
+/* Header of an area that readers should skip (see write_blk()) */
+#define BLK_SKIP_MAGIC		0x5a1c
+/*
+ * A block is closed when it contains BLK_REC_NR_MAX records or
+ * when its (uncompressed) size exceeds BLK_RAW_SIZE_MAX bytes.
+ */
+#define BLK_REC_NR_MAX		60
+#define BLK_RAW_SIZE_MAX	(1 << 20)
+/* Used for sanity check */
+#define BLK_RAW_SIZE_LIMIT	(1 << 26)
+/*
+ * A position in a compressed file is the offset of a block header,
+ * shifted left by BLK_POS_SHIFT bits, plus an offset in block's contents.
+ */
+#define BLK_POS_SHIFT		26
+
+/*
+ * Time index of a data file: Sidecar file (data file name followed by
+ * IDX_SUFFIX) maintained by sadc, made of an idx_header structure followed
+ * by an idx_entry structure for each record saved in data file. sar and sadf
+ * use it to go straight to the first record to display when option -s
+ * is used. It is written with the endianness of the data file.
+ */
+#define IDX_SUFFIX	".idx"
+#define IDX_MAGIC	0x1d5a
+
+struct idx_header {
+	/*
+	 * Timestamp of data file creation (@sa_ust_time in file_header).
+	 */
+	unsigned long long sa_ust_time	__attribute__ ((aligned (8)));
+	/*
+	 * Size of data file once last indexed record has been written.
+	 */
+	unsigned long long data_size	__attribute__ ((aligned (8)));
+	/*
+	 * Position of first record in data file.
+	 */
+	long long first_fpos		__attribute__ ((aligned (8)));
+	/*
+	 * Magic number (IDX_MAGIC).
+	 */
+	unsigned int idx_magic;
+	/*
+	 * Size of an idx_entry structure.
+	 */
+	unsigned int entry_size;
+};
+
+#define IDX_HEADER_SIZE	(sizeof(struct idx_header))
+
+struct idx_entry {
+	/*
+	 * Timestamp of record (number of seconds since the epoch).
+	 */
+	unsigned long long ust_time	__attribute__ ((aligned (8)));
+	/*
+	 * Position of record in data file (as given by sa_ftell()).
+	 */
+	long long fpos			__attribute__ ((aligned (8)));
+	/*
+	 * Number of CPU in effect once record has been read
+	 * (i.e. that given by the last RESTART record).
+	 */
+	unsigned int cpu_nr;
+	/*
+	 * Entry flags (IDX_F_...).
+	 */
+	unsigned int entry_flags;
+	/*
+	 * Record type and time of the record as saved in its header.
+	 */
+	unsigned char record_type;
+	unsigned char hour;
+	unsigned char minute;
+	unsigned char second;
+	unsigned char pad[4];
+};
+
+#define IDX_ENTRY_SIZE	(sizeof(struct idx_entry))
+
+/*
+ * Reading may start at this record: Statistics saved from this record on
+ * don't depend on those of previous records (see FH_F_DELTA).
+ */
+#define IDX_F_SYNC	0x01
+
+/* Block of records being written to or read from a compressed file */
+struct sa_blk {
+	/*
+	 * Header of current block.
+	 */
+	struct blk_header hdr;
+	/*
+	 * File offset of current block header.
+	 */
+	off_t pos;
+	/*
+	 * Block contents (uncompressed) and size allocated for it.
+	 */
+	unsigned char *raw;
+	size_t raw_alloc;
+	/*
+	 * Compressed contents and size allocated for it.
+	 */
+	unsigned char *comp;
+	size_t comp_alloc;
+	/*
+	 * Read offset in @raw.
+	 */
+	size_t off;
+	/*
+	 * File offset of the header of the last version of current block
+	 * written to file, and size of its compressed contents (0 if current
+	 * block has not been written yet).
+	 */
+	off_t disk_pos;
+	unsigned int disk_size;
+	/*
+	 * File descriptor (-1 if not used).
+	 */
+	int fd;
+	/*
+	 * TRUE if current block has been read from file.
+	 */
+	int loaded;
+	/*
+	 * TRUE if file's data don't match current machine's endianness.
+	 */
+	int endian_mismatch;
+};
+
+/* Regular data file mapped in memory to be read (see open_map_reader()) */
+struct sa_map {
+	/*
+	 * Address and size of the mapping.
+	 */
+	unsigned char *addr;
+	size_t size;
+	/*
+	 * Current position in file.
+	 */
+	size_t pos;
+	/*
+	 * File descriptor of file, or -1 if no file is mapped.
+	 */
+	int fd;
+};
 
 /*
  * Base magical number for activities.
@@ -582,13 +900,19 @@ struct file_activity {
 	 * given activity (nr of "long long", nr of "long" and nr of "int").
 	 */
 	unsigned int types_nr[3];
+	/*
+	 * Number of records between two saves of this activity's statistics.
+	 * 0 or 1 means that they are saved in every record. Otherwise
+	 * @has_nr is TRUE and NR_NOT_DUE is saved in the other records.
+	 */
+	unsigned int period;
 };
 
 #define FILE_ACTIVITY_SIZE	(sizeof(struct file_activity))
 #define MAX_FILE_ACTIVITY_SIZE	1024	/* Used for sanity check */
 #define FILE_ACTIVITY_ULL_NR	0	/* Nr of unsigned long long in file_activity structure */
 #define FILE_ACTIVITY_UL_NR	0	/* Nr of unsigned long in file_activity structure */
-#define FILE_ACTIVITY_U_NR	9	/* Nr of [unsigned] int in file_activity structure */
+#define FILE_ACTIVITY_U_NR	10	/* Nr of [unsigned] int in file_activity structure */
 
 
 /* Record type */
@@ -627,6 +951,20 @@ struct record_header {
 	 * Timestamp (number of seconds since the epoch).
 	 */
 	unsigned long long ust_time;
+	/*
+	 * Microseconds part of the timestamp (0-999999).
+	 */
+	unsigned int ust_usec;
+	/*
+	 * Lateness of the sample in microseconds, ie. time elapsed between
+	 * the expected sampling time and the moment statistics were read.
+	 */
+	unsigned int late_usec;
+	/*
+	 * Time elapsed (in microseconds) between the beginning of the first
+	 * activity read and the end of the last one.
+	 */
+	unsigned int spread_usec;
 	/*
 	 * Record type: R_STATS, R_RESTART,...
 	 */
@@ -644,7 +982,7 @@ struct record_header {
 #define MAX_RECORD_HEADER_SIZE	512	/* Used for sanity check */
 #define RECORD_HEADER_ULL_NR	2	/* Nr of unsigned long long in record_header structure */
 #define RECORD_HEADER_UL_NR	0	/* Nr of unsigned long in record_header structure */
-#define RECORD_HEADER_U_NR	0	/* Nr of unsigned int in record_header structure */
+#define RECORD_HEADER_U_NR	3	/* Nr of unsigned int in record_header structure */
 
 
 /*
@@ -710,6 +1048,13 @@ struct record_header {
  * be counted, even if the activity is not collected.
  */
 #define AO_ALWAYS_COUNTED	0x200
+/*
+ * Indicate that the number of items for this activity is found by reading
+ * its statistics (buffer growing as needed) rather than by calling its
+ * count function. Then the number of items read last time is reused when
+ * the file is rotated.
+ */
+#define AO_COUNT_BY_READ	0x400
 
 #define IS_COLLECTED(m)		(((m) & AO_COLLECTED)        == AO_COLLECTED)
 #define IS_SELECTED(m)		(((m) & AO_SELECTED)         == AO_SELECTED)
@@ -721,10 +1066,78 @@ struct record_header {
 #define IS_MATRIX(m)		(((m) & AO_MATRIX)           == AO_MATRIX)
 #define HAS_LIST_ON_CMDLINE(m)	(((m) & AO_LIST_ON_CMDLINE)  == AO_LIST_ON_CMDLINE)
 #define ALWAYS_COUNT_ITEMS(m)	(((m) & AO_ALWAYS_COUNTED)   == AO_ALWAYS_COUNTED)
+#define COUNT_BY_READ(m)	(((m) & AO_COUNT_BY_READ)    == AO_COUNT_BY_READ)
+
+/* TRUE if statistics of activity @a in @buf[c] have been carried forward */
+#define IS_CARRIED(a,c)		(!(a)->nr[c] && ((a)->nr_carried[c] > 0))
 
 #define _buf0	buf[0]
 #define _nr0	nr[0]
 
+/*
+ * Statistics of an activity as saved in last record of a delta encoded
+ * file (see FH_F_DELTA). They are used to encode or decode next record.
+ */
+struct enc_state {
+	/*
+	 * Statistics structures, as written in file.
+	 */
+	void *buf;
+	/*
+	 * Size allocated for @buf (in bytes).
+	 */
+	size_t size;
+	/*
+	 * Number of structures (items x sub-items) in @buf.
+	 */
+	__nr_t nr;
+};
+
+/* Byte swap of consecutive fields of a structure (see struct remap_plan) */
+struct plan_swap {
+	/*
+	 * Offset of first field, number of fields, size of each field
+	 * (4 or 8 bytes) and distance between two consecutive fields.
+	 */
+	unsigned int off;
+	unsigned int nr;
+	unsigned int width;
+	unsigned int stride;
+};
+
+/* Move of fields of a structure to their new position (see struct remap_plan) */
+struct plan_move {
+	/*
+	 * Offsets of destination and source, and number of bytes moved.
+	 */
+	unsigned int dst;
+	unsigned int src;
+	unsigned int len;
+	/*
+	 * Offset and number of bytes to zero (fields which don't exist
+	 * in file).
+	 */
+	unsigned int zoff;
+	unsigned int zlen;
+};
+
+/*
+ * Operations needed to convert each statistics structure of an activity,
+ * as read from file, to that expected by current sysstat version. They are
+ * those done by swap_struct() then remap_struct(), worked out once for all
+ * when the list of activities of the file is read (see compile_remap_plan()).
+ */
+struct remap_plan {
+	struct plan_swap swap[3];
+	struct plan_move move[3];
+	int swap_nr;
+	int move_nr;
+	/*
+	 * TRUE if structures read from file cannot be remapped.
+	 */
+	int invalid;
+};
+
 /* Structure used to define a bitmap needed by an activity */
 struct act_bitmap {
 	/*
@@ -954,6 +1367,34 @@ struct activity {
 	 * compute average).
 	 */
 	void *buf[3];
+	/*
+	 * Size in bytes of each of the buffers @buf[*]. These buffers are
+	 * allocated in a single block (see resize_act_buffers()).
+	 */
+	size_t buf_size;
+	/*
+	 * Number of items saved in @buf[*] when current record didn't contain
+	 * statistics for this activity (@nr[*] is then 0). In this case, @buf[*]
+	 * contains the last statistics read for it.
+	 */
+	__nr_t nr_carried[3];
+	/*
+	 * Uptime (in 1/100th of a second) of the record where the statistics
+	 * saved in @buf[*] have been read.
+	 */
+	unsigned long long uptime_cs[3];
+	/*
+	 * Statistics saved in last record of a delta encoded file.
+	 * [0]: Used to encode (sadc) or decode (sar, sadf) next record.
+	 * [1]: Copy of [0] saved along with the position in file (used by sar
+	 * and sadf when they read the file again from that position).
+	 */
+	struct enc_state enc[2];
+	/*
+	 * Conversion of statistics structures read from file (used by sar
+	 * and sadf).
+	 */
+	struct remap_plan plan;
 	/*
 	 * Bitmap for activities that need one. Such a bitmap is needed by activity
 	 * if @bitmap is not NULL.
@@ -1110,6 +1551,12 @@ struct report_format {
 /* Block size used to allocate arrays for graphs data */
 #define CHUNKSIZE	4096
 
+/*
+ * Max number of points (or rectangles) displayed on average per pixel
+ * column of a graph. Graphs with more points are decimated.
+ */
+#define SVG_POINTS_PER_PX	4
+
 /* Maximum number of views on a single row */
 #define MAX_VIEWS_ON_A_ROW	6
 
@@ -1195,6 +1642,8 @@ __nr_t count_new_filesystem
 	(struct activity *, int);
 __nr_t count_new_fchost
 	(struct activity *, int);
+__nr_t count_new_cgroup
+	(struct activity *, int);
 __nr_t count_new_disk
 	(struct activity *, int);
 
@@ -1223,6 +1672,12 @@ __nr_t wrap_get_filesystem_nr
 	(struct activity *);
 __nr_t wrap_get_fchost_nr
 	(struct activity *);
+__nr_t wrap_get_self_nr
+	(struct activity *);
+__nr_t wrap_get_cgroup_nr
+	(struct activity *);
+__nr_t wrap_get_psi_nr
+	(struct activity *);
 
 /* Functions used to read activities statistics */
 __read_funct_t wrap_read_stat_cpu
@@ -1303,22 +1758,61 @@ __read_funct_t wrap_read_fchost
 	(struct activity *);
 __read_funct_t wrap_read_softnet
 	(struct activity *);
+__read_funct_t wrap_read_self
+	(struct activity *);
+__read_funct_t wrap_read_cgroup
+	(struct activity *);
+__read_funct_t wrap_read_psi
+	(struct activity *);
 
 /* Other functions */
 int check_alt_sa_dir
 	(char *, int, int);
+int commit_blk
+	(struct sa_blk *, unsigned long long, int);
+int decode_act_stats
+	(struct enc_state *, unsigned int [], size_t, const unsigned char *, size_t, __nr_t);
+size_t encode_act_stats
+	(struct enc_state *, unsigned int [], size_t, const void *, __nr_t, int,
+	 unsigned char *);
 void enum_version_nr
 	(struct file_magic *);
+int flush_blk
+	(struct sa_blk *);
+void free_act_buffers
+	(struct activity *);
+char *get_activity_name
+	(struct activity * [], unsigned int);
+size_t get_enc_bound
+	(unsigned int [], size_t, __nr_t);
 int get_activity_nr
 	(struct activity * [], unsigned int, int);
 int get_activity_position
 	(struct activity * [], unsigned int, int);
+off_t get_blk_end
+	(int, off_t);
 void handle_invalid_sa_file
 	(int, struct file_magic *, char *, int);
+void init_blk
+	(struct sa_blk *, int, off_t, int);
+size_t lz_compress
+	(const unsigned char *, size_t, unsigned char *);
+size_t lz_compress_bound
+	(size_t);
+int lz_decompress
+	(const unsigned char *, size_t, unsigned char *, size_t);
+int read_blk_header
+	(int, off_t, struct blk_header *, int);
 void print_collect_error
 	(void);
+void *resize_act_buffers
+	(struct activity *, int, size_t);
 int set_default_file
 	(char *, int, int);
+void swap_blk_header
+	(struct blk_header *);
+void write_blk_data
+	(struct sa_blk *, const void *, size_t);
 int write_all
 	(int, const void *, int);
 
@@ -1329,6 +1823,10 @@ void allocate_bitmaps
 	(struct activity * []);
 void allocate_structures
 	(struct activity * []);
+int apply_remap_plan
+	(struct activity *, void *, __nr_t);
+void carry_forward_stats
+	(struct activity *, int, unsigned long long);
 int check_disk_reg
 	(struct activity *, int, int, int);
 void check_file_actlst
@@ -1338,8 +1836,12 @@ int check_net_dev_reg
 	(struct activity *, int, int, int);
 int check_net_edev_reg
 	(struct activity *, int, int, int);
+void compile_remap_plan
+	(struct activity *, int, int);
 double compute_ifutil
 	(struct stats_net_dev *, double, double);
+void copy_enc_states
+	(struct activity * [], int, int);
 void copy_structures
 	(struct activity * [], unsigned int [],	struct record_header [], int, int);
 int datecmp
@@ -1362,10 +1864,18 @@ void get_global_soft_statistics
 	(struct activity *, int, int, unsigned int, unsigned char []);
 void get_itv_value
 	(struct record_header *, struct record_header *, unsigned long long *);
+struct stats_cgroup *get_prev_cgroup
+	(struct activity *, int, struct stats_cgroup *);
+void index_cgroups
+	(struct activity *, int);
 void init_custom_color_palette
 	(void);
 int next_slice
-	(unsigned long long, unsigned long long, int, long);
+	(unsigned long long, unsigned long long, int, long, int);
+void open_blk_reader
+	(int, unsigned int, int);
+void open_map_reader
+	(int);
 void parse_sa_devices
 	(char *, struct activity *, int, int *, int);
 int parse_sar_opt
@@ -1390,9 +1900,13 @@ int print_special_record
 	(struct record_header *, unsigned int, struct tstamp *, struct tstamp *,
 	 int, int, struct tm *, struct tm *, char *, int, struct file_magic *,
 	 struct file_header *, struct activity * [], struct report_format *, int, int);
+int read_enc_len
+	(int, unsigned int *, int, int);
+int read_enc_stats
+	(int, struct activity *, int, __nr_t, int, char *, struct file_magic *, int);
 int read_file_stat_bunch
-	(struct activity * [], int, int, int, struct file_activity *, int, int,
-	 char *, struct file_magic *, int);
+	(struct activity * [], int, int, int, struct file_activity *, unsigned int,
+	 int, int, char *, struct file_magic *, int, unsigned long long);
 __nr_t read_nr_value
 	(int, char *, struct file_magic *, int, int, int);
 int read_record_hdr
@@ -1400,16 +1914,25 @@ int read_record_hdr
 	 int, size_t);
 void reallocate_all_buffers
 	(struct activity *, __nr_t);
+int remap_struct
+	(unsigned int [], unsigned int [], void *, unsigned int, unsigned int, size_t);
 void replace_nonprintable_char
 	(int, char *);
 int sa_fread
 	(int, void *, size_t, int, int);
+int sa_fseek
+	(int, off_t);
+off_t sa_ftell
+	(int);
 int sa_get_record_timestamp_struct
 	(unsigned int, struct record_header *, struct tm *, struct tm *);
 int sa_open_read_magic
 	(int *, char *, struct file_magic *, int, int *, int);
 int search_list_item
 	(struct sa_item *, char *);
+int seek_time_index
+	(int, char *, struct activity * [], struct file_header *, unsigned int, int,
+	 struct tstamp *, struct tstamp *, int, int);
 void select_all_activities
 	(struct activity * []);
 void select_default_activity
@@ -29,8 +29,11 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <libgen.h>
+#include <setjmp.h>
+#include <signal.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <ctype.h>
 
 #include "version.h"
@@ -85,6 +88,28 @@ int get_activity_position(struct activity *act[], unsigned int act_flag, int sto
 	return -1;
 }
 
+/*
+ ***************************************************************************
+ * Get name of an activity.
+ *
+ * IN:
+ * @act		Array of activities.
+ * @act_flag	Activity flag to look for.
+ *
+ * RETURNS:
+ * Name of activity (e.g. "A_CPU"), or NULL if not found.
+ ***************************************************************************
+ */
+char *get_activity_name(struct activity *act[], unsigned int act_flag)
+{
+	int p;
+
+	if ((p = get_activity_position(act, act_flag, RESUME_IF_NOT_FOUND)) < 0)
+		return NULL;
+
+	return act[p]->name;
+}
+
 /*
  ***************************************************************************
  * Count number of activities with given option.
@@ -325,17 +350,40 @@ void display_sa_file_version(FILE *st, struct file_magic *file_magic)
 void handle_invalid_sa_file(int fd, struct file_magic *file_magic, char *file,
 			    int n)
 {
+	unsigned short fmt;
+
 	fprintf(stderr, _("Invalid system activity file: %s\n"), file);
 
 	if (n == FILE_MAGIC_SIZE) {
 		if ((file_magic->sysstat_magic == SYSSTAT_MAGIC) || (file_magic->sysstat_magic == SYSSTAT_MAGIC_SWAPPED)) {
-			/* This is a sysstat file, but this file has an old format */
+			/* This is a sysstat file, but this file has an old (or new) format */
 			display_sa_file_version(stderr, file_magic);
 
-			fprintf(stderr,
-				_("Current sysstat version cannot read the format of this file (%#x)\n"),
-				file_magic->sysstat_magic == SYSSTAT_MAGIC ?
-				file_magic->format_magic : __builtin_bswap16(file_magic->format_magic));
+			fmt = file_magic->sysstat_magic == SYSSTAT_MAGIC ?
+			      file_magic->format_magic : __builtin_bswap16(file_magic->format_magic);
+
+			if (fmt > FORMAT_MAGIC) {
+				fprintf(stderr,
+					_("This file has been created by a more recent sysstat version (format %#x)\n"),
+					fmt);
+			}
+			else if (fmt < FORMAT_MAGIC) {
+#ifdef SOURCE_SADC
+				fprintf(stderr,
+					_("Current sysstat version cannot append data to a file with this format (%#x)\n"),
+					fmt);
+#else
+				fprintf(stderr,
+					_("Current sysstat version cannot read the format of this file (%#x)\n"),
+					fmt);
+#endif
+				if (fmt >= FORMAT_MAGIC_2171) {
+					/* sadf -c can convert this file */
+					fprintf(stderr,
+						_("Try to convert it to current format. Enter:\n\n"));
+					fprintf(stderr, "sadf -c %s > %s.new\n\n", file, file);
+				}
+			}
 		}
 	}
 
@@ -429,766 +477,1772 @@ int write_all(int fd, const void *buf, int nr_bytes)
 	return offset;
 }
 
-#ifndef SOURCE_SADC
 /*
  ***************************************************************************
- * Allocate structures.
+ * Resize the buffers of an activity. The @nr_buf buffers used by an
+ * activity (buf[0] for sadc, buf[0] to buf[2] for sar and sadf) are laid
+ * out one after the other in a single block of memory: They are allocated
+ * at once and buf[curr] and buf[prev] are close to each other.
+ * The contents of each buffer are kept (up to the new size). Only space
+ * added at the end of each buffer is initialized.
  *
  * IN:
- * @act	Array of activities.
+ * @a		Activity whose buffers need to be resized.
+ * @nr_buf	Number of buffers used for the activity (1 to 3).
+ * @size	New size of each buffer, in bytes.
+ *
+ * OUT:
+ * @a		Activity with its buffers resized.
+ *
+ * RETURNS:
+ * Pointer on the first buffer.
  ***************************************************************************
  */
-void allocate_structures(struct activity *act[])
+void *resize_act_buffers(struct activity *a, int nr_buf, size_t size)
 {
-	int i, j;
+	char *blk = (char *) a->buf[0];
+	size_t old_size = a->buf_size;
+	int j;
 
-	for (i = 0; i < NR_ACT; i++) {
-		if (act[i]->nr_ini > 0) {
-			for (j = 0; j < 3; j++) {
-				SREALLOC(act[i]->buf[j], void,
-						(size_t) act[i]->msize * (size_t) act[i]->nr_ini * (size_t) act[i]->nr2);
-			}
-			act[i]->nr_allocated = act[i]->nr_ini;
+	if (!size || (size == old_size))
+		return a->buf[0];
+
+	if (size < old_size) {
+		/* Shrink: Move buffers towards the beginning of the block first */
+		for (j = 1; j < nr_buf; j++) {
+			memmove(blk + j * size, blk + j * old_size, size);
+		}
+		SREALLOC(blk, char, size * (size_t) nr_buf);
+	}
+	else if (!old_size) {
+		/* New block (init'ed by SREALLOC()) */
+		SREALLOC(blk, char, size * (size_t) nr_buf);
+	}
+	else {
+		/* Grow: Move buffers towards the end of the new block, last one first */
+		SREALLOC(blk, char, size * (size_t) nr_buf);
+		for (j = nr_buf - 1; j > 0; j--) {
+			memmove(blk + j * size, blk + j * old_size, old_size);
+		}
+		for (j = 0; j < nr_buf; j++) {
+			memset(blk + j * size + old_size, 0, size - old_size);
 		}
 	}
+
+	for (j = 0; j < 3; j++) {
+		a->buf[j] = j < nr_buf ? blk + j * size : NULL;
+	}
+	a->buf_size = size;
+
+	return a->buf[0];
 }
 
 /*
  ***************************************************************************
- * Free structures.
+ * Free the buffers of an activity (see resize_act_buffers()).
  *
  * IN:
- * @act	Array of activities.
+ * @a	Activity whose buffers need to be freed.
  ***************************************************************************
  */
-void free_structures(struct activity *act[])
+void free_act_buffers(struct activity *a)
 {
-	int i, j;
+	int j;
 
-	for (i = 0; i < NR_ACT; i++) {
-		if (act[i]->nr_allocated > 0) {
-			for (j = 0; j < 3; j++) {
-				if (act[i]->buf[j]) {
-					free(act[i]->buf[j]);
-					act[i]->buf[j] = NULL;
-				}
-			}
-			act[i]->nr_allocated = 0;
+	if (a->buf[0]) {
+		free(a->buf[0]);
+	}
+	for (j = 0; j < 3; j++) {
+		a->buf[j] = NULL;
+	}
+	a->buf_size = 0;
+	a->nr_allocated = 0;
+
+	for (j = 0; j < 2; j++) {
+		if (a->enc[j].buf) {
+			free(a->enc[j].buf);
 		}
+		memset(&a->enc[j], 0, sizeof(struct enc_state));
 	}
 }
 
 /*
  ***************************************************************************
- * Reallocate all the buffers for a given activity.
+ * Save an unsigned 64-bit value as a varint (7 bits per byte, least
+ * significant bits first, most significant bit set if more bytes follow).
  *
  * IN:
- * @a		Activity whose buffers need to be reallocated.
- * @nr_min	Minimum number of items that the new buffers should be able
- *		to receive.
+ * @out		Buffer where the value will be saved.
+ * @v		Value to save.
+ *
+ * RETURNS:
+ * Pointer on the byte following the varint in @out.
  ***************************************************************************
  */
-void reallocate_all_buffers(struct activity *a, __nr_t nr_min)
+static unsigned char *put_varint(unsigned char *out, uint64_t v)
 {
-	int j;
-	size_t nr_realloc;
-
-	if (nr_min <= 0) {
-		nr_min = 1;
-	}
-	if (!a->nr_allocated) {
-		nr_realloc = nr_min;
-	}
-	else {
-		nr_realloc = a->nr_allocated;
-		do {
-			nr_realloc = nr_realloc * 2;
-		}
-		while (nr_realloc < nr_min);
+	while (v >= 0x80) {
+		*out++ = (unsigned char) (v | 0x80);
+		v >>= 7;
 	}
+	*out++ = (unsigned char) v;
 
-	for (j = 0; j < 3; j++) {
-		SREALLOC(a->buf[j], void,
-			(size_t) a->msize * nr_realloc * (size_t) a->nr2);
-		/* Init additional space which has been allocated */
-		if (a->nr_allocated) {
-			memset(a->buf[j] + a->msize * a->nr_allocated * a->nr2, 0,
-			       (size_t) a->msize * (size_t) (nr_realloc - a->nr_allocated) * (size_t) a->nr2);
-		}
-	}
-
-	a->nr_allocated = nr_realloc;
+	return out;
 }
 
 /*
-  ***************************************************************************
-  * Try to get device real name from sysfs tree.
-  *
-  * IN:
-  * @major	Major number of the device.
-  * @minor	Minor number of the device.
-  *
-  * RETURNS:
-  * The name of the device, which may be the real name (as it appears in /dev)
-  * or NULL.
-  ***************************************************************************
-  */
-char *get_devname_from_sysfs(unsigned int major, unsigned int minor)
+ ***************************************************************************
+ * Read an unsigned 64-bit value saved as a varint (see put_varint()).
+ *
+ * IN:
+ * @in		Buffer containing the varint.
+ * @end		End of buffer.
+ *
+ * OUT:
+ * @v		Value read.
+ *
+ * RETURNS:
+ * Pointer on the byte following the varint in @in, or NULL if the varint
+ * is not valid.
+ ***************************************************************************
+ */
+static const unsigned char *get_varint(const unsigned char *in, const unsigned char *end,
+				       uint64_t *v)
 {
-	static char link[32], target[PATH_MAX];
-	char *devname;
-	ssize_t r;
-
-	snprintf(link, 32, "%s/%u:%u", SYSFS_DEV_BLOCK, major, minor);
+	int shift;
 
-	/* Get full path to device knowing its major and minor numbers */
-	r = readlink(link, target, PATH_MAX);
-	if (r <= 0 || r >= PATH_MAX) {
-		return (NULL);
+	*v = 0;
+	for (shift = 0; (in < end) && (shift < 64); shift += 7) {
+		*v |= (uint64_t) (*in & 0x7f) << shift;
+		if (!(*in++ & 0x80))
+			return in;
 	}
 
-	target[r] = '\0';
+	return NULL;
+}
 
-	/* Get device name */
-	devname = basename(target);
-	if (!devname || strnlen(devname, FILENAME_MAX) == 0) {
-		return (NULL);
-	}
+/* Zigzag encoding: Small negative differences give small unsigned values */
+#define ZIGZAG_ENC(d)	(((d) << 1) ^ (uint64_t) ((int64_t) (d) >> 63))
+#define ZIGZAG_DEC(z)	(((z) >> 1) ^ (uint64_t) -(int64_t) ((z) & 1))
 
-	return (devname);
+/*
+ ***************************************************************************
+ * Get the layout of a structure with statistics as saved in file: Number
+ * of 8-byte fields ([unsigned] long long and long integers), number of
+ * 4-byte fields ([unsigned] integers) then number of remaining bytes.
+ * If the structure description is inconsistent with its size, the whole
+ * structure is considered as remaining bytes.
+ *
+ * IN:
+ * @types_nr	Structure description as read from file.
+ * @st_size	Size of the structure as read from file.
+ *
+ * OUT:
+ * @n8		Number of 8-byte fields.
+ * @n4		Number of 4-byte fields.
+ * @tail	Number of remaining bytes.
+ ***************************************************************************
+ */
+static void get_enc_layout(unsigned int types_nr[], size_t st_size,
+			   size_t *n8, size_t *n4, size_t *tail)
+{
+	if (MAP_SIZE(types_nr) > st_size) {
+		*n8 = *n4 = 0;
+		*tail = st_size;
+		return;
+	}
+	/* NB: UL_ALIGNMENT_WIDTH is 8 even for data from a 32-bit machine */
+	*n8 = types_nr[0] + types_nr[1];
+	*n4 = types_nr[2];
+	*tail = st_size - MAP_SIZE(types_nr);
 }
 
 /*
  ***************************************************************************
- * Get device real name if possible.
- * Warning: This routine may return a bad name on 2.4 kernels where
- * disk activities are read from /proc/stat.
+ * Get the maximum size of a block containing encoded statistics.
  *
  * IN:
- * @major	Major number of the device.
- * @minor	Minor number of the device.
- * @pretty	TRUE if the real name of the device (as it appears in /dev)
- * 		should be returned.
+ * @types_nr	Structure description as read from file.
+ * @st_size	Size of a structure as read from file.
+ * @nr		Number of structures (items x sub-items).
  *
  * RETURNS:
- * The name of the device, which may be the real name (as it appears in /dev)
- * or a string with the following format devM-n.
+ * Maximum size of the block (in bytes).
  ***************************************************************************
  */
-char *get_devname(unsigned int major, unsigned int minor, int pretty)
+size_t get_enc_bound(unsigned int types_nr[], size_t st_size, __nr_t nr)
 {
-	static char buf[32];
-	char *name;
-
-	snprintf(buf, 32, "dev%u-%u", major, minor);
+	size_t n8, n4, tail;
 
-	if (!pretty)
-		return (buf);
+	get_enc_layout(types_nr, st_size, &n8, &n4, &tail);
 
-	name = get_devname_from_sysfs(major, minor);
-	if (name != NULL)
-		return (name);
+	return 1 + (size_t) nr * (n8 * 10 + n4 * 5 + 1 + tail);
+}
 
-	name = ioc_name(major, minor);
-	if ((name != NULL) && strcmp(name, K_NODEV))
-		return (name);
+/*
+ ***************************************************************************
+ * Make sure that the buffer of an encoding state can receive @nr
+ * structures. Structures beyond those already present are set to 0.
+ *
+ * IN:
+ * @es		Encoding state.
+ * @st_size	Size of a structure.
+ * @nr		Number of structures.
+ ***************************************************************************
+ */
+static void grow_enc_state(struct enc_state *es, size_t st_size, __nr_t nr)
+{
+	size_t size = st_size * (size_t) nr;
+	size_t used = es->nr > 0 ? st_size * (size_t) es->nr : 0;
 
-	return (buf);
+	if (size > es->size) {
+		SREALLOC(es->buf, char, size);
+		es->size = size;
+	}
+	if (size > used) {
+		memset((char *) es->buf + used, 0, size - used);
+	}
 }
 
 /*
  ***************************************************************************
- * Check if we are close enough to desired interval.
+ * Encode statistics structures of an activity (see FH_F_DELTA). Each
+ * field is saved as the difference with the same field of the same item
+ * in the structures previously encoded, unless a keyframe is requested
+ * (or there are no previous structures).
+ * Data are encoded as they are written in file: Encoding doesn't depend
+ * on the endianness or version of the structures.
  *
  * IN:
- * @uptime_ref	Uptime used as reference. This is the system uptime for the
- *		first sample statistics, or the first system uptime after a
- *		LINUX RESTART (in 1/100th of a second).
- * @uptime	Current system uptime (in 1/100th of a second).
- * @reset	TRUE if @last_uptime should be reset with @uptime_ref.
- * @interval	Interval of time.
+ * @es		Encoding state (structures previously encoded).
+ * @types_nr	Structure description as written in file.
+ * @st_size	Size of a structure as written in file.
+ * @st		Structures to encode.
+ * @nr		Number of structures (items x sub-items). Must be > 0.
+ * @keyframe	TRUE if a keyframe should be written.
+ * @out		Buffer where encoded block will be saved. Its size must be
+ *		at least that given by get_enc_bound().
+ *
+ * OUT:
+ * @es		Encoding state updated with structures just encoded.
  *
  * RETURNS:
- * 1 if we are actually close enough to desired interval, 0 otherwise.
+ * Size of the encoded block (in bytes).
  ***************************************************************************
-*/
-int next_slice(unsigned long long uptime_ref, unsigned long long uptime,
-	       int reset, long interval)
+ */
+size_t encode_act_stats(struct enc_state *es, unsigned int types_nr[], size_t st_size,
+			const void *st, __nr_t nr, int keyframe, unsigned char *out)
 {
-	unsigned long file_interval, entry;
-	static unsigned long long last_uptime = 0;
-	int min, max, pt1, pt2;
-	double f;
+	const char *cur, *prev;
+	unsigned char *pos = out;
+	size_t n8, n4, tail, k;
+	uint64_t a, b, d;
+	uint32_t a4, b4;
+	__nr_t j;
 
-	/* uptime is expressed in 1/100th of a second */
-	if (!last_uptime || reset) {
-		last_uptime = uptime_ref;
+	get_enc_layout(types_nr, st_size, &n8, &n4, &tail);
+
+	if (es->nr <= 0) {
+		keyframe = TRUE;
 	}
+	*pos++ = keyframe ? ENC_KEYFRAME : ENC_DELTA;
 
-	/* Interval cannot be greater than 0xffffffff here */
-	f = ((double) ((uptime - last_uptime) & 0xffffffff)) / 100;
-	file_interval = (unsigned long) f;
-	if ((f * 10) - (file_interval * 10) >= 5) {
-		file_interval++; /* Rounding to correct value */
+	if (keyframe) {
+		es->nr = 0;
 	}
+	grow_enc_state(es, st_size, nr);
 
-	last_uptime = uptime;
+	for (j = 0; j < nr; j++) {
+		cur  = (const char *) st + j * st_size;
+		prev = (const char *) es->buf + j * st_size;
 
-	/*
-	 * A few notes about the "algorithm" used here to display selected entries
-	 * from the system activity file (option -f with -i flag):
-	 * Let 'Iu' be the interval value given by the user on the command line,
-	 *     'If' the interval between current and previous line in the system
-	 * activity file,
-	 * and 'En' the nth entry (identified by its time stamp) of the file.
-	 * We choose In = [ En - If/2, En + If/2 [ if If is even,
-	 *        or In = [ En - If/2, En + If/2 ] if not.
-	 * En will be displayed if
-	 *       (Pn * Iu) or (P'n * Iu) belongs to In
-	 * with  Pn = En / Iu and P'n = En / Iu + 1
-	 */
-	f = ((double) ((uptime - uptime_ref) & 0xffffffff)) / 100;
-	entry = (unsigned long) f;
-	if ((f * 10) - (entry * 10) >= 5) {
-		entry++;
+		for (k = 0; k < n8; k++) {
+			memcpy(&a, cur  + k * 8, 8);
+			memcpy(&b, prev + k * 8, 8);
+			d = a - b;
+			pos = put_varint(pos, ZIGZAG_ENC(d));
+		}
+		for (k = 0; k < n4; k++) {
+			memcpy(&a4, cur  + n8 * 8 + k * 4, 4);
+			memcpy(&b4, prev + n8 * 8 + k * 4, 4);
+			d = (uint64_t) (int64_t) (int32_t) (a4 - b4);
+			pos = put_varint(pos, ZIGZAG_ENC(d));
+		}
+		if (tail) {
+			if (!memcmp(cur + st_size - tail, prev + st_size - tail, tail)) {
+				*pos++ = 0;
+			}
+			else {
+				*pos++ = 1;
+				memcpy(pos, cur + st_size - tail, tail);
+				pos += tail;
+			}
+		}
 	}
 
-	min = entry - (file_interval / 2);
-	max = entry + (file_interval / 2) + (file_interval & 0x1);
-	pt1 = (entry / interval) * interval;
-	pt2 = ((entry / interval) + 1) * interval;
+	/* Structures just encoded will be used to encode next ones */
+	memcpy(es->buf, st, st_size * (size_t) nr);
+	es->nr = nr;
 
-	return (((pt1 >= min) && (pt1 < max)) || ((pt2 >= min) && (pt2 < max)));
+	return (size_t) (pos - out);
 }
 
 /*
  ***************************************************************************
- * Use time stamp to fill tstamp structure.
+ * Decode statistics structures of an activity encoded with
+ * encode_act_stats().
  *
  * IN:
- * @timestamp	Timestamp to decode (format: HH:MM:SS).
+ * @es		Encoding state (structures previously decoded).
+ * @types_nr	Structure description as read from file.
+ * @st_size	Size of a structure as read from file.
+ * @in		Encoded block.
+ * @len		Size of the encoded block.
+ * @nr		Number of structures (items x sub-items). Must be > 0.
  *
  * OUT:
- * @tse		Structure containing the decoded timestamp.
+ * @es		Encoding state with the structures decoded (in @es->buf).
  *
  * RETURNS:
- * 0 if the timestamp has been successfully decoded, 1 otherwise.
+ * -1 if the block is invalid, 0 otherwise.
  ***************************************************************************
  */
-int decode_timestamp(char timestamp[], struct tstamp *tse)
+int decode_act_stats(struct enc_state *es, unsigned int types_nr[], size_t st_size,
+		     const unsigned char *in, size_t len, __nr_t nr)
 {
-	timestamp[2] = timestamp[5] = '\0';
-	tse->tm_sec  = atoi(&timestamp[6]);
-	tse->tm_min  = atoi(&timestamp[3]);
-	tse->tm_hour = atoi(timestamp);
+	const unsigned char *end = in + len;
+	char *cur;
+	size_t n8, n4, tail, k;
+	uint64_t a, z;
+	uint32_t a4;
+	__nr_t j;
+
+	if (!len)
+		return -1;
 
-	if ((tse->tm_sec < 0) || (tse->tm_sec > 59) ||
-	    (tse->tm_min < 0) || (tse->tm_min > 59) ||
-	    (tse->tm_hour < 0) || (tse->tm_hour > 23))
-		return 1;
+	get_enc_layout(types_nr, st_size, &n8, &n4, &tail);
 
-	tse->use = TRUE;
+	if (*in == ENC_KEYFRAME) {
+		es->nr = 0;
+	}
+	else if ((*in != ENC_DELTA) || (es->nr <= 0))
+		/* Unknown block type, or no previous structures to apply deltas to */
+		return -1;
+	in++;
 
-	return 0;
+	grow_enc_state(es, st_size, nr);
+
+	/* Structures are decoded in place: Each field only depends on its previous value */
+	for (j = 0; j < nr; j++) {
+		cur = (char *) es->buf + j * st_size;
+
+		for (k = 0; k < n8; k++) {
+			if ((in = get_varint(in, end, &z)) == NULL)
+				return -1;
+			memcpy(&a, cur + k * 8, 8);
+			a += ZIGZAG_DEC(z);
+			memcpy(cur + k * 8, &a, 8);
+		}
+		for (k = 0; k < n4; k++) {
+			if ((in = get_varint(in, end, &z)) == NULL)
+				return -1;
+			memcpy(&a4, cur + n8 * 8 + k * 4, 4);
+			a4 += (uint32_t) ZIGZAG_DEC(z);
+			memcpy(cur + n8 * 8 + k * 4, &a4, 4);
+		}
+		if (tail) {
+			if (in >= end)
+				return -1;
+			if (*in++) {
+				if ((size_t) (end - in) < tail)
+					return -1;
+				memcpy(cur + st_size - tail, in, tail);
+				in += tail;
+			}
+		}
+	}
+	es->nr = nr;
+
+	return (in == end) ? 0 : -1;
 }
 
+/* Size of the hash table used by lz_compress() (log2) */
+#define LZ_HASH_LOG	12
+#define LZ_MIN_MATCH	4
+/* Last match must start at least 12 bytes before the end of data */
+#define LZ_MF_LIMIT	12
+/* Last 5 bytes are always literals */
+#define LZ_LAST_LITERALS	5
+
 /*
  ***************************************************************************
- * Compare two timestamps.
+ * Get the maximum size of data compressed with lz_compress().
  *
  * IN:
- * @rectime	Date and time for current sample.
- * @tse		Timestamp used as reference.
+ * @len		Size of data to compress.
  *
  * RETURNS:
- * A positive value if @rectime is greater than @tse,
- * a negative one otherwise.
+ * Maximum size of compressed data (in bytes).
  ***************************************************************************
  */
-int datecmp(struct tm *rectime, struct tstamp *tse)
+size_t lz_compress_bound(size_t len)
 {
-	if (rectime->tm_hour == tse->tm_hour) {
-		if (rectime->tm_min == tse->tm_min)
-			return (rectime->tm_sec - tse->tm_sec);
-		else
-			return (rectime->tm_min - tse->tm_min);
+	return len + len / 255 + 16;
+}
+
+/*
+ ***************************************************************************
+ * Save a length (literals or match) in the extra bytes following a token.
+ *
+ * IN:
+ * @op		Buffer where the length will be saved.
+ * @len		Length minus 15.
+ *
+ * RETURNS:
+ * Pointer on the byte following the length in @op.
+ ***************************************************************************
+ */
+static unsigned char *lz_put_len(unsigned char *op, size_t len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
 	}
-	else
-		return (rectime->tm_hour - tse->tm_hour);
+	*op++ = (unsigned char) len;
+
+	return op;
 }
 
 /*
  ***************************************************************************
- * Parse a timestamp entered on the command line (hh:mm[:ss]) and decode it.
+ * Compress data using the LZ4 block format: A sequence of tokens, each
+ * one followed by literals then by a match (offset in previous data and
+ * length). Matches are found with a greedy search in a hash table of the
+ * positions of 4-byte sequences already seen.
+ * The whole block is compressed at once: It can be decompressed with
+ * lz_decompress() or with any LZ4 block decoder.
  *
  * IN:
- * @argv		Arguments list.
- * @opt			Index in the arguments list.
- * @def_timestamp	Default timestamp to use.
+ * @src		Data to compress.
+ * @len		Size of data to compress.
+ * @dst		Buffer where compressed data will be saved. Its size must be
+ *		at least that given by lz_compress_bound().
+ *
+ * RETURNS:
+ * Size of compressed data (in bytes).
+ ***************************************************************************
+ */
+size_t lz_compress(const unsigned char *src, size_t len, unsigned char *dst)
+{
+	uint32_t htab[1 << LZ_HASH_LOG];
+	const unsigned char *ip = src, *anchor = src, *ref;
+	const unsigned char *end = src + len;
+	unsigned char *op = dst, *token;
+	uint32_t seq, h;
+	size_t lit, ml;
+	unsigned int misses = 0;
+
+	if (len > LZ_MF_LIMIT) {
+		const unsigned char *mflimit = end - LZ_MF_LIMIT;
+		const unsigned char *matchlimit = end - LZ_LAST_LITERALS;
+
+		memset(htab, 0, sizeof(htab));
+
+		while (ip < mflimit) {
+			memcpy(&seq, ip, 4);
+			h = (seq * 2654435761U) >> (32 - LZ_HASH_LOG);
+			ref = src + htab[h];
+			htab[h] = (uint32_t) (ip - src);
+
+			if ((ref >= ip) || (ip - ref > 0xffff) || memcmp(ref, ip, 4)) {
+				/* No match: Go faster in data that don't compress well */
+				ip += 1 + (misses++ >> 6);
+				continue;
+			}
+			misses = 0;
+
+			/* Extend the match */
+			ml = LZ_MIN_MATCH;
+			while ((ip + ml < matchlimit) && (ip[ml] == ref[ml])) {
+				ml++;
+			}
+
+			/* Write token, literals, offset then match length */
+			lit = ip - anchor;
+			token = op++;
+			if (lit >= 15) {
+				*token = 15 << 4;
+				op = lz_put_len(op, lit - 15);
+			}
+			else {
+				*token = (unsigned char) (lit << 4);
+			}
+			memcpy(op, anchor, lit);
+			op += lit;
+			*op++ = (unsigned char) (ip - ref);
+			*op++ = (unsigned char) ((ip - ref) >> 8);
+			ml -= LZ_MIN_MATCH;
+			if (ml >= 15) {
+				*token |= 15;
+				op = lz_put_len(op, ml - 15);
+			}
+			else {
+				*token |= (unsigned char) ml;
+			}
+
+			ip += ml + LZ_MIN_MATCH;
+			anchor = ip;
+		}
+	}
+
+	/* Last literals */
+	lit = end - anchor;
+	if (lit >= 15) {
+		*op++ = 15 << 4;
+		op = lz_put_len(op, lit - 15);
+	}
+	else {
+		*op++ = (unsigned char) (lit << 4);
+	}
+	memcpy(op, anchor, lit);
+	op += lit;
+
+	return op - dst;
+}
+
+/*
+ ***************************************************************************
+ * Read a length (literals or match) saved in the extra bytes following a
+ * token.
+ *
+ * IN:
+ * @ip		Pointer on current position in compressed data.
+ * @iend	End of compressed data.
+ * @len		Length saved in token.
  *
  * OUT:
- * @tse			Structure containing the decoded timestamp.
+ * @ip		Pointer on the byte following the length.
+ * @len		Total length.
  *
  * RETURNS:
- * 0 if the timestamp has been successfully decoded, 1 otherwise.
+ * -1 if compressed data are invalid, 0 otherwise.
  ***************************************************************************
  */
-int parse_timestamp(char *argv[], int *opt, struct tstamp *tse,
-		    const char *def_timestamp)
+static int lz_get_len(const unsigned char **ip, const unsigned char *iend, size_t *len)
 {
-	char timestamp[9];
+	unsigned char b;
 
-	if (argv[++(*opt)]) {
-		switch (strlen(argv[*opt])) {
+	if (*len < 15)
+		return 0;
 
-			case 5:
-				strncpy(timestamp, argv[(*opt)++], 5);
-				timestamp[5] = '\0';
-				strcat(timestamp, ":00");
-				break;
+	do {
+		if (*ip >= iend)
+			return -1;
+		b = *(*ip)++;
+		*len += b;
+	}
+	while (b == 255);
 
-			case 8:
-				strncpy(timestamp, argv[(*opt)++], 8);
-				break;
+	return 0;
+}
 
-			default:
-				strncpy(timestamp, def_timestamp, 8);
-				break;
+/*
+ ***************************************************************************
+ * Decompress data compressed with lz_compress(). Every length and offset
+ * read from compressed data is checked: Invalid data cannot make us read
+ * or write outside the buffers.
+ *
+ * IN:
+ * @src		Compressed data.
+ * @len		Size of compressed data.
+ * @dst		Buffer where data will be decompressed.
+ * @dst_len	Size of @dst.
+ *
+ * RETURNS:
+ * Size of decompressed data, or -1 if compressed data are invalid.
+ ***************************************************************************
+ */
+int lz_decompress(const unsigned char *src, size_t len, unsigned char *dst, size_t dst_len)
+{
+	const unsigned char *ip = src, *iend = src + len;
+	unsigned char *op = dst, *oend = dst + dst_len, *ref;
+	unsigned char token;
+	size_t lit, ml, offset;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Copy literals */
+		lit = token >> 4;
+		if ((lz_get_len(&ip, iend, &lit) < 0) ||
+		    (lit > (size_t) (iend - ip)) || (lit > (size_t) (oend - op)))
+			return -1;
+		memcpy(op, ip, lit);
+		ip += lit;
+		op += lit;
+
+		if (ip == iend)
+			/* Last sequence has no match */
+			break;
+
+		/* Copy match. It may overlap current position */
+		if (iend - ip < 2)
+			return -1;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (!offset || (offset > (size_t) (op - dst)))
+			return -1;
+		ml = token & 15;
+		if (lz_get_len(&ip, iend, &ml) < 0)
+			return -1;
+		ml += LZ_MIN_MATCH;
+		if (ml > (size_t) (oend - op))
+			return -1;
+		for (ref = op - offset; ml; ml--) {
+			*op++ = *ref++;
 		}
-	} else {
-		strncpy(timestamp, def_timestamp, 8);
 	}
-	timestamp[8] = '\0';
 
-	return decode_timestamp(timestamp, tse);
+	return op - dst;
 }
 
 /*
  ***************************************************************************
- * Set interval value.
+ * Swap bytes of the fields of a block header (see FH_F_COMPRESS).
  *
  * IN:
- * @record_hdr_curr	Record with current sample statistics.
- * @record_hdr_prev	Record with previous sample statistics.
+ * @bh		Block header.
+ ***************************************************************************
+ */
+void swap_blk_header(struct blk_header *bh)
+{
+	bh->first_ust_time = __builtin_bswap64(bh->first_ust_time);
+	bh->last_ust_time  = __builtin_bswap64(bh->last_ust_time);
+	bh->blk_magic      = __builtin_bswap32(bh->blk_magic);
+	bh->raw_size       = __builtin_bswap32(bh->raw_size);
+	bh->comp_size      = __builtin_bswap32(bh->comp_size);
+	bh->rec_nr         = __builtin_bswap32(bh->rec_nr);
+}
+
+/*
+ ***************************************************************************
+ * Read a block header from file and check it.
+ *
+ * IN:
+ * @fd		File descriptor of data file.
+ * @pos		Offset in file of block header.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
  *
  * OUT:
- * @itv			Interval of time in 1/100th of a second.
+ * @bh		Block header. Its magic number is BLK_SKIP_MAGIC if the area
+ *		following it should be skipped.
+ *
+ * RETURNS:
+ * -1 on read error, 1 if there is no valid block header at this position
+ * (e.g. end of file has been reached), 0 otherwise.
  ***************************************************************************
  */
-void get_itv_value(struct record_header *record_hdr_curr,
-		   struct record_header *record_hdr_prev,
-		   unsigned long long *itv)
+int read_blk_header(int fd, off_t pos, struct blk_header *bh, int endian_mismatch)
 {
-	/* Interval value in jiffies */
-	*itv = get_interval(record_hdr_prev->uptime_cs,
-			    record_hdr_curr->uptime_cs);
+	ssize_t n;
+
+	if ((n = pread(fd, bh, BLK_HEADER_SIZE, pos)) < 0)
+		return -1;
+	if (n < BLK_HEADER_SIZE)
+		return 1;
+
+	if (endian_mismatch) {
+		swap_blk_header(bh);
+	}
+	if (bh->blk_magic == BLK_SKIP_MAGIC)
+		return 0;
+
+	if ((bh->blk_magic != BLK_MAGIC) || !bh->raw_size || !bh->rec_nr ||
+	    (bh->raw_size > BLK_RAW_SIZE_LIMIT) ||
+	    (bh->comp_size > lz_compress_bound(bh->raw_size))) {
+#ifdef DEBUG
+		fprintf(stderr, "%s: pos=%lld magic=%x raw_size=%u comp_size=%u rec_nr=%u\n",
+			__FUNCTION__, (long long) pos, bh->blk_magic, bh->raw_size, bh->comp_size,
+			bh->rec_nr);
+#endif
+		return 1;
+	}
+
+	return 0;
 }
 
 /*
  ***************************************************************************
- * Fill the rectime structure with the file's creation date, based on file's
- * time data saved in file header.
- * The resulting timestamp is expressed in the locale of the file creator or
- * in the user's own locale, depending on whether option -t has been used
- * or not.
+ * Initialize a block of records (see FH_F_COMPRESS) before writing or
+ * reading it. Buffers previously allocated for the block are kept.
  *
  * IN:
- * @flags	Flags for common options and system state.
- * @file_hdr	System activity file standard header.
+ * @blk		Block of records.
+ * @fd		File descriptor of data file.
+ * @pos		Offset in file of block header.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ ***************************************************************************
+ */
+void init_blk(struct sa_blk *blk, int fd, off_t pos, int endian_mismatch)
+{
+	memset(&blk->hdr, 0, BLK_HEADER_SIZE);
+	blk->fd = fd;
+	blk->pos = pos;
+	blk->off = 0;
+	blk->disk_pos = pos;
+	blk->disk_size = 0;
+	blk->loaded = FALSE;
+	blk->endian_mismatch = endian_mismatch;
+}
+
+/*
+ ***************************************************************************
+ * Add data to the block of records being written.
  *
- * OUT:
- * @rectime	Date (and possibly time) from file header. Only the date,
- * 		not the time, should be used by the caller.
+ * IN:
+ * @blk		Block of records.
+ * @buf		Data to add.
+ * @size	Size of data.
  ***************************************************************************
  */
-void get_file_timestamp_struct(unsigned int flags, struct tm *rectime,
-			       struct file_header *file_hdr)
+void write_blk_data(struct sa_blk *blk, const void *buf, size_t size)
 {
-	if (PRINT_TRUE_TIME(flags)) {
-		/* Get local time. This is just to fill fields with a default value. */
-		get_time(rectime, 0);
+	size_t need = blk->hdr.raw_size + size;
 
-		rectime->tm_mday = file_hdr->sa_day;
-		rectime->tm_mon  = file_hdr->sa_month;
-		rectime->tm_year = file_hdr->sa_year;
-		/*
-		 * Call mktime() to set DST (Daylight Saving Time) flag.
-		 * Has anyone a better way to do it?
-		 */
-		rectime->tm_hour = rectime->tm_min = rectime->tm_sec = 0;
-		mktime(rectime);
+	if (need > blk->raw_alloc) {
+		blk->raw_alloc = need > 2 * blk->raw_alloc ? need : 2 * blk->raw_alloc;
+		SREALLOC(blk->raw, unsigned char, blk->raw_alloc);
 	}
-	else {
-		localtime_r((const time_t *) &file_hdr->sa_ust_time, rectime);
+	memcpy(blk->raw + blk->hdr.raw_size, buf, size);
+	blk->hdr.raw_size += size;
+}
+
+/*
+ ***************************************************************************
+ * Write a block header to file.
+ *
+ * IN:
+ * @blk		Block of records.
+ * @bh		Block header.
+ * @pos		Offset in file where the header should be written.
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+static int write_blk_header(struct sa_blk *blk, struct blk_header bh, off_t pos)
+{
+	/* Block header is written with the same endianness as the rest of the file */
+	if (blk->endian_mismatch) {
+		swap_blk_header(&bh);
 	}
+
+	return (pwrite(blk->fd, &bh, BLK_HEADER_SIZE, pos) != BLK_HEADER_SIZE) ? -1 : 0;
 }
 
 /*
  ***************************************************************************
- * Print report header.
+ * Write a header telling readers to skip an area of the file.
  *
  * IN:
- * @flags	Flags for common options and system state.
- * @file_hdr	System activity file standard header.
+ * @blk		Block of records.
+ * @pos		Offset in file where the header should be written.
+ * @end		End of the area to skip (header included).
  *
- * OUT:
- * @rectime	Date and time from file header.
+ * RETURNS:
+ * -1 on error, 0 otherwise.
  ***************************************************************************
  */
-void print_report_hdr(unsigned int flags, struct tm *rectime,
-		      struct file_header *file_hdr)
+static int write_skip_header(struct sa_blk *blk, off_t pos, off_t end)
 {
+	struct blk_header bh;
 
-	/* Get date of file creation */
-	get_file_timestamp_struct(flags, rectime, file_hdr);
+	memset(&bh, 0, BLK_HEADER_SIZE);
+	bh.blk_magic = BLK_SKIP_MAGIC;
+	bh.comp_size = (unsigned int) (end - pos - BLK_HEADER_SIZE);
 
-	/*
-	 * Display the header.
-	 * NB: Number of CPU (value in [1, NR_CPUS + 1]).
-	 * 	1 means that there is only one proc and non SMP kernel.
-	 *	2 means one proc and SMP kernel. Etc.
-	 */
-	print_gal_header(rectime, file_hdr->sa_sysname, file_hdr->sa_release,
-			 file_hdr->sa_nodename, file_hdr->sa_machine,
-			 file_hdr->sa_cpu_nr > 1 ? file_hdr->sa_cpu_nr - 1 : 1,
-			 PLAIN_OUTPUT);
+	return write_blk_header(blk, bh, pos);
 }
 
 /*
  ***************************************************************************
- * Network interfaces may now be registered (and unregistered) dynamically.
- * This is what we try to guess here.
+ * Compress the block of records being written then save it to file.
+ *
+ * When the block is saved again (@update set to TRUE), the version already
+ * in file is never overwritten, so that the file always contains a valid
+ * version of the block should sadc be killed in the meantime: The new
+ * version is written past the last one, then the header at the block's
+ * position is replaced with a header telling readers to skip the area
+ * containing older versions. If that area is large enough, the new version
+ * is then copied back to the block's position and the file is truncated
+ * right after it.
  *
  * IN:
- * @a		Activity structure with statistics.
- * @curr	Index in array for current sample statistics.
- * @ref		Index in array for sample statistics used as reference.
- * @pos		Index on current network interface.
+ * @blk		Block of records.
+ * @update	TRUE if the block may already have been saved to file, in
+ *		which case its new version replaces the previous one.
+ *		Otherwise it is written at current file position.
  *
  * RETURNS:
- * Position of current network interface in array of sample statistics used
- * as reference.
- * -1 if it is a new interface (it was not present in array of stats used
- * as reference).
- * -2 if it is a known interface but which has been unregistered then
- * registered again on the interval.
+ * -1 on error, 0 otherwise.
  ***************************************************************************
  */
-int check_net_dev_reg(struct activity *a, int curr, int ref, int pos)
+static int write_blk(struct sa_blk *blk, int update)
 {
-	struct stats_net_dev *sndc, *sndp;
-	int j0, j = pos;
+	struct blk_header bh;
+	size_t bound = lz_compress_bound(blk->hdr.raw_size);
+	off_t end, pos = blk->pos;
+	unsigned int comp_size;
+
+	if (bound > blk->comp_alloc) {
+		SREALLOC(blk->comp, unsigned char, bound);
+		blk->comp_alloc = bound;
+	}
+	blk->hdr.blk_magic = BLK_MAGIC;
+	blk->hdr.comp_size = comp_size =
+		(unsigned int) lz_compress(blk->raw, blk->hdr.raw_size, blk->comp);
+
+	if (!update) {
+		bh = blk->hdr;
+		if (blk->endian_mismatch) {
+			swap_blk_header(&bh);
+		}
+		if ((write_all(blk->fd, &bh, BLK_HEADER_SIZE) != BLK_HEADER_SIZE) ||
+		    (write_all(blk->fd, blk->comp, comp_size) != comp_size))
+			return -1;
+		blk->disk_pos = pos;
+		blk->disk_size = comp_size;
+		return 0;
+	}
+
+	if (blk->disk_size) {
+		/* Write new version past the last one, then skip older versions */
+		end = blk->disk_pos + BLK_HEADER_SIZE + blk->disk_size;
+		if ((pwrite(blk->fd, blk->comp, comp_size, end + BLK_HEADER_SIZE) != comp_size) ||
+		    (write_blk_header(blk, blk->hdr, end) < 0) ||
+		    (write_skip_header(blk, pos, end) < 0))
+			return -1;
+		blk->disk_pos = end;
+		blk->disk_size = comp_size;
+
+		if ((pos + (off_t) (2 * BLK_HEADER_SIZE + comp_size) > end) ||
+		    (blk->hdr.rec_nr == BLK_REC_NR_MAX - 1))
+			/*
+			 * Not enough room to move the block back to its position.
+			 * Or the block will be full after next record: Keep older
+			 * versions so that there is enough room for its last version.
+			 */
+			return 0;
 
-	if (!a->nr[ref])
 		/*
-		 * No items found in previous iteration:
-		 * Current interface is necessarily new.
+		 * Copy the new version to the skipped area. It is followed by a
+		 * header skipping the rest of the file until the file is truncated.
 		 */
+		end += BLK_HEADER_SIZE + comp_size;
+		if ((pwrite(blk->fd, blk->comp, comp_size, pos + BLK_HEADER_SIZE) != comp_size) ||
+		    (write_skip_header(blk, pos + BLK_HEADER_SIZE + comp_size, end) < 0))
+			return -1;
+	}
+	else if (pwrite(blk->fd, blk->comp, comp_size, pos + BLK_HEADER_SIZE) != comp_size)
 		return -1;
 
-	if (j >= a->nr[ref]) {
-		j = a->nr[ref] - 1;
+	if (write_blk_header(blk, blk->hdr, pos) < 0)
+		return -1;
+	blk->disk_pos = pos;
+	blk->disk_size = comp_size;
+
+	if (ftruncate(blk->fd, pos + BLK_HEADER_SIZE + comp_size) < 0)
+		return -1;
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Tell that a whole record has been added to the block being written.
+ * The block is closed (and a new one is started) when it is full.
+ *
+ * IN:
+ * @blk		Block of records.
+ * @ust_time	Timestamp of the record.
+ * @update	TRUE if the block should be saved to file after each record
+ *		(each new version replacing the previous one until the block
+ *		is full). Otherwise it is written only once it is full or when
+ *		flush_blk() is called.
+ *
+ * RETURNS:
+ * -1 on error, 1 if a new block has been started, 0 otherwise.
+ ***************************************************************************
+ */
+int commit_blk(struct sa_blk *blk, unsigned long long ust_time, int update)
+{
+	int full;
+
+	if (!blk->hdr.rec_nr) {
+		blk->hdr.first_ust_time = ust_time;
 	}
-	j0 = j;
+	blk->hdr.last_ust_time = ust_time;
+	blk->hdr.rec_nr++;
 
-	sndc = (struct stats_net_dev *) ((char *) a->buf[curr] + pos * a->msize);
+	full = (blk->hdr.rec_nr >= BLK_REC_NR_MAX) || (blk->hdr.raw_size >= BLK_RAW_SIZE_MAX);
 
-	do {
-		sndp = (struct stats_net_dev *) ((char *) a->buf[ref] + j * a->msize);
+	if ((update || full) && (write_blk(blk, update) < 0))
+		return -1;
 
-		if (!strcmp(sndc->interface, sndp->interface)) {
-			/*
-			 * Network interface found.
-			 * If a counter has decreased, then we may assume that the
-			 * corresponding interface was unregistered, then registered again.
-			 */
-			if ((sndc->rx_packets    < sndp->rx_packets)    ||
-			    (sndc->tx_packets    < sndp->tx_packets)    ||
-			    (sndc->rx_bytes      < sndp->rx_bytes)      ||
-			    (sndc->tx_bytes      < sndp->tx_bytes)      ||
-			    (sndc->rx_compressed < sndp->rx_compressed) ||
-			    (sndc->tx_compressed < sndp->tx_compressed) ||
-			    (sndc->multicast     < sndp->multicast)) {
-
-				/*
-				 * Special processing for rx_bytes (_packets) and
-				 * tx_bytes (_packets) counters: If the number of
-				 * bytes (packets) has decreased, whereas the number of
-				 * packets (bytes) has increased, then assume that the
-				 * relevant counter has met an overflow condition, and that
-				 * the interface was not unregistered, which is all the
-				 * more plausible that the previous value for the counter
-				 * was > ULLONG_MAX/2.
-				 * NB: the average value displayed will be wrong in this case...
-				 *
-				 * If such an overflow is detected, just set the flag. There is no
-				 * need to handle this in a special way: the difference is still
-				 * properly calculated if the result is of the same type (i.e.
-				 * unsigned long) as the two values.
-				 */
-				int ovfw = FALSE;
-
-				if ((sndc->rx_bytes   < sndp->rx_bytes)   &&
-				    (sndc->rx_packets > sndp->rx_packets) &&
-				    (sndp->rx_bytes   > (~0ULL >> 1))) {
-					ovfw = TRUE;
-				}
-				if ((sndc->tx_bytes   < sndp->tx_bytes)   &&
-				    (sndc->tx_packets > sndp->tx_packets) &&
-				    (sndp->tx_bytes   > (~0ULL >> 1))) {
-					ovfw = TRUE;
-				}
-				if ((sndc->rx_packets < sndp->rx_packets) &&
-				    (sndc->rx_bytes   > sndp->rx_bytes)   &&
-				    (sndp->rx_packets > (~0ULL >> 1))) {
-					ovfw = TRUE;
-				}
-				if ((sndc->tx_packets < sndp->tx_packets) &&
-				    (sndc->tx_bytes   > sndp->tx_bytes)   &&
-				    (sndp->tx_packets > (~0ULL >> 1))) {
-					ovfw = TRUE;
-				}
+	if (!full)
+		return 0;
 
-				if (!ovfw)
-					/*
-					 * OK: Assume here that the device was
-					 * actually unregistered.
-					 */
-					return -2;
-			}
-			return j;
-		}
-		if (++j >= a->nr[ref]) {
-			j = 0;
-		}
-	}
-	while (j != j0);
+	/* Next block starts right after the last version of this one */
+	blk->pos = blk->disk_pos + BLK_HEADER_SIZE + blk->disk_size;
+	blk->hdr.raw_size = blk->hdr.rec_nr = 0;
+	blk->disk_size = 0;
 
-	/* This is a newly registered interface */
-	return -1;
+	return 1;
 }
 
 /*
  ***************************************************************************
- * Network interfaces may now be registered (and unregistered) dynamically.
- * This is what we try to guess here.
+ * Write the block of records being written if it has not been saved yet
+ * (see commit_blk()).
  *
  * IN:
- * @a		Activity structure with statistics.
- * @curr	Index in array for current sample statistics.
- * @ref		Index in array for sample statistics used as reference.
- * @pos		Index on current network interface.
+ * @blk		Block of records.
  *
  * RETURNS:
- * Position of current network interface in array of sample statistics used
- * as reference.
- * -1 if it is a newly registered interface.
- * -2 if it is a known interface but which has been unregistered then
- * registered again on the interval.
+ * -1 on error, 0 otherwise.
  ***************************************************************************
  */
-int check_net_edev_reg(struct activity *a, int curr, int ref, int pos)
+int flush_blk(struct sa_blk *blk)
 {
-	struct stats_net_edev *snedc, *snedp;
-	int j0, j = pos;
-
-	if (!a->nr[ref])
-		/*
-		 * No items found in previous iteration:
-		 * Current interface is necessarily new.
-		 */
-		return -1;
-
-	if (j >= a->nr[ref]) {
-		j = a->nr[ref] - 1;
-	}
-	j0 = j;
-
-	snedc = (struct stats_net_edev *) ((char *) a->buf[curr] + pos * a->msize);
-
-	do {
-		snedp = (struct stats_net_edev *) ((char *) a->buf[ref] + j * a->msize);
-
-		if (!strcmp(snedc->interface, snedp->interface)) {
-			/*
-			 * Network interface found.
-			 * If a counter has decreased, then we may assume that the
-			 * corresponding interface was unregistered, then registered again.
-			 */
-			if ((snedc->tx_errors         < snedp->tx_errors)         ||
-			    (snedc->collisions        < snedp->collisions)        ||
-			    (snedc->rx_dropped        < snedp->rx_dropped)        ||
-			    (snedc->tx_dropped        < snedp->tx_dropped)        ||
-			    (snedc->tx_carrier_errors < snedp->tx_carrier_errors) ||
-			    (snedc->rx_frame_errors   < snedp->rx_frame_errors)   ||
-			    (snedc->rx_fifo_errors    < snedp->rx_fifo_errors)    ||
-			    (snedc->tx_fifo_errors    < snedp->tx_fifo_errors))
-				/*
-				 * OK: assume here that the device was
-				 * actually unregistered.
-				 */
-				return -2;
-
-			return j;
-		}
-		if (++j >= a->nr[ref]) {
-			j = 0;
-		}
-	}
-	while (j != j0);
+	if (!blk->hdr.rec_nr)
+		return 0;
 
-	/* This is a newly registered interface */
-	return -1;
+	return write_blk(blk, FALSE);
 }
 
 /*
  ***************************************************************************
- * Disks may be registered dynamically (true in /proc/stat file).
- * This is what we try to guess here.
+ * Find the end of the last valid block of records of a compressed file.
+ * What follows it (e.g. a version of a block which was being written when
+ * sadc was killed) is not part of the file.
  *
  * IN:
- * @a		Activity structure with statistics.
- * @curr	Index in array for current sample statistics.
- * @ref		Index in array for sample statistics used as reference.
- * @pos		Index on current disk.
+ * @fd		File descriptor of data file.
+ * @pos		Offset in file of first block header.
  *
  * RETURNS:
- * Position of current disk in array of sample statistics used as reference
- * -1 if it is a newly registered device.
- * -2 if it is a known device but which has been unregistered then registered
- * again on the interval.
+ * Offset in file of the end of the last valid block, or -1 on error.
  ***************************************************************************
  */
-int check_disk_reg(struct activity *a, int curr, int ref, int pos)
+off_t get_blk_end(int fd, off_t pos)
 {
-	struct stats_disk *sdc, *sdp;
-	int j0, j = pos;
+	struct blk_header bh, last_bh = {0};
+	struct stat st;
+	off_t last = -1;
+	unsigned char *comp = NULL, *raw = NULL;
+	int rc;
 
-	if (!a->nr[ref])
-		/*
-		 * No items found in previous iteration:
-		 * Current interface is necessarily new.
-		 */
+	if (fstat(fd, &st) < 0)
 		return -1;
 
-	if (j >= a->nr[ref]) {
-		j = a->nr[ref] - 1;
+	while (!(rc = read_blk_header(fd, pos, &bh, FALSE)) &&
+	       (pos + (off_t) (BLK_HEADER_SIZE + bh.comp_size) <= st.st_size)) {
+		if (bh.blk_magic == BLK_MAGIC) {
+			last = pos;
+			last_bh = bh;
+		}
+		pos += BLK_HEADER_SIZE + bh.comp_size;
 	}
-	j0 = j;
-
-	sdc = (struct stats_disk *) ((char *) a->buf[curr] + pos * a->msize);
-
-	do {
-		sdp = (struct stats_disk *) ((char *) a->buf[ref] + j * a->msize);
+	if (rc < 0)
+		return -1;
 
-		if ((sdc->major == sdp->major) &&
-		    (sdc->minor == sdp->minor)) {
-			/*
-			 * Disk found.
-			 * If all the counters have decreased then the likelyhood
-			 * is that the disk has been unregistered and a new disk inserted.
-			 * If only one or two have decreased then the likelyhood
-			 * is that the counter has simply wrapped.
-			 */
-			if ((sdc->nr_ios < sdp->nr_ios) &&
-			    (sdc->rd_sect < sdp->rd_sect) &&
-			    (sdc->wr_sect < sdp->wr_sect) &&
-			    (sdc->dc_sect < sdp->dc_sect))
-				/* Same device registered again */
-				return -2;
+	if (last < 0)
+		return pos;
 
-			return j;
-		}
-		if (++j >= a->nr[ref]) {
-			j = 0;
-		}
+	/* Check that the contents of the last block have been entirely written */
+	SREALLOC(comp, unsigned char, last_bh.comp_size);
+	SREALLOC(raw, unsigned char, last_bh.raw_size);
+	if (pread(fd, comp, last_bh.comp_size, last + BLK_HEADER_SIZE) != (ssize_t) last_bh.comp_size) {
+		pos = -1;
 	}
-	while (j != j0);
+	else if (lz_decompress(comp, last_bh.comp_size, raw, last_bh.raw_size) != last_bh.raw_size) {
+		pos = last;
+	}
+	free(comp);
+	free(raw);
 
-	/* This is a newly registered device */
-	return -1;
+	return pos;
 }
 
+#ifndef SOURCE_SADC
 /*
  ***************************************************************************
- * Allocate bitmaps for activities that have one.
+ * Allocate structures.
  *
  * IN:
- * @act		Array of activities.
+ * @act	Array of activities.
  ***************************************************************************
  */
-void allocate_bitmaps(struct activity *act[])
+void allocate_structures(struct activity *act[])
 {
 	int i;
 
 	for (i = 0; i < NR_ACT; i++) {
-		/*
-		 * If current activity has a bitmap which has not already
-		 * been allocated, then allocate it.
-		 * Note that a same bitmap may be used by several activities.
-		 */
-		if (act[i]->bitmap && !act[i]->bitmap->b_array) {
-			SREALLOC(act[i]->bitmap->b_array, unsigned char,
-				 BITMAP_SIZE(act[i]->bitmap->b_size));
+		if (act[i]->nr_ini > 0) {
+			resize_act_buffers(act[i], 3,
+					   (size_t) act[i]->msize * (size_t) act[i]->nr_ini * (size_t) act[i]->nr2);
+			act[i]->nr_allocated = act[i]->nr_ini;
 		}
 	}
 }
 
 /*
  ***************************************************************************
- * Free bitmaps for activities that have one.
+ * Free structures.
  *
  * IN:
- * @act		Array of activities.
+ * @act	Array of activities.
  ***************************************************************************
  */
-void free_bitmaps(struct activity *act[])
+void free_structures(struct activity *act[])
 {
 	int i;
 
 	for (i = 0; i < NR_ACT; i++) {
-		if (act[i]->bitmap && act[i]->bitmap->b_array) {
-			free(act[i]->bitmap->b_array);
-			/* Set pointer to NULL to prevent it from being freed again */
-			act[i]->bitmap->b_array = NULL;
+		if (act[i]->nr_allocated > 0) {
+			free_act_buffers(act[i]);
 		}
 	}
 }
 
 /*
  ***************************************************************************
- * Select all activities, even if they have no associated items.
+ * Reallocate all the buffers for a given activity.
  *
  * IN:
- * @act		Array of activities.
- *
- * OUT:
- * @act		Array of activities, all of the being selected.
+ * @a		Activity whose buffers need to be reallocated.
+ * @nr_min	Minimum number of items that the new buffers should be able
+ *		to receive.
  ***************************************************************************
  */
-void select_all_activities(struct activity *act[])
+void reallocate_all_buffers(struct activity *a, __nr_t nr_min)
 {
-	int i;
+	size_t nr_realloc;
 
-	for (i = 0; i < NR_ACT; i++) {
-		act[i]->options |= AO_SELECTED;
+	if (nr_min <= 0) {
+		nr_min = 1;
+	}
+	if (!a->nr_allocated) {
+		nr_realloc = nr_min;
+	}
+	else {
+		nr_realloc = a->nr_allocated;
+		do {
+			nr_realloc = nr_realloc * 2;
+		}
+		while (nr_realloc < nr_min);
 	}
+
+	/* Only additional space is initialized */
+	resize_act_buffers(a, 3, (size_t) a->msize * nr_realloc * (size_t) a->nr2);
+
+	a->nr_allocated = nr_realloc;
 }
 
 /*
- ***************************************************************************
- * Select CPU activity if no other activities have been explicitly selected.
- * Also select CPU "all" if no other CPU has been selected.
- *
- * IN:
- * @act		Array of activities.
- *
- * OUT:
- * @act		Array of activities with CPU activity selected if needed.
- ***************************************************************************
- */
-void select_default_activity(struct activity *act[])
-{
+  ***************************************************************************
+  * Try to get device real name from sysfs tree.
+  *
+  * IN:
+  * @major	Major number of the device.
+  * @minor	Minor number of the device.
+  *
+  * RETURNS:
+  * The name of the device, which may be the real name (as it appears in /dev)
+  * or NULL.
+  ***************************************************************************
+  */
+char *get_devname_from_sysfs(unsigned int major, unsigned int minor)
+{
+	static char link[32], target[PATH_MAX];
+	char *devname;
+	ssize_t r;
+
+	snprintf(link, 32, "%s/%u:%u", SYSFS_DEV_BLOCK, major, minor);
+
+	/* Get full path to device knowing its major and minor numbers */
+	r = readlink(link, target, PATH_MAX);
+	if (r <= 0 || r >= PATH_MAX) {
+		return (NULL);
+	}
+
+	target[r] = '\0';
+
+	/* Get device name */
+	devname = basename(target);
+	if (!devname || strnlen(devname, FILENAME_MAX) == 0) {
+		return (NULL);
+	}
+
+	return (devname);
+}
+
+/*
+ ***************************************************************************
+ * Get device real name if possible.
+ * Warning: This routine may return a bad name on 2.4 kernels where
+ * disk activities are read from /proc/stat.
+ *
+ * IN:
+ * @major	Major number of the device.
+ * @minor	Minor number of the device.
+ * @pretty	TRUE if the real name of the device (as it appears in /dev)
+ * 		should be returned.
+ *
+ * RETURNS:
+ * The name of the device, which may be the real name (as it appears in /dev)
+ * or a string with the following format devM-n.
+ ***************************************************************************
+ */
+char *get_devname(unsigned int major, unsigned int minor, int pretty)
+{
+	static char buf[32];
+	char *name;
+
+	snprintf(buf, 32, "dev%u-%u", major, minor);
+
+	if (!pretty)
+		return (buf);
+
+	name = get_devname_from_sysfs(major, minor);
+	if (name != NULL)
+		return (name);
+
+	name = ioc_name(major, minor);
+	if ((name != NULL) && strcmp(name, K_NODEV))
+		return (name);
+
+	return (buf);
+}
+
+/*
+ ***************************************************************************
+ * Check if we are close enough to desired interval.
+ *
+ * IN:
+ * @uptime_ref	Uptime used as reference. This is the system uptime for the
+ *		first sample statistics, or the first system uptime after a
+ *		LINUX RESTART (in 1/100th of a second).
+ * @uptime	Current system uptime (in 1/100th of a second).
+ * @reset	TRUE if @last_uptime should be reset with @uptime_ref.
+ * @interval	Interval of time (in 1/100th of a second). A negative value
+ *		means that no interval has been entered on the command line.
+ * @subsec	TRUE if the file contains records saved at a sub-second
+ *		interval (see FH_F_SUBSEC).
+ *
+ * RETURNS:
+ * 1 if we are actually close enough to desired interval, 0 otherwise.
+ ***************************************************************************
+*/
+int next_slice(unsigned long long uptime_ref, unsigned long long uptime,
+	       int reset, long interval, int subsec)
+{
+	unsigned long file_interval, entry;
+	static unsigned long long last_uptime = 0;
+	int min, max, pt1, pt2, unit = 100;
+	double f;
+
+	if (interval < 0) {
+		if (subsec)
+			/* No interval entered: Select every record */
+			return 1;
+		/*
+		 * No interval entered: Use an interval of 1 second. Records less
+		 * than half a second apart (e.g. saved by two sadc processes
+		 * started at the same time) are not selected.
+		 */
+		interval = 100;
+	}
+	if (subsec || (interval % 100)) {
+		/*
+		 * Sub-second interval between records or entered on the command line:
+		 * Do all the calculations below in 1/100th of a second.
+		 */
+		unit = 1;
+	}
+	interval /= unit;
+
+	/* uptime is expressed in 1/100th of a second */
+	if (!last_uptime || reset) {
+		last_uptime = uptime_ref;
+	}
+
+	/* Interval cannot be greater than 0xffffffff here */
+	f = ((double) ((uptime - last_uptime) & 0xffffffff)) / unit;
+	file_interval = (unsigned long) f;
+	if ((f * 10) - (file_interval * 10) >= 5) {
+		file_interval++; /* Rounding to correct value */
+	}
+
+	last_uptime = uptime;
+
+	/*
+	 * A few notes about the "algorithm" used here to display selected entries
+	 * from the system activity file (option -f with -i flag):
+	 * Let 'Iu' be the interval value given by the user on the command line,
+	 *     'If' the interval between current and previous line in the system
+	 * activity file,
+	 * and 'En' the nth entry (identified by its time stamp) of the file.
+	 * We choose In = [ En - If/2, En + If/2 [ if If is even,
+	 *        or In = [ En - If/2, En + If/2 ] if not.
+	 * En will be displayed if
+	 *       (Pn * Iu) or (P'n * Iu) belongs to In
+	 * with  Pn = En / Iu and P'n = En / Iu + 1
+	 */
+	f = ((double) ((uptime - uptime_ref) & 0xffffffff)) / unit;
+	entry = (unsigned long) f;
+	if ((f * 10) - (entry * 10) >= 5) {
+		entry++;
+	}
+
+	min = entry - (file_interval / 2);
+	max = entry + (file_interval / 2) + (file_interval & 0x1);
+	pt1 = (entry / interval) * interval;
+	pt2 = ((entry / interval) + 1) * interval;
+
+	return (((pt1 >= min) && (pt1 < max)) || ((pt2 >= min) && (pt2 < max)));
+}
+
+/*
+ ***************************************************************************
+ * Use time stamp to fill tstamp structure.
+ *
+ * IN:
+ * @timestamp	Timestamp to decode (format: HH:MM:SS).
+ *
+ * OUT:
+ * @tse		Structure containing the decoded timestamp.
+ *
+ * RETURNS:
+ * 0 if the timestamp has been successfully decoded, 1 otherwise.
+ ***************************************************************************
+ */
+int decode_timestamp(char timestamp[], struct tstamp *tse)
+{
+	timestamp[2] = timestamp[5] = '\0';
+	tse->tm_sec  = atoi(&timestamp[6]);
+	tse->tm_min  = atoi(&timestamp[3]);
+	tse->tm_hour = atoi(timestamp);
+
+	if ((tse->tm_sec < 0) || (tse->tm_sec > 59) ||
+	    (tse->tm_min < 0) || (tse->tm_min > 59) ||
+	    (tse->tm_hour < 0) || (tse->tm_hour > 23))
+		return 1;
+
+	tse->use = TRUE;
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Compare two timestamps.
+ *
+ * IN:
+ * @rectime	Date and time for current sample.
+ * @tse		Timestamp used as reference.
+ *
+ * RETURNS:
+ * A positive value if @rectime is greater than @tse,
+ * a negative one otherwise.
+ ***************************************************************************
+ */
+int datecmp(struct tm *rectime, struct tstamp *tse)
+{
+	if (rectime->tm_hour == tse->tm_hour) {
+		if (rectime->tm_min == tse->tm_min)
+			return (rectime->tm_sec - tse->tm_sec);
+		else
+			return (rectime->tm_min - tse->tm_min);
+	}
+	else
+		return (rectime->tm_hour - tse->tm_hour);
+}
+
+/*
+ ***************************************************************************
+ * Parse a timestamp entered on the command line (hh:mm[:ss]) and decode it.
+ *
+ * IN:
+ * @argv		Arguments list.
+ * @opt			Index in the arguments list.
+ * @def_timestamp	Default timestamp to use.
+ *
+ * OUT:
+ * @tse			Structure containing the decoded timestamp.
+ *
+ * RETURNS:
+ * 0 if the timestamp has been successfully decoded, 1 otherwise.
+ ***************************************************************************
+ */
+int parse_timestamp(char *argv[], int *opt, struct tstamp *tse,
+		    const char *def_timestamp)
+{
+	char timestamp[9];
+
+	if (argv[++(*opt)]) {
+		switch (strlen(argv[*opt])) {
+
+			case 5:
+				strncpy(timestamp, argv[(*opt)++], 5);
+				timestamp[5] = '\0';
+				strcat(timestamp, ":00");
+				break;
+
+			case 8:
+				strncpy(timestamp, argv[(*opt)++], 8);
+				break;
+
+			default:
+				strncpy(timestamp, def_timestamp, 8);
+				break;
+		}
+	} else {
+		strncpy(timestamp, def_timestamp, 8);
+	}
+	timestamp[8] = '\0';
+
+	return decode_timestamp(timestamp, tse);
+}
+
+/*
+ ***************************************************************************
+ * Set interval value.
+ *
+ * IN:
+ * @record_hdr_curr	Record with current sample statistics.
+ * @record_hdr_prev	Record with previous sample statistics.
+ *
+ * OUT:
+ * @itv			Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+void get_itv_value(struct record_header *record_hdr_curr,
+		   struct record_header *record_hdr_prev,
+		   unsigned long long *itv)
+{
+	/* Interval value in jiffies */
+	*itv = get_interval(record_hdr_prev->uptime_cs,
+			    record_hdr_curr->uptime_cs);
+}
+
+/*
+ ***************************************************************************
+ * Fill the rectime structure with the file's creation date, based on file's
+ * time data saved in file header.
+ * The resulting timestamp is expressed in the locale of the file creator or
+ * in the user's own locale, depending on whether option -t has been used
+ * or not.
+ *
+ * IN:
+ * @flags	Flags for common options and system state.
+ * @file_hdr	System activity file standard header.
+ *
+ * OUT:
+ * @rectime	Date (and possibly time) from file header. Only the date,
+ * 		not the time, should be used by the caller.
+ ***************************************************************************
+ */
+void get_file_timestamp_struct(unsigned int flags, struct tm *rectime,
+			       struct file_header *file_hdr)
+{
+	if (PRINT_TRUE_TIME(flags)) {
+		/* Get local time. This is just to fill fields with a default value. */
+		get_time(rectime, 0);
+
+		rectime->tm_mday = file_hdr->sa_day;
+		rectime->tm_mon  = file_hdr->sa_month;
+		rectime->tm_year = file_hdr->sa_year;
+		/*
+		 * Call mktime() to set DST (Daylight Saving Time) flag.
+		 * Has anyone a better way to do it?
+		 */
+		rectime->tm_hour = rectime->tm_min = rectime->tm_sec = 0;
+		mktime(rectime);
+	}
+	else {
+		localtime_r((const time_t *) &file_hdr->sa_ust_time, rectime);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Print report header.
+ *
+ * IN:
+ * @flags	Flags for common options and system state.
+ * @file_hdr	System activity file standard header.
+ *
+ * OUT:
+ * @rectime	Date and time from file header.
+ ***************************************************************************
+ */
+void print_report_hdr(unsigned int flags, struct tm *rectime,
+		      struct file_header *file_hdr)
+{
+
+	/* Get date of file creation */
+	get_file_timestamp_struct(flags, rectime, file_hdr);
+
+	/*
+	 * Display the header.
+	 * NB: Number of CPU (value in [1, NR_CPUS + 1]).
+	 * 	1 means that there is only one proc and non SMP kernel.
+	 *	2 means one proc and SMP kernel. Etc.
+	 */
+	print_gal_header(rectime, file_hdr->sa_sysname, file_hdr->sa_release,
+			 file_hdr->sa_nodename, file_hdr->sa_machine,
+			 file_hdr->sa_cpu_nr > 1 ? file_hdr->sa_cpu_nr - 1 : 1,
+			 PLAIN_OUTPUT);
+}
+
+/*
+ ***************************************************************************
+ * Network interfaces may now be registered (and unregistered) dynamically.
+ * This is what we try to guess here.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @ref		Index in array for sample statistics used as reference.
+ * @pos		Index on current network interface.
+ *
+ * RETURNS:
+ * Position of current network interface in array of sample statistics used
+ * as reference.
+ * -1 if it is a new interface (it was not present in array of stats used
+ * as reference).
+ * -2 if it is a known interface but which has been unregistered then
+ * registered again on the interval.
+ ***************************************************************************
+ */
+int check_net_dev_reg(struct activity *a, int curr, int ref, int pos)
+{
+	struct stats_net_dev *sndc, *sndp;
+	int j0, j = pos;
+
+	if (!a->nr[ref])
+		/*
+		 * No items found in previous iteration:
+		 * Current interface is necessarily new.
+		 */
+		return -1;
+
+	if (j >= a->nr[ref]) {
+		j = a->nr[ref] - 1;
+	}
+	j0 = j;
+
+	sndc = (struct stats_net_dev *) ((char *) a->buf[curr] + pos * a->msize);
+
+	do {
+		sndp = (struct stats_net_dev *) ((char *) a->buf[ref] + j * a->msize);
+
+		if (!strcmp(sndc->interface, sndp->interface)) {
+			/*
+			 * Network interface found.
+			 * If a counter has decreased, then we may assume that the
+			 * corresponding interface was unregistered, then registered again.
+			 */
+			if ((sndc->rx_packets    < sndp->rx_packets)    ||
+			    (sndc->tx_packets    < sndp->tx_packets)    ||
+			    (sndc->rx_bytes      < sndp->rx_bytes)      ||
+			    (sndc->tx_bytes      < sndp->tx_bytes)      ||
+			    (sndc->rx_compressed < sndp->rx_compressed) ||
+			    (sndc->tx_compressed < sndp->tx_compressed) ||
+			    (sndc->multicast     < sndp->multicast)) {
+
+				/*
+				 * Special processing for rx_bytes (_packets) and
+				 * tx_bytes (_packets) counters: If the number of
+				 * bytes (packets) has decreased, whereas the number of
+				 * packets (bytes) has increased, then assume that the
+				 * relevant counter has met an overflow condition, and that
+				 * the interface was not unregistered, which is all the
+				 * more plausible that the previous value for the counter
+				 * was > ULLONG_MAX/2.
+				 * NB: the average value displayed will be wrong in this case...
+				 *
+				 * If such an overflow is detected, just set the flag. There is no
+				 * need to handle this in a special way: the difference is still
+				 * properly calculated if the result is of the same type (i.e.
+				 * unsigned long) as the two values.
+				 */
+				int ovfw = FALSE;
+
+				if ((sndc->rx_bytes   < sndp->rx_bytes)   &&
+				    (sndc->rx_packets > sndp->rx_packets) &&
+				    (sndp->rx_bytes   > (~0ULL >> 1))) {
+					ovfw = TRUE;
+				}
+				if ((sndc->tx_bytes   < sndp->tx_bytes)   &&
+				    (sndc->tx_packets > sndp->tx_packets) &&
+				    (sndp->tx_bytes   > (~0ULL >> 1))) {
+					ovfw = TRUE;
+				}
+				if ((sndc->rx_packets < sndp->rx_packets) &&
+				    (sndc->rx_bytes   > sndp->rx_bytes)   &&
+				    (sndp->rx_packets > (~0ULL >> 1))) {
+					ovfw = TRUE;
+				}
+				if ((sndc->tx_packets < sndp->tx_packets) &&
+				    (sndc->tx_bytes   > sndp->tx_bytes)   &&
+				    (sndp->tx_packets > (~0ULL >> 1))) {
+					ovfw = TRUE;
+				}
+
+				if (!ovfw)
+					/*
+					 * OK: Assume here that the device was
+					 * actually unregistered.
+					 */
+					return -2;
+			}
+			return j;
+		}
+		if (++j >= a->nr[ref]) {
+			j = 0;
+		}
+	}
+	while (j != j0);
+
+	/* This is a newly registered interface */
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Network interfaces may now be registered (and unregistered) dynamically.
+ * This is what we try to guess here.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @ref		Index in array for sample statistics used as reference.
+ * @pos		Index on current network interface.
+ *
+ * RETURNS:
+ * Position of current network interface in array of sample statistics used
+ * as reference.
+ * -1 if it is a newly registered interface.
+ * -2 if it is a known interface but which has been unregistered then
+ * registered again on the interval.
+ ***************************************************************************
+ */
+int check_net_edev_reg(struct activity *a, int curr, int ref, int pos)
+{
+	struct stats_net_edev *snedc, *snedp;
+	int j0, j = pos;
+
+	if (!a->nr[ref])
+		/*
+		 * No items found in previous iteration:
+		 * Current interface is necessarily new.
+		 */
+		return -1;
+
+	if (j >= a->nr[ref]) {
+		j = a->nr[ref] - 1;
+	}
+	j0 = j;
+
+	snedc = (struct stats_net_edev *) ((char *) a->buf[curr] + pos * a->msize);
+
+	do {
+		snedp = (struct stats_net_edev *) ((char *) a->buf[ref] + j * a->msize);
+
+		if (!strcmp(snedc->interface, snedp->interface)) {
+			/*
+			 * Network interface found.
+			 * If a counter has decreased, then we may assume that the
+			 * corresponding interface was unregistered, then registered again.
+			 */
+			if ((snedc->tx_errors         < snedp->tx_errors)         ||
+			    (snedc->collisions        < snedp->collisions)        ||
+			    (snedc->rx_dropped        < snedp->rx_dropped)        ||
+			    (snedc->tx_dropped        < snedp->tx_dropped)        ||
+			    (snedc->tx_carrier_errors < snedp->tx_carrier_errors) ||
+			    (snedc->rx_frame_errors   < snedp->rx_frame_errors)   ||
+			    (snedc->rx_fifo_errors    < snedp->rx_fifo_errors)    ||
+			    (snedc->tx_fifo_errors    < snedp->tx_fifo_errors))
+				/*
+				 * OK: assume here that the device was
+				 * actually unregistered.
+				 */
+				return -2;
+
+			return j;
+		}
+		if (++j >= a->nr[ref]) {
+			j = 0;
+		}
+	}
+	while (j != j0);
+
+	/* This is a newly registered interface */
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Disks may be registered dynamically (true in /proc/stat file).
+ * This is what we try to guess here.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @ref		Index in array for sample statistics used as reference.
+ * @pos		Index on current disk.
+ *
+ * RETURNS:
+ * Position of current disk in array of sample statistics used as reference
+ * -1 if it is a newly registered device.
+ * -2 if it is a known device but which has been unregistered then registered
+ * again on the interval.
+ ***************************************************************************
+ */
+int check_disk_reg(struct activity *a, int curr, int ref, int pos)
+{
+	struct stats_disk *sdc, *sdp;
+	int j0, j = pos;
+
+	if (!a->nr[ref])
+		/*
+		 * No items found in previous iteration:
+		 * Current interface is necessarily new.
+		 */
+		return -1;
+
+	if (j >= a->nr[ref]) {
+		j = a->nr[ref] - 1;
+	}
+	j0 = j;
+
+	sdc = (struct stats_disk *) ((char *) a->buf[curr] + pos * a->msize);
+
+	do {
+		sdp = (struct stats_disk *) ((char *) a->buf[ref] + j * a->msize);
+
+		if ((sdc->major == sdp->major) &&
+		    (sdc->minor == sdp->minor)) {
+			/*
+			 * Disk found.
+			 * If all the counters have decreased then the likelyhood
+			 * is that the disk has been unregistered and a new disk inserted.
+			 * If only one or two have decreased then the likelyhood
+			 * is that the counter has simply wrapped.
+			 */
+			if ((sdc->nr_ios < sdp->nr_ios) &&
+			    (sdc->rd_sect < sdp->rd_sect) &&
+			    (sdc->wr_sect < sdp->wr_sect) &&
+			    (sdc->dc_sect < sdp->dc_sect))
+				/* Same device registered again */
+				return -2;
+
+			return j;
+		}
+		if (++j >= a->nr[ref]) {
+			j = 0;
+		}
+	}
+	while (j != j0);
+
+	/* This is a newly registered device */
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Allocate bitmaps for activities that have one.
+ *
+ * IN:
+ * @act		Array of activities.
+ ***************************************************************************
+ */
+void allocate_bitmaps(struct activity *act[])
+{
+	int i;
+
+	for (i = 0; i < NR_ACT; i++) {
+		/*
+		 * If current activity has a bitmap which has not already
+		 * been allocated, then allocate it.
+		 * Note that a same bitmap may be used by several activities.
+		 */
+		if (act[i]->bitmap && !act[i]->bitmap->b_array) {
+			SREALLOC(act[i]->bitmap->b_array, unsigned char,
+				 BITMAP_SIZE(act[i]->bitmap->b_size));
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Free bitmaps for activities that have one.
+ *
+ * IN:
+ * @act		Array of activities.
+ ***************************************************************************
+ */
+void free_bitmaps(struct activity *act[])
+{
+	int i;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (act[i]->bitmap && act[i]->bitmap->b_array) {
+			free(act[i]->bitmap->b_array);
+			/* Set pointer to NULL to prevent it from being freed again */
+			act[i]->bitmap->b_array = NULL;
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Select all activities, even if they have no associated items.
+ *
+ * IN:
+ * @act		Array of activities.
+ *
+ * OUT:
+ * @act		Array of activities, all of the being selected.
+ ***************************************************************************
+ */
+void select_all_activities(struct activity *act[])
+{
+	int i;
+
+	for (i = 0; i < NR_ACT; i++) {
+		act[i]->options |= AO_SELECTED;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Select CPU activity if no other activities have been explicitly selected.
+ * Also select CPU "all" if no other CPU has been selected.
+ *
+ * IN:
+ * @act		Array of activities.
+ *
+ * OUT:
+ * @act		Array of activities with CPU activity selected if needed.
+ ***************************************************************************
+ */
+void select_default_activity(struct activity *act[])
+{
 	int p;
 
 	p = get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND);
@@ -1368,13 +2422,426 @@ int remap_struct(unsigned int gtypes_nr[], unsigned int ftypes_nr[],
 	return 0;
 }
 
+/* Block of records being read from a compressed file (see FH_F_COMPRESS) */
+static struct sa_blk blk_rd = {.fd = -1};
+/* Data file mapped in memory (see open_map_reader()) */
+static struct sa_map map_rd = {.fd = -1};
+/* Where to go back if the mapped file is truncated while being copied */
+static sigjmp_buf map_rd_env;
+/* TRUE while data are being copied from the mapped file (see read_map_data()) */
+static volatile sig_atomic_t map_rd_copying = FALSE;
+/* SIGBUS handler in use before the file was mapped */
+static struct sigaction map_rd_sigbus_act;
+
+/*
+ ***************************************************************************
+ * SIGBUS signal handler, received when the pages of the data file mapped
+ * in memory no longer exist (i.e. the file has been truncated). Signals
+ * not raised while copying data from the mapped file are passed on to the
+ * handler that was in use before the file was mapped.
+ *
+ * IN:
+ * @sig	Signal number.
+ ***************************************************************************
+ */
+static void sigbus_handler(int sig)
+{
+	if (map_rd_copying) {
+		map_rd_copying = FALSE;
+		siglongjmp(map_rd_env, 1);
+	}
+
+	sigaction(SIGBUS, &map_rd_sigbus_act, NULL);
+	raise(sig);
+}
+
+/*
+ ***************************************************************************
+ * Unmap the data file mapped in memory, if any. It will be read again with
+ * read() system calls.
+ ***************************************************************************
+ */
+static void close_map_reader(void)
+{
+	if (map_rd.addr) {
+		munmap(map_rd.addr, map_rd.size);
+		sigaction(SIGBUS, &map_rd_sigbus_act, NULL);
+	}
+	map_rd.addr = NULL;
+	map_rd.size = map_rd.pos = 0;
+	map_rd.fd = -1;
+}
+
+/*
+ ***************************************************************************
+ * Map the whole data file in memory so that its records are read by
+ * sa_fread() without any system call. Only regular files whose records are
+ * not compressed are mapped: Other files (e.g. pipes) are still read with
+ * read(). Must be called once file's header and list of activities have
+ * been read, i.e. when file is positioned on its first record. Should the
+ * file be truncated while mapped, sa_fread() reads it again with read().
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ ***************************************************************************
+ */
+void open_map_reader(int ifd)
+{
+	struct sigaction sigbus_act;
+	struct stat st;
+	off_t fpos;
+	void *addr;
+
+	close_map_reader();
+
+	if ((ifd == blk_rd.fd) || (fstat(ifd, &st) < 0) || !S_ISREG(st.st_mode) ||
+	    (st.st_size <= 0) || ((unsigned long long) st.st_size > SIZE_MAX))
+		return;
+
+	if ((fpos = lseek(ifd, 0, SEEK_CUR)) < 0) {
+		perror("lseek");
+		close(ifd);
+		exit(2);
+	}
+
+	if ((addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, ifd, 0)) == MAP_FAILED)
+		/* Keep on reading file with read() */
+		return;
+#ifdef MADV_SEQUENTIAL
+	madvise(addr, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+
+	/*
+	 * Accessing pages beyond the end of file raises SIGBUS. Signal is not
+	 * blocked while being handled since its handler either doesn't return
+	 * or raises it again for the previous handler.
+	 */
+	memset(&sigbus_act, 0, sizeof(sigbus_act));
+	sigbus_act.sa_handler = sigbus_handler;
+	sigbus_act.sa_flags = SA_NODEFER;
+	sigaction(SIGBUS, &sigbus_act, &map_rd_sigbus_act);
+
+	map_rd.addr = (unsigned char *) addr;
+	map_rd.size = (size_t) st.st_size;
+	map_rd.pos = (size_t) fpos;
+	map_rd.fd = ifd;
+}
+
+/*
+ ***************************************************************************
+ * Map the data file again if it has grown since it was mapped (e.g. sadc
+ * has appended records to it). Called when the end of the mapping has
+ * been reached.
+ ***************************************************************************
+ */
+static void remap_file(void)
+{
+	struct stat st;
+	void *addr;
+
+	if ((fstat(map_rd.fd, &st) < 0) || (st.st_size <= (off_t) map_rd.size) ||
+	    ((unsigned long long) st.st_size > SIZE_MAX))
+		return;
+
+	if ((addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+			 map_rd.fd, 0)) == MAP_FAILED)
+		return;
+
+	munmap(map_rd.addr, map_rd.size);
+	map_rd.addr = (unsigned char *) addr;
+	map_rd.size = (size_t) st.st_size;
+}
+
+/*
+ ***************************************************************************
+ * Read data from the data file mapped in memory. Should the file be
+ * truncated while data are copied (SIGBUS received), the file is unmapped
+ * and positioned where data were to be read.
+ *
+ * IN:
+ * @buffer	Buffer where data are read. NULL if data should be skipped.
+ * @size	Number of bytes to read.
+ *
+ * RETURNS:
+ * Number of bytes read (less than @size if end of file has been reached),
+ * or -1 if the file has been truncated and should now be read with read().
+ ***************************************************************************
+ */
+static ssize_t read_map_data(void *buffer, size_t size)
+{
+	size_t n, pos;
+	int fd;
+
+	if (map_rd.size - map_rd.pos < size) {
+		remap_file();
+	}
+	if (map_rd.pos >= map_rd.size)
+		return 0;
+
+	n = map_rd.size - map_rd.pos;
+	if (n > size) {
+		n = size;
+	}
+	if (buffer) {
+		if (sigsetjmp(map_rd_env, 0)) {
+			pos = map_rd.pos;
+			fd = map_rd.fd;
+			close_map_reader();
+			if (lseek(fd, (off_t) pos, SEEK_SET) < 0) {
+				perror("lseek");
+				close(fd);
+				exit(2);
+			}
+			return -1;
+		}
+		map_rd_copying = TRUE;
+		memcpy(buffer, map_rd.addr + map_rd.pos, n);
+		map_rd_copying = FALSE;
+	}
+	map_rd.pos += n;
+
+	return (ssize_t) n;
+}
+
+/*
+ ***************************************************************************
+ * Tell whether records of a data file are grouped in compressed blocks,
+ * in which case they will be read and decompressed one block at a time
+ * by sa_fread(). Must be called once file's header and list of activities
+ * have been read, i.e. when file is positioned on the first block.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @sa_flags	Flags (FH_F_...) from file header.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ ***************************************************************************
+ */
+void open_blk_reader(int ifd, unsigned int sa_flags, int endian_mismatch)
+{
+	off_t fpos;
+
+	if (ifd == map_rd.fd) {
+		close_map_reader();
+	}
+
+	if (!IS_COMPRESSED(sa_flags)) {
+		if (blk_rd.fd == ifd) {
+			blk_rd.fd = -1;
+		}
+		return;
+	}
+
+	if ((fpos = lseek(ifd, 0, SEEK_CUR)) < 0) {
+		perror("lseek");
+		close(ifd);
+		exit(2);
+	}
+	init_blk(&blk_rd, ifd, fpos, endian_mismatch);
+}
+
+/*
+ ***************************************************************************
+ * Read then decompress a block of records from file.
+ *
+ * IN:
+ * @pos		Offset in file of block header (or of a header telling to
+ *		skip older versions of the block).
+ *
+ * RETURNS:
+ * -1 if the block is invalid, 1 if end of file has been reached (no block,
+ * or incomplete or invalid last block at this position), 0 otherwise.
+ ***************************************************************************
+ */
+static int load_blk(off_t pos)
+{
+	struct blk_header bh;
+	struct stat st;
+	ssize_t n;
+	int rc;
+
+	/* Skip older versions of a block which was being written */
+	while (!(rc = read_blk_header(blk_rd.fd, pos, &bh, blk_rd.endian_mismatch)) &&
+	       (bh.blk_magic == BLK_SKIP_MAGIC)) {
+		pos += BLK_HEADER_SIZE + bh.comp_size;
+	}
+	if (rc < 0)
+		goto read_error;
+	if (rc > 0)
+		/* No block or invalid block (e.g. block header partially written) */
+		return 1;
+
+	if (bh.comp_size > blk_rd.comp_alloc) {
+		SREALLOC(blk_rd.comp, unsigned char, bh.comp_size);
+		blk_rd.comp_alloc = bh.comp_size;
+	}
+	if (bh.raw_size > blk_rd.raw_alloc) {
+		SREALLOC(blk_rd.raw, unsigned char, bh.raw_size);
+		blk_rd.raw_alloc = bh.raw_size;
+	}
+
+	if ((n = pread(blk_rd.fd, blk_rd.comp, bh.comp_size, pos + BLK_HEADER_SIZE)) < 0)
+		goto read_error;
+	if (n < bh.comp_size)
+		return 1;
+
+	/* Current block is no longer valid */
+	blk_rd.loaded = FALSE;
+	if (lz_decompress(blk_rd.comp, bh.comp_size, blk_rd.raw, bh.raw_size) != bh.raw_size) {
+		/*
+		 * The last block of the file may have been partially written
+		 * (e.g. sadc has been killed): Consider it as the end of file.
+		 */
+		if (fstat(blk_rd.fd, &st) < 0)
+			goto read_error;
+		return (pos + (off_t) (BLK_HEADER_SIZE + bh.comp_size) < st.st_size) ? -1 : 1;
+	}
+
+	blk_rd.hdr = bh;
+	blk_rd.pos = pos;
+	blk_rd.off = 0;
+	blk_rd.loaded = TRUE;
+
+	return 0;
+
+read_error:
+	fprintf(stderr, _("Error while reading system activity file: %s\n"),
+		strerror(errno));
+	close(blk_rd.fd);
+	exit(2);
+}
+
+/*
+ ***************************************************************************
+ * Read data from the blocks of records of a compressed file.
+ *
+ * IN:
+ * @buffer	Buffer where data are read. NULL if data should be skipped.
+ * @size	Number of bytes to read.
+ *
+ * RETURNS:
+ * Number of bytes read (less than @size if end of file has been reached).
+ ***************************************************************************
+ */
+static size_t read_blk_data(void *buffer, size_t size)
+{
+	size_t done = 0, n;
+	off_t next;
+	int rc;
+
+	while (done < size) {
+		if (!blk_rd.loaded || (blk_rd.off == blk_rd.hdr.raw_size)) {
+			/* Go to next block */
+			next = blk_rd.loaded ? blk_rd.pos + BLK_HEADER_SIZE + blk_rd.hdr.comp_size
+					     : blk_rd.pos;
+			if ((rc = load_blk(next)) < 0) {
+				fprintf(stderr, _("Invalid compressed block in system activity file\n"));
+				close(blk_rd.fd);
+				exit(2);
+			}
+			if (rc > 0)
+				break;
+		}
+
+		n = blk_rd.hdr.raw_size - blk_rd.off;
+		if (n > size - done) {
+			n = size - done;
+		}
+		if (buffer) {
+			memcpy((char *) buffer + done, blk_rd.raw + blk_rd.off, n);
+		}
+		blk_rd.off += n;
+		done += n;
+	}
+
+	return done;
+}
+
+/*
+ ***************************************************************************
+ * Get current position in a system activity data file. For a compressed
+ * file, this is a position in the blocks of records (see BLK_POS_SHIFT).
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ *
+ * RETURNS:
+ * Current position, or -1 on error.
+ ***************************************************************************
+ */
+off_t sa_ftell(int ifd)
+{
+	if (ifd == map_rd.fd)
+		return (off_t) map_rd.pos;
+
+	if (ifd != blk_rd.fd)
+		return lseek(ifd, 0, SEEK_CUR);
+
+	return (blk_rd.pos << BLK_POS_SHIFT) | (off_t) (blk_rd.loaded ? blk_rd.off : 0);
+}
+
+/*
+ ***************************************************************************
+ * Go back to a position in a system activity data file.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @fpos	Position previously returned by sa_ftell().
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int sa_fseek(int ifd, off_t fpos)
+{
+	off_t pos;
+	size_t off;
+	int rc;
+
+	if (ifd == map_rd.fd) {
+		if (fpos < 0)
+			goto seek_error;
+		map_rd.pos = (size_t) fpos;
+		return 0;
+	}
+
+	if (ifd != blk_rd.fd)
+		return (lseek(ifd, fpos, SEEK_SET) < fpos) ? -1 : 0;
+
+	pos = fpos >> BLK_POS_SHIFT;
+	off = (size_t) (fpos & (((off_t) 1 << BLK_POS_SHIFT) - 1));
+
+	if (!blk_rd.loaded || (pos != blk_rd.pos)) {
+		if ((rc = load_blk(pos)) < 0)
+			goto seek_error;
+		if (rc > 0) {
+			if (off)
+				goto seek_error;
+			/* Position is at the end of file: Next block doesn't exist (yet) */
+			blk_rd.pos = pos;
+			blk_rd.loaded = FALSE;
+			return 0;
+		}
+	}
+	if (off > blk_rd.hdr.raw_size)
+		goto seek_error;
+	blk_rd.off = off;
+
+	return 0;
+
+seek_error:
+	errno = EINVAL;
+	return -1;
+}
+
 /*
  ***************************************************************************
- * Read data from a system activity data file.
+ * Read data from a system activity data file. Data from a compressed file
+ * (see FH_F_COMPRESS) are read from its decompressed blocks of records.
  *
  * IN:
  * @ifd		Input file descriptor.
- * @buffer	Buffer where data are read.
+ * @buffer	Buffer where data are read. NULL if data should be skipped.
  * @size	Number of bytes to read.
  * @mode	If set to HARD_SIZE, indicate that an EOF should be considered
  * 		as an error.
@@ -1391,7 +2858,27 @@ int sa_fread(int ifd, void *buffer, size_t size, int mode, int oneof)
 {
 	ssize_t n;
 
-	if ((n = read(ifd, buffer, size)) < 0) {
+	if (ifd == map_rd.fd) {
+		if ((n = read_map_data(buffer, size)) < 0)
+			/*
+			 * File has been truncated while being read from memory:
+			 * Read it again with read() from current position.
+			 */
+			return sa_fread(ifd, buffer, size, mode, oneof);
+	}
+	else if (ifd == blk_rd.fd) {
+		n = (ssize_t) read_blk_data(buffer, size);
+	}
+	else if (!buffer) {
+		/* Skip data */
+		if (lseek(ifd, (off_t) size, SEEK_CUR) < 0) {
+			perror("lseek");
+			close(ifd);
+			exit(2);
+		}
+		n = (ssize_t) size;
+	}
+	else if ((n = read(ifd, buffer, size)) < 0) {
 		fprintf(stderr, _("Error while reading system activity file: %s\n"),
 			strerror(errno));
 		close(ifd);
@@ -1412,6 +2899,193 @@ int sa_fread(int ifd, void *buffer, size_t size, int mode, int oneof)
 	return 0;
 }
 
+/*
+ ***************************************************************************
+ * Add a byte swap of consecutive fields to the plan used to convert the
+ * statistics structures of an activity. Fields contiguous with those of
+ * previous swap, and of the same size, are swapped along with them.
+ *
+ * IN:
+ * @plan	Conversion plan.
+ * @off		Offset of first field.
+ * @nr		Number of fields.
+ * @width	Size of each field (4 or 8 bytes).
+ * @stride	Distance between two consecutive fields.
+ *
+ * OUT:
+ * @plan	Conversion plan with byte swap added.
+ ***************************************************************************
+ */
+static void add_plan_swap(struct remap_plan *plan, unsigned int off, unsigned int nr,
+			  unsigned int width, unsigned int stride)
+{
+	struct plan_swap *ps;
+
+	if (!nr)
+		return;
+
+	if (plan->swap_nr) {
+		ps = &plan->swap[plan->swap_nr - 1];
+		if ((ps->width == width) && (ps->stride == stride) &&
+		    (ps->off + ps->nr * ps->stride == off)) {
+			ps->nr += nr;
+			return;
+		}
+	}
+
+	ps = &plan->swap[plan->swap_nr++];
+	ps->off = off;
+	ps->nr = nr;
+	ps->width = width;
+	ps->stride = stride;
+}
+
+/*
+ ***************************************************************************
+ * Work out the operations needed to convert each statistics structure of
+ * an activity read from file to that expected by current sysstat version.
+ * They are the same as those done by swap_struct() then remap_struct()
+ * (with the same sanity checks), but are computed only once for the
+ * whole file instead of once for each structure read.
+ * Must be called when the sizes and descriptions of the structures (as
+ * read from file and for current version) are known.
+ *
+ * IN:
+ * @a		Activity.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @arch_64	TRUE if file's data come from a 64 bit machine.
+ *
+ * OUT:
+ * @a		Activity with its conversion plan.
+ ***************************************************************************
+ */
+void compile_remap_plan(struct activity *a, int endian_mismatch, int arch_64)
+{
+	struct remap_plan *plan = &a->plan;
+	struct plan_move *pm;
+	unsigned int *gt = a->gtypes_nr, *ft = a->ftypes_nr;
+	unsigned int width[3] = {ULL_ALIGNMENT_WIDTH, UL_ALIGNMENT_WIDTH, U_ALIGNMENT_WIDTH};
+	unsigned int f_size = a->fsize, g_size = a->msize;
+	unsigned int f_used = 0, g_used = 0, src, n;
+	int d, k;
+
+	memset(plan, 0, sizeof(struct remap_plan));
+
+	/* Byte swaps: See swap_struct() */
+	if (endian_mismatch) {
+		add_plan_swap(plan, 0, ft[0], 8, ULL_ALIGNMENT_WIDTH);
+		add_plan_swap(plan, ft[0] * ULL_ALIGNMENT_WIDTH, ft[1],
+			      arch_64 ? 8 : 4, UL_ALIGNMENT_WIDTH);
+		add_plan_swap(plan, ft[0] * ULL_ALIGNMENT_WIDTH + ft[1] * UL_ALIGNMENT_WIDTH,
+			      ft[2], 4, U_ALIGNMENT_WIDTH);
+	}
+
+	/* Field moves: See remap_struct() */
+	if (MAP_SIZE(ft) > f_size) {
+		plan->invalid = TRUE;
+		return;
+	}
+
+	for (k = 0; k < 3; k++) {
+		/*
+		 * Fields of type k and following ones are located after those of
+		 * previous types (already remapped) and after the @ft[k] fields
+		 * of type k from file. They are moved after the @gt[k] fields
+		 * of type k expected by current version.
+		 */
+		src = g_used + ft[k] * width[k];
+		f_used += ft[k] * width[k];
+		g_used += gt[k] * width[k];
+
+		if (!(d = gt[k] - ft[k]))
+			continue;
+
+		n = MINIMUM(f_size - f_used, g_size - g_used);
+		if ((src >= g_size) || (g_used + n > g_size) || (src + n > g_size)) {
+			plan->invalid = TRUE;
+			return;
+		}
+
+		pm = &plan->move[plan->move_nr++];
+		pm->dst = g_used;
+		pm->src = src;
+		pm->len = n;
+		if (d > 0) {
+			/* New fields are set to 0 */
+			pm->zoff = src;
+			pm->zlen = d * width[k];
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Convert the statistics structures of an activity read from file to
+ * those expected by current sysstat version, following the plan computed
+ * by compile_remap_plan().
+ *
+ * IN:
+ * @a		Activity.
+ * @buf		Buffer containing the structures, each one being @a->msize
+ *		bytes long.
+ * @nr		Number of structures (items x sub-items).
+ *
+ * OUT:
+ * @buf		Buffer with converted structures.
+ *
+ * RETURNS:
+ * -1 if the structures cannot be converted, 0 otherwise.
+ ***************************************************************************
+ */
+int apply_remap_plan(struct activity *a, void *buf, __nr_t nr)
+{
+	struct remap_plan *plan = &a->plan;
+	struct plan_swap *ps;
+	struct plan_move *pm;
+	char *st;
+	uint64_t *x;
+	uint32_t *y;
+	__nr_t j;
+	int i;
+	unsigned int k;
+
+	if (plan->invalid)
+		return -1;
+
+	for (j = 0; j < nr; j++) {
+		st = (char *) buf + (size_t) j * a->msize;
+
+		for (i = 0; i < plan->swap_nr; i++) {
+			ps = &plan->swap[i];
+			if (ps->width == 8) {
+				x = (uint64_t *) (st + ps->off);
+				for (k = 0; k < ps->nr; k++) {
+					*x = __builtin_bswap64(*x);
+					x = (uint64_t *) ((char *) x + ps->stride);
+				}
+			}
+			else {
+				y = (uint32_t *) (st + ps->off);
+				for (k = 0; k < ps->nr; k++) {
+					*y = __builtin_bswap32(*y);
+					y = (uint32_t *) ((char *) y + ps->stride);
+				}
+			}
+		}
+
+		for (i = 0; i < plan->move_nr; i++) {
+			pm = &plan->move[i];
+			memmove(st + pm->dst, st + pm->src, pm->len);
+			if (pm->zlen) {
+				memset(st + pm->zoff, 0, pm->zlen);
+			}
+		}
+	}
+
+	return 0;
+}
+
 /*
  ***************************************************************************
  * Read the record header of current sample and process it.
@@ -1428,36 +3102,198 @@ int sa_fread(int ifd, void *buffer, size_t size, int mode, int oneof)
  *		endianness.
  * @oneof	Set to EOF_CONT if an unexpected end of file should not make
  *		sadf stop. Default behavior is to stop on unexpected EOF.
- * @b_size	@buffer size.
+ * @b_size	@buffer size.
+ *
+ * OUT:
+ * @record_hdr	Record header for current sample.
+ *
+ * RETURNS:
+ * 1 if EOF has been reached,
+ * 2 if an error has been encountered (e.g. unexpected EOF),
+ * 0 otherwise.
+ ***************************************************************************
+ */
+int read_record_hdr(int ifd, void *buffer, struct record_header *record_hdr,
+		    struct file_header *file_hdr, int arch_64, int endian_mismatch,
+		    int oneof, size_t b_size)
+{
+	int rc;
+
+	if ((rc = sa_fread(ifd, buffer, (size_t) file_hdr->rec_size, SOFT_SIZE, oneof)) != 0)
+		/* End of sa data file */
+		return rc;
+
+	/* Remap record header structure to that expected by current version */
+	if (remap_struct(rec_types_nr, file_hdr->rec_types_nr, buffer,
+			 file_hdr->rec_size, RECORD_HEADER_SIZE, b_size) < 0)
+		return 2;
+	memcpy(record_hdr, buffer, RECORD_HEADER_SIZE);
+
+	/* Normalize endianness */
+	if (endian_mismatch) {
+		swap_struct(rec_types_nr, record_hdr, arch_64);
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Move structures data.
+ *
+ * IN:
+ * @act		Array of activities.
+ * @id_seq	Activity sequence in file.
+ * @record_hdr	Current record header.
+ * @dest	Index in array where stats have to be copied to.
+ * @src		Index in array where stats to copy are.
+ ***************************************************************************
+ */
+void copy_structures(struct activity *act[], unsigned int id_seq[],
+		     struct record_header record_hdr[], int dest, int src)
+{
+	int i, p;
+
+	memcpy(&record_hdr[dest], &record_hdr[src], RECORD_HEADER_SIZE);
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+
+		p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
+
+		memcpy(act[p]->buf[dest], act[p]->buf[src],
+		       (size_t) act[p]->msize *
+		       (size_t) (act[p]->nr[src] ? act[p]->nr[src] : act[p]->nr_carried[src]) *
+		       (size_t) act[p]->nr2);
+		act[p]->nr[dest] = act[p]->nr[src];
+		act[p]->nr_carried[dest] = act[p]->nr_carried[src];
+		act[p]->uptime_cs[dest] = act[p]->uptime_cs[src];
+	}
+}
+
+/*
+ ***************************************************************************
+ * Read an __nr_t value from file.
+ * Such a value can be the new number of CPU saved after a RESTART record,
+ * or the number of structures to read saved before the structures containing
+ * statistics for an activity with a varying number of items in file.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @arch_64	TRUE if file's data come from a 64 bit machine.
+ * @non_zero	TRUE if value should not be zero. Else NR_NOT_DUE is
+ *		also accepted.
+ *
+ * RETURNS:
+ * __nr_t value, as read from file.
+ ***************************************************************************
+ */
+__nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
+		     int endian_mismatch, int arch_64, int non_zero)
+{
+	__nr_t value;
+
+	sa_fread(ifd, &value, sizeof(__nr_t), HARD_SIZE, UEOF_STOP);
+
+	/* Normalize endianness for file_activity structures */
+	if (endian_mismatch) {
+		nr_types_nr[2] = 1;
+		swap_struct(nr_types_nr, &value, arch_64);
+	}
+
+	if ((non_zero && !value) ||
+	    ((value < 0) && (non_zero || (value != NR_NOT_DUE)))) {
+#ifdef DEBUG
+		fprintf(stderr, "%s: Value=%d\n",
+			__FUNCTION__, value);
+#endif
+		/* Value number cannot be zero or negative (unless activity is not due) */
+		handle_invalid_sa_file(ifd, file_magic, file, 0);
+	}
+
+	return value;
+}
+
+/*
+ ***************************************************************************
+ * Carry forward the last statistics read for an activity which is not due
+ * in current record (i.e. which is saved at a longer period than the
+ * other ones). They are taken from the buffer containing the most recent
+ * statistics read before current record, then tagged as carried so that
+ * they are not displayed.
+ *
+ * IN:
+ * @a		Activity which is not due.
+ * @curr	Index in array for current sample statistics.
+ * @uptime_cs	Uptime of current record.
+ ***************************************************************************
+ */
+void carry_forward_stats(struct activity *a, int curr, unsigned long long uptime_cs)
+{
+	int src = -1;
+	__nr_t nr_src = 0;
+
+	/*
+	 * Buffers may contain statistics more recent than current record (e.g.
+	 * when sar reads the file again for another activity): Don't use them.
+	 */
+	if ((a->uptime_cs[!curr] < uptime_cs) &&
+	    ((a->uptime_cs[!curr] >= a->uptime_cs[curr]) || (a->uptime_cs[curr] >= uptime_cs))) {
+		src = !curr;
+	}
+	else if (a->uptime_cs[curr] < uptime_cs) {
+		src = curr;
+	}
+
+	if (src >= 0) {
+		nr_src = a->nr[src] ? a->nr[src] : a->nr_carried[src];
+	}
+
+	if (src != curr) {
+		if (nr_src > 0) {
+			memcpy(a->buf[curr], a->buf[src],
+			       (size_t) a->msize * (size_t) nr_src * (size_t) a->nr2);
+			a->uptime_cs[curr] = a->uptime_cs[src];
+		}
+		else {
+			a->uptime_cs[curr] = 0;
+		}
+	}
+	a->nr[curr] = 0;
+	a->nr_carried[curr] = nr_src;
+}
+
+/*
+ ***************************************************************************
+ * Read the size of a block of encoded statistics (see FH_F_DELTA).
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @oneof	Set to UEOF_CONT if an unexpected end of file should not make
+ *		sadf stop. Default behavior is to stop on unexpected EOF.
  *
  * OUT:
- * @record_hdr	Record header for current sample.
+ * @len		Size of the block following in file.
  *
  * RETURNS:
- * 1 if EOF has been reached,
- * 2 if an error has been encountered (e.g. unexpected EOF),
- * 0 otherwise.
+ * 2 if an unexpected EOF has been reached, 0 otherwise.
  ***************************************************************************
  */
-int read_record_hdr(int ifd, void *buffer, struct record_header *record_hdr,
-		    struct file_header *file_hdr, int arch_64, int endian_mismatch,
-		    int oneof, size_t b_size)
+int read_enc_len(int ifd, unsigned int *len, int endian_mismatch, int oneof)
 {
-	int rc;
-
-	if ((rc = sa_fread(ifd, buffer, (size_t) file_hdr->rec_size, SOFT_SIZE, oneof)) != 0)
-		/* End of sa data file */
-		return rc;
-
-	/* Remap record header structure to that expected by current version */
-	if (remap_struct(rec_types_nr, file_hdr->rec_types_nr, buffer,
-			 file_hdr->rec_size, RECORD_HEADER_SIZE, b_size) < 0)
+	if (sa_fread(ifd, len, sizeof(unsigned int), HARD_SIZE, oneof) > 0)
 		return 2;
-	memcpy(record_hdr, buffer, RECORD_HEADER_SIZE);
 
-	/* Normalize endianness */
 	if (endian_mismatch) {
-		swap_struct(rec_types_nr, record_hdr, arch_64);
+		*len = __builtin_bswap32(*len);
 	}
 
 	return 0;
@@ -1465,79 +3301,107 @@ int read_record_hdr(int ifd, void *buffer, struct record_header *record_hdr,
 
 /*
  ***************************************************************************
- * Move structures data.
+ * Read and decode a block of encoded statistics for an activity (see
+ * FH_F_DELTA), then copy the structures to the buffer for current sample.
+ * Structures are left as they are written in file: Their endianness and
+ * fields still need to be normalized and remapped.
  *
  * IN:
- * @act		Array of activities.
- * @id_seq	Activity sequence in file.
- * @record_hdr	Current record header.
- * @dest	Index in array where stats have to be copied to.
- * @src		Index in array where stats to copy are.
+ * @ifd		Input file descriptor.
+ * @a		Activity whose statistics are read.
+ * @curr	Index in array for current sample statistics.
+ * @nr_value	Number of items.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @dfile	Name of system activity data file.
+ * @file_magic	file_magic structure containing data read from file magic
+ *		header.
+ * @oneof	Set to UEOF_CONT if an unexpected end of file should not make
+ *		sadf stop. Default behavior is to stop on unexpected EOF.
+ *
+ * RETURNS:
+ * 2 if an unexpected EOF has been reached, 0 otherwise.
  ***************************************************************************
  */
-void copy_structures(struct activity *act[], unsigned int id_seq[],
-		     struct record_header record_hdr[], int dest, int src)
+int read_enc_stats(int ifd, struct activity *a, int curr, __nr_t nr_value,
+		   int endian_mismatch, char *dfile, struct file_magic *file_magic,
+		   int oneof)
 {
-	int i, p;
+	static unsigned char *blk = NULL;
+	static size_t blk_size = 0;
+	unsigned int len;
+	__nr_t nr = nr_value * a->nr2;
+	int j;
 
-	memcpy(&record_hdr[dest], &record_hdr[src], RECORD_HEADER_SIZE);
+	if (read_enc_len(ifd, &len, endian_mismatch, oneof) > 0)
+		return 2;
 
-	for (i = 0; i < NR_ACT; i++) {
+	if (!len || (len > get_enc_bound(a->ftypes_nr, (size_t) a->fsize, nr))) {
+#ifdef DEBUG
+		fprintf(stderr, "%s: %s: len=%u\n", __FUNCTION__, a->name, len);
+#endif
+		handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+	}
 
-		if (!id_seq[i])
-			continue;
+	if (len > blk_size) {
+		SREALLOC(blk, unsigned char, len);
+		blk_size = len;
+	}
+	if (sa_fread(ifd, blk, (size_t) len, HARD_SIZE, oneof) > 0)
+		/* Unexpected EOF */
+		return 2;
 
-		p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
+	if (decode_act_stats(&a->enc[0], a->ftypes_nr, (size_t) a->fsize, blk, len, nr) < 0) {
+#ifdef DEBUG
+		fprintf(stderr, "%s: %s: Cannot decode statistics\n", __FUNCTION__, a->name);
+#endif
+		handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+	}
 
-		memcpy(act[p]->buf[dest], act[p]->buf[src],
-		       (size_t) act[p]->msize * (size_t) act[p]->nr[src] * (size_t) act[p]->nr2);
-		act[p]->nr[dest] = act[p]->nr[src];
+	/* Note: If msize was smaller than fsize, it has been set to fsize in check_file_actlst() */
+	if (a->msize == a->fsize) {
+		memcpy(a->buf[curr], a->enc[0].buf, (size_t) a->fsize * (size_t) nr);
 	}
+	else {
+		for (j = 0; j < nr; j++) {
+			memcpy((char *) a->buf[curr] + j * a->msize,
+			       (char *) a->enc[0].buf + j * a->fsize, (size_t) a->fsize);
+		}
+	}
+
+	return 0;
 }
 
 /*
  ***************************************************************************
- * Read an __nr_t value from file.
- * Such a value can be the new number of CPU saved after a RESTART record,
- * or the number of structures to read saved before the structures containing
- * statistics for an activity with a varying number of items in file.
+ * Save the statistics used to decode next record of a delta encoded file
+ * (along with current position in file), or restore them (when the file
+ * is read again from the saved position).
  *
  * IN:
- * @ifd		Input file descriptor.
- * @file	Name of file being read.
- * @file_magic	file_magic structure filled with file magic header data.
- * @endian_mismatch
- *		TRUE if file's data don't match current machine's endianness.
- * @arch_64	TRUE if file's data come from a 64 bit machine.
- * @non_zero	TRUE if value should not be zero.
- *
- * RETURNS:
- * __nr_t value, as read from file.
+ * @act		Array of activities.
+ * @dest	Index in arrays where statistics have to be copied to.
+ * @src		Index in arrays where statistics to copy are.
  ***************************************************************************
  */
-__nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
-		     int endian_mismatch, int arch_64, int non_zero)
+void copy_enc_states(struct activity *act[], int dest, int src)
 {
-	__nr_t value;
-
-	sa_fread(ifd, &value, sizeof(__nr_t), HARD_SIZE, UEOF_STOP);
+	int i;
+	struct enc_state *esd, *ess;
 
-	/* Normalize endianness for file_activity structures */
-	if (endian_mismatch) {
-		nr_types_nr[2] = 1;
-		swap_struct(nr_types_nr, &value, arch_64);
-	}
+	for (i = 0; i < NR_ACT; i++) {
+		esd = &act[i]->enc[dest];
+		ess = &act[i]->enc[src];
 
-	if ((non_zero && !value) || (value < 0)) {
-#ifdef DEBUG
-		fprintf(stderr, "%s: Value=%d\n",
-			__FUNCTION__, value);
-#endif
-		/* Value number cannot be zero or negative */
-		handle_invalid_sa_file(ifd, file_magic, file, 0);
+		if (ess->nr > 0) {
+			if (ess->size > esd->size) {
+				SREALLOC(esd->buf, char, ess->size);
+				esd->size = ess->size;
+			}
+			memcpy(esd->buf, ess->buf, ess->size);
+		}
+		esd->nr = ess->nr;
 	}
-
-	return value;
 }
 
 /*
@@ -1550,6 +3414,7 @@ __nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
  * @ifd		Input file descriptor.
  * @act_nr	Number of activities in file.
  * @file_actlst	Activity list in file.
+ * @sa_flags	File flags (FH_F_...) read from file header.
  * @endian_mismatch
  *		TRUE if file's data don't match current machine's endianness.
  * @arch_64	TRUE if file's data come from a 64 bit machine.
@@ -1558,6 +3423,7 @@ __nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
  *		header.
  * @oneof	Set to UEOF_CONT if an unexpected end of file should not make
  *		sadf stop. Default behavior is to stop on unexpected EOF.
+ * @uptime_cs	Uptime of current record (read from its header).
  *
  * RETURNS:
  * 2 if an error has been encountered (e.g. unexpected EOF),
@@ -1565,14 +3431,16 @@ __nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
  ***************************************************************************
  */
 int read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
-			 struct file_activity *file_actlst, int endian_mismatch,
-			 int arch_64, char *dfile, struct file_magic *file_magic,
-			 int oneof)
+			 struct file_activity *file_actlst, unsigned int sa_flags,
+			 int endian_mismatch, int arch_64, char *dfile,
+			 struct file_magic *file_magic, int oneof,
+			 unsigned long long uptime_cs)
 {
 	int i, j, p;
 	struct file_activity *fal = file_actlst;
 	off_t offset;
 	__nr_t nr_value;
+	unsigned int enc_len = 0;
 
 	for (i = 0; i < act_nr; i++, fal++) {
 
@@ -1598,15 +3466,18 @@ int read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
 			 * Ignore current activity in file, which is unknown to
 			 * current sysstat version or has an unknown format.
 			 */
-			if (nr_value) {
-				offset = (off_t) fal->size * (off_t) nr_value * (off_t) fal->nr2;
-				if (lseek(ifd, offset, SEEK_CUR) < offset) {
-					close(ifd);
-					perror("lseek");
-					if (oneof == UEOF_CONT)
+			if (nr_value > 0) {
+				if (IS_DELTA_ENCODED(sa_flags)) {
+					/* Skip encoded block */
+					if (read_enc_len(ifd, &enc_len, endian_mismatch, oneof) > 0)
 						return 2;
-					exit(2);
+					offset = (off_t) enc_len;
 				}
+				else {
+					offset = (off_t) fal->size * (off_t) nr_value * (off_t) fal->nr2;
+				}
+				if (sa_fread(ifd, NULL, (size_t) offset, HARD_SIZE, oneof) > 0)
+					return 2;
 			}
 			continue;
 		}
@@ -1618,7 +3489,20 @@ int read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
 #endif
 			handle_invalid_sa_file(ifd, file_magic, dfile, 0);
 		}
+		if (nr_value == NR_NOT_DUE) {
+			/* Activity not saved in this record */
+			carry_forward_stats(act[p], curr, uptime_cs);
+			continue;
+		}
+
 		act[p]->nr[curr] = nr_value;
+		act[p]->nr_carried[curr] = 0;
+		act[p]->uptime_cs[curr] = uptime_cs;
+		if (IS_CARRIED(act[p], !curr)) {
+			/* Previous statistics are those carried forward */
+			act[p]->nr[!curr] = act[p]->nr_carried[!curr];
+			act[p]->nr_carried[!curr] = 0;
+		}
 
 		/* Reallocate buffers if needed */
 		if (nr_value > act[p]->nr_allocated) {
@@ -1636,15 +3520,31 @@ int read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
                 }
 
 		/* OK, this is a known activity: Read the stats structures */
-		if ((nr_value > 0) &&
+		if ((nr_value > 0) && IS_DELTA_ENCODED(sa_flags)) {
+			if (read_enc_stats(ifd, act[p], curr, nr_value, endian_mismatch,
+					   dfile, file_magic, oneof) > 0)
+				return 2;
+		}
+		else if ((nr_value > 0) &&
 		    ((nr_value > 1) || (act[p]->nr2 > 1)) &&
 		    (act[p]->msize > act[p]->fsize)) {
+			/*
+			 * Read all the structures at once, then spread them out
+			 * (starting with the last one so that none is overwritten).
+			 */
+			if (sa_fread(ifd, act[p]->buf[curr],
+				 (size_t) act[p]->fsize * (size_t) nr_value * (size_t) act[p]->nr2,
+				 HARD_SIZE, oneof) > 0)
+				/* Unexpected EOF */
+				return 2;
 
-			for (j = 0; j < (nr_value * act[p]->nr2); j++) {
-				if (sa_fread(ifd, (char *) act[p]->buf[curr] + j * act[p]->msize,
-					 (size_t) act[p]->fsize, HARD_SIZE, oneof) > 0)
-					/* Unexpected EOF */
-					return 2;
+			for (j = nr_value * act[p]->nr2 - 1; j >= 0; j--) {
+				memmove((char *) act[p]->buf[curr] + (size_t) j * act[p]->msize,
+					(char *) act[p]->buf[curr] + (size_t) j * act[p]->fsize,
+					(size_t) act[p]->fsize);
+				memset((char *) act[p]->buf[curr] + (size_t) j * act[p]->msize
+								   + act[p]->fsize,
+				       0, (size_t) (act[p]->msize - act[p]->fsize));
 			}
 		}
 		else if (nr_value > 0) {
@@ -1663,21 +3563,12 @@ int read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
 			continue;
 		}
 
-		/* Normalize endianness for current activity's structures */
-		if (endian_mismatch) {
-			for (j = 0; j < (nr_value * act[p]->nr2); j++) {
-				swap_struct(act[p]->ftypes_nr, (char *) act[p]->buf[curr] + j * act[p]->msize,
-					    arch_64);
-			}
-		}
-
-		/* Remap structure's fields to those known by current sysstat version */
-		for (j = 0; j < (nr_value * act[p]->nr2); j++) {
-			if (remap_struct(act[p]->gtypes_nr, act[p]->ftypes_nr,
-					 (char *) act[p]->buf[curr] + j * act[p]->msize,
-					 act[p]->fsize, act[p]->msize, act[p]->msize) < 0)
-				return 2;
-		}
+		/*
+		 * Normalize endianness for current activity's structures and remap
+		 * their fields to those known by current sysstat version.
+		 */
+		if (apply_remap_plan(act[p], act[p]->buf[curr], nr_value * act[p]->nr2) < 0)
+			return 2;
 	}
 
 	return 0;
@@ -1724,13 +3615,15 @@ int sa_open_read_magic(int *fd, char *dfile, struct file_magic *file_magic,
 		}
 		exit(2);
 	}
+	/* Data of this file are not compressed until we know they are (see open_blk_reader()) */
+	open_blk_reader(*fd, 0, FALSE);
 
 	/* Read file magic data */
 	n = read(*fd, file_magic, FILE_MAGIC_SIZE);
 
 	if ((n != FILE_MAGIC_SIZE) ||
 	    ((file_magic->sysstat_magic != SYSSTAT_MAGIC) && (file_magic->sysstat_magic != SYSSTAT_MAGIC_SWAPPED)) ||
-	    ((file_magic->format_magic != FORMAT_MAGIC) && (file_magic->format_magic != FORMAT_MAGIC_SWAPPED) && !ignore)) {
+	    (!IS_READABLE_FORMAT(file_magic->format_magic) && !ignore)) {
 #ifdef DEBUG
 		fprintf(stderr, "%s: Bytes read=%d sysstat_magic=%x format_magic=%x\n",
 			__FUNCTION__, n, file_magic->sysstat_magic, file_magic->format_magic);
@@ -1758,7 +3651,9 @@ int sa_open_read_magic(int *fd, char *dfile, struct file_magic *file_magic,
 		/* header_size field exists only for sysstat versions 10.3.1 and later */
 		if ((file_magic->header_size <= MIN_FILE_HEADER_SIZE) ||
 		    (file_magic->header_size > MAX_FILE_HEADER_SIZE) ||
-		    ((file_magic->header_size < FILE_HEADER_SIZE) && !ignore)) {
+		    ((file_magic->header_size < FILE_HEADER_SIZE) && !ignore &&
+		     ((file_magic->format_magic == FORMAT_MAGIC) ||
+		      (file_magic->format_magic == FORMAT_MAGIC_SWAPPED)))) {
 #ifdef DEBUG
 			fprintf(stderr, "%s: header_size=%u\n",
 				__FUNCTION__, file_magic->header_size);
@@ -1779,8 +3674,7 @@ int sa_open_read_magic(int *fd, char *dfile, struct file_magic *file_magic,
 		}
 	}
 
-	if ((file_magic->format_magic != FORMAT_MAGIC) &&
-	    (file_magic->format_magic != FORMAT_MAGIC_SWAPPED))
+	if (!IS_READABLE_FORMAT(file_magic->format_magic))
 		/*
 		 * This is an old (or new) sa datafile format to
 		 * be read by sadf (since @ignore was set to TRUE).
@@ -1825,6 +3719,7 @@ void check_file_actlst(int *ifd, char *dfile, struct activity *act[], unsigned i
 	int i, j, k, p;
 	struct file_activity *fal;
 	void *buffer = NULL;
+	size_t bh_size;
 
 	/* Open sa data file and read its magic structure */
 	if (sa_open_read_magic(ifd, dfile, file_magic, ignore, endian_mismatch, TRUE) < 0)
@@ -1884,17 +3779,22 @@ void check_file_actlst(int *ifd, char *dfile, struct activity *act[], unsigned i
 	    (file_hdr->act_size > MAX_FILE_ACTIVITY_SIZE) ||
 	    (file_hdr->rec_size > MAX_RECORD_HEADER_SIZE) ||
 	    (MAP_SIZE(file_hdr->act_types_nr) > file_hdr->act_size) ||
-	    (MAP_SIZE(file_hdr->rec_types_nr) > file_hdr->rec_size)) {
+	    (MAP_SIZE(file_hdr->rec_types_nr) > file_hdr->rec_size) ||
+	    (file_hdr->sa_flags & ~FH_F_KNOWN)) {
 #ifdef DEBUG
-		fprintf(stderr, "%s: sa_act_nr=%d act_size=%u rec_size=%u map_size(act)=%u map_size(rec)=%u\n",
+		fprintf(stderr, "%s: sa_act_nr=%d act_size=%u rec_size=%u map_size(act)=%u map_size(rec)=%u flags=%x\n",
 			__FUNCTION__, file_hdr->sa_act_nr, file_hdr->act_size, file_hdr->rec_size,
-			MAP_SIZE(file_hdr->act_types_nr), MAP_SIZE(file_hdr->rec_types_nr));
+			MAP_SIZE(file_hdr->act_types_nr), MAP_SIZE(file_hdr->rec_types_nr),
+			file_hdr->sa_flags);
 #endif
 		/* Maybe a "false positive" sysstat datafile? */
 		goto format_error;
 	}
 
-	SREALLOC(buffer, char, file_hdr->act_size);
+	/* Buffer must be large enough to remap a structure smaller than expected */
+	bh_size = file_hdr->act_size > FILE_ACTIVITY_SIZE ?
+		  file_hdr->act_size : FILE_ACTIVITY_SIZE;
+	SREALLOC(buffer, char, bh_size);
 	SREALLOC(*file_actlst, struct file_activity, FILE_ACTIVITY_SIZE * file_hdr->sa_act_nr);
 	fal = *file_actlst;
 
@@ -1910,7 +3810,7 @@ void check_file_actlst(int *ifd, char *dfile, struct activity *act[], unsigned i
 		* then copy its contents to the expected structure.
 		*/
 		if (remap_struct(act_types_nr, file_hdr->act_types_nr, buffer,
-			     file_hdr->act_size, FILE_ACTIVITY_SIZE, file_hdr->act_size) < 0)
+			     file_hdr->act_size, FILE_ACTIVITY_SIZE, bh_size) < 0)
 			goto format_error;
 		memcpy(fal, buffer, FILE_ACTIVITY_SIZE);
 
@@ -2007,6 +3907,9 @@ void check_file_actlst(int *ifd, char *dfile, struct activity *act[], unsigned i
 		act[p]->nr_ini = fal->nr;
 		act[p]->nr2    = fal->nr2;
 		act[p]->fsize  = fal->size;
+
+		/* Work out how structures read from file will be converted */
+		compile_remap_plan(act[p], *endian_mismatch, *arch_64);
 		/*
 		 * This is a known activity with a known format
 		 * (magical number). Only such activities will be displayed.
@@ -2051,6 +3954,13 @@ void check_file_actlst(int *ifd, char *dfile, struct activity *act[], unsigned i
 		exit(1);
 	}
 
+	/*
+	 * Records from a compressed file will be read one block at a time.
+	 * Those from other regular files will be read from memory.
+	 */
+	open_blk_reader(*ifd, file_hdr->sa_flags, *endian_mismatch);
+	open_map_reader(*ifd);
+
 	return;
 
 format_error:
@@ -2060,6 +3970,162 @@ format_error:
 	handle_invalid_sa_file(*ifd, file_magic, dfile, 0);
 }
 
+/*
+ ***************************************************************************
+ * Use the time index of a data file (see IDX_SUFFIX) to go to the first
+ * record which may be displayed when a start time has been entered (option
+ * -s). Records before that one would have been skipped anyway. File is
+ * positioned on the last record preceding it at which reading may start
+ * (see IDX_F_SYNC). Records between them are read as usual.
+ * Nothing is done if the index doesn't exist or cannot be used: File is
+ * then read from its first record.
+ * NB: Must be called when file is positioned on its first record.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @dfile	Name of system activity data file.
+ * @act		Array of activities.
+ * @file_hdr	File's header structure.
+ * @l_flags	Flags used to get the time of each record (see
+ *		sa_get_record_timestamp_struct()).
+ * @use_loctime	TRUE if records time used to compare with @tm_start and
+ *		@tm_end is local time (sadf), FALSE if it is that given by
+ *		@l_flags (sar).
+ * @tm_start	Start time entered with option -s.
+ * @tm_end	End time entered with option -e.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @arch_64	TRUE if file's data come from a 64 bit machine.
+ *
+ * OUT:
+ * @act		Array of activities, whose number of items has been updated
+ *		if RESTART records have been skipped.
+ *
+ * RETURNS:
+ * 1 if file position has changed, 0 otherwise.
+ ***************************************************************************
+ */
+int seek_time_index(int ifd, char *dfile, struct activity *act[],
+		    struct file_header *file_hdr, unsigned int l_flags, int use_loctime,
+		    struct tstamp *tm_start, struct tstamp *tm_end, int endian_mismatch,
+		    int arch_64)
+{
+	char idx_file[MAX_FILE_LEN + sizeof(IDX_SUFFIX)];
+	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
+	struct idx_header idx_hdr;
+	struct idx_entry idx_buf[256], best;
+	struct record_header rec_hdr;
+	struct tm rectime, loctime, *rtm;
+	off_t fpos0;
+	ssize_t n;
+	int idx_fd, i, p, dp, found = FALSE, stop = FALSE;
+
+	if (!tm_start->use || endian_mismatch)
+		/* NB: Index has the endianness of sadc which created the data file */
+		return 0;
+
+	if ((fpos0 = sa_ftell(ifd)) < 0)
+		return 0;
+
+	snprintf(idx_file, sizeof(idx_file), "%s%s", dfile, IDX_SUFFIX);
+	if ((idx_fd = open(idx_file, O_RDONLY)) < 0)
+		return 0;
+
+	if ((read(idx_fd, &idx_hdr, IDX_HEADER_SIZE) != IDX_HEADER_SIZE) ||
+	    (idx_hdr.idx_magic != IDX_MAGIC) ||
+	    (idx_hdr.entry_size != IDX_ENTRY_SIZE) ||
+	    (idx_hdr.sa_ust_time != file_hdr->sa_ust_time) ||
+	    (idx_hdr.first_fpos != (long long) fpos0)) {
+		/* Index doesn't belong to this file or doesn't cover all of it */
+		close(idx_fd);
+		return 0;
+	}
+
+	memset(&rec_hdr, 0, sizeof(rec_hdr));
+	memset(&best, 0, IDX_ENTRY_SIZE);
+	rtm = use_loctime ? &loctime : &rectime;
+
+	while (!stop && ((n = read(idx_fd, idx_buf, sizeof(idx_buf))) >= (ssize_t) IDX_ENTRY_SIZE)) {
+
+		for (i = 0; i < n / (ssize_t) IDX_ENTRY_SIZE; i++) {
+
+			rec_hdr.ust_time = idx_buf[i].ust_time;
+			rec_hdr.hour     = idx_buf[i].hour;
+			rec_hdr.minute   = idx_buf[i].minute;
+			rec_hdr.second   = idx_buf[i].second;
+			if (sa_get_record_timestamp_struct(l_flags, &rec_hdr, &rectime,
+							   use_loctime ? &loctime : NULL)) {
+				/* Cannot tell whether this record would be displayed */
+				stop = TRUE;
+				break;
+			}
+
+			/*
+			 * Would this record be displayed? Use the same tests as
+			 * those made when reading the file.
+			 */
+			if ((idx_buf[i].record_type == R_RESTART) ||
+			    (idx_buf[i].record_type == R_COMMENT)) {
+				dp = (datecmp(rtm, tm_start) >= 0) &&
+				     (!tm_end->use || (datecmp(rtm, tm_end) <= 0));
+			}
+			else {
+				dp = (datecmp(rtm, tm_start) >= 0) &&
+				     (!tm_end->use || (datecmp(rtm, tm_end) < 0));
+			}
+
+			if (idx_buf[i].entry_flags & IDX_F_SYNC) {
+				best = idx_buf[i];
+				found = TRUE;
+			}
+			if (dp) {
+				stop = TRUE;
+				break;
+			}
+		}
+	}
+	close(idx_fd);
+
+	if (!found || (best.fpos == (long long) fpos0))
+		return 0;
+
+	/* Check that the record found in index is where it should be */
+	if ((sa_fseek(ifd, (off_t) best.fpos) < 0) ||
+	    read_record_hdr(ifd, rec_hdr_tmp, &rec_hdr, file_hdr, arch_64,
+			    endian_mismatch, UEOF_CONT, sizeof(rec_hdr_tmp)) ||
+	    (rec_hdr.ust_time != best.ust_time) ||
+	    (sa_fseek(ifd, (off_t) best.fpos) < 0)) {
+#ifdef DEBUG
+		fprintf(stderr, "%s: Invalid index entry: fpos=%lld ust_time=%llu\n",
+			__FUNCTION__, best.fpos, best.ust_time);
+#endif
+		if (sa_fseek(ifd, fpos0) < 0) {
+			perror("lseek");
+			close(ifd);
+			exit(2);
+		}
+		return 0;
+	}
+
+	/*
+	 * Apply the number of CPU given by the RESTART records skipped.
+	 * NB: @sa_cpu_nr in file header is left unchanged since it is only
+	 * displayed in report headers.
+	 */
+	if ((best.cpu_nr > 0) && (best.cpu_nr <= NR_CPUS + 1)) {
+		for (p = 0; p < NR_ACT; p++) {
+			if (HAS_PERSISTENT_VALUES(act[p]->options)) {
+				act[p]->nr_ini = best.cpu_nr;
+				if (act[p]->nr_ini > act[p]->nr_allocated) {
+					reallocate_all_buffers(act[p], act[p]->nr_ini);
+				}
+			}
+		}
+	}
+
+	return 1;
+}
+
 /*
  ***************************************************************************
  * Parse sar activities options (also used by sadf).
@@ -2142,6 +4208,10 @@ int parse_sar_opt(char *argv[], int *opt, struct activity *act[],
 			}
 			break;
 
+		case 'g':
+			SELECT_ACTIVITY(A_CGROUP);
+			break;
+
 		case 'H':
 			SELECT_ACTIVITY(A_HUGE);
 			break;
@@ -2182,6 +4252,15 @@ int parse_sar_opt(char *argv[], int *opt, struct activity *act[],
 			break;
 
 		case 'q':
+			if (!*(argv[*opt] + i + 1) && argv[*opt + 1] &&
+			    (!strcmp(argv[*opt + 1], K_PSI) || !strcmp(argv[*opt + 1], K_ALL))) {
+				(*opt)++;
+				if (!strcmp(argv[*opt], K_ALL)) {
+					SELECT_ACTIVITY(A_QUEUE);
+				}
+				SELECT_ACTIVITY(A_PSI);
+				return 0;
+			}
 			SELECT_ACTIVITY(A_QUEUE);
 			break;
 
@@ -2240,6 +4319,10 @@ int parse_sar_opt(char *argv[], int *opt, struct activity *act[],
 			SELECT_ACTIVITY(A_SWAP);
 			break;
 
+		case 'x':
+			SELECT_ACTIVITY(A_SELF);
+			break;
+
 		case 'y':
 			SELECT_ACTIVITY(A_SERIAL);
 			break;
@@ -2659,6 +4742,121 @@ double compute_ifutil(struct stats_net_dev *st_net_dev, double rx, double tx)
 	return 0;
 }
 
+/*
+ * Hash index of the cgroups found in a given sample. Cgroups can be
+ * created or removed at any time, so their position in the buffers may
+ * differ from one sample to the next. Entries are position + 1 in the
+ * buffer (0 means empty slot). Size of the table is a power of 2.
+ */
+static int *cg_index = NULL;
+static unsigned int cg_index_sz = 0;
+
+/*
+ ***************************************************************************
+ * Compute hash value of a cgroup name (FNV-1a).
+ *
+ * IN:
+ * @name	Cgroup name.
+ *
+ * RETURNS:
+ * Hash value.
+ ***************************************************************************
+ */
+static unsigned int hash_cgroup_name(const char *name)
+{
+	unsigned int h = 2166136261U;
+
+	while (*name) {
+		h ^= (unsigned char) *(name++);
+		h *= 16777619U;
+	}
+
+	return h;
+}
+
+/*
+ ***************************************************************************
+ * Build the hash index of the cgroups saved in a given sample. Must be
+ * called before using get_prev_cgroup() with the same sample.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @prev	Index in array where the sample to index is.
+ ***************************************************************************
+ */
+void index_cgroups(struct activity *a, int prev)
+{
+	struct stats_cgroup *scgp;
+	unsigned int sz = 16, h;
+	int j;
+
+	while (sz < 2 * (unsigned int) a->nr[prev]) {
+		sz <<= 1;
+	}
+	if (sz > cg_index_sz) {
+		SREALLOC(cg_index, int, sz * sizeof(int));
+		cg_index_sz = sz;
+	}
+	memset(cg_index, 0, cg_index_sz * sizeof(int));
+
+	for (j = 0; j < a->nr[prev]; j++) {
+		scgp = (struct stats_cgroup *) ((char *) a->buf[prev] + j * a->msize);
+
+		/* Linear probing */
+		for (h = hash_cgroup_name(scgp->cg_name) & (cg_index_sz - 1);
+		     cg_index[h];
+		     h = (h + 1) & (cg_index_sz - 1));
+		cg_index[h] = j + 1;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Look for the statistics of a cgroup in the sample which has been
+ * indexed by index_cgroups().
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @prev	Index in array where the indexed sample is.
+ * @sccg	Current statistics of the cgroup.
+ *
+ * RETURNS:
+ * Pointer on the statistics of the same cgroup in the indexed sample.
+ * If the cgroup didn't exist then (or has been removed then created again
+ * since), a pointer on a structure filled with zeros is returned, as all
+ * the counters of a cgroup start at zero when the cgroup is created.
+ ***************************************************************************
+ */
+struct stats_cgroup *get_prev_cgroup(struct activity *a, int prev,
+				     struct stats_cgroup *sccg)
+{
+	static struct stats_cgroup zero_cg;
+	struct stats_cgroup *scgp;
+	unsigned int h;
+
+	if (!cg_index_sz)
+		return &zero_cg;
+
+	for (h = hash_cgroup_name(sccg->cg_name) & (cg_index_sz - 1);
+	     cg_index[h];
+	     h = (h + 1) & (cg_index_sz - 1)) {
+
+		scgp = (struct stats_cgroup *) ((char *) a->buf[prev] +
+						(cg_index[h] - 1) * a->msize);
+		if (!strcmp(sccg->cg_name, scgp->cg_name)) {
+			if ((sccg->usage_usec < scgp->usage_usec) ||
+			    (sccg->io_rbytes < scgp->io_rbytes) ||
+			    (sccg->io_wbytes < scgp->io_wbytes))
+				/* Counters went backwards: This is a new cgroup */
+				return &zero_cg;
+
+			return scgp;
+		}
+	}
+
+	return &zero_cg;
+}
+
 /*
  ***************************************************************************
  * Read and replace unprintable characters in comment with ".".
@@ -2769,7 +4967,8 @@ int sa_get_record_timestamp_struct(unsigned int l_flags, struct record_header *r
  * IN:
  * @l_flags	Flags indicating the type of time expected by the user.
  * 		S_F_SEC_EPOCH means the time should be expressed in seconds
- * 		since the epoch (01/01/1970).
+ * 		since the epoch (01/01/1970). S_F_SUBSEC_TIME means that
+ *		milliseconds should be added to the time.
  * @record_hdr	Record header containing the number of seconds since the
  * 		epoch.
  * @cur_date	String where timestamp's date will be saved. May be NULL.
@@ -2809,6 +5008,13 @@ void set_record_timestamp_string(unsigned int l_flags, struct record_header *rec
 			strftime(cur_time, len, "%H:%M:%S", rectime);
 		}
 	}
+
+	if (DISPLAY_SUBSEC_TIME(l_flags)) {
+		/* Records may be less than a second apart: Add milliseconds */
+		size_t n = strlen(cur_time);
+
+		snprintf(cur_time + n, len - n, ".%03u", record_hdr->ust_usec / 1000);
+	}
 }
 
 /*
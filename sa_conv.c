@@ -84,6 +84,12 @@ int upgrade_magic_section(char dfile[], int *fd, int stdfd, struct file_magic *f
 			return 0;
 			break;
 
+		case FORMAT_MAGIC_2175:
+		case FORMAT_MAGIC_2175_SWAPPED:
+			*previous_format = FORMAT_MAGIC_2175;
+			return 0;
+			break;
+
 		case FORMAT_MAGIC_2171:
 		case FORMAT_MAGIC_2171_SWAPPED:
 			*previous_format = FORMAT_MAGIC_2171;
@@ -1180,17 +1186,24 @@ void upgrade_stats_filesystem(struct activity *act[], int p, int st_size)
 {
 	int i;
 	struct stats_filesystem *sfc;
-	struct stats_filesystem_8a *sfp;
+	struct stats_filesystem_8a sf8a, *sfp = &sf8a;
 
 	for (i = 0; i < act[p]->nr_ini; i++) {
-		sfp = (struct stats_filesystem_8a *) ((char *) act[p]->buf[0] + i * act[p]->msize);
-		sfc = (struct stats_filesystem *)    ((char *) act[p]->buf[1] + i * act[p]->fsize);
+		/*
+		 * Items read from file may not be aligned as required by
+		 * struct stats_filesystem_8a: Work on an aligned copy.
+		 */
+		memset(&sf8a, 0, sizeof(sf8a));
+		memcpy(&sf8a, (char *) act[p]->buf[0] + i * act[p]->msize,
+		       MINIMUM(st_size, sizeof(sf8a)));
+		sfc = (struct stats_filesystem *) ((char *) act[p]->buf[1] + i * act[p]->fsize);
 
 		sfc->f_blocks = sfp->f_blocks;
 		sfc->f_bfree = sfp->f_bfree;
 		sfc->f_bavail = sfp->f_bavail;
 		sfc->f_files = sfp->f_files;
 		sfc->f_ffree = sfp->f_ffree;
+		sfc->stale = FALSE;
 		strncpy(sfc->fs_name, sfp->fs_name, MAX_FS_LEN);
 		sfc->fs_name[MAX_FS_LEN - 1] = '\0';
 
@@ -1459,6 +1472,7 @@ int upgrade_record_header(int fd, int stdfd, struct old_record_header *orec_hdr,
 	struct record_header rec_hdr;
 
 	/* Convert current record header */
+	memset(&rec_hdr, 0, RECORD_HEADER_SIZE);
 	rec_hdr.uptime_cs = orec_hdr->uptime0 * 100 / HZ;	/* Uptime in cs, not jiffies */
 	rec_hdr.ust_time = (unsigned long long) orec_hdr->ust_time;
 	rec_hdr.record_type = orec_hdr->record_type;
@@ -1904,6 +1918,536 @@ int upgrade_stat_records(int fd, int stdfd, struct activity *act[], struct file_
 	return 0;
 }
 
+/*
+ ***************************************************************************
+ * Tell if the statistics structures of an activity saved in a file with the
+ * 0x2175 format should be remapped to their current format when the file
+ * is upgraded. Only structures which have been extended are remapped.
+ *
+ * IN:
+ * @act		Array of activities.
+ * @fal		Structure describing the activity (normalized).
+ *
+ * RETURNS:
+ * Position of the activity in the activity list, or -1 if its structures
+ * are to be copied unchanged.
+ ***************************************************************************
+ */
+int get_remapped_act(struct activity *act[], struct file_activity *fal)
+{
+	int p, j;
+
+	if (((p = get_activity_position(act, fal->id, RESUME_IF_NOT_FOUND)) < 0) ||
+	    (act[p]->magic != fal->magic) || (act[p]->fsize < fal->size))
+		return -1;
+
+	for (j = 0; j < 3; j++) {
+		if (act[p]->gtypes_nr[j] < fal->types_nr[j])
+			return -1;
+	}
+	if ((act[p]->fsize == fal->size) &&
+	    (act[p]->gtypes_nr[0] == fal->types_nr[0]) &&
+	    (act[p]->gtypes_nr[1] == fal->types_nr[1]) &&
+	    (act[p]->gtypes_nr[2] == fal->types_nr[2]))
+		/* Same format */
+		return -1;
+
+	return p;
+}
+
+/*
+ ***************************************************************************
+ * Copy file's header and activity list sections of a data file with
+ * current format, setting or clearing delta encoding flag (FH_F_DELTA).
+ * With a file in 0x2175 format, header and activity list are upgraded
+ * instead (statistics encoding is unchanged).
+ *
+ * IN:
+ * @fd		File descriptor for sa datafile to convert.
+ * @stdfd	File descriptor for STDOUT.
+ * @act		Array of activities.
+ * @file_magic	File's magic structure.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current	machine's
+ *		endianness.
+ * @upgrade	TRUE if the file has the 0x2175 format.
+ *
+ * OUT:
+ * @file_hdr	File's header structure (up-to-date format, normalized).
+ *		Its @sa_flags field contains the new flags. Sizes of
+ *		structures are those of the file being converted.
+ * @file_actlst	Activity list in file (normalized).
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int convert_enc_header_section(int fd, int stdfd, struct activity *act[],
+			       struct file_magic *file_magic,
+			       struct file_header *file_hdr,
+			       struct file_activity **file_actlst,
+			       int endian_mismatch, int upgrade, int *arch_64)
+{
+	struct file_magic fm;
+	struct file_header fh;
+	struct file_activity *fal, ufa;
+	unsigned int fm_types_nr[] = {FILE_MAGIC_ULL_NR, FILE_MAGIC_UL_NR, FILE_MAGIC_U_NR};
+	char *buffer = NULL;
+	size_t bh_size;
+	int i, j, p;
+
+	if ((file_magic->header_size <= MIN_FILE_HEADER_SIZE) ||
+	    (file_magic->header_size > MAX_FILE_HEADER_SIZE)) {
+		fprintf(stderr, _("Invalid data file header\n"));
+		return -1;
+	}
+
+	/* Read file header and remap its fields to those of current version */
+	bh_size = file_magic->header_size > FILE_HEADER_SIZE ? file_magic->header_size
+							      : FILE_HEADER_SIZE;
+	SREALLOC(buffer, char, bh_size);
+	sa_fread(fd, buffer, (size_t) file_magic->header_size, HARD_SIZE, UEOF_STOP);
+	if (remap_struct(hdr_types_nr, file_magic->hdr_types_nr, buffer,
+			 file_magic->header_size, FILE_HEADER_SIZE, bh_size) < 0) {
+		fprintf(stderr, _("Invalid data file header\n"));
+		free(buffer);
+		return -1;
+	}
+	memcpy(file_hdr, buffer, FILE_HEADER_SIZE);
+	free(buffer);
+	buffer = NULL;
+
+	*arch_64 = (file_hdr->sa_sizeof_long == SIZEOF_LONG_64BIT);
+	if (endian_mismatch) {
+		swap_struct(hdr_types_nr, file_hdr, *arch_64);
+	}
+
+	if ((file_hdr->sa_act_nr > MAX_NR_ACT) ||
+	    (file_hdr->act_size > MAX_FILE_ACTIVITY_SIZE) ||
+	    (file_hdr->rec_size > MAX_RECORD_HEADER_SIZE) ||
+	    (MAP_SIZE(file_hdr->act_types_nr) > file_hdr->act_size) ||
+	    (MAP_SIZE(file_hdr->rec_types_nr) > file_hdr->rec_size) ||
+	    (file_hdr->sa_flags & ~FH_F_KNOWN)) {
+		fprintf(stderr, _("Invalid data file header\n"));
+		return -1;
+	}
+	if (upgrade && file_hdr->sa_flags) {
+		/* No sysstat release created such files */
+		fprintf(stderr, _("Cannot convert the format of this file\n"));
+		return -1;
+	}
+
+	/* Write file's magic structure. Header will have the up-to-date format */
+	memcpy(&fm, file_magic, FILE_MAGIC_SIZE);
+	fm.header_size = FILE_HEADER_SIZE;
+	for (i = 0; i < 3; i++) {
+		fm.hdr_types_nr[i] = hdr_types_nr[i];
+	}
+	if (upgrade) {
+		struct file_magic cfm;
+
+		fm.format_magic = (endian_mismatch ? FORMAT_MAGIC_SWAPPED : FORMAT_MAGIC);
+
+		/* Indicate that file has been upgraded */
+		enum_version_nr(&cfm);
+		fm.upgraded = (cfm.sysstat_patchlevel << 8) + cfm.sysstat_sublevel + 1;
+	}
+	if (endian_mismatch) {
+		/* Start swapping at field "header_size" position */
+		swap_struct(fm_types_nr, &fm.header_size, 0);
+	}
+	if (write_all(stdfd, &fm, FILE_MAGIC_SIZE) != FILE_MAGIC_SIZE) {
+		fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+		return -1;
+	}
+	fprintf(stderr, "file_magic: OK\n");
+
+	/* Write file's header with new encoding, or with up-to-date structures sizes */
+	if (!upgrade) {
+		file_hdr->sa_flags ^= FH_F_DELTA;
+	}
+	memcpy(&fh, file_hdr, FILE_HEADER_SIZE);
+	if (upgrade) {
+		fh.act_size = FILE_ACTIVITY_SIZE;
+		fh.rec_size = RECORD_HEADER_SIZE;
+		for (i = 0; i < 3; i++) {
+			fh.act_types_nr[i] = act_types_nr[i];
+			fh.rec_types_nr[i] = rec_types_nr[i];
+		}
+	}
+	if (endian_mismatch) {
+		swap_struct(hdr_types_nr, &fh, *arch_64);
+	}
+	if (write_all(stdfd, &fh, FILE_HEADER_SIZE) != FILE_HEADER_SIZE) {
+		fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+		return -1;
+	}
+	fprintf(stderr, "file_header: OK\n");
+
+	/* Copy activity list, keeping a normalized copy of it */
+	bh_size = file_hdr->act_size > FILE_ACTIVITY_SIZE ? file_hdr->act_size
+							  : FILE_ACTIVITY_SIZE;
+	SREALLOC(buffer, char, bh_size);
+	SREALLOC(*file_actlst, struct file_activity, FILE_ACTIVITY_SIZE * file_hdr->sa_act_nr);
+	fal = *file_actlst;
+
+	for (i = 0; i < file_hdr->sa_act_nr; i++, fal++) {
+
+		sa_fread(fd, buffer, (size_t) file_hdr->act_size, HARD_SIZE, UEOF_STOP);
+		if (!upgrade &&
+		    (write_all(stdfd, buffer, file_hdr->act_size) != file_hdr->act_size))
+			goto write_error;
+
+		if (remap_struct(act_types_nr, file_hdr->act_types_nr, buffer,
+				 file_hdr->act_size, FILE_ACTIVITY_SIZE, bh_size) < 0) {
+			free(buffer);
+			return -1;
+		}
+		memcpy(fal, buffer, FILE_ACTIVITY_SIZE);
+		if (endian_mismatch) {
+			swap_struct(act_types_nr, fal, *arch_64);
+		}
+
+		if ((fal->nr < 1) || (fal->nr2 < 1) ||
+		    (fal->nr > NR_MAX) || (fal->nr2 > NR2_MAX) ||
+		    (fal->size <= 0)) {
+			fprintf(stderr, _("Invalid activity list\n"));
+			free(buffer);
+			return -1;
+		}
+
+		if (upgrade) {
+			/*
+			 * Write activity with up-to-date format. Its statistics
+			 * structures may also be remapped to their current format.
+			 */
+			memcpy(&ufa, fal, FILE_ACTIVITY_SIZE);
+			if ((p = get_remapped_act(act, fal)) >= 0) {
+				ufa.size = act[p]->fsize;
+				for (j = 0; j < 3; j++) {
+					ufa.types_nr[j] = act[p]->gtypes_nr[j];
+				}
+			}
+			if (endian_mismatch) {
+				swap_struct(act_types_nr, &ufa, *arch_64);
+			}
+			if (write_all(stdfd, &ufa, FILE_ACTIVITY_SIZE) != FILE_ACTIVITY_SIZE)
+				goto write_error;
+		}
+	}
+	free(buffer);
+	fprintf(stderr, "file_activity: OK\n");
+
+	return 0;
+
+write_error:
+	fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+	free(buffer);
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Write data to the file being converted, or to its block of records if it
+ * is compressed.
+ *
+ * IN:
+ * @stdfd	File descriptor for STDOUT.
+ * @ob		Block of records being written (its file descriptor is -1 if
+ *		file is not compressed).
+ * @buf		Data to write.
+ * @size	Size of data.
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int write_enc_data(int stdfd, struct sa_blk *ob, const void *buf, size_t size)
+{
+	if (ob->fd >= 0) {
+		write_blk_data(ob, buf, size);
+		return 0;
+	}
+
+	return (write_all(stdfd, buf, size) != size) ? -1 : 0;
+}
+
+/*
+ ***************************************************************************
+ * Copy the statistics of a record, encoding (FH_F_DELTA set in new file
+ * header) or decoding (FH_F_DELTA cleared) them, or copying them (remapped
+ * to their current format if needed).
+ *
+ * IN:
+ * @fd		File descriptor for sa datafile to convert.
+ * @stdfd	File descriptor for STDOUT.
+ * @act		Array of activities.
+ * @ob		Block of records being written.
+ * @file_hdr	File's header structure (with new flags).
+ * @file_actlst	Activity list in file.
+ * @es		Encoding state of each activity in list.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current	machine's
+ *		endianness.
+ * @keyframe	TRUE if a keyframe should be written.
+ * @copy	TRUE if statistics should be copied unchanged.
+ * @blk		Buffer for encoded blocks.
+ * @blk_size	Size of @blk.
+ * @st		Buffer for statistics structures.
+ *
+ * OUT:
+ * @blk		Buffer for encoded blocks (possibly reallocated).
+ * @blk_size	New size of @blk.
+ * @st		Buffer for statistics structures (possibly reallocated).
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int convert_enc_stats(int fd, int stdfd, struct activity *act[], struct sa_blk *ob,
+		      struct file_header *file_hdr,
+		      struct file_activity *file_actlst, struct enc_state *es,
+		      int endian_mismatch, int keyframe, int copy, unsigned char **blk,
+		      size_t *blk_size, char **st)
+{
+	struct file_activity *fal;
+	size_t st_size, bound;
+	unsigned int len;
+	int i, j, p;
+	__nr_t nr, nr_value;
+
+	for (i = 0, fal = file_actlst; i < file_hdr->sa_act_nr; i++, fal++) {
+
+		if (fal->has_nr) {
+			sa_fread(fd, &nr_value, sizeof(__nr_t), HARD_SIZE, UEOF_STOP);
+			if (write_enc_data(stdfd, ob, &nr_value, sizeof(__nr_t)) < 0)
+				goto write_error;
+			if (endian_mismatch) {
+				nr_value = (__nr_t) __builtin_bswap32((unsigned int) nr_value);
+			}
+		}
+		else {
+			nr_value = fal->nr;
+		}
+
+		if (nr_value > NR_MAX) {
+			fprintf(stderr, _("Invalid number of items\n"));
+			return -1;
+		}
+		if (nr_value <= 0)
+			/* No items, or activity not saved in this record */
+			continue;
+
+		nr = nr_value * fal->nr2;
+		st_size = (size_t) fal->size;
+
+		if (copy) {
+			if ((p = get_remapped_act(act, fal)) < 0) {
+				/* Structures are copied unchanged */
+				SREALLOC(*st, char, st_size * (size_t) nr);
+				sa_fread(fd, *st, st_size * (size_t) nr, HARD_SIZE, UEOF_STOP);
+				if (write_enc_data(stdfd, ob, *st, st_size * nr) < 0)
+					goto write_error;
+				continue;
+			}
+
+			/* Remap each structure to the size known by current version */
+			SREALLOC(*st, char, act[p]->fsize);
+			for (j = 0; j < nr; j++) {
+				memset(*st, 0, act[p]->fsize);
+				sa_fread(fd, *st, st_size, HARD_SIZE, UEOF_STOP);
+				if (remap_struct(act[p]->gtypes_nr, fal->types_nr, *st,
+						 fal->size, act[p]->fsize, act[p]->fsize) < 0) {
+					fprintf(stderr, _("Cannot convert the format of this file\n"));
+					return -1;
+				}
+				if (write_enc_data(stdfd, ob, *st, act[p]->fsize) < 0)
+					goto write_error;
+			}
+			continue;
+		}
+
+		bound = get_enc_bound(fal->types_nr, st_size, nr);
+
+		if (bound > *blk_size) {
+			SREALLOC(*blk, unsigned char, bound);
+			*blk_size = bound;
+		}
+
+		if (IS_DELTA_ENCODED(file_hdr->sa_flags)) {
+			/* Encode structures read from file */
+			SREALLOC(*st, char, st_size * (size_t) nr);
+			sa_fread(fd, *st, st_size * (size_t) nr, HARD_SIZE, UEOF_STOP);
+
+			len = (unsigned int) encode_act_stats(&es[i], fal->types_nr, st_size,
+							      *st, nr, keyframe, *blk);
+			nr_value = (__nr_t) len;
+			if (endian_mismatch) {
+				nr_value = (__nr_t) __builtin_bswap32(len);
+			}
+			if ((write_enc_data(stdfd, ob, &nr_value, sizeof(unsigned int)) < 0) ||
+			    (write_enc_data(stdfd, ob, *blk, len) < 0))
+				goto write_error;
+		}
+		else {
+			/* Decode structures read from file */
+			read_enc_len(fd, &len, endian_mismatch, UEOF_STOP);
+			if (!len || (len > bound)) {
+				fprintf(stderr, _("Invalid encoded statistics\n"));
+				return -1;
+			}
+			sa_fread(fd, *blk, (size_t) len, HARD_SIZE, UEOF_STOP);
+
+			if (decode_act_stats(&es[i], fal->types_nr, st_size, *blk, len, nr) < 0) {
+				fprintf(stderr, _("Invalid encoded statistics\n"));
+				return -1;
+			}
+			if (write_enc_data(stdfd, ob, es[i].buf, st_size * nr) < 0)
+				goto write_error;
+		}
+	}
+
+	return 0;
+
+write_error:
+	fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Copy statistics records of a data file with current format, encoding
+ * (FH_F_DELTA set in new file header) or decoding (FH_F_DELTA cleared)
+ * statistics structures. Records are otherwise written unchanged.
+ * When a file in 0x2175 format is upgraded, record headers are written
+ * with the up-to-date format and statistics are copied without being encoded.
+ * Records of a compressed file (FH_F_COMPRESS) are decompressed when they
+ * are read, then grouped in new compressed blocks when they are written.
+ *
+ * IN:
+ * @fd		File descriptor for sa datafile to convert.
+ * @stdfd	File descriptor for STDOUT.
+ * @act		Array of activities.
+ * @file_hdr	File's header structure (with new flags).
+ * @file_actlst	Activity list in file.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current	machine's
+ *		endianness.
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
+ * @upgrade	TRUE if the file has the 0x2175 format.
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int convert_enc_stat_records(int fd, int stdfd, struct activity *act[],
+			     struct file_header *file_hdr,
+			     struct file_activity *file_actlst, int endian_mismatch,
+			     int arch_64, int upgrade)
+{
+	struct record_header rec_hdr;
+	struct enc_state *es;
+	struct sa_blk ob;
+	char rec_buf[MAX_RECORD_HEADER_SIZE], *st = NULL;
+	char file_comment[MAX_COMMENT_LEN];
+	unsigned char *blk = NULL;
+	size_t blk_size = 0;
+	unsigned long rec_nr = 0;
+	int i, rc = -1;
+	__nr_t nr_value;
+
+	/* Records of a compressed file are read then written one block at a time */
+	open_blk_reader(fd, file_hdr->sa_flags, endian_mismatch);
+	open_map_reader(fd);
+	memset(&ob, 0, sizeof(ob));
+	init_blk(&ob, IS_COMPRESSED(file_hdr->sa_flags) ? stdfd : -1, 0, endian_mismatch);
+
+	es = (struct enc_state *) calloc(file_hdr->sa_act_nr ? file_hdr->sa_act_nr : 1,
+					 sizeof(struct enc_state));
+	if (!es) {
+		perror("calloc");
+		return -1;
+	}
+
+	fprintf(stderr, _("Statistics:\n"));
+
+	while (!sa_fread(fd, rec_buf, (size_t) file_hdr->rec_size, SOFT_SIZE, UEOF_STOP)) {
+
+		/* Record header is written unchanged, unless it is upgraded */
+		if (!upgrade &&
+		    (write_enc_data(stdfd, &ob, rec_buf, file_hdr->rec_size) < 0))
+			goto write_error;
+
+		if (remap_struct(rec_types_nr, file_hdr->rec_types_nr, rec_buf,
+				 file_hdr->rec_size, RECORD_HEADER_SIZE, sizeof(rec_buf)) < 0)
+			goto out;
+		if (upgrade &&
+		    (write_enc_data(stdfd, &ob, rec_buf, RECORD_HEADER_SIZE) < 0))
+			goto write_error;
+		memcpy(&rec_hdr, rec_buf, RECORD_HEADER_SIZE);
+		if (endian_mismatch) {
+			rec_hdr.ust_time = __builtin_bswap64(rec_hdr.ust_time);
+		}
+
+		if (rec_hdr.record_type == R_COMMENT) {
+			/* Copy the comment */
+			sa_fread(fd, file_comment, MAX_COMMENT_LEN, HARD_SIZE, UEOF_STOP);
+			if (write_enc_data(stdfd, &ob, file_comment, MAX_COMMENT_LEN) < 0)
+				goto write_error;
+			fprintf(stderr, "C");
+		}
+		else if (rec_hdr.record_type == R_RESTART) {
+			/* Copy the number of CPU following the RESTART record */
+			sa_fread(fd, &nr_value, sizeof(__nr_t), HARD_SIZE, UEOF_STOP);
+			if (write_enc_data(stdfd, &ob, &nr_value, sizeof(__nr_t)) < 0)
+				goto write_error;
+			fprintf(stderr, "R");
+		}
+		else if (convert_enc_stats(fd, stdfd, act, &ob, file_hdr, file_actlst, es, endian_mismatch,
+					   !(rec_nr++ % ENC_KEYFRAME_INTERVAL), upgrade,
+					   &blk, &blk_size, &st) < 0)
+			goto out;
+		else {
+			fprintf(stderr, ".");
+		}
+
+		if ((ob.fd >= 0) &&
+		    ((i = commit_blk(&ob, rec_hdr.ust_time, FALSE)) != 0)) {
+			if (i < 0)
+				goto write_error;
+			if (IS_DELTA_ENCODED(file_hdr->sa_flags)) {
+				/* A new block has been started: It must be decoded independently */
+				for (i = 0; i < file_hdr->sa_act_nr; i++) {
+					es[i].nr = 0;
+				}
+			}
+		}
+	}
+
+	if (flush_blk(&ob) < 0)
+		goto write_error;
+
+	fprintf(stderr, "\n");
+	rc = 0;
+	goto out;
+
+write_error:
+	fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+
+out:
+	for (i = 0; i < file_hdr->sa_act_nr; i++) {
+		free(es[i].buf);
+	}
+	free(es);
+	free(st);
+	free(blk);
+	free(ob.raw);
+	free(ob.comp);
+
+	return rc;
+}
+
 /*
  ***************************************************************************
  * Close file descriptors and exit.
@@ -1932,6 +2476,9 @@ void upgrade_exit(int fd, int stdfd, int exit_code)
  * Convert a sysstat activity data file from a previous version to the
  * up-to-date format. Presently data files from sysstat version 9.1.6 and
  * later are converted to current sysstat version format.
+ * A data file which already has the up-to-date format is converted from
+ * plain to delta encoding (see FH_F_DELTA), or from delta to plain encoding.
+ * A data file with the 0x2175 format only gets up-to-date headers.
  *
  * IN:
  * @dfile	System activity data file name.
@@ -1941,7 +2488,7 @@ void upgrade_exit(int fd, int stdfd, int exit_code)
 void convert_file(char dfile[], struct activity *act[])
 {
 	int fd = 0, stdfd = 0, previous_format = 0;
-	int arch_64 = TRUE;
+	int arch_64 = TRUE, upgrade;
 	unsigned int vol_act_nr = 0, hdr_size;
 	struct file_magic file_magic;
 	struct file_header file_hdr;
@@ -1959,9 +2506,31 @@ void convert_file(char dfile[], struct activity *act[])
 				  &previous_format, &endian_mismatch) < 0) {
 		upgrade_exit(fd, stdfd, 2);
 	}
-	if (previous_format == FORMAT_MAGIC) {
-		/* Nothing to do at the present time */
-		fprintf(stderr, _("\nFile format already up-to-date\n"));
+	if ((previous_format == FORMAT_MAGIC) || (previous_format == FORMAT_MAGIC_2175)) {
+		/*
+		 * Format already up-to-date: Switch statistics encoding.
+		 * Format 0x2175: Upgrade headers.
+		 */
+		upgrade = (previous_format == FORMAT_MAGIC_2175);
+		if ((convert_enc_header_section(fd, stdfd, act, &file_magic, &file_hdr, &file_actlst,
+						endian_mismatch, upgrade, &arch_64) < 0) ||
+		    (convert_enc_stat_records(fd, stdfd, act, &file_hdr, file_actlst,
+					      endian_mismatch, arch_64, upgrade) < 0)) {
+			upgrade_exit(fd, stdfd, 2);
+		}
+		free(file_actlst);
+
+		if (upgrade) {
+			fprintf(stderr,
+				_("File successfully converted to sysstat format version %s\n"),
+				VERSION);
+		}
+		else if (IS_DELTA_ENCODED(file_hdr.sa_flags)) {
+			fprintf(stderr, _("File successfully converted to delta encoding\n"));
+		}
+		else {
+			fprintf(stderr, _("File successfully converted to plain encoding\n"));
+		}
 		goto success;
 	}
 
@@ -27,6 +27,8 @@
 
 extern unsigned int flags;
 extern struct record_header record_hdr;
+extern struct activity *act[];
+extern struct stats_self self_cost[];
 
 /*
  ***************************************************************************
@@ -44,9 +46,9 @@ extern struct record_header record_hdr;
  */
 void *reallocate_buffer(struct activity *a)
 {
-	SREALLOC(a->_buf0, void,
-		 (size_t) a->msize * (size_t) a->nr_allocated * 2);	/* a->nr2 value is 1 */
-	memset(a->_buf0, 0, (size_t) a->msize * (size_t) a->nr_allocated * 2);
+	/* Only additional space is initialized: Existing items will be read again */
+	resize_act_buffers(a, 1,
+			   (size_t) a->msize * (size_t) a->nr_allocated * 2);	/* a->nr2 value is 1 */
 
 	a->nr_allocated *= 2;	/* NB: nr_allocated > 0 */
 
@@ -163,6 +165,28 @@ __read_funct_t wrap_read_loadavg(struct activity *a)
 	return;
 }
 
+/*
+ ***************************************************************************
+ * Read pressure stall information.
+ *
+ * IN:
+ * @a	Activity structure.
+ *
+ * OUT:
+ * @a	Activity structure with statistics.
+ ***************************************************************************
+ */
+__read_funct_t wrap_read_psi(struct activity *a)
+{
+	struct stats_psi *st_psi
+		= (struct stats_psi *) a->_buf0;
+
+	/* Read PSI stats */
+	a->_nr0 = read_psi(st_psi);
+
+	return;
+}
+
 /*
  ***************************************************************************
  * Read memory statistics.
@@ -370,13 +394,6 @@ __read_funct_t wrap_read_net_dev(struct activity *a)
 
 	a->_nr0 = nr_read;
 
-	if (!nr_read)
-		/* No data read. Exit */
-		return;
-
-	/* Read duplex and speed info for each interface */
-	read_if_info(st_net_dev, nr_read);
-
 	return;
 }
 
@@ -1160,6 +1177,72 @@ __read_funct_t wrap_read_softnet(struct activity *a)
 	return;
 }
 
+/*
+ ***************************************************************************
+ * Read cgroup v2 statistics.
+ *
+ * IN:
+ * @a	Activity structure.
+ *
+ * OUT:
+ * @a	Activity structure with statistics.
+ ***************************************************************************
+ */
+__read_funct_t wrap_read_cgroup(struct activity *a)
+{
+	struct stats_cgroup *st_cg
+		= (struct stats_cgroup *) a->_buf0;
+	__nr_t nr_read = 0;
+
+	/* Read cgroups statistics */
+	do {
+		nr_read = read_cgroup(st_cg, a->nr_allocated);
+
+		if (nr_read < 0) {
+			/* Buffer needs to be reallocated */
+			st_cg = (struct stats_cgroup *) reallocate_buffer(a);
+		}
+	}
+	while (nr_read < 0);
+
+	a->_nr0 = nr_read;
+
+	return;
+}
+
+/*
+ ***************************************************************************
+ * Save what it has cost so far to read and count each collected activity.
+ * Costs are measured by sadc while reading the other activities, so
+ * this one should be read last.
+ *
+ * IN:
+ * @a	Activity structure.
+ *
+ * OUT:
+ * @a	Activity structure with statistics.
+ ***************************************************************************
+ */
+__read_funct_t wrap_read_self(struct activity *a)
+{
+	struct stats_self *st_self
+		= (struct stats_self *) a->_buf0;
+	int i;
+	__nr_t nr_read = 0;
+
+	for (i = 0; (i < NR_ACT) && (nr_read < a->nr_allocated); i++) {
+		if (!IS_COLLECTED(act[i]->options) || (act[i] == a))
+			continue;
+
+		st_self[nr_read] = self_cost[i];
+		st_self[nr_read++].id = act[i]->id;
+	}
+
+	a->_nr0 = nr_read;
+
+	return;
+}
+
 /*
  ***************************************************************************
  * Count number of interrupts that are in /proc/stat file.
@@ -1443,3 +1526,71 @@ __nr_t wrap_get_fchost_nr(struct activity *a)
 
 	return 0;
 }
+
+/*
+ ***************************************************************************
+ * Get number of cgroups in the cgroup v2 hierarchy.
+ *
+ * IN:
+ * @a	Activity structure.
+ *
+ * RETURNS:
+ * Number of cgroups. Number cannot exceed MAX_NR_CGROUPS.
+ ***************************************************************************
+ */
+__nr_t wrap_get_cgroup_nr(struct activity *a)
+{
+	__nr_t n = 0;
+
+	if ((n = get_cgroup_nr()) > 0) {
+		if (n > MAX_NR_CGROUPS)
+			return MAX_NR_CGROUPS;
+		else
+			return n;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Check that pressure stall information is available.
+ *
+ * IN:
+ * @a	Activity structure.
+ *
+ * RETURNS:
+ * 1 if PSI can be read, 0 otherwise.
+ ***************************************************************************
+ */
+__nr_t wrap_get_psi_nr(struct activity *a)
+{
+	struct stats_psi st_psi;
+
+	return read_psi(&st_psi);
+}
+
+/*
+ ***************************************************************************
+ * Get number of activities whose collection cost will be saved.
+ *
+ * IN:
+ * @a	Activity structure.
+ *
+ * RETURNS:
+ * Number of collected activities, not including current one.
+ ***************************************************************************
+ */
+__nr_t wrap_get_self_nr(struct activity *a)
+{
+	int i;
+	__nr_t n = 0;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (IS_COLLECTED(act[i]->options) && (act[i] != a)) {
+			n++;
+		}
+	}
+
+	return n;
+}
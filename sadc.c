@@ -20,6 +20,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
@@ -28,6 +29,7 @@
 #include <time.h>
 #include <errno.h>
 #include <signal.h>
+#include <pthread.h>
 #include <dirent.h>
 #include <sys/file.h>
 #include <sys/stat.h>
@@ -54,7 +56,7 @@
 char *sccsid(void) { return (SCCSID); }
 #endif
 
-long interval = 0;
+long long interval = 0;
 unsigned int flags = 0;
 
 int optz = 0;
@@ -65,6 +67,26 @@ struct record_header record_hdr;
 
 char comment[MAX_COMMENT_LEN];
 
+/*
+ * Flags (FH_F_...) of output file header, and number of records written
+ * to output file since it has been opened (used to know when a keyframe
+ * should be written to a delta encoded file).
+ */
+unsigned int ofile_flags = 0;
+unsigned long enc_rec_nr = 0;
+/* Block of records being written to output file if it is compressed */
+struct sa_blk ofile_blk = {.fd = -1};
+/*
+ * Time index of output file (see IDX_SUFFIX): File descriptors of index and
+ * of indexed file, number of entries, number of CPU in effect, and position
+ * in output file of next record to be written.
+ */
+int idx_fd = -1, idx_ofd = -1;
+struct idx_header idx_hdr;
+unsigned long idx_nr = 0;
+unsigned int idx_cpu_nr = 0;
+long long idx_next_fpos = 0;
+
 unsigned int id_seq[NR_ACT];
 
 extern unsigned int hdr_types_nr[];
@@ -74,9 +96,73 @@ extern unsigned int rec_types_nr[];
 extern struct activity *act[];
 extern __nr_t (*f_count[]) (struct activity *);
 
-struct sigaction alrm_act, int_act;
+struct sigaction int_act;
 int sigint_caught = 0;
 
+/* Timer used to sample statistics at regular intervals */
+struct sample_timer sample_tm;
+
+/*
+ * Cost of reading and counting each activity (A_SELF).
+ * Entries are indexed by the position of the activity in act[].
+ */
+struct stats_self self_cost[NR_ACT];
+
+/*
+ * TRUE if buffers of an activity already contain stats read by
+ * sa_sys_init() when it counted its items (see count_by_read()).
+ * These stats are used for next sample instead of reading them again.
+ * Entries are indexed by the position of the activity in act[].
+ */
+int act_primed[NR_ACT];
+
+/* Initial number of items allocated for activities counted by reading them */
+#define NR_ITEMS_FIRST_READ	16
+
+/*
+ * Period at which each activity is saved (option -S <keyword>:<period>):
+ * As entered on the command line (in microseconds), then as a number of
+ * records. Also number of records remaining before each activity is due
+ * again. Entries are indexed by the position of the activity in act[].
+ */
+long long period_us[NR_ACT];
+unsigned int act_period[NR_ACT];
+unsigned int act_countdown[NR_ACT];
+
+#define IS_DUE(p)	(!act_countdown[p])
+#define SAVED_WITH_NR(p) ((act[p]->f_count_index >= 0) || (act_period[p] > 1))
+
+/* Number of threads used to read activities (option -P) */
+int nr_threads = 1;
+
+/*
+ * Pool of worker threads used to read activities concurrently.
+ * Collected activities are split into groups (see get_read_group()).
+ * Activities belonging to the same group are read one after the other
+ * by the same thread.
+ */
+struct read_pool {
+	pthread_t *tid;
+	int nr_workers;
+	int stop;
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond;
+	pthread_cond_t done_cond;
+	/* Groups of activities to read for current sample */
+	int grp_nr;
+	int grp_next;
+	int grp_done;
+	int grp_act_nr[NR_ACT];
+	int grp_act[NR_ACT][NR_ACT];
+	/* Time when each group started and ended to be read */
+	struct timespec grp_beg[NR_ACT];
+	struct timespec grp_end[NR_ACT];
+} pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.work_cond = PTHREAD_COND_INITIALIZER,
+	.done_cond = PTHREAD_COND_INITIALIZER
+};
+
 /*
  ***************************************************************************
  * Print usage and exit.
@@ -91,8 +177,9 @@ void usage(char *progname)
 		progname);
 
 	fprintf(stderr, _("Options are:\n"
-			  "[ -C <comment> ] [ -D ] [ -F ] [ -f ] [ -L ] [ -V ]\n"
-			  "[ -S { INT | DISK | IPV6 | POWER | SNMP | XDISK | ALL | XALL } ]\n"));
+			  "[ -C <comment> ] [ -D ] [ -E ] [ -F ] [ -f ] [ -L ] [ -P <threads> ] [ -V ] [ -z ]\n"
+			  "[ -S { INT | DISK | IPV6 | POWER | SNMP | XDISK | SELF | CGROUP |\n"
+			  "       ALL | XALL }[:<period>] ]\n"));
 	exit(1);
 }
 
@@ -103,9 +190,12 @@ void usage(char *progname)
  * IN:
  * @group_id	Group identification number.
  * @opt_f	Optionnal flag to set.
+ * @period	Period at which activities should be saved (in microseconds),
+ *		or 0 to keep the default one.
  ***************************************************************************
  */
-void collect_group_activities(unsigned int group_id, unsigned int opt_f)
+void collect_group_activities(unsigned int group_id, unsigned int opt_f,
+			      long long period)
 {
 	int i;
 
@@ -115,6 +205,9 @@ void collect_group_activities(unsigned int group_id, unsigned int opt_f)
 			if (opt_f) {
 				act[i]->opt_flags |= opt_f;
 			}
+			if (period) {
+				period_us[i] = period;
+			}
 		}
 	}
 }
@@ -130,63 +223,85 @@ void collect_group_activities(unsigned int group_id, unsigned int opt_f)
  */
 void parse_sadc_S_option(char *argv[], int opt)
 {
-	char *p;
+	char *p, *c;
 	int i;
+	long long period;
 
 	for (p = strtok(argv[opt], ","); p; p = strtok(NULL, ",")) {
+		/* Look for an optional period, e.g. "FS:300" */
+		period = 0;
+		if ((c = strchr(p, ':')) != NULL) {
+			*c = '\0';
+			if ((period = parse_interval(c + 1)) < 1) {
+				usage(argv[0]);
+			}
+		}
+
 		if (!strcmp(p, K_INT)) {
 			/* Select group of interrupt activities */
-			collect_group_activities(G_INT, AO_F_NULL);
+			collect_group_activities(G_INT, AO_F_NULL, period);
 		}
 		else if (!strcmp(p, K_DISK)) {
 			/* Select group of disk activities */
-			collect_group_activities(G_DISK, AO_F_NULL);
+			collect_group_activities(G_DISK, AO_F_NULL, period);
 		}
 		else if (!strcmp(p, K_XDISK)) {
 			/* Select group of disk and partition/filesystem activities */
-			collect_group_activities(G_DISK + G_XDISK, AO_F_DISK_PART);
+			collect_group_activities(G_DISK + G_XDISK, AO_F_DISK_PART, period);
 		}
 		else if (!strcmp(p, K_SNMP)) {
 			/* Select group of SNMP activities */
-			collect_group_activities(G_SNMP, AO_F_NULL);
+			collect_group_activities(G_SNMP, AO_F_NULL, period);
 		}
 		else if (!strcmp(p, K_IPV6)) {
 			/* Select group of IPv6 activities */
-			collect_group_activities(G_IPV6, AO_F_NULL);
+			collect_group_activities(G_IPV6, AO_F_NULL, period);
 		}
 		else if (!strcmp(p, K_POWER)) {
 			/* Select group of activities related to power management */
-			collect_group_activities(G_POWER, AO_F_NULL);
+			collect_group_activities(G_POWER, AO_F_NULL, period);
+		}
+		else if (!strcmp(p, K_SELF)) {
+			/* Select sadc own collection cost activity */
+			collect_group_activities(G_SELF, AO_F_NULL, period);
+		}
+		else if (!strcmp(p, K_CGROUP)) {
+			/* Select cgroup v2 activity */
+			collect_group_activities(G_CGROUP, AO_F_NULL, period);
 		}
 		else if (!strcmp(p, K_ALL) || !strcmp(p, K_XALL)) {
 			/* Select all activities */
 			for (i = 0; i < NR_ACT; i++) {
 
-				if (!strcmp(p, K_ALL) && (act[i]->group & G_XDISK))
+				if (!strcmp(p, K_ALL) &&
+				    (act[i]->group & (G_XDISK + G_SELF + G_CGROUP)))
 					/*
-					 * Don't select G_XDISK activities
+					 * Don't select G_XDISK, G_SELF and G_CGROUP activities
 					 * when option -S ALL is used.
 					 */
 					continue;
 
 				act[i]->options |= AO_COLLECTED;
+				if (period) {
+					period_us[i] = period;
+				}
 			}
 			if (!strcmp(p, K_XALL)) {
 				/* Tell sadc to also collect partition statistics */
-				collect_group_activities(G_DISK + G_XDISK, AO_F_DISK_PART);
+				collect_group_activities(G_DISK + G_XDISK, AO_F_DISK_PART, period);
 			}
 		}
-		else if (!strcmp(p, K_A_NULL)) {
+		else if (!strcmp(p, K_A_NULL) && !period) {
 			/* Unselect all activities */
 			for (i = 0; i < NR_ACT; i++) {
 				act[i]->options &= ~AO_COLLECTED;
 			}
 		}
-		else if (!strncmp(p, "A_", 2)) {
-			/* Select activity by name */
+		else if (!strncmp(p, "-A_", 3) && !period) {
+			/* Unselect activity by name */
 			for (i = 0; i < NR_ACT; i++) {
-				if (!strcmp(p, act[i]->name)) {
-					act[i]->options |= AO_COLLECTED;
+				if (!strcmp(p + 1, act[i]->name)) {
+					act[i]->options &= ~AO_COLLECTED;
 					break;
 				}
 			}
@@ -194,11 +309,14 @@ void parse_sadc_S_option(char *argv[], int opt)
 				usage(argv[0]);
 			}
 		}
-		else if (!strncmp(p, "-A_", 3)) {
-			/* Unselect activity by name */
+		else {
+			/* Select activity by name, with or without its "A_" prefix */
 			for (i = 0; i < NR_ACT; i++) {
-				if (!strcmp(p + 1, act[i]->name)) {
-					act[i]->options &= ~AO_COLLECTED;
+				if (!strcmp(p, act[i]->name) || !strcmp(p, act[i]->name + 2)) {
+					act[i]->options |= AO_COLLECTED;
+					if (period) {
+						period_us[i] = period;
+					}
 					break;
 				}
 			}
@@ -206,25 +324,9 @@ void parse_sadc_S_option(char *argv[], int opt)
 				usage(argv[0]);
 			}
 		}
-		else {
-			usage(argv[0]);
-		}
 	}
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to reset handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * SIGINT signal handler.
@@ -269,7 +371,7 @@ void p_write_error(void)
 /*
  ***************************************************************************
  * Init structures. All of them are init'ed first when they are allocated
- * (done by SREALLOC() macro in sa_sys_init() function).
+ * (done by resize_act_buffers() in sa_sys_init() function).
  * Then, they are init'ed again each time before reading the various system
  * stats to make sure that no stats from a previous reading will remain.
  * This is useful mainly for non sequential activities where some structures
@@ -286,6 +388,10 @@ void reset_stats(void)
 	int i;
 
         for (i = 0; i < NR_ACT; i++) {
+		if (act_primed[i])
+			/* Stats have just been read by sa_sys_init() */
+			continue;
+
 		if ((act[i]->nr > 0) && act[i]->_buf0) {
 			memset(act[i]->_buf0, 0,
 			       (size_t) act[i]->msize * (size_t) act[i]->nr_allocated * (size_t) act[i]->nr2);
@@ -293,6 +399,70 @@ void reset_stats(void)
 	}
 }
 
+/*
+ ***************************************************************************
+ * Read current wall clock and CPU time of calling thread. Used to know
+ * what it costs to read or count an activity.
+ *
+ * OUT:
+ * @ts		Monotonic time (@ts[0]) and thread CPU time (@ts[1]).
+ ***************************************************************************
+ */
+void get_cost_clocks(struct timespec ts[])
+{
+	clock_gettime(CLOCK_MONOTONIC, &ts[0]);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts[1]);
+}
+
+/*
+ ***************************************************************************
+ * Add time spent counting items to the cost of an activity.
+ *
+ * IN:
+ * @p		Position of the activity in act[].
+ * @beg		Clocks read before counting items.
+ * @end		Clocks read after counting items.
+ ***************************************************************************
+ */
+void add_count_cost(int p, struct timespec beg[], struct timespec end[])
+{
+	self_cost[p].count_wall += TS_DIFF_USEC(beg[0], end[0]);
+	self_cost[p].count_cpu  += TS_DIFF_USEC(beg[1], end[1]);
+}
+
+/*
+ ***************************************************************************
+ * Get the number of items of an activity with AO_COUNT_BY_READ flag set.
+ * This is the number of items read last time if the activity has already
+ * been read (e.g. when a file is rotated). Else its stats are read now,
+ * its buffer growing as needed, and they will be used for next sample.
+ *
+ * IN:
+ * @p		Position of the activity in act[].
+ *
+ * RETURNS:
+ * Number of items.
+ ***************************************************************************
+ */
+__nr_t count_by_read(int p)
+{
+	struct activity *a = act[p];
+
+	if (a->_nr0 >= 0)
+		return a->_nr0;
+
+	if (a->nr_allocated <= 0) {
+		/* a->nr2 value is 1 */
+		resize_act_buffers(a, 1, (size_t) a->msize * NR_ITEMS_FIRST_READ);
+		a->nr_allocated = NR_ITEMS_FIRST_READ;
+	}
+
+	(*a->f_read)(a);
+	act_primed[p] = TRUE;
+
+	return a->_nr0;
+}
+
 /*
  ***************************************************************************
  * Count activities items then allocate and init corresponding structures.
@@ -300,6 +470,8 @@ void reset_stats(void)
  * (thus the number of CPU will always be counted even if CPU activity is
  * not collected), but ONLY those that will be collected have allocated
  * structures.
+ * Activities with AO_COUNT_BY_READ flag set are not counted by their count
+ * function when collected: See count_by_read().
  * This function is called when sadc is started, and when a file is rotated.
  * If a file is rotated and structures are reallocated with a larger size,
  * additional space is not initialized: It doesn't matter as reset_stats()
@@ -310,6 +482,10 @@ void sa_sys_init(void)
 {
 	int i, idx;
 	__nr_t f_count_results[NR_F_COUNT];
+	struct timespec beg[2], end[2];
+
+	/* Open statistics files once: They will be kept open between samples */
+	open_src_files();
 
 	/* Init array. Means that no items have been counted yet */
 	for (i = 0; i < NR_F_COUNT; i++) {
@@ -326,15 +502,29 @@ void sa_sys_init(void)
 			if (f_count_results[idx] >= 0) {
 				act[i]->nr_ini = f_count_results[idx];
 			}
+			else if (COUNT_BY_READ(act[i]->options) && IS_COLLECTED(act[i]->options)) {
+				/* Items are counted by reading them: Sources are parsed only once */
+				get_cost_clocks(beg);
+				act[i]->nr_ini = count_by_read(i);
+				get_cost_clocks(end);
+				add_count_cost(i, beg, end);
+				f_count_results[idx] = act[i]->nr_ini;
+			}
 			else {
+				get_cost_clocks(beg);
 				act[i]->nr_ini = (f_count[idx])(act[i]);
+				get_cost_clocks(end);
+				add_count_cost(i, beg, end);
 				f_count_results[idx] = act[i]->nr_ini;
 			}
 		}
 
 		if (act[i]->nr_ini > 0) {
 			if (act[i]->f_count2) {
+				get_cost_clocks(beg);
 				act[i]->nr2 = (*act[i]->f_count2)(act[i]);
+				get_cost_clocks(end);
+				add_count_cost(i, beg, end);
 			}
 			/* else act[i]->nr2 is a constant and doesn't need to be calculated */
 
@@ -343,16 +533,21 @@ void sa_sys_init(void)
 			}
 		}
 
-		if (IS_COLLECTED(act[i]->options) && (act[i]->nr_ini > 0)) {
-			/* Allocate structures for current activity (using nr_ini and nr2 results) */
-			SREALLOC(act[i]->_buf0, void,
-				 (size_t) act[i]->msize * (size_t) act[i]->nr_ini * (size_t) act[i]->nr2);
+		if (IS_COLLECTED(act[i]->options) && (act[i]->nr_ini > 0) &&
+		    (!COUNT_BY_READ(act[i]->options) || (act[i]->nr_allocated < act[i]->nr_ini))) {
+			/*
+			 * Allocate structures for current activity (using nr_ini and nr2 results).
+			 * Buffers of activities counted by reading them are already large enough.
+			 */
+			resize_act_buffers(act[i], 1,
+					   (size_t) act[i]->msize * (size_t) act[i]->nr_ini * (size_t) act[i]->nr2);
 			act[i]->nr_allocated = act[i]->nr_ini;
 		}
 
 		if (act[i]->nr_ini <= 0) {
 			/* No items found: Invalidate current activity */
 			act[i]->options &= ~AO_COLLECTED;
+			act_primed[i] = FALSE;
 		}
 
 		/* Set default activity list */
@@ -372,13 +567,11 @@ void sa_sys_free(void)
 	for (i = 0; i < NR_ACT; i++) {
 
 		if (act[i]->nr_allocated > 0) {
-			if (act[i]->_buf0) {
-				free(act[i]->_buf0);
-				act[i]->_buf0 = NULL;
-				act[i]->nr_allocated = 0;
-			}
+			free_act_buffers(act[i]);
 		}
 	}
+
+	close_src_files();
 }
 
 /*
@@ -455,10 +648,11 @@ void fill_magic_header(struct file_magic *file_magic)
  * Fill system activity file header, then write it (or print it if stdout).
  *
  * IN:
- * @fd	Output file descriptor. May be stdout.
+ * @fd		Output file descriptor. May be stdout.
+ * @sa_flags	File flags (FH_F_...) to save in header.
  ***************************************************************************
  */
-void setup_file_hdr(int fd)
+void setup_file_hdr(int fd, unsigned int sa_flags)
 {
 	int i, j, p;
 	struct tm rectime;
@@ -493,6 +687,7 @@ void setup_file_hdr(int fd)
 	}
 	file_hdr.act_size = FILE_ACTIVITY_SIZE;
 	file_hdr.rec_size = RECORD_HEADER_SIZE;
+	file_hdr.sa_flags = sa_flags;
 
 	/*
 	 * This is a new file (or stdout): Set sa_cpu_nr field to the number
@@ -540,7 +735,12 @@ void setup_file_hdr(int fd)
 				file_act.types_nr[j] = act[p]->gtypes_nr[j];
 			}
 
-			file_act.has_nr = HAS_COUNT_FUNCTION(act[p]->options);
+			/*
+			 * Activities saved at a longer period than the others
+			 * are preceded by NR_NOT_DUE in the records where they are not due.
+			 */
+			file_act.period = act_period[p];
+			file_act.has_nr = SAVED_WITH_NR(p);
 
 			if (write_all(fd, &file_act, FILE_ACTIVITY_SIZE) != FILE_ACTIVITY_SIZE) {
 				p_write_error();
@@ -551,6 +751,220 @@ void setup_file_hdr(int fd)
 	return;
 }
 
+/*
+ ***************************************************************************
+ * Write part of a record to a file. If the file is compressed (see
+ * FH_F_COMPRESS) then data are added to the block of records being
+ * written, which will be saved by commit_record().
+ *
+ * IN:
+ * @ofd		Output file descriptor. May be stdout.
+ * @buf		Data to write.
+ * @size	Size of data.
+ ***************************************************************************
+ */
+void write_rec_data(int ofd, const void *buf, size_t size)
+{
+	if (ofd == ofile_blk.fd) {
+		write_blk_data(&ofile_blk, buf, size);
+	}
+	else if (write_all(ofd, buf, size) != size) {
+		p_write_error();
+	}
+}
+
+/*
+ ***************************************************************************
+ * Open the time index of output file (see IDX_SUFFIX). A new index is
+ * created along with a new file. When data are appended to an existing
+ * file, its index is used only if it covers all the records of the file,
+ * otherwise it is deleted: The file won't be indexed.
+ * Errors are not fatal: Data file can always be read without its index.
+ *
+ * IN:
+ * @ofd		Output file descriptor. File is positioned on its first
+ *		record if it has just been created.
+ * @ofile	Name of output file.
+ * @create	TRUE if output file has just been created.
+ ***************************************************************************
+ */
+void open_time_index(int ofd, char *ofile, int create)
+{
+	char idx_file[MAX_FILE_LEN + sizeof(IDX_SUFFIX)];
+	struct idx_entry ie;
+	struct stat ist, ost;
+
+	snprintf(idx_file, sizeof(idx_file), "%s%s", ofile, IDX_SUFFIX);
+
+	if (fstat(ofd, &ost) < 0)
+		return;
+
+	if (create) {
+		if ((idx_fd = open(idx_file, O_CREAT | O_TRUNC | O_RDWR,
+				   S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0)
+			return;
+
+		memset(&idx_hdr, 0, IDX_HEADER_SIZE);
+		idx_hdr.sa_ust_time = file_hdr.sa_ust_time;
+		idx_hdr.data_size = (unsigned long long) ost.st_size;
+		idx_hdr.idx_magic = IDX_MAGIC;
+		idx_hdr.entry_size = IDX_ENTRY_SIZE;
+		if (IS_COMPRESSED(ofile_flags)) {
+			idx_hdr.first_fpos = (long long) ofile_blk.pos << BLK_POS_SHIFT;
+		}
+		else {
+			idx_hdr.first_fpos = (long long) ost.st_size;
+		}
+		if (pwrite(idx_fd, &idx_hdr, IDX_HEADER_SIZE, 0) != IDX_HEADER_SIZE)
+			goto idx_error;
+
+		idx_nr = 0;
+		idx_cpu_nr = file_hdr.sa_cpu_nr;
+	}
+	else {
+		if ((idx_fd = open(idx_file, O_RDWR)) < 0)
+			return;
+
+		if ((fstat(idx_fd, &ist) < 0) ||
+		    (pread(idx_fd, &idx_hdr, IDX_HEADER_SIZE, 0) != IDX_HEADER_SIZE) ||
+		    (idx_hdr.idx_magic != IDX_MAGIC) ||
+		    (idx_hdr.entry_size != IDX_ENTRY_SIZE) ||
+		    (idx_hdr.sa_ust_time != file_hdr.sa_ust_time) ||
+		    (idx_hdr.data_size != (unsigned long long) ost.st_size) ||
+		    ((ist.st_size - IDX_HEADER_SIZE) % IDX_ENTRY_SIZE)) {
+			/* Index is not that of this file or records have been added without it */
+#ifdef DEBUG
+			fprintf(stderr, "%s: Index %s is not up to date\n", __FUNCTION__, idx_file);
+#endif
+			close(idx_fd);
+			idx_fd = -1;
+			unlink(idx_file);
+			return;
+		}
+
+		idx_nr = (ist.st_size - IDX_HEADER_SIZE) / IDX_ENTRY_SIZE;
+		idx_cpu_nr = file_hdr.sa_cpu_nr;
+		if (idx_nr) {
+			/* Get number of CPU given by the last RESTART record */
+			if (pread(idx_fd, &ie, IDX_ENTRY_SIZE,
+				  IDX_HEADER_SIZE + (idx_nr - 1) * IDX_ENTRY_SIZE) != IDX_ENTRY_SIZE)
+				goto idx_error;
+			idx_cpu_nr = ie.cpu_nr;
+		}
+	}
+
+	/* Records are appended at the end of file (in a new block if file is compressed) */
+	if (IS_COMPRESSED(ofile_flags)) {
+		idx_next_fpos = (long long) ofile_blk.pos << BLK_POS_SHIFT;
+	}
+	else {
+		idx_next_fpos = (long long) ost.st_size;
+	}
+	idx_ofd = ofd;
+
+	return;
+
+idx_error:
+	close(idx_fd);
+	idx_fd = -1;
+	unlink(idx_file);
+}
+
+/*
+ ***************************************************************************
+ * Add the record which has just been written to output file to its time
+ * index. If the index cannot be updated then it is emptied, since it
+ * would no longer cover all the records of the file.
+ *
+ * IN:
+ * @ofd		Output file descriptor.
+ * @sync	TRUE if reading may start at this record (see IDX_F_SYNC).
+ ***************************************************************************
+ */
+void write_index_entry(int ofd, int sync)
+{
+	struct idx_entry ie;
+	struct stat st;
+
+	if (record_hdr.record_type == R_RESTART) {
+		idx_cpu_nr = act[get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND)]->nr_ini;
+	}
+
+	memset(&ie, 0, IDX_ENTRY_SIZE);
+	ie.ust_time = record_hdr.ust_time;
+	ie.fpos = idx_next_fpos;
+	ie.cpu_nr = idx_cpu_nr;
+	ie.entry_flags = sync ? IDX_F_SYNC : 0;
+	ie.record_type = record_hdr.record_type;
+	ie.hour = record_hdr.hour;
+	ie.minute = record_hdr.minute;
+	ie.second = record_hdr.second;
+
+	if (fstat(ofd, &st) < 0)
+		goto idx_error;
+	idx_hdr.data_size = (unsigned long long) st.st_size;
+
+	/* Write entry first: Header tells how much of the file is covered by the index */
+	if ((pwrite(idx_fd, &ie, IDX_ENTRY_SIZE,
+		    IDX_HEADER_SIZE + idx_nr * IDX_ENTRY_SIZE) != IDX_ENTRY_SIZE) ||
+	    (pwrite(idx_fd, &idx_hdr, IDX_HEADER_SIZE, 0) != IDX_HEADER_SIZE))
+		goto idx_error;
+	idx_nr++;
+
+	/* Position of next record */
+	if (IS_COMPRESSED(ofile_flags)) {
+		idx_next_fpos = ((long long) ofile_blk.pos << BLK_POS_SHIFT) |
+				ofile_blk.hdr.raw_size;
+	}
+	else {
+		idx_next_fpos = (long long) st.st_size;
+	}
+
+	return;
+
+idx_error:
+	if (ftruncate(idx_fd, 0) < 0) {
+		perror("ftruncate");
+	}
+	close(idx_fd);
+	idx_fd = -1;
+}
+
+/*
+ ***************************************************************************
+ * Tell that a whole record has been written to a file. If the file is
+ * compressed then the block containing the record is (re)written to it.
+ * The record is then added to the time index of the file.
+ *
+ * IN:
+ * @ofd		Output file descriptor. May be stdout.
+ * @sync	TRUE if reading may start at this record (see IDX_F_SYNC).
+ ***************************************************************************
+ */
+void commit_record(int ofd, int sync)
+{
+	int i, rc;
+
+	if (ofd == ofile_blk.fd) {
+		if ((rc = commit_blk(&ofile_blk, record_hdr.ust_time, TRUE)) < 0) {
+			p_write_error();
+		}
+		if (rc > 0) {
+			/*
+			 * A new block has been started: It must be decompressed and decoded
+			 * independently of the previous ones.
+			 */
+			for (i = 0; i < NR_ACT; i++) {
+				act[i]->enc[0].nr = 0;
+			}
+		}
+	}
+
+	if ((ofd == idx_ofd) && (idx_fd >= 0)) {
+		write_index_entry(ofd, sync);
+	}
+}
+
 /*
  ***************************************************************************
  * Write the new number of CPU after the RESTART record in file.
@@ -565,9 +979,7 @@ void write_new_cpu_nr(int ofd)
 
 	p = get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND);
 
-	if (write_all(ofd, &(act[p]->nr_ini), sizeof(__nr_t)) != sizeof(__nr_t)) {
-		p_write_error();
-	}
+	write_rec_data(ofd, &(act[p]->nr_ini), sizeof(__nr_t));
 }
 
 /*
@@ -599,16 +1011,15 @@ void write_special_record(int ofd, int rtype)
 	record_hdr.record_type = rtype;
 
 	/* Save time */
-	record_hdr.ust_time = (unsigned long long) get_time(&rectime, 0);
+	record_hdr.ust_time = (unsigned long long) get_time_usec(&rectime, 0,
+								 &record_hdr.ust_usec);
 
 	record_hdr.hour   = rectime.tm_hour;
 	record_hdr.minute = rectime.tm_min;
 	record_hdr.second = rectime.tm_sec;
 
 	/* Write record now */
-	if (write_all(ofd, &record_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) {
-		p_write_error();
-	}
+	write_rec_data(ofd, &record_hdr, RECORD_HEADER_SIZE);
 
 	if (rtype == R_RESTART) {
 		/* Also write the new number of CPU */
@@ -616,10 +1027,42 @@ void write_special_record(int ofd, int rtype)
 	}
 	else if (rtype == R_COMMENT) {
 		/* Also write the comment */
-		if (write_all(ofd, comment, MAX_COMMENT_LEN) != MAX_COMMENT_LEN) {
-			p_write_error();
-		}
+		write_rec_data(ofd, comment, MAX_COMMENT_LEN);
+	}
+
+	commit_record(ofd, FALSE);
+}
+
+/*
+ ***************************************************************************
+ * Encode the statistics of an activity then write them (see FH_F_DELTA).
+ *
+ * IN:
+ * @ofd		Output file descriptor.
+ * @a		Activity whose statistics are written.
+ * @keyframe	TRUE if a keyframe should be written.
+ ***************************************************************************
+ */
+void write_enc_stats(int ofd, struct activity *a, int keyframe)
+{
+	static unsigned char *blk = NULL;
+	static size_t blk_size = 0;
+	size_t bound;
+	unsigned int len;
+	__nr_t nr = a->_nr0 * a->nr2;
+
+	bound = sizeof(unsigned int) + get_enc_bound(a->gtypes_nr, (size_t) a->fsize, nr);
+	if (bound > blk_size) {
+		SREALLOC(blk, unsigned char, bound);
+		blk_size = bound;
 	}
+
+	/* Encoded block is preceded by its size */
+	len = (unsigned int) encode_act_stats(&a->enc[0], a->gtypes_nr, (size_t) a->fsize,
+					      a->_buf0, nr, keyframe, blk + sizeof(unsigned int));
+	memcpy(blk, &len, sizeof(unsigned int));
+
+	write_rec_data(ofd, blk, sizeof(unsigned int) + len);
 }
 
 /*
@@ -628,11 +1071,13 @@ void write_special_record(int ofd, int rtype)
  *
  * IN:
  * @ofd		Output file descriptor. May be stdout.
+ * @sa_flags	Flags (FH_F_...) of output file header.
  ***************************************************************************
  */
-void write_stats(int ofd)
+void write_stats(int ofd, unsigned int sa_flags)
 {
-	int i, p;
+	int i, p, keyframe = FALSE, sync = TRUE;
+	__nr_t nr_not_due = NR_NOT_DUE;
 
 	/* Try to lock file */
 	if (!FILE_LOCKED(flags)) {
@@ -645,8 +1090,24 @@ void write_stats(int ofd)
 	}
 
 	/* Write record header */
-	if (write_all(ofd, &record_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) {
-		p_write_error();
+	write_rec_data(ofd, &record_hdr, RECORD_HEADER_SIZE);
+
+	if (IS_DELTA_ENCODED(sa_flags)) {
+		/* Write a keyframe every ENC_KEYFRAME_INTERVAL records */
+		keyframe = !(enc_rec_nr++ % ENC_KEYFRAME_INTERVAL);
+
+		for (i = 0; i < NR_ACT; i++) {
+			if (keyframe) {
+				/*
+				 * Also for activities not saved in this record, so that
+				 * reading may start here (see IDX_F_SYNC).
+				 */
+				act[i]->enc[0].nr = 0;
+			}
+			else if (act[i]->enc[0].nr > 0) {
+				sync = FALSE;
+			}
+		}
 	}
 
 	/* Then write all statistics */
@@ -658,17 +1119,27 @@ void write_stats(int ofd)
 			continue;
 
 		if (IS_COLLECTED(act[p]->options)) {
-			if (act[p]->f_count_index >= 0) {
-				if (write_all(ofd, &(act[p]->_nr0), sizeof(__nr_t)) != sizeof(__nr_t)) {
-					p_write_error();
+			if (!IS_DUE(p)) {
+				/* Activity not due: Save NR_NOT_DUE instead of its statistics */
+				write_rec_data(ofd, &nr_not_due, sizeof(__nr_t));
+				continue;
+			}
+			if (SAVED_WITH_NR(p)) {
+				write_rec_data(ofd, &(act[p]->_nr0), sizeof(__nr_t));
+			}
+			if (IS_DELTA_ENCODED(sa_flags)) {
+				if (act[p]->_nr0 > 0) {
+					write_enc_stats(ofd, act[p], keyframe);
 				}
 			}
-			if (write_all(ofd, act[p]->_buf0, act[p]->fsize * act[p]->_nr0 * act[p]->nr2) !=
-			    (act[p]->fsize * act[p]->_nr0 * act[p]->nr2)) {
-				p_write_error();
+			else {
+				write_rec_data(ofd, act[p]->_buf0,
+					       (size_t) act[p]->fsize * act[p]->_nr0 * act[p]->nr2);
 			}
 		}
 	}
+
+	commit_record(ofd, sync);
 }
 
 /*
@@ -695,7 +1166,16 @@ void create_sa_file(int *ofd, char *ofile)
 	if (ftruncate(*ofd, 0) >= 0) {
 
 		/* Write file header */
-		setup_file_hdr(*ofd);
+		ofile_flags = (WANT_DELTA_ENC(flags) ? FH_F_DELTA : 0) |
+			      (WANT_BLK_COMPRESS(flags) ? FH_F_COMPRESS : 0) |
+			      (IS_SUBSEC_INTERVAL(interval) ? FH_F_SUBSEC : 0);
+		setup_file_hdr(*ofd, ofile_flags);
+
+		if (IS_COMPRESSED(ofile_flags)) {
+			/* First block of records starts right after the list of activities */
+			init_blk(&ofile_blk, *ofd, lseek(*ofd, 0, SEEK_CUR), FALSE);
+		}
+		open_time_index(*ofd, ofile, TRUE);
 
 		return;
 	}
@@ -725,7 +1205,7 @@ void open_stdout(int *stdfd)
 			exit(4);
 		}
 		/* Write file header on STDOUT */
-		setup_file_hdr(*stdfd);
+		setup_file_hdr(*stdfd, IS_SUBSEC_INTERVAL(interval) ? FH_F_SUBSEC : 0);
 	}
 }
 
@@ -752,11 +1232,25 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 	struct file_activity file_act[NR_ACT];
 	struct tm rectime = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
 	ssize_t sz;
+	off_t fpos;
 	int i, p;
 
 	if (!ofile[0])
 		return;
 
+	/* Statistics written to this file won't be encoded against those of a previous one */
+	for (i = 0; i < NR_ACT; i++) {
+		act[i]->enc[0].nr = 0;
+	}
+	enc_rec_nr = 0;
+	ofile_blk.fd = -1;
+	if (idx_fd >= 0) {
+		/* Close index of previous file */
+		close(idx_fd);
+		idx_fd = -1;
+	}
+	idx_ofd = -1;
+
 	/* Try to open file and check that data can be appended to it */
 	if ((*ofd = open(ofile, O_APPEND | O_RDWR)) < 0) {
 		if (errno == ENOENT) {
@@ -845,7 +1339,8 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 	    (file_hdr.rec_size != RECORD_HEADER_SIZE) ||
 	    (file_hdr.rec_types_nr[0] != RECORD_HEADER_ULL_NR) ||
 	    (file_hdr.rec_types_nr[1] != RECORD_HEADER_UL_NR) ||
-	    (file_hdr.rec_types_nr[2] != RECORD_HEADER_U_NR)) {
+	    (file_hdr.rec_types_nr[2] != RECORD_HEADER_U_NR) ||
+	    (file_hdr.sa_flags & ~FH_F_KNOWN)) {
 #ifdef DEBUG
 		fprintf(stderr, "%s: act_size=%u act=%d,%d,%d rec_size=%u rec=%d,%d,%d\n",
 			__FUNCTION__, file_hdr.act_size,
@@ -920,8 +1415,8 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 			goto append_error;
 		}
 
-		if ((file_act[i].has_nr && (act[p]->f_count_index < 0)) ||
-		    (!file_act[i].has_nr && (act[p]->f_count_index >=0))) {
+		if ((file_act[i].has_nr && (act[p]->f_count_index < 0) && (file_act[i].period <= 1)) ||
+		    (!file_act[i].has_nr && ((act[p]->f_count_index >=0) || (file_act[i].period > 1)))) {
 #ifdef DEBUG
 			fprintf(stderr, "%s: %s: has_nr=%d count_index=%d\n",
 				__FUNCTION__, act[p]->name, file_act[i].has_nr, act[p]->f_count_index);
@@ -929,9 +1424,53 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 			/*
 			 * For every activity whose number of items is not a constant,
 			 * a value giving the number of structures to read should exist.
+			 * This is also the case for every activity saved at a longer period.
+			 */
+			goto append_error;
+		}
+
+		if (optz && (file_act[i].period > 1))
+			/*
+			 * Activities are saved in every record sent to sar (on STDOUT).
+			 * So they must also be in every record of the file.
 			 */
 			goto append_error;
+	}
+
+	/* Statistics appended to the file are encoded the same way as those already saved */
+	ofile_flags = file_hdr.sa_flags;
+
+	if (IS_SUBSEC_INTERVAL(interval) && !HAS_SUBSEC_RECORDS(ofile_flags)) {
+		/*
+		 * Records less than a second apart will be appended to the file:
+		 * Update its header. O_APPEND is cleared so that pwrite() writes
+		 * at the requested offset.
+		 */
+		ofile_flags |= FH_F_SUBSEC;
+		if ((fcntl(*ofd, F_SETFL, fcntl(*ofd, F_GETFL) & ~O_APPEND) < 0) ||
+		    (pwrite(*ofd, &ofile_flags, sizeof(ofile_flags),
+			    FILE_MAGIC_SIZE + offsetof(struct file_header, sa_flags)) != sizeof(ofile_flags)) ||
+		    (fcntl(*ofd, F_SETFL, fcntl(*ofd, F_GETFL) | O_APPEND) < 0)) {
+			fprintf(stderr, _("Cannot open %s: %s\n"), ofile, strerror(errno));
+			exit(2);
+		}
+	}
+
+	if (IS_COMPRESSED(ofile_flags)) {
+		/*
+		 * Records are appended in a new block, which is saved again each
+		 * time a record is added to it: O_APPEND cannot be used.
+		 * The block starts after the last valid one: A block which was
+		 * being written when sadc was killed may follow it.
+		 */
+		if ((fcntl(*ofd, F_SETFL, fcntl(*ofd, F_GETFL) & ~O_APPEND) < 0) ||
+		    ((fpos = lseek(*ofd, 0, SEEK_CUR)) < 0) ||
+		    ((fpos = get_blk_end(*ofd, fpos)) < 0) ||
+		    (ftruncate(*ofd, fpos) < 0)) {
+			fprintf(stderr, _("Cannot open %s: %s\n"), ofile, strerror(errno));
+			exit(2);
 		}
+		init_blk(&ofile_blk, *ofd, fpos, FALSE);
 	}
 
 	/*
@@ -964,15 +1503,21 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 		 * we need to reallocate.
 		 */
 		act[p]->nr2 = file_act[i].nr2;
-		SREALLOC(act[p]->_buf0, void,
-			 (size_t) act[p]->msize * (size_t) act[p]->nr_ini * (size_t) act[p]->nr2);
+		resize_act_buffers(act[p], 1,
+				   (size_t) act[p]->msize * (size_t) act[p]->nr_ini * (size_t) act[p]->nr2);
 		act[p]->nr_allocated = act[p]->nr_ini;
+		act_primed[p] = FALSE;
+
+		/* Period at which activity is saved is also that of the file */
+		act_period[p] = file_act[i].period > 1 ? file_act[i].period : 1;
 
 		/* Save activity sequence */
 		id_seq[i] = file_act[i].id;
 		act[p]->options |= AO_COLLECTED;
 	}
 
+	open_time_index(*ofd, ofile, FALSE);
+
 	return;
 
 append_error:
@@ -988,22 +1533,326 @@ append_error:
 	}
 }
 
+/*
+ ***************************************************************************
+ * Get the group an activity belongs to. Activities sharing some state
+ * other than their own buffers must be in the same group, so that they
+ * are never read at the same time.
+ *
+ * IN:
+ * @id		Activity identification.
+ *
+ * RETURNS:
+ * Group identification.
+ ***************************************************************************
+ */
+unsigned int get_read_group(unsigned int id)
+{
+	switch (id) {
+
+	case A_NET_EDEV:
+		/* Netlink snapshot may be read again when counting interfaces */
+		return A_NET_DEV;
+
+	case A_PWR_TEMP:
+	case A_PWR_IN:
+		/* libsensors is not thread-safe */
+		return A_PWR_FAN;
+
+	default:
+		return id;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Read all the activities belonging to a group.
+ *
+ * IN:
+ * @g		Group number.
+ ***************************************************************************
+ */
+void read_group_stats(int g)
+{
+	int i, p;
+	struct timespec beg[2], end[2];
+
+	clock_gettime(CLOCK_MONOTONIC, &pool.grp_beg[g]);
+
+	for (i = 0; i < pool.grp_act_nr[g]; i++) {
+		p = pool.grp_act[g][i];
+
+		if (act_primed[p]) {
+			/* Stats have already been read by sa_sys_init() */
+			act_primed[p] = FALSE;
+			continue;
+		}
+
+		get_cost_clocks(beg);
+		(*act[p]->f_read)(act[p]);
+		get_cost_clocks(end);
+
+		self_cost[p].nr_read++;
+		self_cost[p].read_wall += TS_DIFF_USEC(beg[0], end[0]);
+		self_cost[p].read_cpu  += TS_DIFF_USEC(beg[1], end[1]);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &pool.grp_end[g]);
+}
+
+/*
+ ***************************************************************************
+ * Read groups of activities until there is none left for current sample.
+ * Must be called with pool lock held.
+ ***************************************************************************
+ */
+void read_pending_groups(void)
+{
+	int g;
+
+	while (pool.grp_next < pool.grp_nr) {
+		g = pool.grp_next++;
+
+		pthread_mutex_unlock(&pool.lock);
+		read_group_stats(g);
+		pthread_mutex_lock(&pool.lock);
+
+		if (++pool.grp_done == pool.grp_nr) {
+			pthread_cond_signal(&pool.done_cond);
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Main function of worker threads.
+ *
+ * IN:
+ * @arg		Unused.
+ ***************************************************************************
+ */
+void *read_worker(void *arg)
+{
+	pthread_mutex_lock(&pool.lock);
+
+	while (!pool.stop) {
+		read_pending_groups();
+		pthread_cond_wait(&pool.work_cond, &pool.lock);
+	}
+
+	pthread_mutex_unlock(&pool.lock);
+
+	/* Statistics files are kept open (and their buffers allocated) by each thread */
+	close_src_files();
+
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Start worker threads. The main thread also reads activities, so
+ * (@nr_threads - 1) threads are created. Signals are blocked in worker
+ * threads so that they are always handled by the main one.
+ ***************************************************************************
+ */
+void start_read_pool(void)
+{
+	sigset_t set, old_set;
+	int i, rc;
+
+	if (nr_threads <= 1)
+		return;
+
+	SREALLOC(pool.tid, pthread_t, sizeof(pthread_t) * (nr_threads - 1));
+
+	sigfillset(&set);
+	pthread_sigmask(SIG_BLOCK, &set, &old_set);
+
+	for (i = 0; i < nr_threads - 1; i++) {
+		if ((rc = pthread_create(&pool.tid[i], NULL, read_worker, NULL)) != 0) {
+			/* Go on with the threads already created */
+			fprintf(stderr, "pthread_create: %s\n", strerror(rc));
+			break;
+		}
+	}
+	pool.nr_workers = i;
+
+	pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+}
+
+/*
+ ***************************************************************************
+ * Stop worker threads and wait for them to terminate.
+ ***************************************************************************
+ */
+void stop_read_pool(void)
+{
+	int i;
+
+	if (!pool.nr_workers)
+		return;
+
+	pthread_mutex_lock(&pool.lock);
+	pool.stop = TRUE;
+	pthread_cond_broadcast(&pool.work_cond);
+	pthread_mutex_unlock(&pool.lock);
+
+	for (i = 0; i < pool.nr_workers; i++) {
+		pthread_join(pool.tid[i], NULL);
+	}
+	pool.nr_workers = 0;
+
+	free(pool.tid);
+	pool.tid = NULL;
+}
+
+/*
+ ***************************************************************************
+ * Split collected activities into groups that can be read concurrently.
+ * Must be called with pool lock held.
+ ***************************************************************************
+ */
+void set_read_groups(void)
+{
+	int i, g;
+	unsigned int grp_id[NR_ACT];
+
+	pool.grp_nr = 0;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (!IS_COLLECTED(act[i]->options) || !IS_DUE(i) || (act[i]->id == A_SELF))
+			/*
+			 * Activities not due are not read.
+			 * A_SELF is read last, once all the other activities have been read.
+			 */
+			continue;
+
+		/* Look for the group this activity belongs to */
+		for (g = 0; g < pool.grp_nr; g++) {
+			if (grp_id[g] == get_read_group(act[i]->id))
+				break;
+		}
+		if (g == pool.grp_nr) {
+			/* New group */
+			grp_id[g] = get_read_group(act[i]->id);
+			pool.grp_act_nr[g] = 0;
+			pool.grp_nr++;
+		}
+		pool.grp_act[g][pool.grp_act_nr[g]++] = i;
+	}
+}
+
 /*
  ***************************************************************************
  * Read statistics from various system files.
+ * Activities are read concurrently if a worker pool has been started.
+ * Also save the time elapsed between the beginning of the first read
+ * and the end of the last one in the record header.
  ***************************************************************************
  */
 void read_stats(void)
 {
-	int i;
+	int g, p;
+	struct timespec beg, end;
+	unsigned long long spread;
 
 	/* Read system uptime in 1/100th of a second */
 	read_uptime(&(record_hdr.uptime_cs));
 
+	/*
+	 * Read /proc/stat once for all the activities using it
+	 * (A_CPU, A_PCSW and A_IRQ). A_CPU is always collected.
+	 */
+	read_stat_snapshot();
+
+	/* Get all network interfaces stats at once for A_NET_DEV and A_NET_EDEV */
+	if (IS_COLLECTED(act[get_activity_position(act, A_NET_DEV, EXIT_IF_NOT_FOUND)]->options) ||
+	    IS_COLLECTED(act[get_activity_position(act, A_NET_EDEV, EXIT_IF_NOT_FOUND)]->options)) {
+		read_link_snapshot();
+	}
+
+	/* Wake up worker threads (if any) then read groups of activities */
+	pthread_mutex_lock(&pool.lock);
+	set_read_groups();
+	pool.grp_next = pool.grp_done = 0;
+	if (pool.nr_workers) {
+		pthread_cond_broadcast(&pool.work_cond);
+	}
+	read_pending_groups();
+	while (pool.grp_done < pool.grp_nr) {
+		pthread_cond_wait(&pool.done_cond, &pool.lock);
+	}
+	pthread_mutex_unlock(&pool.lock);
+
+	release_stat_snapshot();
+	release_link_snapshot();
+
+	/* Compute spread between first and last read (if any activities were due) */
+	spread = 0;
+	if (pool.grp_nr) {
+		beg = pool.grp_beg[0];
+		end = pool.grp_end[0];
+		for (g = 1; g < pool.grp_nr; g++) {
+			if ((pool.grp_beg[g].tv_sec < beg.tv_sec) ||
+			    ((pool.grp_beg[g].tv_sec == beg.tv_sec) &&
+			     (pool.grp_beg[g].tv_nsec < beg.tv_nsec))) {
+				beg = pool.grp_beg[g];
+			}
+			if ((pool.grp_end[g].tv_sec > end.tv_sec) ||
+			    ((pool.grp_end[g].tv_sec == end.tv_sec) &&
+			     (pool.grp_end[g].tv_nsec > end.tv_nsec))) {
+				end = pool.grp_end[g];
+			}
+		}
+		spread = TS_DIFF_USEC(beg, end);
+	}
+	record_hdr.spread_usec = spread > UINT_MAX ? UINT_MAX : (unsigned int) spread;
+
+	/* Save cost of reading and counting each activity */
+	p = get_activity_position(act, A_SELF, EXIT_IF_NOT_FOUND);
+	if (IS_COLLECTED(act[p]->options) && IS_DUE(p)) {
+		(*act[p]->f_read)(act[p]);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Convert the periods entered with option -S into a number of records.
+ * Periods are ignored when statistics are written to STDOUT, since sar
+ * expects every activity in every record.
+ *
+ * IN:
+ * @stdfd	Stdout file descriptor (negative if not used).
+ ***************************************************************************
+ */
+void set_act_periods(int stdfd)
+{
+	int i;
+
+	for (i = 0; i < NR_ACT; i++) {
+		act_period[i] = 1;
+		if ((stdfd < 0) && (interval > 0) && (period_us[i] > interval)) {
+			/* Round period to the nearest multiple of interval */
+			act_period[i] = (unsigned int) ((period_us[i] + interval / 2) / interval);
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Update the number of records remaining before each activity is due.
+ ***************************************************************************
+ */
+void update_act_countdowns(void)
+{
+	int i;
+
 	for (i = 0; i < NR_ACT; i++) {
-		if (IS_COLLECTED(act[i]->options)) {
-			/* Read statistics for current activity */
-			(*act[i]->f_read)(act[i]);
+		if (act_countdown[i]) {
+			act_countdown[i]--;
+		}
+		else {
+			act_countdown[i] = act_period[i] - 1;
 		}
 	}
 }
@@ -1040,7 +1889,10 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 		reset_stats();
 
 		/* Save time */
-		record_hdr.ust_time = (unsigned long long) get_time(&rectime, 0);
+		record_hdr.ust_time = (unsigned long long) get_time_usec(&rectime, 0,
+									 &record_hdr.ust_usec);
+		record_hdr.late_usec = sample_tm.late_us > UINT_MAX ?
+				       UINT_MAX : (unsigned int) sample_tm.late_us;
 		record_hdr.hour     = rectime.tm_hour;
 		record_hdr.minute   = rectime.tm_min;
 		record_hdr.second   = rectime.tm_sec;
@@ -1059,14 +1911,14 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 		if (stdfd >= 0) {
 			save_flags = flags;
 			flags &= ~S_F_LOCK_FILE;
-			write_stats(stdfd);
+			write_stats(stdfd, 0);
 			flags = save_flags;
 		}
 
 		/* If the record type was R_LAST_STATS, tag it R_STATS before writing it */
 		record_hdr.record_type = R_STATS;
 		if (ofile[0]) {
-			write_stats(ofd);
+			write_stats(ofd, ofile_flags);
 		}
 
 		if (do_sa_rotat) {
@@ -1100,11 +1952,11 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 			 * number of items may have changed.
 			 */
 			if (stdfd >= 0) {
-				setup_file_hdr(stdfd);
+				setup_file_hdr(stdfd, IS_SUBSEC_INTERVAL(interval) ? FH_F_SUBSEC : 0);
 			}
 
 			/* Write stats to file again */
-			write_stats(ofd);
+			write_stats(ofd, ofile_flags);
 		}
 
 		/* Flush data */
@@ -1117,13 +1969,15 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 			}
 		}
 
+		update_act_countdowns();
+
 		if (count > 0) {
 			count--;
 		}
 
 		if (count) {
-			/* Wait for a signal (probably SIGALRM or SIGINT) */
-			pause();
+			/* Wait for next sampling time, or until SIGINT is received */
+			while ((wait_sample_timer(&sample_tm) < 0) && !sigint_caught);
 		}
 
 		if (sigint_caught)
@@ -1139,6 +1993,11 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 
 			if (strcmp(ofile, new_ofile)) {
 				do_sa_rotat = TRUE;
+				/*
+				 * Next record will be the first one of the new file:
+				 * Every activity must be saved in it.
+				 */
+				memset(act_countdown, 0, sizeof(act_countdown));
 			}
 		}
 	}
@@ -1217,6 +2076,27 @@ int main(int argc, char **argv)
 			flags |= S_F_FDATASYNC;
 		}
 
+		else if (!strcmp(argv[opt], "-E")) {
+			/* Delta encode statistics saved in a new file */
+			flags |= S_F_DELTA_ENC;
+		}
+
+		else if (!strcmp(argv[opt], "-z")) {
+			/* Compress records saved in a new file */
+			flags |= S_F_BLK_COMPRESS;
+		}
+
+		else if (!strcmp(argv[opt], "-P")) {
+			/* Number of threads used to read activities */
+			if (!argv[++opt] || (strspn(argv[opt], DIGITS) != strlen(argv[opt]))) {
+				usage(argv[0]);
+			}
+			nr_threads = atoi(argv[opt]);
+			if ((nr_threads < 1) || (nr_threads > MAX_NR_THREADS)) {
+				usage(argv[0]);
+			}
+		}
+
 		else if (!strcmp(argv[opt], "-C")) {
 			if (!argv[++opt]) {
 				usage(argv[0]);
@@ -1228,7 +2108,8 @@ int main(int argc, char **argv)
 			}
 		}
 
-		else if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
+		else if ((strspn(argv[opt], DIGITS) != strlen(argv[opt])) &&
+			 (interval || (parse_interval(argv[opt]) < 0))) {
 			if (ofile[0] || WANT_SA_ROTAT(flags)) {
 				/* Outfile already specified */
 				usage(argv[0]);
@@ -1251,7 +2132,7 @@ int main(int argc, char **argv)
 
 		else if (!interval) {
 			/* Get interval */
-			interval = atol(argv[opt]);
+			interval = parse_interval(argv[opt]);
 			if (interval < 1) {
 				usage(argv[0]);
 			}
@@ -1312,6 +2193,9 @@ int main(int argc, char **argv)
 		flags &= ~S_F_LOCK_FILE;
 	}
 
+	/* Set period at which each activity will be saved */
+	set_act_periods(stdfd);
+
 	/* Init structures according to machine architecture */
 	sa_sys_init();
 
@@ -1366,15 +2250,17 @@ int main(int argc, char **argv)
 		exit(0);
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Start worker threads used to read activities */
+	start_read_pool();
+
+	/* Start sampling timer */
+	start_sample_timer(&sample_tm, (unsigned long long) interval);
 
 	/* Main loop */
 	rw_sa_stat_loop(count, stdfd, ofd, ofile, sa_dir);
 
+	stop_read_pool();
+
 #ifdef HAVE_SENSORS
 	/* Cleanup sensors */
 	sensors_cleanup();
@@ -29,6 +29,7 @@
 
 #include "version.h"
 #include "sadf.h"
+#include "arrow_ipc.h"
 
 # include <locale.h>	/* For setlocale() */
 #ifdef USE_NLS
@@ -81,6 +82,19 @@ struct record_header record_hdr[3];
 struct tstamp tm_start, tm_end;
 char *args[MAX_ARGV_NR];
 
+/*
+ * Cache used to display all the activities in a single pass (see
+ * rw_all_act_stats()): Records saved, statistics of each activity for
+ * these records, and total size of the cache. Also a copy of the
+ * standard output file descriptor.
+ */
+struct pass_rec *pass_recs = NULL;
+int pass_rec_nr = 0, pass_rec_alloc = 0;
+char *pass_buf[NR_ACT];
+size_t pass_len[NR_ACT], pass_alloc[NR_ACT];
+size_t pass_cache_size = 0;
+int stdout_fd = -1;
+
 extern struct activity *act[];
 extern struct report_format *fmt[];
 
@@ -99,7 +113,7 @@ void usage(char *progname)
 		progname);
 
 	fprintf(stderr, _("Options are:\n"
-			  "[ -C ] [ -c | -d | -g | -j | -l | -p | -r | -x ] [ -H ] [ -h ] [ -T | -t | -U ] [ -V ]\n"
+			  "[ -C ] [ -a | -c | -d | -g | -j | -l | -p | -r | -x ] [ -H ] [ -h ] [ -T | -t | -U ] [ -V ]\n"
 			  "[ -O <opts> [,...] ] [ -P { <cpu> [,...] | ALL } ]\n"
 			  "[ --dev=<dev_list> ] [ --fs=<fs_list> ] [ --iface=<iface_list> ]\n"
 			  "[ -s [ <hh:mm[:ss]> ] ] [ -e [ <hh:mm[:ss]> ] ]\n"
@@ -252,13 +266,8 @@ int read_next_sample(int ifd, int action, int curr, char *file, int *rtype, int
 	if (*rtype == R_COMMENT) {
 		if (action & IGNORE_COMMENT) {
 			/* Ignore COMMENT record */
-			if (lseek(ifd, MAX_COMMENT_LEN, SEEK_CUR) < MAX_COMMENT_LEN) {
-				perror("lseek");
-				if (oneof == UEOF_CONT)
-					return 2;
-				close(ifd);
-				exit(2);
-			}
+			if (sa_fread(ifd, NULL, MAX_COMMENT_LEN, HARD_SIZE, oneof) > 0)
+				return 2;
 			if (action & SET_TIMESTAMPS) {
 				sa_get_record_timestamp_struct(flags, &record_hdr[curr],
 							       rectime, loctime);
@@ -302,7 +311,8 @@ int read_next_sample(int ifd, int action, int curr, char *file, int *rtype, int
 		 * So read now the extra fields.
 		 */
 		if (read_file_stat_bunch(act, curr, ifd, file_hdr.sa_act_nr, file_actlst,
-					 endian_mismatch, arch_64, file, file_magic, oneof) > 0)
+					 file_hdr.sa_flags, endian_mismatch, arch_64, file,
+					 file_magic, oneof, record_hdr[curr].uptime_cs) > 0)
 			return 2;
 		sa_get_record_timestamp_struct(flags, &record_hdr[curr], rectime, loctime);
 	}
@@ -419,19 +429,48 @@ void seek_file_position(int ifd, int action)
 
 	if (action == DO_SAVE) {
 		/* Save current file position */
-		if ((fpos = lseek(ifd, 0, SEEK_CUR)) < 0) {
+		if ((fpos = sa_ftell(ifd)) < 0) {
 			perror("lseek");
 			exit(2);
 		}
 		save_cpu_nr = file_hdr.sa_cpu_nr;
+		/* Also save statistics used to decode next record if file is delta encoded */
+		copy_enc_states(act, 1, 0);
 	}
 	else if (action == DO_RESTORE) {
 		/* Rewind file */
-		if ((fpos < 0) || (lseek(ifd, fpos, SEEK_SET) < fpos)) {
+		if ((fpos < 0) || (sa_fseek(ifd, fpos) < 0)) {
 			perror("lseek");
 			exit(2);
 		}
 		file_hdr.sa_cpu_nr = save_cpu_nr;
+		copy_enc_states(act, 0, 1);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Update the number of different items found in file for each activity
+ * with those of current sample. New items are added to the list in field
+ * @item_list of structure activity.
+ *
+ * IN:
+ * @curr	Index in array for current sample statistics.
+ ***************************************************************************
+ */
+void count_new_items(int curr)
+{
+	int i;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (!HAS_LIST_ON_CMDLINE(act[i]->options)) {
+			if (act[i]->f_count_new) {
+				act[i]->item_list_sz += (*act[i]->f_count_new)(act[i], curr);
+			}
+			else if (act[i]->nr[curr] > act[i]->item_list_sz) {
+				act[i]->item_list_sz = act[i]->nr[curr];
+			}
+		}
 	}
 }
 
@@ -489,16 +528,7 @@ int count_file_items(int ifd, char *file, struct file_magic *file_magic,
 	 * of items for each activity.
 	 */
 	do {
-		for (i = 0; i < NR_ACT; i++) {
-			if (!HAS_LIST_ON_CMDLINE(act[i]->options)) {
-				if (act[i]->f_count_new) {
-					act[i]->item_list_sz += (*act[i]->f_count_new)(act[i], 0);
-				}
-				else if (act[i]->nr[0] > act[i]->item_list_sz) {
-					act[i]->item_list_sz = act[i]->nr[0];
-				}
-			}
-		}
+		count_new_items(0);
 
 		do {
 			eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
@@ -526,18 +556,10 @@ int count_file_items(int ifd, char *file, struct file_magic *file_magic,
  * Each activity selected may have several views. Moreover some activities
  * may have a number of items that varies within the file: In this case,
  * the number of views will depend on the highest number of items saved in
- * the file.
+ * the file. This number should have been computed when the file was read
+ * (see read_svg_records()).
  *
  * IN:
- * @ifd			File descriptor of input file.
- * @file		Name of file being read.
- * @file_magic		file_magic structure filled with file magic header data.
- * @file_actlst		List of (known or unknown) activities in file.
- * @rectime		Structure where timestamp (expressed in local time or
- *			in UTC depending on whether options -T/-t have been
- *			used or not) can be saved for current record.
- * @loctime		Structure where timestamp (expressed in local time)
- *			can be saved for current record.
  * @views_per_row	Default number of views displayed on a single row.
  *
  * OUT:
@@ -552,19 +574,12 @@ int count_file_items(int ifd, char *file, struct file_magic *file_magic,
  * Result may be 0.
  ***************************************************************************
  */
-int get_svg_graph_nr(int ifd, char *file, struct file_magic *file_magic,
-		     struct file_activity *file_actlst, struct tm *rectime,
-		     struct tm *loctime, int *views_per_row, int *nr_act_dispd)
+int get_svg_graph_nr(int *views_per_row, int *nr_act_dispd)
 {
 	int i, n, p, tot_g_nr = 0;
 
 	*nr_act_dispd = 0;
 
-	/* Count items in file */
-	if (!count_file_items(ifd, file, file_magic, file_actlst, rectime, loctime))
-		/* No record to display => No graph */
-		return 0;
-
 	for (i = 0; i < NR_ACT; i++) {
 		if (!id_seq[i])
 			continue;
@@ -612,9 +627,9 @@ int get_svg_graph_nr(int ifd, char *file, struct file_magic *file_magic,
 }
 /*
  ***************************************************************************
- * Display *one* sample of statistics for one or several activities,
- * checking that all conditions are met before printing (time start, time
- * end, interval). Current record should be a record of statistics (R_STATS),
+ * Check that all conditions are met before printing *one* sample of
+ * statistics for one or several activities (time start, time end,
+ * interval). Current record should be a record of statistics (R_STATS),
  * not a special one (R_RESTART or R_COMMENT).
  *
  * IN:
@@ -623,11 +638,6 @@ int get_svg_graph_nr(int ifd, char *file, struct file_magic *file_magic,
  * @use_tm_end		Set to TRUE if option -e has been used.
  * @reset		Set to TRUE if last_uptime should be reinitialized
  *			(used in next_slice() function).
- * @parm		Pointer on parameters depending on output format
- * 			(eg.: number of tabulations to print).
- * @rectime		Structure where timestamp (expressed in local time
- *			or in UTC depending on whether options -T/-t have
- * 			been used or not) has been saved for current record.
  * @loctime		Structure where timestamp (expressed in local time)
  *			has been saved for current record.
  * @reset_cd		TRUE if static cross_day variable should be reset.
@@ -638,18 +648,17 @@ int get_svg_graph_nr(int ifd, char *file, struct file_magic *file_magic,
  * OUT:
  * @cnt			Set to 0 to indicate that no other lines of stats
  * 			should be displayed.
+ * @itv			Interval of time with previous sample (in 1/100th
+ *			of a second).
  *
  * RETURNS:
- * 1 if stats have been successfully displayed.
+ * 1 if stats should be displayed.
  ***************************************************************************
  */
-int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
-			long *cnt, void *parm, struct tm *rectime,
-			struct tm *loctime, int reset_cd, unsigned int act_id)
+int check_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
+		      long *cnt, struct tm *loctime, int reset_cd, unsigned int act_id,
+		      unsigned long long *itv)
 {
-	int i;
-	unsigned long long dt, itv;
-	char cur_date[TIMESTAMP_LEN], cur_time[TIMESTAMP_LEN], *pre = NULL;
 	static int cross_day = FALSE;
 
 	if (reset_cd) {
@@ -661,6 +670,14 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 		cross_day = 0;
 	}
 
+	if ((act_id != ALL_ACTIVITIES) &&
+	    IS_CARRIED(act[get_activity_position(act, act_id, EXIT_IF_NOT_FOUND)], curr))
+		/*
+		 * Activity not saved in this record (it is saved at a longer period).
+		 * See note in sar.c.
+		 */
+		return 0;
+
 	/*
 	 * Check time (1).
 	 * For this first check, we use the time interval entered on
@@ -669,7 +686,8 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 	 * specified by the interval parameter.
 	 */
 	if (!next_slice(record_hdr[2].uptime_cs, record_hdr[curr].uptime_cs,
-			reset, interval))
+			reset, (interval < 0) ? -1 : interval * 100,
+			HAS_SUBSEC_RECORDS(file_hdr.sa_flags)))
 		/* Not close enough to desired interval */
 		return 0;
 
@@ -695,7 +713,7 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 		return 0;
 
 	/* Get interval values in 1/100th of a second */
-	get_itv_value(&record_hdr[curr], &record_hdr[!curr], &itv);
+	get_itv_value(&record_hdr[curr], &record_hdr[!curr], itv);
 
 	/* Check time (3) */
 	if (use_tm_end && (datecmp(loctime, &tm_end) > 0)) {
@@ -704,18 +722,44 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 		return 0;
 	}
 
-	dt = itv / 100;
-	/* Correct rounding error for dt */
-	if ((itv % 100) >= 50) {
-		dt++;
-	}
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Display *one* sample of statistics for one or several activities.
+ * Conditions to display it should have been checked with
+ * check_write_stats().
+ *
+ * IN:
+ * @curr		Index in array for current sample statistics.
+ * @parm		Pointer on parameters depending on output format
+ * 			(eg.: number of tabulations to print).
+ * @rectime		Structure where timestamp (expressed in local time
+ *			or in UTC depending on whether options -T/-t have
+ * 			been used or not) has been saved for current record.
+ * @itv			Interval of time with previous sample (in 1/100th
+ *			of a second).
+ * @act_id		Activity to display (only for formats where
+ * 			activities are displayed one at a time) or
+ *			ALL_ACTIVITIES for all.
+ ***************************************************************************
+ */
+void write_curr_stats(int curr, void *parm, struct tm *rectime, unsigned long long itv,
+		      unsigned int act_id)
+{
+	int i;
+	unsigned long long dt, act_itv;
+	char cur_date[TIMESTAMP_LEN], cur_time[TIMESTAMP_LEN], *pre = NULL;
+
+	dt = ROUND_ITV_SEC(itv);
 
 	/* Set date and time strings for current record */
 	set_record_timestamp_string(flags, &record_hdr[curr],
 				    cur_date, cur_time, TIMESTAMP_LEN, rectime);
 
 	if (*fmt[f_position]->f_timestamp) {
-		pre = (char *) (*fmt[f_position]->f_timestamp)(parm, F_BEGIN, cur_date, cur_time, dt,
+		pre = (char *) (*fmt[f_position]->f_timestamp)(parm, F_BEGIN, cur_date, cur_time, itv,
 							       &record_hdr[curr], &file_hdr, flags);
 	}
 
@@ -726,36 +770,47 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 			continue;
 
 		if ((TEST_MARKUP(fmt[f_position]->options) && CLOSE_MARKUP(act[i]->options)) ||
-		    (IS_SELECTED(act[i]->options) && (act[i]->nr > 0))) {
+		    (IS_SELECTED(act[i]->options) && !IS_CARRIED(act[i], curr))) {
+
+			/*
+			 * Statistics of an activity saved at a longer period than the
+			 * others are compared to the last ones read for it.
+			 */
+			act_itv = itv;
+			if ((act[i]->uptime_cs[curr] > act[i]->uptime_cs[!curr]) &&
+			    act[i]->uptime_cs[!curr]) {
+				act_itv = get_interval(act[i]->uptime_cs[!curr],
+						       act[i]->uptime_cs[curr]);
+			}
 
 			if (format == F_JSON_OUTPUT) {
 				/* JSON output */
 				int *tab = (int *) parm;
 
-				if (IS_SELECTED(act[i]->options) && (act[i]->nr > 0)) {
+				if (IS_SELECTED(act[i]->options) && !IS_CARRIED(act[i], curr)) {
 
 					if (*fmt[f_position]->f_timestamp) {
 						(*fmt[f_position]->f_timestamp)(tab, F_MAIN, cur_date, cur_time,
-										dt, &record_hdr[curr],
+										itv, &record_hdr[curr],
 										&file_hdr, flags);
 					}
 				}
-				(*act[i]->f_json_print)(act[i], curr, *tab, itv);
+				(*act[i]->f_json_print)(act[i], curr, *tab, act_itv);
 			}
 
 			else if (format == F_XML_OUTPUT) {
 				/* XML output */
 				int *tab = (int *) parm;
 
-				(*act[i]->f_xml_print)(act[i], curr, *tab, itv);
+				(*act[i]->f_xml_print)(act[i], curr, *tab, act_itv);
 			}
 
 			else if (format == F_SVG_OUTPUT) {
 				/* SVG output */
 				struct svg_parm *svg_p = (struct svg_parm *) parm;
 
-				svg_p->dt = (unsigned long) dt;
-				(*act[i]->f_svg_print)(act[i], curr, F_MAIN, svg_p, itv, &record_hdr[curr]);
+				svg_p->dt = (svg_p->timetag_hz > 1) ? itv * svg_p->timetag_hz / 100 : dt;
+				(*act[i]->f_svg_print)(act[i], curr, F_MAIN, svg_p, act_itv, &record_hdr[curr]);
 			}
 
 			else if (format == F_RAW_OUTPUT) {
@@ -771,21 +826,73 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 			else if (format == F_PCP_OUTPUT) {
 				/* PCP archive */
 				if (*act[i]->f_pcp_print) {
-					(*act[i]->f_pcp_print)(act[i], curr, itv, &record_hdr[curr]);
+					(*act[i]->f_pcp_print)(act[i], curr, act_itv, &record_hdr[curr]);
 				}
 			}
 
+			else if (format == F_ARROW_OUTPUT) {
+				/* Arrow output: Values are saved by the same functions as db output */
+				arrow_set_activity(act[i]);
+				(*act[i]->f_render)(act[i], RENDER_ARROW, pre, curr, act_itv);
+			}
+
 			else {
 				/* Other output formats: db, ppc */
-				(*act[i]->f_render)(act[i], (format == F_DB_OUTPUT), pre, curr, itv);
+				(*act[i]->f_render)(act[i], (format == F_DB_OUTPUT), pre, curr, act_itv);
 			}
 		}
 	}
 
 	if (*fmt[f_position]->f_timestamp) {
-		(*fmt[f_position]->f_timestamp)(parm, F_END, cur_date, cur_time, dt,
+		(*fmt[f_position]->f_timestamp)(parm, F_END, cur_date, cur_time, itv,
 						&record_hdr[curr], &file_hdr, flags);
 	}
+}
+
+/*
+ ***************************************************************************
+ * Display *one* sample of statistics for one or several activities,
+ * checking that all conditions are met before printing (time start, time
+ * end, interval). Current record should be a record of statistics (R_STATS),
+ * not a special one (R_RESTART or R_COMMENT).
+ *
+ * IN:
+ * @curr		Index in array for current sample statistics.
+ * @use_tm_start	Set to TRUE if option -s has been used.
+ * @use_tm_end		Set to TRUE if option -e has been used.
+ * @reset		Set to TRUE if last_uptime should be reinitialized
+ *			(used in next_slice() function).
+ * @parm		Pointer on parameters depending on output format
+ * 			(eg.: number of tabulations to print).
+ * @rectime		Structure where timestamp (expressed in local time
+ *			or in UTC depending on whether options -T/-t have
+ * 			been used or not) has been saved for current record.
+ * @loctime		Structure where timestamp (expressed in local time)
+ *			has been saved for current record.
+ * @reset_cd		TRUE if static cross_day variable should be reset.
+ * @act_id		Activity to display (only for formats where
+ * 			activities are displayed one at a time) or
+ *			ALL_ACTIVITIES for all.
+ *
+ * OUT:
+ * @cnt			Set to 0 to indicate that no other lines of stats
+ * 			should be displayed.
+ *
+ * RETURNS:
+ * 1 if stats have been successfully displayed.
+ ***************************************************************************
+ */
+int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
+			long *cnt, void *parm, struct tm *rectime,
+			struct tm *loctime, int reset_cd, unsigned int act_id)
+{
+	unsigned long long itv;
+
+	if (!check_write_stats(curr, use_tm_start, use_tm_end, reset, cnt, loctime,
+			       reset_cd, act_id, &itv))
+		return 0;
+
+	write_curr_stats(curr, parm, rectime, itv, act_id);
 
 	return 1;
 }
@@ -869,18 +976,366 @@ void rw_curr_act_stats(int ifd, int *curr, long *cnt, int *eosaf,
 	}
 	while (*cnt && !*eosaf && (rtype != R_RESTART));
 
+	if (format == F_ARROW_OUTPUT) {
+		/* Terminate the stream of current activity */
+		arrow_end_stream();
+	}
+
 	*reset = TRUE;
 }
 
 /*
  ***************************************************************************
- * Read stats for current activity from file and display its SVG graphs.
- * At most <count> lines of stats are taken into account.
+ * Save the statistics of an activity read for current record in the cache
+ * used to display all the activities in a single pass.
+ *
+ * IN:
+ * @p		Position of activity in array.
+ * @curr	Index in array where statistics have been read.
+ ***************************************************************************
+ */
+void cache_act_data(int p, int curr)
+{
+	struct activity *a = act[p];
+	struct pass_data pd;
+	__nr_t nr;
+	size_t sz;
+
+	nr = a->nr[curr] ? a->nr[curr] : a->nr_carried[curr];
+	if (HAS_PERSISTENT_VALUES(a->options) && (a->nr_ini > nr)) {
+		/* Structures up to @nr_ini have been reset when the record has been read */
+		nr = a->nr_ini;
+	}
+
+	memset(&pd, 0, sizeof(pd));
+	pd.uptime_cs = a->uptime_cs[curr];
+	pd.size = (size_t) a->msize * (size_t) nr * (size_t) a->nr2;
+	pd.nr = a->nr[curr];
+	pd.nr_carried = a->nr_carried[curr];
+
+	sz = (sizeof(pd) + pd.size + 7) & ~((size_t) 7);
+	if (pass_len[p] + sz > pass_alloc[p]) {
+		pass_alloc[p] = (pass_len[p] + sz) * 2;
+		SREALLOC(pass_buf[p], char, pass_alloc[p]);
+	}
+	memcpy(pass_buf[p] + pass_len[p], &pd, sizeof(pd));
+	memcpy(pass_buf[p] + pass_len[p] + sizeof(pd), a->buf[curr], pd.size);
+
+	pass_len[p] += sz;
+	pass_cache_size += sz;
+}
+
+/*
+ ***************************************************************************
+ * Restore the statistics of an activity saved in the cache used to
+ * display all the activities in a single pass.
+ *
+ * IN:
+ * @p		Position of activity in array.
+ * @curr	Index in array where statistics should be restored.
+ * @pos		Position of statistics in cache.
+ *
+ * OUT:
+ * @pos		Position of the statistics saved for next record.
+ ***************************************************************************
+ */
+void load_act_data(int p, int curr, size_t *pos)
+{
+	struct activity *a = act[p];
+	struct pass_data pd;
+
+	memcpy(&pd, pass_buf[p] + *pos, sizeof(pd));
+	memcpy(a->buf[curr], pass_buf[p] + *pos + sizeof(pd), pd.size);
+	a->uptime_cs[curr] = pd.uptime_cs;
+	a->nr[curr] = pd.nr;
+	a->nr_carried[curr] = pd.nr_carried;
+
+	*pos += (sizeof(pd) + pd.size + 7) & ~((size_t) 7);
+}
+
+/*
+ ***************************************************************************
+ * Save current record in the cache used to display all the activities in
+ * a single pass, along with the statistics of the activities to display.
+ *
+ * IN:
+ * @rtype	Record type (R_STATS, R_COMMENT or R_RESTART), or 0 for
+ *		the previous record displayed.
+ * @curr	Index in array where record has been read.
+ * @fpos	Position of record in file.
+ * @itv		Interval of time with previous record displayed.
+ * @rectime	Timestamp of record.
+ * @loctime	Timestamp of record (expressed in local time).
+ * @passes	Outputs to produce.
+ * @pass_nr	Number of outputs.
+ ***************************************************************************
+ */
+void cache_record(int rtype, int curr, off_t fpos, unsigned long long itv,
+		  struct tm *rectime, struct tm *loctime, struct pass passes[],
+		  int pass_nr)
+{
+	struct pass_rec *pr;
+	int k;
+
+	if (pass_rec_nr >= pass_rec_alloc) {
+		pass_rec_alloc = pass_rec_alloc ? pass_rec_alloc * 2 : 256;
+		SREALLOC(pass_recs, struct pass_rec, (size_t) pass_rec_alloc * sizeof(struct pass_rec));
+	}
+	pr = &pass_recs[pass_rec_nr++];
+
+	memcpy(&pr->hdr, &record_hdr[curr], RECORD_HEADER_SIZE);
+	pr->rectime = *rectime;
+	pr->loctime = *loctime;
+	pr->itv = itv;
+	pr->fpos = fpos;
+	pr->rtype = rtype;
+	pr->curr = curr;
+	pass_cache_size += sizeof(struct pass_rec);
+
+	if ((rtype == R_COMMENT) || (rtype == R_RESTART))
+		/*
+		 * COMMENT records will be read again from file.
+		 * RESTART records contain no statistics.
+		 */
+		return;
+
+	for (k = 0; k < pass_nr; k++) {
+		/* Outputs of an activity with multiple outputs are consecutive */
+		if (!k || (passes[k].p != passes[k - 1].p)) {
+			cache_act_data(passes[k].p, curr);
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Produce the output of every activity from the records saved in the
+ * cache, then empty it. Output of the first activity is displayed, those
+ * of the others are saved in their temporary files.
+ *
+ * IN:
+ * @ifd		File descriptor of input file.
+ * @passes	Outputs to produce.
+ * @pass_nr	Number of outputs.
+ * @first	TRUE if this is the first part of the outputs.
+ * @file_actlst	List of (known or unknown) activities in file.
+ * @rectime	Structure where timestamp can be saved for current record.
+ * @loctime	Structure where timestamp (expressed in local time) can be
+ *		saved for current record.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ ***************************************************************************
+ */
+void flush_pass_cache(int ifd, struct pass passes[], int pass_nr, int first,
+		      struct file_activity *file_actlst, struct tm *rectime,
+		      struct tm *loctime, char *file, struct file_magic *file_magic)
+{
+	struct record_header hdr_save[2];
+	struct pass_rec *pr;
+	unsigned int optf;
+	size_t pos;
+	off_t fpos;
+	int i, k, p, rtype, reread = FALSE;
+
+	/* Save current state of file reading */
+	memcpy(hdr_save, record_hdr, 2 * RECORD_HEADER_SIZE);
+	if ((fpos = sa_ftell(ifd)) < 0) {
+		perror("lseek");
+		exit(2);
+	}
+
+	for (k = 0; k < pass_nr; k++) {
+		p = passes[k].p;
+
+		if (passes[k].fp) {
+			/* Redirect output to the temporary file of the activity */
+			fflush(stdout);
+			if (dup2(fileno(passes[k].fp), STDOUT_FILENO) < 0) {
+				perror("dup2");
+				exit(4);
+			}
+		}
+
+		optf = act[p]->opt_flags;
+		act[p]->opt_flags = passes[k].opt_flags;
+
+		if (first && DISPLAY_FIELD_LIST(fmt[f_position]->options)) {
+			/* Print field list */
+			list_fields(act[p]->id);
+		}
+
+		pos = 0;
+		for (i = 0; i < pass_rec_nr; i++) {
+			pr = &pass_recs[i];
+
+			if (pr->rtype == R_COMMENT) {
+				/* Read COMMENT record again to display it */
+				if (sa_fseek(ifd, pr->fpos) < 0) {
+					perror("lseek");
+					exit(2);
+				}
+				read_next_sample(ifd, IGNORE_RESTART | DONT_READ_CPU_NR, pr->curr,
+						 file, &rtype, 0, file_magic, file_actlst,
+						 rectime, loctime, UEOF_STOP);
+				reread = TRUE;
+				continue;
+			}
+
+			memcpy(&record_hdr[pr->curr], &pr->hdr, RECORD_HEADER_SIZE);
+			load_act_data(p, pr->curr, &pos);
+
+			if (pr->rtype == R_STATS) {
+				write_curr_stats(pr->curr, NULL, &pr->rectime, pr->itv, act[p]->id);
+			}
+		}
+
+		if (format == F_ARROW_OUTPUT) {
+			/* Terminate the stream before output is redirected */
+			arrow_end_stream();
+		}
+
+		act[p]->opt_flags = optf;
+	}
+
+	/* Restore standard output */
+	fflush(stdout);
+	if ((pass_nr > 1) && (dup2(stdout_fd, STDOUT_FILENO) < 0)) {
+		perror("dup2");
+		exit(4);
+	}
+
+	/* Restore state of file reading */
+	memcpy(record_hdr, hdr_save, 2 * RECORD_HEADER_SIZE);
+	if (reread && (sa_fseek(ifd, fpos) < 0)) {
+		perror("lseek");
+		exit(2);
+	}
+
+	/* Empty the cache */
+	pass_rec_nr = 0;
+	for (p = 0; p < NR_ACT; p++) {
+		pass_len[p] = 0;
+	}
+	pass_cache_size = 0;
+}
+
+/*
+ ***************************************************************************
+ * Get the list of the outputs to produce for the selected activities, in
+ * the order in which they should be displayed. Each output of an activity
+ * with multiple outputs is a different one.
+ *
+ * IN:
+ * @graphs	TRUE if only activities with SVG graphs should be taken
+ *		into account.
+ *
+ * OUT:
+ * @passes	Outputs to produce. Their temporary files are not created.
+ *
+ * RETURNS:
+ * Number of outputs to produce.
+ ***************************************************************************
+ */
+int get_act_outputs(struct pass passes[], int graphs)
+{
+	int i, p, pass_nr = 0;
+	unsigned int msk;
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+
+		p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
+		if (!IS_SELECTED(act[p]->options) || (graphs && !act[p]->g_nr))
+			continue;
+
+		if (!HAS_MULTIPLE_OUTPUTS(act[p]->options)) {
+			passes[pass_nr].fp = NULL;
+			passes[pass_nr].p = p;
+			passes[pass_nr++].opt_flags = act[p]->opt_flags;
+		}
+		else {
+			for (msk = 1; msk < 0x100; msk <<= 1) {
+				if ((act[p]->opt_flags & 0xff) & msk) {
+					passes[pass_nr].fp = NULL;
+					passes[pass_nr].p = p;
+					passes[pass_nr++].opt_flags = act[p]->opt_flags & (0xffffff00 + msk);
+				}
+			}
+		}
+	}
+
+	return pass_nr;
+}
+
+/*
+ ***************************************************************************
+ * Get the list of the outputs to produce for the selected activities when
+ * they are displayed one after the other, and create the temporary files
+ * where all these outputs but the first one will be saved while the file
+ * is read. Each output of an activity with multiple outputs is a
+ * different one.
+ *
+ * IN:
+ * @file_actlst	List of (known or unknown) activities in file.
+ *
+ * OUT:
+ * @passes	Outputs to produce, in the order in which they should be
+ *		displayed.
+ *
+ * RETURNS:
+ * Number of outputs to produce, or 0 if they cannot be produced in a
+ * single pass (see rw_all_act_stats()).
+ ***************************************************************************
+ */
+int get_passes(struct pass passes[], struct file_activity *file_actlst)
+{
+	int i, p, k, pass_nr;
+	struct file_activity *fal = file_actlst;
+
+	for (i = 0; i < file_hdr.sa_act_nr; i++, fal++) {
+		p = get_activity_position(act, fal->id, RESUME_IF_NOT_FOUND);
+		if ((p >= 0) && IS_SELECTED(act[p]->options) && (fal->period > 1))
+			/* Activity saved at a longer period than the others */
+			return 0;
+	}
+
+	if ((pass_nr = get_act_outputs(passes, FALSE)) < 2)
+		return 0;
+
+	for (k = 1; k < pass_nr; k++) {
+		if ((passes[k].fp = tmpfile()) == NULL) {
+			/* Fall back to reading the file once per activity */
+			while (--k > 0) {
+				fclose(passes[k].fp);
+			}
+			return 0;
+		}
+	}
+
+	return pass_nr;
+}
+
+/*
+ ***************************************************************************
+ * Read stats from file and print them for all the activities to display
+ * in a single pass: Each record is read only once, then the output of
+ * each activity is produced from a cache of the records read, exactly as
+ * rw_curr_act_stats() would have produced it when reading the file again
+ * for each activity. Display at most <count> lines of stats (and possibly
+ * comments inserted in file) located between two LINUX RESTART messages.
+ * NB: This cannot be used when an activity is saved at a longer period
+ * than the others, since the records taken into account would then
+ * depend on the activity displayed.
  *
  * IN:
  * @ifd		File descriptor of input file.
  * @curr	Index in array for current sample statistics.
- * @p		Current activity position.
+ * @passes	Outputs to produce, in the order in which they should be
+ *		displayed. The temporary files of all the outputs but the
+ *		first one should have been created.
+ * @pass_nr	Number of outputs.
  * @file_actlst	List of (known or unknown) activities in file.
  * @rectime	Structure where timestamp (expressed in local time or in UTC
  *		depending on whether options -T/-t have been used or not) can
@@ -889,27 +1344,31 @@ void rw_curr_act_stats(int ifd, int *curr, long *cnt, int *eosaf,
  *		saved for current record.
  * @file	Name of file being read.
  * @file_magic	file_magic structure filled with file magic header data.
- * @g_nr	Number of graphs already displayed (for all activities).
- * @nr_act_dispd
- *		Total number of activities that will be displayed.
  *
  * OUT:
+ * @curr	Index in array for next sample statistics.
  * @cnt		Number of lines of stats remaining to write.
  * @eosaf	Set to TRUE if EOF (end of file) has been reached.
  * @reset	Set to TRUE if last_uptime variable should be
- *		reinitialized (used in next_slice() function).
- * @g_nr	Total number of views displayed (including current activity).
+ * 		reinitialized (used in next_slice() function).
  ***************************************************************************
  */
-void display_curr_act_graphs(int ifd, int *curr, long *cnt, int *eosaf,
-			     int p, int *reset, struct file_activity *file_actlst,
-			     struct tm *rectime, struct tm *loctime,
-			     char *file, struct file_magic *file_magic, int *g_nr,
-			     int nr_act_dispd)
+void rw_all_act_stats(int ifd, int *curr, long *cnt, int *eosaf, int *reset,
+		      struct pass passes[], int pass_nr, struct file_activity *file_actlst,
+		      struct tm *rectime, struct tm *loctime, char *file,
+		      struct file_magic *file_magic)
 {
-	struct svg_parm parm;
-	int rtype;
-	int next, reset_cd;
+	char buf[4096];
+	unsigned long long itv;
+	ssize_t n;
+	off_t fpos;
+	int rtype, k;
+	int next, reset_cd, first = TRUE;
+
+	if ((stdout_fd < 0) && ((stdout_fd = dup(STDOUT_FILENO)) < 0)) {
+		perror("dup");
+		exit(4);
+	}
 
 	/* Rewind file */
 	seek_file_position(ifd, DO_RESTORE);
@@ -919,38 +1378,34 @@ void display_curr_act_graphs(int ifd, int *curr, long *cnt, int *eosaf,
 	 * Used to compute the rate displayed on the first line.
 	 */
 	copy_structures(act, id_seq, record_hdr, !*curr, 2);
-
-	parm.graph_no = *g_nr;
-	parm.ust_time_ref = (unsigned long long) get_time_ref();
-	parm.ust_time_first = record_hdr[2].ust_time;
-	parm.restart = TRUE;
-	parm.file_hdr = &file_hdr;
-	parm.nr_act_dispd = nr_act_dispd;
+	cache_record(0, !*curr, 0, 0, rectime, loctime, passes, pass_nr);
 
 	*cnt  = count;
 	reset_cd = 1;
 
-	/* Allocate graphs arrays */
-	(*act[p]->f_svg_print)(act[p], !*curr, F_BEGIN, &parm, 0, &record_hdr[!*curr]);
-
 	do {
-		*eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
-					  *curr, file, &rtype, 0, file_magic,
-					  file_actlst, rectime, loctime, UEOF_CONT);
+		if ((fpos = sa_ftell(ifd)) < 0) {
+			perror("lseek");
+			exit(2);
+		}
 
-		if (!*eosaf && (rtype != R_COMMENT) && (rtype != R_RESTART)) {
+		/* COMMENT records are displayed when the output of each activity is produced */
+		*eosaf = read_next_sample(ifd, IGNORE_RESTART | DONT_READ_CPU_NR | IGNORE_COMMENT,
+					  *curr, file, &rtype, 0, file_magic,
+					  file_actlst, rectime, loctime, UEOF_STOP);
 
-			next = generic_write_stats(*curr, tm_start.use, tm_end.use, *reset, cnt,
-						   &parm, rectime, loctime, reset_cd, act[p]->id);
+		if (!*eosaf && (rtype == R_COMMENT)) {
+			cache_record(R_COMMENT, *curr, fpos, 0, rectime, loctime,
+				     passes, pass_nr);
+		}
+		else if (!*eosaf && (rtype != R_RESTART)) {
+			next = check_write_stats(*curr, tm_start.use, tm_end.use, *reset, cnt,
+						 loctime, reset_cd, ALL_ACTIVITIES, &itv);
 			reset_cd = 0;
+
 			if (next) {
-				/*
-				 * next is set to 1 when we were close enough to desired interval.
-				 * In this case, the call to generic_write_stats() has actually
-				 * displayed a line of stats.
-				 */
-				parm.restart = FALSE;
-				parm.ust_time_end = record_hdr[*curr].ust_time;
+				cache_record(R_STATS, *curr, fpos, itv, rectime, loctime,
+					     passes, pass_nr);
 				*curr ^= 1;
 				if (*cnt > 0) {
 					(*cnt)--;
@@ -958,21 +1413,277 @@ void display_curr_act_graphs(int ifd, int *curr, long *cnt, int *eosaf,
 			}
 			*reset = FALSE;
 		}
-		if (!*eosaf && (rtype == R_RESTART)) {
+
+		if (pass_cache_size >= PASS_CACHE_SIZE) {
+			flush_pass_cache(ifd, passes, pass_nr, first, file_actlst,
+					 rectime, loctime, file, file_magic);
+			first = FALSE;
+			/* Next records will be compared with the last one displayed */
+			cache_record(0, !*curr, 0, 0, rectime, loctime, passes, pass_nr);
+		}
+	}
+	while (*cnt && !*eosaf && (rtype != R_RESTART));
+
+	flush_pass_cache(ifd, passes, pass_nr, first, file_actlst,
+			 rectime, loctime, file, file_magic);
+
+	/* Now display the outputs of the other activities, in order */
+	for (k = 1; k < pass_nr; k++) {
+		if (lseek(fileno(passes[k].fp), 0, SEEK_SET) < 0) {
+			perror("lseek");
+			exit(4);
+		}
+		while ((n = read(fileno(passes[k].fp), buf, sizeof(buf))) > 0) {
+			fwrite(buf, 1, (size_t) n, stdout);
+		}
+	}
+
+	*reset = TRUE;
+}
+
+/*
+ ***************************************************************************
+ * Read the whole file for SVG output. Each record is read and decoded only
+ * once: The number of different items in file is counted for each
+ * activity (see count_file_items()) and the statistics of the activities
+ * to display are saved in the cache used to display all the activities in
+ * a single pass. Graphs are then drawn from this cache (see
+ * display_curr_act_graphs()). Unlike rw_all_act_stats(), the cache is not
+ * emptied while the file is read since the number of items should be
+ * known before any graph can be drawn.
+ *
+ * IN:
+ * @ifd		File descriptor of input file.
+ * @passes	Outputs to produce.
+ * @pass_nr	Number of outputs.
+ * @file_actlst	List of (known or unknown) activities in file.
+ * @rectime	Structure where timestamp (expressed in local time or in UTC
+ *		depending on whether options -T/-t have been used or not) can
+ *		be saved for current record.
+ * @loctime	Structure where timestamp (expressed in local time) can be
+ *		saved for current record.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ *
+ * RETURNS:
+ * 0 if no records are concerned in file, and 1 otherwise.
+ ***************************************************************************
+ */
+int read_svg_records(int ifd, struct pass passes[], int pass_nr,
+		     struct file_activity *file_actlst, struct tm *rectime,
+		     struct tm *loctime, char *file, struct file_magic *file_magic)
+{
+	unsigned int save_cpu_nr = file_hdr.sa_cpu_nr;
+	int i, rtype, counting = TRUE;
+
+	/* Init maximum number of items for each activity */
+	for (i = 0; i < NR_ACT; i++) {
+		if (!HAS_LIST_ON_CMDLINE(act[i]->options)) {
+			act[i]->item_list_sz = 0;
+		}
+	}
+
+	/*
+	* If this record is a special (RESTART or COMMENT) one, ignore it and
+	* (try to) get another one.
+	*/
+	do {
+		if (read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS, 0,
+				     file, &rtype, 0, file_magic, file_actlst,
+				     rectime, loctime, UEOF_CONT))
+			/* End of sa data file: No record to display */
+			return 0;
+	}
+	while ((rtype == R_RESTART) || (rtype == R_COMMENT) ||
+	       (tm_start.use && (datecmp(loctime, &tm_start) < 0)) ||
+	       (tm_end.use && (datecmp(loctime, &tm_end) >= 0)));
+
+	/* Save the first stats collected. Used for example in next_slice() function */
+	copy_structures(act, id_seq, record_hdr, 2, 0);
+
+	count_new_items(0);
+
+	/* Empty the cache */
+	pass_rec_nr = 0;
+	for (i = 0; i < NR_ACT; i++) {
+		pass_len[i] = 0;
+	}
+	pass_cache_size = 0;
+
+	while (!read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS, 0,
+				 file, &rtype, 0, file_magic, file_actlst,
+				 rectime, loctime, UEOF_CONT)) {
+
+		if (rtype == R_COMMENT)
+			continue;
+
+		if (tm_end.use && (datecmp(loctime, &tm_end) >= 0)) {
+			/* End time exceeded: Items are no longer counted */
+			counting = FALSE;
+		}
+
+		if ((rtype == R_STATS) && counting) {
+			count_new_items(0);
+		}
+		cache_record(rtype, 0, 0, 0, rectime, loctime, passes, pass_nr);
+	}
+
+	/* Restore CPU number read at the beginning of the file (displayed in SVG header) */
+	file_hdr.sa_cpu_nr = save_cpu_nr;
+
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Get the scaling factor on X axis used to decimate the SVG graphs drawn
+ * from the records saved in the cache by read_svg_records(), if they are
+ * to contain more points than can be displayed (see SVG_POINTS_PER_PX).
+ * Graphs are decimated while being drawn, i.e. before the end of the X
+ * axis is known: It is estimated from the records that may be displayed.
+ *
+ * IN:
+ * @svg_p	SVG specific parameters: X axis start time (.@ust_time_ref)
+ *		and units of X axis per second (.@timetag_hz).
+ *
+ * RETURNS:
+ * Scaling factor on X axis, or 0 if graphs should not be decimated.
+ ***************************************************************************
+ */
+double get_svg_dec_xfactor(struct svg_parm *svg_p)
+{
+	unsigned long long xend = 0;
+	long nr = 0;
+	int i;
+
+	for (i = 0; i < pass_rec_nr; i++) {
+		if ((pass_recs[i].rtype != R_STATS) ||
+		    (tm_end.use && (datecmp(&pass_recs[i].loctime, &tm_end) > 0)))
+			continue;
+
+		/*
+		 * When the number of lines of stats is limited, the end of the X axis
+		 * may be underestimated: Graphs are then less decimated than needed.
+		 */
+		if ((count <= 0) || (nr < count)) {
+			xend = SVG_TIMETAG(svg_p, &pass_recs[i].hdr);
+		}
+		nr++;
+	}
+	if ((count > 0) && (nr > count)) {
+		nr = count;
+	}
+
+	if (DISPLAY_ONE_DAY(flags) && (3600 * 24 * svg_p->timetag_hz > xend)) {
+		xend = 3600 * 24 * svg_p->timetag_hz;
+	}
+
+	if ((nr <= SVG_POINTS_PER_PX * SVG_G_XSIZE) || !xend)
+		return 0.0;
+
+	return (double) SVG_G_XSIZE / xend;
+}
+
+/*
+ ***************************************************************************
+ * Display the SVG graphs of current activity from the records saved in the
+ * cache by read_svg_records(). At most <count> lines of stats are taken
+ * into account.
+ *
+ * IN:
+ * @curr	Index in array for current sample statistics.
+ * @p		Current activity position.
+ * @rectime	Structure where timestamp (expressed in local time or in UTC
+ *		depending on whether options -T/-t have been used or not) can
+ *		be saved for current record.
+ * @loctime	Structure where timestamp (expressed in local time) can be
+ *		saved for current record.
+ * @g_nr	Number of graphs already displayed (for all activities).
+ * @nr_act_dispd
+ *		Total number of activities that will be displayed.
+ *
+ * OUT:
+ * @curr	Index in array for next sample statistics.
+ * @reset	Set to TRUE if last_uptime variable should be
+ *		reinitialized (used in next_slice() function).
+ * @g_nr	Total number of views displayed (including current activity).
+ ***************************************************************************
+ */
+void display_curr_act_graphs(int *curr, int p, int *reset, struct tm *rectime,
+			     struct tm *loctime, int *g_nr, int nr_act_dispd)
+{
+	struct svg_parm parm;
+	struct pass_rec *pr;
+	size_t pos = 0;
+	long cnt;
+	int i, next, reset_cd;
+
+	/*
+	 * Restore the first stats collected.
+	 * Used to compute the rate displayed on the first line.
+	 */
+	copy_structures(act, id_seq, record_hdr, !*curr, 2);
+
+	parm.graph_no = *g_nr;
+	parm.ust_time_ref = (unsigned long long) get_time_ref();
+	/* X axis unit is the millisecond when records may be less than a second apart */
+	parm.timetag_hz = DISPLAY_SUBSEC_TIME(flags) ? 1000 : 1;
+	parm.timetag_first = SVG_TIMETAG(&parm, &record_hdr[2]);
+	parm.restart = TRUE;
+	parm.file_hdr = &file_hdr;
+	parm.nr_act_dispd = nr_act_dispd;
+	parm.dec_xfactor = get_svg_dec_xfactor(&parm);
+
+	cnt  = count;
+	reset_cd = 1;
+
+	/* Allocate graphs arrays */
+	(*act[p]->f_svg_print)(act[p], !*curr, F_BEGIN, &parm, 0, &record_hdr[!*curr]);
+
+	for (i = 0; i < pass_rec_nr; i++) {
+		pr = &pass_recs[i];
+
+		if (pr->rtype == R_RESTART) {
 			parm.restart = TRUE;
 			*reset = TRUE;
 			/* Go to next statistics record, if possible */
-			do {
-				*eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
-							  *curr, file, &rtype, 0, file_magic,
-							  file_actlst, rectime, loctime, UEOF_CONT);
+			while ((i + 1 < pass_rec_nr) && (pass_recs[i + 1].rtype == R_RESTART)) {
+				i++;
 			}
-			while (!*eosaf && ((rtype == R_RESTART) || (rtype == R_COMMENT)));
+			if (++i < pass_rec_nr) {
+				pr = &pass_recs[i];
+				memcpy(&record_hdr[*curr], &pr->hdr, RECORD_HEADER_SIZE);
+				load_act_data(p, *curr, &pos);
+			}
+
+			*curr ^= 1;
+			continue;
+		}
+
+		memcpy(&record_hdr[*curr], &pr->hdr, RECORD_HEADER_SIZE);
+		load_act_data(p, *curr, &pos);
+		*rectime = pr->rectime;
+		*loctime = pr->loctime;
 
+		next = generic_write_stats(*curr, tm_start.use, tm_end.use, *reset, &cnt,
+					   &parm, rectime, loctime, reset_cd, act[p]->id);
+		reset_cd = 0;
+		if (next) {
+			/*
+			 * next is set to 1 when we were close enough to desired interval.
+			 * In this case, the call to generic_write_stats() has actually
+			 * displayed a line of stats.
+			 */
+			parm.restart = FALSE;
+			parm.ust_time_end = record_hdr[*curr].ust_time;
+			parm.ust_usec_end = record_hdr[*curr].ust_usec;
 			*curr ^= 1;
+			if (cnt > 0) {
+				cnt--;
+			}
 		}
+		*reset = FALSE;
 	}
-	while (!*eosaf);
 
 	*reset = TRUE;
 
@@ -980,6 +1691,7 @@ void display_curr_act_graphs(int ifd, int *curr, long *cnt, int *eosaf,
 	if (DISPLAY_ONE_DAY(flags) &&
 	    (parm.ust_time_ref + (3600 * 24) > parm.ust_time_end)) {
 		parm.ust_time_end = parm.ust_time_ref + (3600 * 24);
+		parm.ust_usec_end = 0;
 	}
 
 	/* Actually display graphs for current activity */
@@ -1178,10 +1890,11 @@ void logic2_display_loop(int ifd, struct file_activity *file_actlst,
 			 struct tm *rectime, struct tm *loctime, char *file,
 			 struct file_magic *file_magic)
 {
-	int i, p;
+	int i, p, k, pass_nr;
 	int curr = 1, rtype;
 	int eosaf = TRUE, reset = FALSE;
 	long cnt = 1;
+	struct pass passes[NR_ACT * 8];
 
 	/* Read system statistics from file */
 	do {
@@ -1220,6 +1933,16 @@ void logic2_display_loop(int ifd, struct file_activity *file_actlst,
 					  ALL_ACTIVITIES, &reset, file_actlst,
 					  rectime, loctime, file, file_magic);
 		}
+		else if ((pass_nr = get_passes(passes, file_actlst)) > 1) {
+			/* Read the statistics only once for all the activities */
+			rw_all_act_stats(ifd, &curr, &cnt, &eosaf, &reset,
+					 passes, pass_nr, file_actlst,
+					 rectime, loctime, file, file_magic);
+
+			for (k = 1; k < pass_nr; k++) {
+				fclose(passes[k].fp);
+			}
+		}
 		else {
 			/* For each requested activity... */
 			for (i = 0; i < NR_ACT; i++) {
@@ -1304,11 +2027,12 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 			 struct file_magic *file_magic)
 {
 	struct svg_hdr_parm parm;
-	int i, p;
-	int curr = 1, rtype, g_nr = 0, views_per_row = 1, nr_act_dispd;
-	int eosaf = TRUE, reset = TRUE;
-	long cnt = 1;
-	int graph_nr = 0;
+	int k, p, pass_nr;
+	int curr = 1, g_nr = 0, views_per_row = 1, nr_act_dispd = 0;
+	int reset = TRUE;
+	int graph_nr = 0, rec_nr;
+	unsigned int optf;
+	struct pass passes[NR_ACT * 8];
 
 	/* Use a decimal point to make SVG code locale independent */
 	setlocale(LC_NUMERIC, "C");
@@ -1316,13 +2040,18 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 	/* Init custom colors palette */
 	init_custom_color_palette();
 
+	/* Read the whole file once, counting items and saving the statistics to display */
+	pass_nr = get_act_outputs(passes, TRUE);
+	rec_nr = read_svg_records(ifd, passes, pass_nr, file_actlst,
+				  rectime, loctime, file, file_magic);
+
 	/*
 	 * Calculate the number of rows and the max number of views per row to display.
 	 * Result may be 0. In this case, "No data" will be displayed instead of the graphs.
 	 */
-	graph_nr = get_svg_graph_nr(ifd, file, file_magic,
-				    file_actlst, rectime, loctime, &views_per_row,
-				    &nr_act_dispd);
+	if (rec_nr) {
+		graph_nr = get_svg_graph_nr(&views_per_row, &nr_act_dispd);
+	}
 
 	if (SET_CANVAS_HEIGHT(flags)) {
 		/*
@@ -1343,62 +2072,23 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 					     &file_hdr, act, id_seq, file_actlst);
 	}
 
-	/*
-	* If this record is a special (RESTART or COMMENT) one, ignore it and
-	* (try to) get another one.
-	*/
-	do {
-		if (read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT, 0,
-				     file, &rtype, 0, file_magic, file_actlst,
-				     rectime, loctime, UEOF_CONT))
-		{
-			/* End of sa data file: No views displayed */
-			parm.graph_nr = 0;
-			goto close_svg;
-		}
+	if (!rec_nr) {
+		/* End of sa data file: No views displayed */
+		parm.graph_nr = 0;
+		goto close_svg;
 	}
-	while ((rtype == R_RESTART) || (rtype == R_COMMENT) ||
-	       (tm_start.use && (datecmp(loctime, &tm_start) < 0)) ||
-	       (tm_end.use && (datecmp(loctime, &tm_end) >= 0)));
-
-	/* Save the first stats collected. Used for example in next_slice() function */
-	copy_structures(act, id_seq, record_hdr, 2, 0);
-
-	/* Save current file position */
-	seek_file_position(ifd, DO_SAVE);
 
 	/* For each requested activity, display graphs */
-	for (i = 0; i < NR_ACT; i++) {
-
-		if (!id_seq[i])
-			continue;
+	for (k = 0; k < pass_nr; k++) {
+		p = passes[k].p;
 
-		p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
-		if (!IS_SELECTED(act[p]->options) || !act[p]->g_nr)
-			continue;
-
-		if (!HAS_MULTIPLE_OUTPUTS(act[p]->options)) {
-			display_curr_act_graphs(ifd, &curr, &cnt, &eosaf,
-						p, &reset, file_actlst,
-						rectime, loctime, file,
-						file_magic, &g_nr, nr_act_dispd);
-		}
-		else {
-			unsigned int optf, msk;
+		optf = act[p]->opt_flags;
+		act[p]->opt_flags = passes[k].opt_flags;
 
-			optf = act[p]->opt_flags;
+		display_curr_act_graphs(&curr, p, &reset, rectime, loctime,
+					&g_nr, nr_act_dispd);
 
-			for (msk = 1; msk < 0x100; msk <<= 1) {
-				if ((act[p]->opt_flags & 0xff) & msk) {
-					act[p]->opt_flags &= (0xffffff00 + msk);
-					display_curr_act_graphs(ifd, &curr, &cnt, &eosaf,
-								p, &reset, file_actlst,
-								rectime, loctime, file,
-								file_magic, &g_nr, nr_act_dispd);
-					act[p]->opt_flags = optf;
-				}
-			}
-		}
+		act[p]->opt_flags = optf;
 	}
 
 	/* Real number of graphs that have been displayed */
@@ -1435,6 +2125,11 @@ void read_stats_from_file(char dfile[], char pcparchive[])
 	check_file_actlst(&ifd, dfile, act, flags, &file_magic, &file_hdr,
 			  &file_actlst, id_seq, ignore, &endian_mismatch, &arch_64);
 
+	if (HAS_SUBSEC_RECORDS(file_hdr.sa_flags)) {
+		/* Records may be less than a second apart: Display milliseconds in timestamps */
+		flags |= S_F_SUBSEC_TIME;
+	}
+
 	if (DISPLAY_HDR_ONLY(flags)) {
 		if (*fmt[f_position]->f_header) {
 			if (format == F_PCP_OUTPUT) {
@@ -1450,6 +2145,10 @@ void read_stats_from_file(char dfile[], char pcparchive[])
 	/* Perform required allocations */
 	allocate_structures(act);
 
+	/* Skip records preceding start time if file has a time index */
+	seek_time_index(ifd, dfile, act, &file_hdr, flags, TRUE,
+			&tm_start, &tm_end, endian_mismatch, arch_64);
+
 	/* Call function corresponding to selected output format */
 	if (format == F_SVG_OUTPUT) {
 		logic3_display_loop(ifd, file_actlst,
@@ -1599,6 +2298,9 @@ int main(int argc, char **argv)
 				else if (!strcmp(t, K_BWCOL)) {
 					palette = SVG_BW_COL_PALETTE;
 				}
+				else if (!strcmp(t, K_COMPACT)) {
+					json_compact = TRUE;
+				}
 				else if (!strncmp(t, K_PCPARCHIVE, strlen(K_PCPARCHIVE))) {
 					v = t + strlen(K_PCPARCHIVE);
 					strncpy(pcparchive, v, MAX_FILE_LEN);
@@ -1663,6 +2365,13 @@ int main(int argc, char **argv)
 
 					switch (*(argv[opt] + i)) {
 
+					case 'a':
+						if (format) {
+							usage(argv[0]);
+						}
+						format = F_ARROW_OUTPUT;
+						break;
+
 					case 'C':
 						flags |= S_F_COMMENT;
 						break;
@@ -1843,10 +2552,6 @@ int main(int argc, char **argv)
 	/* Check options consistency with selected output format. Default is PPC display */
 	check_format_options();
 
-	if (interval < 0) {
-		interval = 1;
-	}
-
 	if (format == F_CONV_OUTPUT) {
 		/* Convert file to current format */
 		convert_file(dfile, act);
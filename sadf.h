@@ -21,6 +21,9 @@
 #define IGNORE_COMMENT		4
 #define SET_TIMESTAMPS		8
 
+/* Interval of time (in 1/100th of a second) rounded to the nearest second */
+#define ROUND_ITV_SEC(itv)	(((itv) / 100) + (((itv) % 100) >= 50))
+
 /*
  ***************************************************************************
  * Output format identification values.
@@ -28,7 +31,7 @@
  */
 
 /* Number of output formats */
-#define NR_FMT	9
+#define NR_FMT	10
 
 /* Output formats */
 #define F_DB_OUTPUT	1
@@ -40,6 +43,7 @@
 #define F_SVG_OUTPUT	7
 #define F_RAW_OUTPUT	8
 #define F_PCP_OUTPUT	9
+#define F_ARROW_OUTPUT	10
 
 /* Format options */
 
@@ -117,6 +121,81 @@
 #define TEST_MARKUP(m)			(((m) & FO_TEST_MARKUP)		== FO_TEST_MARKUP)
 #define REJECT_TRUE_TIME(m)		(((m) & FO_NO_TRUE_TIME)	== FO_NO_TRUE_TIME)
 
+/*
+ ***************************************************************************
+ * Structures used to display all the activities in a single pass over the
+ * data file (see rw_all_act_stats() and read_svg_records()).
+ ***************************************************************************
+ */
+
+/*
+ * Records are decoded then saved in a cache until its size reaches this
+ * value (in bytes). The output of every activity is then produced from the
+ * records of the cache.
+ */
+#define PASS_CACHE_SIZE		(32 * 1024 * 1024)
+
+/* Record saved in the cache */
+struct pass_rec {
+	/*
+	 * Record header and timestamp (expressed in local time or in UTC
+	 * depending on whether options -T/-t have been used or not).
+	 */
+	struct record_header hdr;
+	struct tm rectime;
+	/*
+	 * Timestamp of record expressed in local time (used only for
+	 * SVG output).
+	 */
+	struct tm loctime;
+	/*
+	 * Interval of time with previous record displayed (in 1/100th of
+	 * a second).
+	 */
+	unsigned long long itv;
+	/*
+	 * Position of record in file (used to read COMMENT records again).
+	 */
+	off_t fpos;
+	/*
+	 * Record type (R_STATS, R_COMMENT or R_RESTART), or 0 for the
+	 * previous record displayed (saved at the beginning of the cache).
+	 */
+	int rtype;
+	/*
+	 * Index in arrays where record has been read.
+	 */
+	int curr;
+};
+
+/* Statistics of an activity saved in the cache for a record */
+struct pass_data {
+	unsigned long long uptime_cs;
+	/*
+	 * Size of the statistics structures following this structure.
+	 * Each pass_data structure is aligned on 8 bytes.
+	 */
+	size_t size;
+	__nr_t nr;
+	__nr_t nr_carried;
+};
+
+/* Output of an activity */
+struct pass {
+	/*
+	 * Temporary file where output is saved until the outputs of
+	 * the previous activities have been displayed. NULL for the
+	 * first activity, whose output is displayed as it is produced.
+	 */
+	FILE *fp;
+	/*
+	 * Position of activity in array, and flags (AO_F_...) of the
+	 * output (for activities with multiple outputs).
+	 */
+	int p;
+	unsigned int opt_flags;
+};
+
 
 /*
  ***************************************************************************
@@ -188,6 +267,9 @@ __tm_funct_t print_raw_timestamp
 __tm_funct_t print_pcp_timestamp
 	(void *, int, char *, char *, unsigned long long,
 	 struct record_header *, struct file_header *, unsigned int);
+__tm_funct_t print_arrow_timestamp
+	(void *, int, char *, char *, unsigned long long,
+	 struct record_header *, struct file_header *, unsigned int);
 
 /*
  * Prototypes used to display the report header
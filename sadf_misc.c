@@ -24,6 +24,7 @@
 
 #include "sadf.h"
 #include "pcp_def_metrics.h"
+#include "arrow_ipc.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -169,26 +170,26 @@ __printf_funct_t print_json_restart(int *tab, int action, char *cur_date,
 	static int sep = FALSE;
 
 	if (action & F_BEGIN) {
-		printf(",\n");
-		xprintf((*tab)++, "\"restarts\": [");
+		jprintf0(0, ",\n");
+		jprintf((*tab)++, "\"restarts\": [");
 	}
 	if (action & F_MAIN) {
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
-		xprintf((*tab)++, "{");
-		xprintf(*tab, "\"boot\": {\"date\": \"%s\", \"time\": \"%s\", \"utc\": %d, \"cpu_count\": %d}",
+		jprintf((*tab)++, "{");
+		jprintf(*tab, "\"boot\": {\"date\": \"%s\", \"time\": \"%s\", \"utc\": %d, \"cpu_count\": %d}",
 			cur_date, cur_time, utc ? 1 : 0,
 			file_hdr->sa_cpu_nr > 1 ? file_hdr->sa_cpu_nr - 1 : 1);
-		xprintf0(--(*tab), "}");
+		jprintf0(--(*tab), "}");
 		sep = TRUE;
 	}
 	if (action & F_END) {
 		if (sep) {
-			printf("\n");
+			jprintf0(0, "\n");
 			sep = FALSE;
 		}
-		xprintf0(--(*tab), "]");
+		jprintf0(--(*tab), "]");
 	}
 }
 
@@ -353,27 +354,27 @@ __printf_funct_t print_json_comment(int *tab, int action, char *cur_date,
 	static int sep = FALSE;
 
 	if (action & F_BEGIN) {
-		printf(",\n");
-		xprintf((*tab)++, "\"comments\": [");
+		jprintf0(0, ",\n");
+		jprintf((*tab)++, "\"comments\": [");
 	}
 	if (action & F_MAIN) {
 		if (sep) {
-			printf(",\n");
+			jprintf0(0, ",\n");
 		}
-		xprintf((*tab)++, "{");
-		xprintf(*tab,
+		jprintf((*tab)++, "{");
+		jprintf(*tab,
 			"\"comment\": {\"date\": \"%s\", \"time\": \"%s\", "
 			"\"utc\": %d, \"com\": \"%s\"}",
 			cur_date, cur_time, utc ? 1 : 0, comment);
-		xprintf0(--(*tab), "}");
+		jprintf0(--(*tab), "}");
 		sep = TRUE;
 	}
 	if (action & F_END) {
 		if (sep) {
-			printf("\n");
+			jprintf0(0, "\n");
 			sep = FALSE;
 		}
-		xprintf0(--(*tab), "]");
+		jprintf0(--(*tab), "]");
 	}
 }
 
@@ -450,22 +451,22 @@ __printf_funct_t print_json_statistics(int *tab, int action, struct activity *ac
 	static int sep = FALSE;
 
 	if (action & F_BEGIN) {
-		printf(",\n");
-		xprintf((*tab)++, "\"statistics\": [");
+		jprintf0(0, ",\n");
+		jprintf((*tab)++, "\"statistics\": [");
 	}
 	if (action & F_MAIN) {
 		if (sep) {
-			xprintf(--(*tab), "},");
+			jprintf(--(*tab), "},");
 		}
-		xprintf((*tab)++, "{");
+		jprintf((*tab)++, "{");
 		sep = TRUE;
 	}
 	if (action & F_END) {
 		if (sep) {
-			xprintf(--(*tab), "}");
+			jprintf(--(*tab), "}");
 			sep = FALSE;
 		}
-		xprintf0(--(*tab), "]");
+		jprintf0(--(*tab), "]");
 	}
 }
 
@@ -555,6 +556,33 @@ __printf_funct_t print_pcp_statistics(int *tab, int action, struct activity *act
 #endif /* HAVE_PCP */
 }
 
+/*
+ ***************************************************************************
+ * Format the interval of time with preceding record, expressed in seconds.
+ * The interval is rounded to the nearest second, unless the file contains
+ * records less than a second apart.
+ *
+ * IN:
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
+ *
+ * RETURNS:
+ * Pointer on a static string containing the interval.
+ ***************************************************************************
+ */
+char *format_itv(unsigned long long itv)
+{
+	static char str[32];
+
+	if (DISPLAY_SUBSEC_TIME(flags)) {
+		snprintf(str, sizeof(str), "%llu.%02llu", itv / 100, itv % 100);
+	}
+	else {
+		snprintf(str, sizeof(str), "%llu", ROUND_ITV_SEC(itv));
+	}
+
+	return str;
+}
+
 /*
  ***************************************************************************
  * Display the "timestamp" part of the report (db and ppc format).
@@ -565,7 +593,7 @@ __printf_funct_t print_pcp_statistics(int *tab, int action, struct activity *act
  * @cur_date	Date string of current record.
  * @cur_time	Time string of current record.
  * @utc		True if @cur_time is expressed in UTC.
- * @itv		Interval of time with preceding record.
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
  *
  * RETURNS:
  * Pointer on the "timestamp" string.
@@ -579,8 +607,8 @@ char *print_dbppc_timestamp(int fmt, struct file_header *file_hdr, char *cur_dat
 	char temp1[128], temp2[256];
 
 	/* This substring appears on every output line, preformat it here */
-	snprintf(temp1, sizeof(temp1), "%s%s%lld%s",
-		 file_hdr->sa_nodename, seps[isdb], itv, seps[isdb]);
+	snprintf(temp1, sizeof(temp1), "%s%s%s%s",
+		 file_hdr->sa_nodename, seps[isdb], format_itv(itv), seps[isdb]);
 	if (strlen(cur_date)) {
 		snprintf(temp2, sizeof(temp2), "%s%s ", temp1, cur_date);
 	}
@@ -607,7 +635,7 @@ char *print_dbppc_timestamp(int fmt, struct file_header *file_hdr, char *cur_dat
  * @action	Action expected from current function.
  * @cur_date	Date string of current record.
  * @cur_time	Time string of current record.
- * @itv		Interval of time with preceding record.
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
  * @record_hdr	Record header for current sample (unused here).
  * @file_hdr	System activity file standard header.
  * @flags	Flags for common options.
@@ -644,7 +672,7 @@ __tm_funct_t print_ppc_timestamp(void *parm, int action, char *cur_date,
  * @action	Action expected from current function.
  * @cur_date	Date string of current record.
  * @cur_time	Time string of current record.
- * @itv		Interval of time with preceding record.
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
  * @record_hdr	Record header for current sample (unused here).
  * @file_hdr	System activity file standard header.
  * @flags	Flags for common options.
@@ -681,7 +709,7 @@ __tm_funct_t print_db_timestamp(void *parm, int action, char *cur_date,
  * @action	Action expected from current function.
  * @cur_date	Date string of current comment.
  * @cur_time	Time string of current comment.
- * @itv		Interval of time with preceding record.
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
  * @record_hdr	Record header for current sample (unused here).
  * @file_hdr	System activity file standard header (unused here).
  * @flags	Flags for common options.
@@ -696,8 +724,8 @@ __tm_funct_t print_xml_timestamp(void *parm, int action, char *cur_date,
 	int *tab = (int *) parm;
 
 	if (action & F_BEGIN) {
-		xprintf((*tab)++, "<timestamp date=\"%s\" time=\"%s\" utc=\"%d\" interval=\"%llu\">",
-			cur_date, cur_time, utc ? 1 : 0, itv);
+		xprintf((*tab)++, "<timestamp date=\"%s\" time=\"%s\" utc=\"%d\" interval=\"%s\">",
+			cur_date, cur_time, utc ? 1 : 0, format_itv(itv));
 	}
 	if (action & F_END) {
 		xprintf(--(*tab), "</timestamp>");
@@ -715,7 +743,7 @@ __tm_funct_t print_xml_timestamp(void *parm, int action, char *cur_date,
  * @action	Action expected from current function.
  * @cur_date	Date string of current comment.
  * @cur_time	Time string of current comment.
- * @itv		Interval of time with preceding record.
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
  * @record_hdr	Record header for current sample (unused here).
  * @file_hdr	System activity file standard header (unused here).
  * @flags	Flags for common options.
@@ -730,16 +758,16 @@ __tm_funct_t print_json_timestamp(void *parm, int action, char *cur_date,
 	int *tab = (int *) parm;
 
 	if (action & F_BEGIN) {
-		xprintf0(*tab,
+		jprintf0(*tab,
 			 "\"timestamp\": {\"date\": \"%s\", \"time\": \"%s\", "
-			 "\"utc\": %d, \"interval\": %llu}",
-			 cur_date, cur_time, utc ? 1 : 0, itv);
+			 "\"utc\": %d, \"interval\": %s}",
+			 cur_date, cur_time, utc ? 1 : 0, format_itv(itv));
 	}
 	if (action & F_MAIN) {
-		printf(",\n");
+		jprintf0(0, ",\n");
 	}
 	if (action & F_END) {
-		printf("\n");
+		jprintf0(0, "\n");
 	}
 
 	return NULL;
@@ -755,7 +783,7 @@ __tm_funct_t print_json_timestamp(void *parm, int action, char *cur_date,
  * @cur_date	Date string of current record.
  * @cur_time	Time string of current record.
  * @itv		Interval of time with preceding record (unused here).
- * @record_hdr	Record header for current sample (unused here).
+ * @record_hdr	Record header for current sample.
  * @file_hdr	System activity file standard header (unused here).
  * @flags	Flags for common options.
  *
@@ -772,6 +800,14 @@ __tm_funct_t print_raw_timestamp(void *parm, int action, char *cur_date,
 	static char pre[80];
 
 	if (action & F_BEGIN) {
+		if (DISPLAY_DEBUG_MODE(flags)) {
+			/*
+			 * Display how late the sample has been taken, and the time
+			 * spent by sadc reading its statistics.
+			 */
+			printf("# Record: late_usec=%u spread_usec=%u\n",
+			       record_hdr->late_usec, record_hdr->spread_usec);
+		}
 		snprintf(pre, 80, "%s%s", cur_time, strlen(cur_date) && utc ? " UTC" : "");
 		pre[79] = '\0';
 		return pre;
@@ -816,6 +852,47 @@ __tm_funct_t print_pcp_timestamp(void *parm, int action, char *cur_date,
 	return NULL;
 }
 
+/*
+ ***************************************************************************
+ * Save the "timestamp" part of the report (Arrow format). Interval and
+ * timestamp are written with each row of statistics.
+ *
+ * IN:
+ * @parm	Pointer on specific parameters (unused here).
+ * @action	Action expected from current function.
+ * @cur_date	Date string of current record (unused here).
+ * @cur_time	Time string of current record (unused here).
+ * @itv		Interval of time with preceding record (in 1/100th of a second).
+ * @record_hdr	Record header for current sample.
+ * @file_hdr	System activity file standard header.
+ * @flags	Flags for common options.
+ *
+ * RETURNS:
+ * Pointer on the "timestamp" string (always NULL here).
+ ***************************************************************************
+ */
+__tm_funct_t print_arrow_timestamp(void *parm, int action, char *cur_date,
+				   char *cur_time, unsigned long long itv,
+				   struct record_header *record_hdr,
+				   struct file_header *file_hdr, unsigned int flags)
+{
+	if (!(action & F_BEGIN))
+		return NULL;
+
+	if (DISPLAY_SUBSEC_TIME(flags)) {
+		arrow_set_record((double) itv / 100,
+				 record_hdr->ust_time * 1000 + record_hdr->ust_usec / 1000,
+				 file_hdr->sa_nodename);
+	}
+	else {
+		arrow_set_record((double) ROUND_ITV_SEC(itv),
+				 record_hdr->ust_time * 1000,
+				 file_hdr->sa_nodename);
+	}
+
+	return NULL;
+}
+
 /*
  ***************************************************************************
  * Display the header of the report (XML format).
@@ -913,35 +990,36 @@ __printf_funct_t print_json_header(void *parm, int action, char *dfile,
 	int *tab = (int *) parm;
 
 	if (action & F_BEGIN) {
-		xprintf(*tab, "{\"sysstat\": {");
+		jprintf(*tab, "{\"sysstat\": {");
 
-		xprintf(++(*tab), "\"hosts\": [");
-		xprintf(++(*tab), "{");
-		xprintf(++(*tab), "\"nodename\": \"%s\",", file_hdr->sa_nodename);
-		xprintf(*tab, "\"sysname\": \"%s\",", file_hdr->sa_sysname);
-		xprintf(*tab, "\"release\": \"%s\",", file_hdr->sa_release);
+		jprintf(++(*tab), "\"hosts\": [");
+		jprintf(++(*tab), "{");
+		jprintf(++(*tab), "\"nodename\": \"%s\",", file_hdr->sa_nodename);
+		jprintf(*tab, "\"sysname\": \"%s\",", file_hdr->sa_sysname);
+		jprintf(*tab, "\"release\": \"%s\",", file_hdr->sa_release);
 
-		xprintf(*tab, "\"machine\": \"%s\",", file_hdr->sa_machine);
-		xprintf(*tab, "\"number-of-cpus\": %d,",
+		jprintf(*tab, "\"machine\": \"%s\",", file_hdr->sa_machine);
+		jprintf(*tab, "\"number-of-cpus\": %d,",
 			file_hdr->sa_cpu_nr > 1 ? file_hdr->sa_cpu_nr - 1 : 1);
 
 		/* Fill file timestmap structure (rectime) */
 		get_file_timestamp_struct(flags, &rectime, file_hdr);
 		strftime(cur_time, sizeof(cur_time), "%Y-%m-%d", &rectime);
-		xprintf0(*tab, "\"file-date\": \"%s\"", cur_time);
+		jprintf0(*tab, "\"file-date\": \"%s\"", cur_time);
 
 		if (gmtime_r((const time_t *) &file_hdr->sa_ust_time, &loc_t) != NULL) {
 			strftime(cur_time, sizeof(cur_time), "%T", &loc_t);
-			printf(",\n");
-			xprintf0(*tab, "\"file-utc-time\": \"%s\"", cur_time);
+			jprintf0(0, ",\n");
+			jprintf0(*tab, "\"file-utc-time\": \"%s\"", cur_time);
 		}
 
 	}
 	if (action & F_END) {
-		printf("\n");
-		xprintf(--(*tab), "}");
-		xprintf(--(*tab), "]");
-		xprintf(--(*tab), "}}");
+		jprintf0(0, "\n");
+		jprintf(--(*tab), "}");
+		jprintf(--(*tab), "]");
+		jprintf(--(*tab), "}}");
+		jprintf_end();
 	}
 }
 
@@ -978,7 +1056,7 @@ __printf_funct_t print_hdr_header(void *parm, int action, char *dfile,
 
 		display_sa_file_version(stdout, file_magic);
 
-		if (file_magic->format_magic != FORMAT_MAGIC) {
+		if (!IS_READABLE_FORMAT(file_magic->format_magic)) {
 			return;
 		}
 
@@ -1033,6 +1111,9 @@ __printf_funct_t print_hdr_header(void *parm, int action, char *dfile,
 				printf("x%d", fal->nr2);
 			}
 			printf("\t(%d,%d,%d)", fal->types_nr[0], fal->types_nr[1], fal->types_nr[2]);
+			if (fal->period > 1) {
+				printf(_(" \tEvery %u records"), fal->period);
+			}
 			if ((p >= 0) && (act[p]->magic == ACTIVITY_MAGIC_UNKNOWN)) {
 				printf(_(" \t[Unknown format]"));
 			}
@@ -1312,6 +1393,35 @@ __nr_t count_new_fchost(struct activity *a, int curr)
 	return nr;
 }
 
+/*
+ ***************************************************************************
+ * Count the number of new cgroups in current sample. If a new
+ * cgroup is found then add it to the linked list starting at
+ * @a->item_list.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ *
+ * RETURNS:
+ * Number of new cgroups identified in current sample that were not
+ * previously in the list.
+ ***************************************************************************
+ */
+__nr_t count_new_cgroup(struct activity *a, int curr)
+{
+	int i, nr = 0;
+	struct stats_cgroup *scgc;
+
+	for (i = 0; i < a->nr[curr]; i++) {
+		scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+
+		nr += add_list_item(&(a->item_list), scgc->cg_name, MAX_CG_LEN);
+	}
+
+	return nr;
+}
+
 /*
  ***************************************************************************
  * Count the number of new block devices in current sample. If a new
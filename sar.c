@@ -46,6 +46,8 @@ char *sccsid(void) { return (SCCSID); }
 
 /* Interval and count parameters */
 long interval = -1, count = 0;
+/* Interval entered on the command line, in microseconds (may be sub-second) */
+long long interval_us = -1;
 
 /* TRUE if a header line must be printed */
 int dish = TRUE;
@@ -115,9 +117,9 @@ void usage(char *progname)
 {
 	print_usage_title(stderr, progname);
 	fprintf(stderr, _("Options are:\n"
-			  "[ -A ] [ -B ] [ -b ] [ -C ] [ -D ] [ -d ] [ -F [ MOUNT ] ] [ -H ] [ -h ]\n"
-			  "[ -p ] [ -q ] [ -r [ ALL ] ] [ -S ] [ -t ] [ -u [ ALL ] ] [ -V ]\n"
-			  "[ -v ] [ -W ] [ -w ] [ -y ] [ -z ]\n"
+			  "[ -A ] [ -B ] [ -b ] [ -C ] [ -D ] [ -d ] [ -F [ MOUNT ] ] [ -g ] [ -H ] [ -h ]\n"
+			  "[ -p ] [ -q [ PSI | ALL ] ] [ -r [ ALL ] ] [ -S ] [ -t ] [ -u [ ALL ] ]\n"
+			  "[ -V ] [ -v ] [ -W ] [ -w ] [ -x ] [ -y ] [ -z ]\n"
 			  "[ -I { <int_list> | SUM | ALL } ] [ -P { <cpu_list> | ALL } ]\n"
 			  "[ -m { <keyword> [,...] | ALL } ] [ -n { <keyword> [,...] | ALL } ]\n"
 			  "[ --dev=<dev_list> ] [ --fs=<fs_list> ] [ --iface=<iface_list> ]\n"
@@ -441,10 +443,19 @@ int write_stats(int curr, int read_from_file, long *cnt, int use_tm_start,
 		cross_day = 0;
 	}
 
+	if (read_from_file && (act_id != ALL_ACTIVITIES) &&
+	    IS_CARRIED(act[get_activity_position(act, act_id, EXIT_IF_NOT_FOUND)], curr))
+		/*
+		 * Activity not saved in this record (it is saved at a longer period):
+		 * Its next statistics will be compared to the last ones displayed.
+		 */
+		return 0;
+
 	/* Check time (1) */
 	if (read_from_file) {
-		if (!next_slice(record_hdr[2].uptime_cs, record_hdr[curr].uptime_cs,
-				reset, interval))
+		if (!next_slice(record_hdr[2].uptime_cs, record_hdr[curr].uptime_cs, reset,
+				(interval < 0) ? -1 : (long) ((interval_us + 9999) / 10000),
+				HAS_SUBSEC_RECORDS(file_hdr.sa_flags)))
 			/* Not close enough to desired interval */
 			return 0;
 	}
@@ -748,10 +759,12 @@ void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf
 	unsigned char rtype;
 	int davg = 0, next, inc = 0;
 
-	if (lseek(ifd, fpos, SEEK_SET) < fpos) {
+	if (sa_fseek(ifd, fpos) < 0) {
 		perror("lseek");
 		exit(2);
 	}
+	/* Restore statistics used to decode next record if file is delta encoded */
+	copy_enc_states(act, 0, 1);
 
 	/*
 	 * Restore the first stats collected.
@@ -781,7 +794,8 @@ void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf
 		if (!*eosaf && (rtype != R_RESTART) && (rtype != R_COMMENT)) {
 			/* Read the extra fields since it's not a special record */
 			read_file_stat_bunch(act, *curr, ifd, file_hdr.sa_act_nr, file_actlst,
-					     endian_mismatch, arch_64, file, file_magic, UEOF_STOP);
+					     file_hdr.sa_flags, endian_mismatch, arch_64, file,
+					     file_magic, UEOF_STOP, record_hdr[*curr].uptime_cs);
 		}
 
 		if ((lines >= rows) || !lines) {
@@ -914,6 +928,11 @@ void read_header_data(void)
 		print_read_error(INCONSISTENT_INPUT_DATA);
 	}
 
+	if (HAS_SUBSEC_RECORDS(file_hdr.sa_flags)) {
+		/* Records less than a second apart: Display milliseconds in timestamps */
+		flags |= S_F_SUBSEC_TIME;
+	}
+
 	/* Read activity list */
 	for (i = 0; i < file_hdr.sa_act_nr; i++) {
 
@@ -990,12 +1009,21 @@ void read_stats_from_file(char from_file[])
 	check_file_actlst(&ifd, from_file, act, flags, &file_magic, &file_hdr,
 			  &file_actlst, id_seq, FALSE, &endian_mismatch, &arch_64);
 
+	if (HAS_SUBSEC_RECORDS(file_hdr.sa_flags)) {
+		/* Records may be less than a second apart: Display milliseconds in timestamps */
+		flags |= S_F_SUBSEC_TIME;
+	}
+
 	/* Perform required allocations */
 	allocate_structures(act);
 
 	/* Print report header */
 	print_report_hdr(flags, &rectime, &file_hdr);
 
+	/* Skip records preceding start time if file has a time index */
+	seek_time_index(ifd, from_file, act, &file_hdr, flags + S_F_LOCAL_TIME, FALSE,
+			&tm_start, &tm_end, endian_mismatch, arch_64);
+
 	/* Read system statistics from file */
 	do {
 		/*
@@ -1022,8 +1050,9 @@ void read_stats_from_file(char from_file[])
 				 * So read now the extra fields.
 				 */
 				read_file_stat_bunch(act, 0, ifd, file_hdr.sa_act_nr,
-						     file_actlst, endian_mismatch, arch_64,
-						     from_file, &file_magic, UEOF_STOP);
+						     file_actlst, file_hdr.sa_flags, endian_mismatch,
+						     arch_64, from_file, &file_magic, UEOF_STOP,
+						     record_hdr[0].uptime_cs);
 				if (sa_get_record_timestamp_struct(flags + S_F_LOCAL_TIME,
 								   &record_hdr[0],
 								   &rectime, NULL))
@@ -1044,10 +1073,11 @@ void read_stats_from_file(char from_file[])
 		reset = TRUE;	/* Set flag to reset last_uptime variable */
 
 		/* Save current file position */
-		if ((fpos = lseek(ifd, 0, SEEK_CUR)) < 0) {
+		if ((fpos = sa_ftell(ifd)) < 0) {
 			perror("lseek");
 			exit(2);
 		}
+		copy_enc_states(act, 1, 0);
 
 		/*
 		 * Read and write stats located between two possible Linux restarts.
@@ -1101,8 +1131,9 @@ void read_stats_from_file(char from_file[])
 
 				if (!eosaf && (rtype != R_RESTART) && (rtype != R_COMMENT)) {
 					read_file_stat_bunch(act, curr, ifd, file_hdr.sa_act_nr,
-							     file_actlst, endian_mismatch, arch_64,
-							     from_file, &file_magic, UEOF_STOP);
+							     file_actlst, file_hdr.sa_flags, endian_mismatch,
+							     arch_64, from_file, &file_magic, UEOF_STOP,
+							     record_hdr[curr].uptime_cs);
 				}
 				else if (!eosaf && (rtype == R_COMMENT)) {
 					/* This was a COMMENT record: print it */
@@ -1393,6 +1424,7 @@ int main(int argc, char **argv)
 			if (interval < 1) {
 				usage(argv[0]);
 			}
+			interval_us = (long long) interval * 1000000;
 			flags |= S_F_INTERVAL_SET;
 		}
 
@@ -1440,13 +1472,15 @@ int main(int argc, char **argv)
 
 		else if (interval < 0) {
 			/* Get interval */
-			if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
-				usage(argv[0]);
-			}
-			interval = atol(argv[opt++]);
-			if (interval < 0) {
+			interval_us = parse_interval(argv[opt++]);
+			if (interval_us < 0) {
 				usage(argv[0]);
 			}
+			/*
+			 * Interval in seconds, rounded up so that a sub-second
+			 * interval is not taken for a null one.
+			 */
+			interval = (long) ((interval_us + 999999) / 1000000);
 		}
 
 		else {
@@ -1521,10 +1555,6 @@ int main(int argc, char **argv)
 
 	/* Reading stats from file: */
 	if (from_file[0]) {
-		if (interval < 0) {
-			interval = 1;
-		}
-
 		/* Read stats from file */
 		read_stats_from_file(from_file);
 
@@ -1576,7 +1606,9 @@ int main(int argc, char **argv)
 			salloc(args_idx++, ltemp);
 		}
 		else {
-			sprintf(ltemp, "%ld", interval);
+			/* Interval may be sub-second: Keep microsecond resolution */
+			sprintf(ltemp, "%lld.%06lld",
+				interval_us / 1000000, interval_us % 1000000);
 		}
 		salloc(args_idx++, ltemp);
 
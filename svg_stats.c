@@ -38,6 +38,7 @@
 #endif
 
 extern unsigned int flags;
+extern struct activity *act[];
 extern int palette;
 
 unsigned int svg_colors[SVG_COL_PALETTE_NR][SVG_COL_PALETTE_SIZE] =
@@ -212,17 +213,20 @@ void get_global_extrema(int pos, int n, double *spmin, double *spmax,
  * array is returned. This is equivalent to "char data[][n]" where each
  * element is of indeterminate size and will contain the graph data (eg.
  * << path d="M12,14 L13,16..." ... >>.
- * The size of element data[i] is given by outsize[i].
+ * The size allocated for element data[i] and the length of the graph data
+ * it contains are given by outsize[i].
  * Also allocate an array to save min values (equivalent to "double spmin[n]")
  * and an array for max values (equivalent to "double spmax[n]").
  *
  * IN:
  * @n		Number of graphs to draw for current activity.
+ * @xfactor	Scaling factor on X axis used to decimate graphs, or 0 if
+ *		graphs should not be decimated.
  *
  * OUT:
  * @outsize	Array that will contain the sizes of each element in array
- *		of chars. Equivalent to "int outsize[n]" with
- * 		outsize[n] = sizeof(data[][n]).
+ *		of chars. Equivalent to "struct svg_outsize outsize[n]" with
+ * 		outsize[n].alloc = sizeof(data[][n]).
  * @spmin	Array that will contain min values for current activity.
  * @spmax	Array that will contain max values for current activity.
  *
@@ -233,7 +237,8 @@ void get_global_extrema(int pos, int n, double *spmin, double *spmax,
  * in the statistics structure.
  ***************************************************************************
  */
-char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax)
+char **allocate_graph_lines(int n, struct svg_outsize **outsize, double **spmin,
+			    double **spmax, double xfactor)
 {
 	char **out;
 	char *out_p;
@@ -248,7 +253,7 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
 		exit(4);
 	}
 	/* Allocate array that will contain the size of each array of chars */
-	if ((*outsize = (int *) malloc(n * sizeof(int))) == NULL) {
+	if ((*outsize = (struct svg_outsize *) malloc(n * sizeof(struct svg_outsize))) == NULL) {
 		perror("malloc");
 		exit(4);
 	}
@@ -269,8 +274,11 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
 			exit(4);
 		}
 		*(out + i) = out_p;
-		*out_p = '\0';			/* Reset string so that it can be safely strncat()'d later */
-		*(*outsize + i) = CHUNKSIZE;	/* Each array of chars has a default size of CHUNKSIZE */
+		*out_p = '\0';				/* Reset string */
+		(*outsize + i)->alloc = CHUNKSIZE;	/* Each array of chars has a default size of CHUNKSIZE */
+		(*outsize + i)->len = 0;
+		(*outsize + i)->xfactor = xfactor;
+		(*outsize + i)->col = -1;
 		*(*spmin + i) = DBL_MAX;	/* Init min and max values */
 		*(*spmax + i) = -DBL_MAX;
 	}
@@ -284,6 +292,7 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
  *
  * IN:
  * @data	SVG code to append to current graph definition.
+ * @len		Length of SVG code to append.
  * @out		Pointer on array of chars for current graph definition.
  * @outsize	Size of array of chars for current graph definition.
  *
@@ -294,25 +303,215 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
  *		element in array of chars.
  ***************************************************************************
  */
-void save_svg_data(char *data, char **out, int *outsize)
+void save_svg_data(char *data, int len, char **out, struct svg_outsize *outsize)
 {
-	char *out_p;
-	int len;
-
-	out_p = *out;
-	/* Determine space left in array */
-	len = *outsize - strlen(out_p) - 1;
-	if (strlen(data) >= len) {
+	if (outsize->len + len >= outsize->alloc) {
 		/*
 		 * If current array of chars doesn't have enough space left
-		 * then reallocate it with CHUNKSIZE more bytes.
+		 * then double its size, so that the number of reallocations
+		 * only grows with the logarithm of the graph size.
 		 */
-		SREALLOC(out_p, char, *outsize + CHUNKSIZE);
-		*out = out_p;
-		*outsize += CHUNKSIZE;
-		len += CHUNKSIZE;
+		do {
+			outsize->alloc *= 2;
+		}
+		while (outsize->len + len >= outsize->alloc);
+		SREALLOC(*out, char, outsize->alloc);
+	}
+	memcpy(*out + outsize->len, data, len);
+	outsize->len += len;
+	*(*out + outsize->len) = '\0';
+}
+
+/*
+ ***************************************************************************
+ * Append a point to a line graph definition.
+ *
+ * IN:
+ * @pt		Point to append.
+ * @out		Pointer on array of chars for current graph definition.
+ * @outsize	Size of array of chars for current graph definition.
+ *
+ * OUT:
+ * @out		Pointer on array of chars for current graph definition that
+ *		has been updated with the addition of the point.
+ * @outsize	Array that containing the (possibly new) sizes of each
+ *		element in array of chars.
+ ***************************************************************************
+ */
+void print_svg_point(struct svg_point *pt, char **out, struct svg_outsize *outsize)
+{
+	char data[128], *d = data;
+
+	/* Prepare additional graph definition data: " %c%llu,%.2f" or " %c%llu,%llu" */
+	*d++ = ' ';
+	*d++ = pt->cmd;
+	d += sprint_u64(d, pt->timetag);
+	*d++ = ',';
+	if (pt->integer) {
+		d += sprint_u64(d, pt->value.u);
+	}
+	else {
+		d += sprint_fixed(d, pt->value.d, 2);
+	}
+
+	save_svg_data(data, d - data, out, outsize);
+}
+
+/*
+ ***************************************************************************
+ * Append a rectangle to a bar graph definition.
+ *
+ * IN:
+ * @x		X coordinate of the rectangle.
+ * @y		Y coordinate of the rectangle.
+ * @h		Height of the rectangle.
+ * @w		Width of the rectangle.
+ * @out		Pointer on array of chars for current graph definition.
+ * @outsize	Size of array of chars for current graph definition.
+ *
+ * OUT:
+ * @out		Pointer on array of chars for current graph definition that
+ *		has been updated with the addition of the rectangle.
+ * @outsize	Array that containing the (possibly new) sizes of each
+ *		element in array of chars.
+ ***************************************************************************
+ */
+void print_svg_rect(unsigned long long x, double y, double h, unsigned long long w,
+		    char **out, struct svg_outsize *outsize)
+{
+	char data[256], *d;
+
+	/* "<rect x=\"%llu\" y=\"%.2f\" height=\"%.2f\" width=\"%llu\"/>" */
+	d = stpcpy(data, "<rect x=\"");
+	d += sprint_u64(d, x);
+	d = stpcpy(d, "\" y=\"");
+	d += sprint_fixed(d, y, 2);
+	d = stpcpy(d, "\" height=\"");
+	d += sprint_fixed(d, h, 2);
+	d = stpcpy(d, "\" width=\"");
+	d += sprint_u64(d, w);
+	d = stpcpy(d, "\"/>");
+
+	save_svg_data(data, d - data, out, outsize);
+}
+
+/*
+ ***************************************************************************
+ * Append the points kept for the pixel column being decimated to the graph
+ * definition: The first, min, max and last points of a line graph, in the
+ * order in which they were found, or the highest rectangle of a bar graph,
+ * enlarged to cover all the rectangles of the pixel column.
+ *
+ * IN:
+ * @out		Pointer on array of chars for current graph definition.
+ * @outsize	Size of array of chars for current graph definition.
+ *
+ * OUT:
+ * @out		Pointer on array of chars for current graph definition that
+ *		has been updated with the addition of the points.
+ * @outsize	Array that containing the (possibly new) sizes of each
+ *		element in array of chars.
+ ***************************************************************************
+ */
+void flush_svg_column(char **out, struct svg_outsize *outsize)
+{
+	struct svg_point pt;
+	int i, j;
+
+	if (outsize->col < 0)
+		return;
+	outsize->col = -1;
+
+	if (outsize->col_type == SVG_BAR_GRAPH) {
+		print_svg_rect(outsize->x0, outsize->y0, outsize->h0,
+			       outsize->xend - outsize->x0, out, outsize);
+		return;
+	}
+
+	/* Sort points by rank in pixel column */
+	for (i = 1; i < 4; i++) {
+		for (j = i; (j > 0) && (outsize->pt[j].rank < outsize->pt[j - 1].rank); j--) {
+			pt = outsize->pt[j];
+			outsize->pt[j] = outsize->pt[j - 1];
+			outsize->pt[j - 1] = pt;
+		}
+	}
+
+	for (i = 0; i < 4; i++) {
+		if (i && (outsize->pt[i].rank == outsize->pt[i - 1].rank))
+			/* Same point as previous one */
+			continue;
+		print_svg_point(&outsize->pt[i], out, outsize);
 	}
-	strncat(out_p, data, len);
+}
+
+/*
+ ***************************************************************************
+ * Get the value of a point of a line graph as a floating point number.
+ *
+ * IN:
+ * @pt		Point of a line graph.
+ *
+ * RETURNS:
+ * Y coordinate of the point.
+ ***************************************************************************
+ */
+double svg_point_value(struct svg_point *pt)
+{
+	return pt->integer ? (double) pt->value.u : pt->value.d;
+}
+
+/*
+ ***************************************************************************
+ * Add a point to a line graph. If the graph is decimated, only the first,
+ * min, max and last points of each pixel column are kept, so that the
+ * shape of the graph and its peaks remain the same on screen.
+ *
+ * IN:
+ * @pt		Point to add. Its rank is set by this function.
+ * @out		Pointer on array of chars for current graph definition.
+ * @outsize	Size of array of chars for current graph definition.
+ *
+ * OUT:
+ * @out		Pointer on array of chars for current graph definition that
+ *		has been updated with the addition of the point.
+ * @outsize	Array that containing the (possibly new) sizes of each
+ *		element in array of chars.
+ ***************************************************************************
+ */
+void add_svg_point(struct svg_point *pt, char **out, struct svg_outsize *outsize)
+{
+	double v = svg_point_value(pt);
+	long col;
+
+	if (!outsize->xfactor) {
+		print_svg_point(pt, out, outsize);
+		return;
+	}
+
+	col = (long) (pt->timetag * outsize->xfactor);
+	if ((pt->cmd == 'M') || (col != outsize->col) ||
+	    (outsize->col_type != SVG_LINE_GRAPH)) {
+		/* New pixel column, or new part of the graph after a RESTART */
+		flush_svg_column(out, outsize);
+		pt->rank = 0;
+		outsize->pt[0] = outsize->pt[1] = outsize->pt[2] = outsize->pt[3] = *pt;
+		outsize->col = col;
+		outsize->col_type = SVG_LINE_GRAPH;
+		outsize->col_nr = 1;
+		return;
+	}
+
+	pt->rank = outsize->col_nr++;
+	if (v < svg_point_value(&outsize->pt[1])) {
+		/* New min value for current pixel column */
+		outsize->pt[1] = *pt;
+	}
+	if (v > svg_point_value(&outsize->pt[2])) {
+		/* New max value for current pixel column */
+		outsize->pt[2] = *pt;
+	}
+	outsize->pt[3] = *pt;
 }
 
 /*
@@ -320,8 +519,9 @@ void save_svg_data(char *data, char **out, int *outsize)
  * Update line graph definition by appending current X,Y coordinates.
  *
  * IN:
- * @timetag	Timestamp in seconds since the epoch for current sample
- *		stats. Will be used as X coordinate.
+ * @timetag	Time elapsed since the start of the X axis for current
+ *		sample stats (see SVG_TIMETAG()). Will be used as X
+ *		coordinate.
  * @value	Value of current sample metric. Will be used as Y coordinate.
  * @out		Pointer on array of chars for current graph definition.
  * @outsize	Size of array of chars for current graph definition.
@@ -335,16 +535,17 @@ void save_svg_data(char *data, char **out, int *outsize)
  *		element in array of chars.
  ***************************************************************************
  */
-void lnappend(unsigned long long timetag, double value, char **out, int *outsize,
-	      int restart)
+void lnappend(unsigned long long timetag, double value, char **out,
+	      struct svg_outsize *outsize, int restart)
 {
-	char data[128];
+	struct svg_point pt;
 
-	/* Prepare additional graph definition data */
-	snprintf(data, 128, " %c%llu,%.2f", restart ? 'M' : 'L', timetag, value);
-	data[127] = '\0';
+	pt.timetag = timetag;
+	pt.value.d = value;
+	pt.cmd = restart ? 'M' : 'L';
+	pt.integer = FALSE;
 
-	save_svg_data(data, out, outsize);
+	add_svg_point(&pt, out, outsize);
 }
 
 /*
@@ -353,8 +554,9 @@ void lnappend(unsigned long long timetag, double value, char **out, int *outsize
  * (unsigned long) integer values here.
  *
  * IN:
- * @timetag	Timestamp in seconds since the epoch for current sample
- *		stats. Will be used as X coordinate.
+ * @timetag	Time elapsed since the start of the X axis for current
+ *		sample stats (see SVG_TIMETAG()). Will be used as X
+ *		coordinate.
  * @value	Value of current sample metric. Will be used as Y coordinate.
  * @out		Pointer on array of chars for current graph definition.
  * @outsize	Size of array of chars for current graph definition.
@@ -369,31 +571,35 @@ void lnappend(unsigned long long timetag, double value, char **out, int *outsize
  ***************************************************************************
  */
 void lniappend(unsigned long long timetag, unsigned long long value, char **out,
-	       int *outsize, int restart)
+	       struct svg_outsize *outsize, int restart)
 {
-	char data[128];
+	struct svg_point pt;
 
-	/* Prepare additional graph definition data */
-	snprintf(data, 128, " %c%llu,%llu", restart ? 'M' : 'L', timetag, value);
-	data[127] = '\0';
+	pt.timetag = timetag;
+	pt.value.u = value;
+	pt.cmd = restart ? 'M' : 'L';
+	pt.integer = TRUE;
 
-	save_svg_data(data, out, outsize);
+	add_svg_point(&pt, out, outsize);
 }
 
 /*
  ***************************************************************************
- * Update bar graph definition by adding a new rectangle.
+ * Update bar graph definition by adding a new rectangle. If the graph is
+ * decimated, the rectangles of each pixel column are replaced with the
+ * highest of them, enlarged to cover them all.
  *
  * IN:
- * @timetag	Timestamp in seconds since the epoch for current sample
- *		stats. Will be used as X coordinate.
+ * @timetag	Time elapsed since the start of the X axis for current
+ *		sample stats (see SVG_TIMETAG()). Will be used as X
+ *		coordinate.
  * @value	Value of current sample metric. Will be used as rectangle
  *		height.
  * @offset	Offset for Y coordinate.
  * @out		Pointer on array of chars for current graph definition.
  * @outsize	Size of array of chars for current graph definition.
- * @dt		Interval of time in seconds between current and previous
- * 		sample.
+ * @dt		Interval of time between current and previous sample,
+ *		in the same unit as @timetag.
  *
  * OUT:
  * @out		Pointer on array of chars for current graph definition that
@@ -403,10 +609,11 @@ void lniappend(unsigned long long timetag, unsigned long long value, char **out,
  ***************************************************************************
  */
 void brappend(unsigned long long timetag, double offset, double value, char **out,
-	      int *outsize, unsigned long long dt)
+	      struct svg_outsize *outsize, unsigned long long dt)
 {
-	char data[128];
 	unsigned long long t = 0;
+	double y, h;
+	long col;
 
 	/* Prepare additional graph definition data */
 	if ((value == 0.0) || (dt == 0))
@@ -415,13 +622,35 @@ void brappend(unsigned long long timetag, double offset, double value, char **ou
 	if (dt < timetag) {
 		t = timetag -dt;
 	}
+	y = MINIMUM(offset, 100.0);
+	h = MINIMUM(value, (100.0 - offset));
 
-	snprintf(data, 128, "<rect x=\"%llu\" y=\"%.2f\" height=\"%.2f\" width=\"%llu\"/>",
-		 t, MINIMUM(offset, 100.0), MINIMUM(value, (100.0 - offset)), dt);
-	data[127] = '\0';
+	if (!outsize->xfactor) {
+		print_svg_rect(t, y, h, dt, out, outsize);
+		return;
+	}
 
-	save_svg_data(data, out, outsize);
+	col = (long) (t * outsize->xfactor);
+	if ((col != outsize->col) || (outsize->col_type != SVG_BAR_GRAPH)) {
+		/* New pixel column */
+		flush_svg_column(out, outsize);
+		outsize->x0 = t;
+		outsize->xend = t + dt;
+		outsize->y0 = y;
+		outsize->h0 = h;
+		outsize->col = col;
+		outsize->col_type = SVG_BAR_GRAPH;
+		return;
+	}
 
+	if (h > outsize->h0) {
+		/* Highest rectangle for current pixel column */
+		outsize->y0 = y;
+		outsize->h0 = h;
+	}
+	if (t + dt > outsize->xend) {
+		outsize->xend = t + dt;
+	}
 }
 
 /*
@@ -429,15 +658,16 @@ void brappend(unsigned long long timetag, double offset, double value, char **ou
  * Update CPU graph and min/max values for each metric.
  *
  * IN:
- * @timetag	Timestamp in seconds since the epoch for current sample
- *		stats. Will be used as X coordinate.
+ * @timetag	Time elapsed since the start of the X axis for current
+ *		sample stats (see SVG_TIMETAG()). Will be used as X
+ *		coordinate.
  * @offset	Offset for Y coordinate.
  * @value	Value of current CPU metric. Will be used as rectangle
  *		height.
  * @out		Pointer on array of chars for current graph definition.
  * @outsize	Size of array of chars for current graph definition.
- * @dt		Interval of time in seconds between current and previous
- * 		sample.
+ * @dt		Interval of time between current and previous sample,
+ *		in the same unit as @timetag.
  * @spmin	Min value already found for this CPU metric.
  * @spmax	Max value already found for this CPU metric.
  *
@@ -450,7 +680,8 @@ void brappend(unsigned long long timetag, double offset, double value, char **ou
  ***************************************************************************
  */
 void cpuappend(unsigned long long timetag, double *offset, double value, char **out,
-	       int *outsize, unsigned long long dt, double *spmin, double *spmax)
+	       struct svg_outsize *outsize, unsigned long long dt, double *spmin,
+	       double *spmax)
 {
 	/* Save min and max values */
 	if (value < *spmin) {
@@ -470,16 +701,17 @@ void cpuappend(unsigned long long timetag, double *offset, double value, char **
  * Update rectangular graph and min/max values.
  *
  * IN:
- * @timetag	Timestamp in seconds since the epoch for current sample
- *		stats. Will be used as X coordinate.
+ * @timetag	Time elapsed since the start of the X axis for current
+ *		sample stats (see SVG_TIMETAG()). Will be used as X
+ *		coordinate.
  * @p_value	Metric value for previous sample
  * @value	Metric value for current sample.
  * @out		Pointer on array of chars for current graph definition.
  * @outsize	Size of array of chars for current graph definition.
  * @restart	Set to TRUE if a RESTART record has been read since the last
  * 		statistics sample.
- * @dt		Interval of time in seconds between current and previous
- * 		sample.
+ * @dt		Interval of time between current and previous sample,
+ *		in the same unit as @timetag.
  * @spmin	Min value already found for this metric.
  * @spmax	Max value already found for this metric.
  *
@@ -493,11 +725,10 @@ void cpuappend(unsigned long long timetag, double *offset, double value, char **
  ***************************************************************************
  */
 void recappend(unsigned long long timetag, double p_value, double value, char **out,
-	       int *outsize, int restart, unsigned long long dt,
+	       struct svg_outsize *outsize, int restart, unsigned long long dt,
 	       double *spmin, double *spmax)
 {
-	char data[512], data1[128], data2[128];
-	unsigned long long t = 0;
+	struct svg_point pt;
 
 	/* Save min and max values */
 	if (value < *spmin) {
@@ -506,23 +737,23 @@ void recappend(unsigned long long timetag, double p_value, double value, char **
 	if (value > *spmax) {
 		*spmax = value;
 	}
-	if (dt < timetag) {
-		t = timetag -dt;
-	}
-	/* Prepare additional graph definition data */
+	pt.integer = FALSE;
+
+	/* Prepare additional graph definition data: "[ M%llu,%.2f] L%llu,%.2f[ L%llu,%.2f]" */
 	if (restart) {
-		snprintf(data1, sizeof(data1), " M%llu,%.2f", t, p_value);
-		data1[sizeof(data1) - 1] = '\0';
-	}
+		pt.timetag = (dt < timetag) ? timetag - dt : 0;
+		pt.value.d = p_value;
+		pt.cmd = 'M';
+		add_svg_point(&pt, out, outsize);
+	}
+	pt.timetag = timetag;
+	pt.value.d = p_value;
+	pt.cmd = 'L';
+	add_svg_point(&pt, out, outsize);
 	if (p_value != value) {
-		snprintf(data2, sizeof(data2), " L%llu,%.2f", timetag, value);
-		data2[sizeof(data2) - 1] = '\0';
+		pt.value.d = value;
+		add_svg_point(&pt, out, outsize);
 	}
-	snprintf(data, sizeof(data), "%s L%llu,%.2f%s", restart ? data1 : "", timetag, p_value,
-		 p_value != value ? data2 : "");
-	data[sizeof(data) - 1] = '\0';
-
-	save_svg_data(data, out, outsize);
 }
 
 /*
@@ -636,7 +867,7 @@ void display_hgrid(double ypos, double yfactor, double lmax, int dp)
  * Display background grid (vertical lines) and corresponding graduations.
  *
  * IN:
- * @xpos	Gap between two vertical lines.
+ * @xpos	Gap between two vertical lines (in seconds).
  * @xfactor	Scaling factor on X axis.
  * @v_gridnr	Default number of vertical lines to display. The actual
  *		number may vary between this value and 2 times this value.
@@ -648,6 +879,7 @@ void display_vgrid(long int xpos, double xfactor, int v_gridnr, struct svg_parm
 	struct record_header stamp;
 	struct tm rectime;
 	char cur_time[TIMESTAMP_LEN];
+	long int x;
 	int j;
 
 	stamp.ust_time = svg_p->ust_time_ref; /* Only ust_time field needs to be set. TRUE_TIME not allowed */
@@ -661,10 +893,12 @@ void display_vgrid(long int xpos, double xfactor, int v_gridnr, struct svg_parm
 
 		/* Display vertical lines */
 		sa_get_record_timestamp_struct(flags, &stamp, &rectime, NULL);
-		set_record_timestamp_string(flags, &stamp, NULL, cur_time, TIMESTAMP_LEN, &rectime);
+		set_record_timestamp_string(flags & ~S_F_SUBSEC_TIME, &stamp, NULL, cur_time,
+					    TIMESTAMP_LEN, &rectime);
+		x = xpos * j * svg_p->timetag_hz;
 		printf("<polyline points=\"%ld,0 %ld,%d\" style=\"vector-effect: non-scaling-stroke; "
 		       "stroke: #%06x\" transform=\"scale(%f,1)\"/>\n",
-		       xpos * j, xpos * j, -SVG_G_YSIZE,
+		       x, x, -SVG_G_YSIZE,
 		       svg_colors[palette][SVG_COL_GRID_IDX],
 		       xfactor);
 		/*
@@ -675,16 +909,16 @@ void display_vgrid(long int xpos, double xfactor, int v_gridnr, struct svg_parm
 		if (DISPLAY_ONE_DAY(flags) && (rectime.tm_min == 0)) {
 			printf("<text x=\"%ld\" y=\"15\" style=\"fill: #%06x; stroke: none; font-size: 14px; "
 			       "text-anchor: start\">%2d:00</text>\n",
-			       (long) (xpos * j * xfactor) - 15,
+			       (long) (x * xfactor) - 15,
 			       svg_colors[palette][SVG_COL_AXIS_IDX],
 			       rectime.tm_hour);
 		}
 		else {
 			printf("<text x=\"%ld\" y=\"10\" style=\"fill: #%06x; stroke: none; font-size: 12px; "
 			       "text-anchor: start\" transform=\"rotate(45,%ld,0)\">%s</text>\n",
-			       (long) (xpos * j * xfactor),
+			       (long) (x * xfactor),
 			       svg_colors[palette][SVG_COL_AXIS_IDX],
-			       (long) (xpos * j * xfactor), cur_time);
+			       (long) (x * xfactor), cur_time);
 		}
 		stamp.ust_time += xpos;
 	}
@@ -772,7 +1006,8 @@ long int xgrid(unsigned long timestart, unsigned long timeend, int v_gridnr)
  * @spmax	Array containing max values for graphs.
  ***************************************************************************
  */
-void free_graphs(char **out, int *outsize, double *spmin, double *spmax)
+void free_graphs(char **out, struct svg_outsize *outsize, double *spmin,
+		 double *spmax)
 {
 	if (out) {
 		free(out);
@@ -834,9 +1069,10 @@ void skip_current_view(char **out, int *pos, int group)
  * @out		Pointer on array of chars for each graph definition.
  * @outsize	Size of array of chars for each graph definition.
  * @svg_p	SVG specific parameters: Current views row number (.@graph_no),
- *		time for the first sample of stats (.@ust_time_first), and
+ *		X coordinate of the first sample of stats (.@timetag_first),
  *		times used as start and end values on the X axis
- *		(.@ust_time_ref and .@ust_time_end).
+ *		(.@ust_time_ref, .@ust_time_end and .@ust_usec_end), and
+ *		units of X axis per second (.@timetag_hz).
  * @record_hdr	Pointer on record header of current stats sample.
  * @skip_void	Set to <> 0 if graphs with no data should be skipped.
  *		This is typicallly used to not display CPU offline on the
@@ -849,9 +1085,10 @@ void skip_current_view(char **out, int *pos, int group)
  ***************************************************************************
  */
 int draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[], char *item_name,
-			 int group[], double *spmin, double *spmax, char **out, int *outsize,
-			 struct svg_parm *svg_p, struct record_header *record_hdr, int skip_void,
-			 unsigned int id, unsigned int xid)
+			 int group[], double *spmin, double *spmax, char **out,
+			 struct svg_outsize *outsize, struct svg_parm *svg_p,
+			 struct record_header *record_hdr, int skip_void, unsigned int id,
+			 unsigned int xid)
 {
 	char *out_p;
 	int i, j, dp, pos = 0, views_nr = 0, displayed = FALSE, palpos;
@@ -926,7 +1163,7 @@ int draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[],
 		 * At least two samples are needed.
 		 * And a min and max value should have been found.
 		 */
-		if ((record_hdr->ust_time == svg_p->ust_time_first) ||
+		if ((SVG_TIMETAG(svg_p, record_hdr) == svg_p->timetag_first) ||
 		    (*(spmin + pos) == DBL_MAX) || (*(spmax + pos) == -DBL_MIN)) {
 			/* No data found */
 			printf("<text x=\"%d\" y=\"%d\" style=\"fill: #%06x; stroke: none\">No data</text>\n",
@@ -1023,13 +1260,17 @@ int draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[],
 		v_gridnr = DISPLAY_ONE_DAY(flags) ? 12 : SVG_V_GRIDNR;
 
 		xpos = xgrid(svg_p->ust_time_ref, svg_p->ust_time_end, v_gridnr);
-		xfactor = (double) SVG_G_XSIZE / (svg_p->ust_time_end - svg_p->ust_time_ref);
+		xfactor = (double) SVG_G_XSIZE /
+			  ((svg_p->ust_time_end - svg_p->ust_time_ref) * svg_p->timetag_hz +
+			   svg_p->ust_usec_end * svg_p->timetag_hz / 1000000);
 
 		/* Display vertical lines and graduations */
 		display_vgrid(xpos, xfactor, v_gridnr, svg_p);
 
 		/* Draw current graphs set */
 		for (j = 0; j < group[i]; j++) {
+			/* Add points kept for the last pixel column of a decimated graph */
+			flush_svg_column(out + pos + j, outsize + pos + j);
 			out_p = *(out + pos + j);
 			if (g_type[i] == SVG_LINE_GRAPH) {
 				/* Line graphs */
@@ -1095,7 +1336,7 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 	char *g_title2[] = {"%usr", "%nice", "%sys", "%iowait", "%steal", "%irq", "%soft", "%guest", "%gnice", "%idle"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char item_name[16];
 	double offset, val;
 	int i, j, k, pos;
@@ -1105,7 +1346,8 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(10 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(10 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1182,7 +1424,7 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 					}
 
 					/* %idle */
-					cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+					cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 						  &offset, val,
 						  out + pos + j, outsize + pos + j, svg_p->dt,
 						  spmin + pos + j, spmax + pos + j);
@@ -1192,14 +1434,14 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 
 			if (DISPLAY_CPU_DEF(a->opt_flags)) {
 				/* %user */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_user, scc->cpu_user, deltot_jiffies),
 					  out + pos, outsize + pos, svg_p->dt,
 					  spmin + pos, spmax + pos);
 			}
 			else {
 				/* %usr */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset,
 					  (scc->cpu_user - scc->cpu_guest) < (scp->cpu_user - scp->cpu_guest) ?
 					   0.0 :
@@ -1211,14 +1453,14 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 
 			if (DISPLAY_CPU_DEF(a->opt_flags)) {
 				/* %nice */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_nice, scc->cpu_nice, deltot_jiffies),
 					  out + pos + 1, outsize + pos + 1, svg_p->dt,
 					  spmin + pos + 1, spmax + pos + 1);
 			}
 			else {
 				/* %nice */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset,
 					  (scc->cpu_nice - scc->cpu_guest_nice) < (scp->cpu_nice - scp->cpu_guest_nice) ?
 					   0.0 :
@@ -1230,7 +1472,7 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 
 			if (DISPLAY_CPU_DEF(a->opt_flags)) {
 				/* %system */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset,
 					  ll_sp_value(scp->cpu_sys + scp->cpu_hardirq + scp->cpu_softirq,
 						      scc->cpu_sys + scc->cpu_hardirq + scc->cpu_softirq,
@@ -1240,41 +1482,41 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 			}
 			else {
 				/* %sys */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_sys, scc->cpu_sys, deltot_jiffies),
 					  out + pos + 2, outsize + pos + 2, svg_p->dt,
 					  spmin + pos + 2, spmax + pos + 2);
 			}
 
 			/* %iowait */
-			cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 				  &offset, ll_sp_value(scp->cpu_iowait, scc->cpu_iowait, deltot_jiffies),
 				  out + pos + 3, outsize + pos + 3, svg_p->dt,
 				  spmin + pos + 3, spmax + pos + 3);
 			/* %steal */
-			cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 				  &offset, ll_sp_value(scp->cpu_steal, scc->cpu_steal, deltot_jiffies),
 				  out + pos + 4, outsize + pos + 4, svg_p->dt,
 				  spmin + pos + 4, spmax + pos + 4);
 
 			if (DISPLAY_CPU_ALL(a->opt_flags)) {
 				/* %irq */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_hardirq, scc->cpu_hardirq, deltot_jiffies),
 					  out + pos + 5, outsize + pos + 5, svg_p->dt,
 					  spmin + pos + 5, spmax + pos + 5);
 				/* %soft */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_softirq, scc->cpu_softirq, deltot_jiffies),
 					  out + pos + 6, outsize + pos + 6, svg_p->dt,
 					  spmin + pos + 6, spmax + pos + 6);
 				/* %guest */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_guest, scc->cpu_guest, deltot_jiffies),
 					  out + pos + 7, outsize + pos + 7, svg_p->dt,
 					  spmin + pos + 7, spmax + pos + 7);
 				/* %gnice */
-				cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+				cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 					  &offset, ll_sp_value(scp->cpu_guest_nice, scc->cpu_guest_nice, deltot_jiffies),
 					  out + pos + 8, outsize + pos + 8, svg_p->dt,
 					  spmin + pos + 8, spmax + pos + 8);
@@ -1286,7 +1528,7 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 			}
 
 			/* %idle */
-			cpuappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			cpuappend(SVG_TIMETAG(svg_p, record_hdr),
 				  &offset,
 				  (scc->cpu_idle < scp->cpu_idle ? 0.0 :
 				   ll_sp_value(scp->cpu_idle, scc->cpu_idle, deltot_jiffies)),
@@ -1372,14 +1614,15 @@ __print_funct_t svg_print_pcsw_stats(struct activity *a, int curr, int action, s
 			   "cswch/s"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(2, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(2, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1387,11 +1630,11 @@ __print_funct_t svg_print_pcsw_stats(struct activity *a, int curr, int action, s
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], (void *) a->buf[!curr],
 			     itv, spmin, spmax, g_fields);
 		/* proc/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->processes, spc->processes, itv),
 			 out, outsize, svg_p->restart);
 		/* cswch/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->context_switch, spc->context_switch, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 	}
@@ -1434,14 +1677,15 @@ __print_funct_t svg_print_swap_stats(struct activity *a, int curr, int action, s
 	int g_fields[] = {0, 1};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(2, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(2, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1449,11 +1693,11 @@ __print_funct_t svg_print_swap_stats(struct activity *a, int curr, int action, s
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], (void *) a->buf[!curr],
 			     itv, spmin, spmax, g_fields);
 		/* pswpin/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(ssp->pswpin, ssc->pswpin, itv),
 			 out, outsize, svg_p->restart);
 		/* pswpout/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(ssp->pswpout, ssc->pswpout, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 	}
@@ -1498,14 +1742,15 @@ __print_funct_t svg_print_paging_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(8, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(8, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1513,35 +1758,35 @@ __print_funct_t svg_print_paging_stats(struct activity *a, int curr, int action,
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], (void *) a->buf[!curr],
 			     itv, spmin, spmax, g_fields);
 		/* pgpgin/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgpgin, spc->pgpgin, itv),
 			 out, outsize, svg_p->restart);
 		/* pgpgout/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgpgout, spc->pgpgout, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* fault/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgfault, spc->pgfault, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* majflt/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgmajfault, spc->pgmajfault, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* pgfree/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgfree, spc->pgfree, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* pgscank/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgscan_kswapd, spc->pgscan_kswapd, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* pgscand/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgscan_direct, spc->pgscan_direct, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* pgsteal/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(spp->pgsteal, spc->pgsteal, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 	}
@@ -1596,14 +1841,15 @@ __print_funct_t svg_print_io_stats(struct activity *a, int curr, int action, str
 	int g_fields[] = {0, 1, 2, 4, 5, 3, 6};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(7, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(7, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1618,37 +1864,37 @@ __print_funct_t svg_print_io_stats(struct activity *a, int curr, int action, str
 		 * the user that the value cannot be calculated here.
 		 */
 		/* tps */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive < sip->dk_drive ? 0.0 :
 			 S_VALUE(sip->dk_drive, sic->dk_drive, itv),
 			 out, outsize, svg_p->restart);
 		/* rtps */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive_rio < sip->dk_drive_rio ? 0.0 :
 			 S_VALUE(sip->dk_drive_rio, sic->dk_drive_rio, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* wtps */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive_wio < sip->dk_drive_wio ? 0.0 :
 			 S_VALUE(sip->dk_drive_wio, sic->dk_drive_wio, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* dtps */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive_dio < sip->dk_drive_dio ? 0.0 :
 			 S_VALUE(sip->dk_drive_dio, sic->dk_drive_dio, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* bread/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive_rblk < sip->dk_drive_rblk ? 0.0 :
 			 S_VALUE(sip->dk_drive_rblk, sic->dk_drive_rblk, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* bwrtn/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive_wblk < sip->dk_drive_wblk ? 0.0 :
 			 S_VALUE(sip->dk_drive_wblk, sic->dk_drive_wblk, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* bdscd/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 sic->dk_drive_dblk < sip->dk_drive_dblk ? 0.0 :
 			 S_VALUE(sip->dk_drive_dblk, sic->dk_drive_dblk, itv),
 			 out + 6, outsize + 6, svg_p->restart);
@@ -1703,7 +1949,7 @@ __print_funct_t svg_print_memory_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 4, 5, 21, 16, 22, 18, 6, 8, 9, 10, 11, 12, 13, 14, 15, 1};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	static int xid = 0;
 	double tval;
 	int i;
@@ -1714,7 +1960,8 @@ __print_funct_t svg_print_memory_stats(struct activity *a, int curr, int action,
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(23, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(23, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1778,93 +2025,93 @@ __print_funct_t svg_print_memory_stats(struct activity *a, int curr, int action,
 		}
 
 		/* MBmemfree */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->frmkb) / 1024,
 			 out, outsize, svg_p->restart);
 		/* MBmemused */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) (smc->tlmkb - nousedmem)) / 1024,
 			 out + 2, outsize + 2, svg_p->restart);
 		/* MBavail */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->availablekb) / 1024,
 			 out + 1, outsize + 1, svg_p->restart);
 		/* MBbuffers */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->bufkb) / 1024,
 			 out + 4, outsize + 4, svg_p->restart);
 		/* MBcached */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->camkb) / 1024,
 			  out + 5, outsize + 5, svg_p->restart);
 		/* MBswpfree */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->frskb) / 1024,
 			 out + 16, outsize + 16, svg_p->restart);
 		/* MBswpused */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) (smc->tlskb - smc->frskb)) / 1024,
 			 out + 17, outsize + 17, svg_p->restart);
 		/* MBswpcad */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->caskb) / 1024,
 			 out + 18, outsize + 18, svg_p->restart);
 		/* MBcommit */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->comkb) / 1024,
 			 out + 6, outsize + 6, svg_p->restart);
 		/* MBactive */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->activekb) / 1024,
 			 out + 8, outsize + 8, svg_p->restart);
 		/* MBinact */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->inactkb) / 1024,
 			 out + 9, outsize + 9, svg_p->restart);
 		/* MBdirty */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->dirtykb) / 1024,
 			 out + 10, outsize + 10, svg_p->restart);
 		/* MBanonpg */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->anonpgkb) / 1024,
 			 out + 11, outsize + 11, svg_p->restart);
 		/* MBslab */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->slabkb) / 1024,
 			 out + 12, outsize + 12, svg_p->restart);
 		/* MBkstack */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->kstackkb) / 1024,
 			 out + 13, outsize + 13, svg_p->restart);
 		/* MBpgtbl */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->pgtblkb) / 1024,
 			 out + 14, outsize + 14, svg_p->restart);
 		/* MBvmused */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 ((double) smc->vmusedkb) / 1024,
 			 out + 15, outsize + 15, svg_p->restart);
 		/* %memused */
-		brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		brappend(SVG_TIMETAG(svg_p, record_hdr),
 			 0.0,
 			 smc->tlmkb ?
 			 SP_VALUE(nousedmem, smc->tlmkb, smc->tlmkb) : 0.0,
 			 out + 3, outsize + 3, svg_p->dt);
 		/* %commit */
-		brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		brappend(SVG_TIMETAG(svg_p, record_hdr),
 			 0.0,
 			 (smc->tlmkb + smc->tlskb) ?
 			 SP_VALUE(0, smc->comkb, smc->tlmkb + smc->tlskb) : 0.0,
 			 out + 7, outsize + 7, svg_p->dt);
 		/* %swpused */
-		brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		brappend(SVG_TIMETAG(svg_p, record_hdr),
 			 0.0,
 			 smc->tlskb ?
 			 SP_VALUE(smc->frskb, smc->tlskb, smc->tlskb) : 0.0,
 			 out + 19, outsize + 19, svg_p->dt);
 		/* %swpcad */
-		brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		brappend(SVG_TIMETAG(svg_p, record_hdr),
 			 0.0,
 			 (smc->tlskb - smc->frskb) ?
 			 SP_VALUE(0, smc->caskb, smc->tlskb - smc->frskb) : 0.0,
@@ -1928,14 +2175,15 @@ __print_funct_t svg_print_ktables_stats(struct activity *a, int curr, int action
 	int g_fields[] = {1, 2, 0, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(4, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(4, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -1943,19 +2191,19 @@ __print_funct_t svg_print_ktables_stats(struct activity *a, int curr, int action
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], NULL,
 			     itv, spmin, spmax, g_fields);
 		/* dentunusd */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) skc->dentry_stat,
 			  out, outsize, svg_p->restart);
 		/* file-nr */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) skc->file_used,
 			  out + 1, outsize + 1, svg_p->restart);
 		/* inode-nr */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) skc->inode_used,
 			  out + 2, outsize + 2, svg_p->restart);
 		/* pty-nr */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) skc->pty_nr,
 			  out + 3, outsize + 3, svg_p->restart);
 	}
@@ -1999,14 +2247,15 @@ __print_funct_t svg_print_queue_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3, 4, 5};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(6, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(6, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2014,27 +2263,27 @@ __print_funct_t svg_print_queue_stats(struct activity *a, int curr, int action,
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], NULL,
 			     itv, spmin, spmax, g_fields);
 		/* runq-sz */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) sqc->nr_running,
 			  out, outsize, svg_p->restart);
 		/* blocked */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) sqc->procs_blocked,
 			  out + 1, outsize + 1, svg_p->restart);
 		/* plist-sz */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) sqc->nr_threads,
 			  out + 2, outsize + 2, svg_p->restart);
 		/* ldavg-1 */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 (double) sqc->load_avg_1 / 100,
 			 out + 3, outsize + 3, svg_p->restart);
 		/* ldavg-5 */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 (double) sqc->load_avg_5 / 100,
 			 out + 4, outsize + 4, svg_p->restart);
 		/* ldavg-15 */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 (double) sqc->load_avg_15 / 100,
 			 out + 5, outsize + 5, svg_p->restart);
 	}
@@ -2053,6 +2302,94 @@ __print_funct_t svg_print_queue_stats(struct activity *a, int curr, int action,
 	}
 }
 
+/*
+ ***************************************************************************
+ * Display pressure stall information in SVG.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @action	Action expected from current function.
+ * @svg_p	SVG specific parameters: Current graph number (.@graph_no),
+ * 		flag indicating that a restart record has been previously
+ * 		found (.@restart) and time used for the X axis origin
+ * 		(@ust_time_ref).
+ * @itv		Interval of time in 1/100th of a second (only with F_MAIN action).
+ * @record_hdr	Pointer on record header of current stats sample.
+ ***************************************************************************
+ */
+__print_funct_t svg_print_psi_stats(struct activity *a, int curr, int action, struct svg_parm *svg_p,
+				    unsigned long long itv, struct record_header *record_hdr)
+{
+	struct stats_psi
+		*spc = (struct stats_psi *) a->buf[curr],
+		*spp = (struct stats_psi *) a->buf[!curr];
+	int group[] = {2, 2, 2};
+	int g_fields[] = {0, 1, 2, 3, 4, 5};
+	int g_type[] = {SVG_LINE_GRAPH, SVG_LINE_GRAPH, SVG_LINE_GRAPH};
+	char *title[] = {"CPU pressure", "Memory pressure", "I/O pressure"};
+	char *g_title[] = {"%scpu", "%fcpu",
+			   "%smem", "%fmem",
+			   "%sio", "%fio"};
+	static double *spmin, *spmax;
+	static char **out;
+	static struct svg_outsize *outsize;
+	int i;
+
+	if (action & F_BEGIN) {
+		/*
+		 * Allocate arrays that will contain the graphs data
+		 * and the min/max values.
+		 */
+		out = allocate_graph_lines(6, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
+	}
+
+	if (action & F_MAIN) {
+		/* Check for min/max values */
+		save_extrema(a->gtypes_nr, (void *) a->buf[curr], (void *) a->buf[!curr],
+			     itv, spmin, spmax, g_fields);
+		/* %scpu */
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
+			 S_VALUE(spp->some_cpu_total, spc->some_cpu_total, itv) / 10000,
+			 out, outsize, svg_p->restart);
+		/* %fcpu */
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
+			 S_VALUE(spp->full_cpu_total, spc->full_cpu_total, itv) / 10000,
+			 out + 1, outsize + 1, svg_p->restart);
+		/* %smem */
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
+			 S_VALUE(spp->some_mem_total, spc->some_mem_total, itv) / 10000,
+			 out + 2, outsize + 2, svg_p->restart);
+		/* %fmem */
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
+			 S_VALUE(spp->full_mem_total, spc->full_mem_total, itv) / 10000,
+			 out + 3, outsize + 3, svg_p->restart);
+		/* %sio */
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
+			 S_VALUE(spp->some_io_total, spc->some_io_total, itv) / 10000,
+			 out + 4, outsize + 4, svg_p->restart);
+		/* %fio */
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
+			 S_VALUE(spp->full_io_total, spc->full_io_total, itv) / 10000,
+			 out + 5, outsize + 5, svg_p->restart);
+	}
+
+	if (action & F_END) {
+		/* Stall times are in microseconds: Fix min/max values */
+		for (i = 0; i < 6; i++) {
+			*(spmin + i) /= 10000;
+			*(spmax + i) /= 10000;
+		}
+
+		draw_activity_graphs(a->g_nr, g_type, title, g_title, NULL, group,
+				     spmin, spmax, out, outsize, svg_p, record_hdr, FALSE, a->id, 0);
+
+		/* Free remaining structures */
+		free_graphs(out, outsize, spmin, spmax);
+	}
+}
+
 /*
  ***************************************************************************
  * Display disk statistics in SVG.
@@ -2090,7 +2427,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 	unsigned int local_types_nr[] = {1, 0, 0};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char *item_name;
 	double rkB, wkB, dkB, aqusz;
 	int i, j, k, pos, restart, *unregistered;
@@ -2102,10 +2439,11 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 		 * Also allocate one additional array (#8) for each disk device:
 		 * spmax + 8 will contain the device major number,
 		 * spmin + 8 will contain the device minor number,
-		 * outsize + 8 will contain a positive value (TRUE) if the device
+		 * outsize[8].alloc will contain a positive value (TRUE) if the device
 		 * has either still not been registered, or has been unregistered.
 		 */
-		out = allocate_graph_lines(nr_arrays * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(nr_arrays * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2116,7 +2454,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * nr_arrays + 8;
+			unregistered = &(outsize + k * nr_arrays + 8)->alloc;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -2159,7 +2497,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 				}
 			}
 			pos = k * nr_arrays;
-			unregistered = outsize + pos + 8;
+			unregistered = &(outsize + pos + 8)->alloc;
 
 			/*
 			 * If current device was marked as previously unregistered,
@@ -2240,42 +2578,42 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 			}
 
 			/* tps */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sdp->nr_ios, sdc->nr_ios, itv),
 				 out + pos, outsize + pos, restart);
 			/* rkB/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sdp->rd_sect, sdc->rd_sect, itv) / 2,
 				 out + pos + 1, outsize + pos + 1, restart);
 			/* wkB/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sdp->wr_sect, sdc->wr_sect, itv) / 2,
 				 out + pos + 2, outsize + pos + 2, restart);
 			/* dkB/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sdp->dc_sect, sdc->dc_sect, itv) / 2,
 				 out + pos + 3, outsize + pos + 3, restart);
 			/* areq-sz */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 xds.arqsz / 2,
 				 out + pos + 4, outsize + pos + 4, restart);
 			/* aqu-sz */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 aqusz,
 				 out + pos + 5, outsize + pos + 5, restart);
 			/* await */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 xds.await,
 				 out + pos + 6, outsize + pos + 6, restart);
 			/* %util */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0, xds.util / 10.0,
 				 out + pos + 7, outsize + pos + 7, svg_p->dt);
 		}
 
 		/* Mark devices not seen here as now unregistered */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * nr_arrays + 8;
+			unregistered = &(outsize + k * nr_arrays + 8)->alloc;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -2340,7 +2678,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 	unsigned int local_types_nr[] = {7, 0, 0};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char *item_name;
 	double rxkb, txkb, ifutil;
 	int i, j, k, pos, restart, *unregistered;
@@ -2351,10 +2689,11 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 		 * and the min/max values.
 		 * Also allocate one additional array (#8) for each interface:
 		 * out + 8 will contain the interface name,
-		 * outsize + 8 will contain a positive value (TRUE) if the interface
+		 * outsize[8].alloc will contain a positive value (TRUE) if the interface
 		 * has either still not been registered, or has been unregistered.
 		 */
-		out = allocate_graph_lines(9 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(9 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2365,7 +2704,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * 9 + 8;
+			unregistered = &(outsize + k * 9 + 8)->alloc;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -2406,7 +2745,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 				}
 			}
 			pos = k * 9;
-			unregistered = outsize + pos + 8;
+			unregistered = &(outsize + pos + 8)->alloc;
 
 			j = check_net_dev_reg(a, curr, !curr, i);
 			if (j < 0) {
@@ -2449,42 +2788,42 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 			}
 
 			/* rxpck/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sndp->rx_packets, sndc->rx_packets, itv),
 				 out + pos, outsize + pos, restart);
 			/* txpck/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sndp->tx_packets, sndc->tx_packets, itv),
 				 out + pos + 1, outsize + pos + 1, restart);
 			/* rxkB/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 rxkb / 1024,
 				 out + pos + 2, outsize + pos + 2, restart);
 			/* txkB/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 txkb / 1024,
 				 out + pos + 3, outsize + pos + 3, restart);
 			/* rxcmp/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sndp->rx_compressed, sndc->rx_compressed, itv),
 				 out + pos + 4, outsize + pos + 4, restart);
 			/* txcmp/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sndp->tx_compressed, sndc->tx_compressed, itv),
 				 out + pos + 5, outsize + pos + 5, restart);
 			/* rxmcst/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sndp->multicast, sndc->multicast, itv),
 				 out + pos + 6, outsize + pos + 6, restart);
 			/* %ifutil */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0, ifutil,
 				 out + pos + 7, outsize + pos + 7, svg_p->dt);
 		}
 
 		/* Mark interfaces not seen here as now unregistered */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * 9 + 8;
+			unregistered = &(outsize + k * 9 + 8)->alloc;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -2556,7 +2895,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {6, 0, 1, 2, 3, 4, 5, 8, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char *item_name;
 	int i, j, k, pos, restart, *unregistered;
 
@@ -2566,10 +2905,11 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 		 * and the min/max values.
 		 * Also allocate one additional array (#9) for each interface:
 		 * out + 9 will contain the interface name,
-		 * outsize + 9 will contain a positive value (TRUE) if the interface
+		 * outsize[9].alloc will contain a positive value (TRUE) if the interface
 		 * has either still not been registered, or has been unregistered.
 		 */
-		out = allocate_graph_lines(10 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(10 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2580,7 +2920,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * 10 + 9;
+			unregistered = &(outsize + k * 10 + 9)->alloc;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -2625,7 +2965,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 			}
 
 			pos = k * 10;
-			unregistered = outsize + pos + 9;
+			unregistered = &(outsize + pos + 9)->alloc;
 
 			j = check_net_edev_reg(a, curr, !curr, i);
 			if (j < 0) {
@@ -2658,46 +2998,46 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 				     itv, spmin + pos, spmax + pos, g_fields);
 
 			/* rxerr/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->rx_errors, snedc->rx_errors, itv),
 				 out + pos, outsize + pos, restart);
 			/* txerr/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->tx_errors, snedc->tx_errors, itv),
 				 out + pos + 1, outsize + pos + 1, restart);
 			/* rxdrop/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->rx_dropped, snedc->rx_dropped, itv),
 				 out + pos + 2, outsize + pos + 2, restart);
 			/* txdrop/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->tx_dropped, snedc->tx_dropped, itv),
 				 out + pos + 3, outsize + pos + 3, restart);
 			/* rxfifo/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->rx_fifo_errors, snedc->rx_fifo_errors, itv),
 				 out + pos + 4, outsize + pos + 4, restart);
 			/* txfifo/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->tx_fifo_errors, snedc->tx_fifo_errors, itv),
 				 out + pos + 5, outsize + pos + 5, restart);
 			/* coll/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->collisions, snedc->collisions, itv),
 				 out + pos + 6, outsize + pos + 6, restart);
 			/* txcarr/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->tx_carrier_errors, snedc->tx_carrier_errors, itv),
 				 out + pos + 7, outsize + pos + 7, restart);
 			/* rxfram/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(snedp->rx_frame_errors, snedc->rx_frame_errors, itv),
 				 out + pos + 8, outsize + pos + 8, restart);
 		}
 
 		/* Mark interfaces not seen here as now unregistered */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * 10 + 9;
+			unregistered = &(outsize + k * 10 + 9)->alloc;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -2763,14 +3103,15 @@ __print_funct_t svg_print_net_nfs_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4, 5};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(6, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(6, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2779,27 +3120,27 @@ __print_funct_t svg_print_net_nfs_stats(struct activity *a, int curr, int action
 			     itv, spmin, spmax, g_fields);
 
 		/* call/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snnp->nfs_rpccnt, snnc->nfs_rpccnt, itv),
 			 out, outsize, svg_p->restart);
 		/* retrans/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snnp->nfs_rpcretrans, snnc->nfs_rpcretrans, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* read/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snnp->nfs_readcnt, snnc->nfs_readcnt, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* write/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snnp->nfs_writecnt, snnc->nfs_writecnt, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* access/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snnp->nfs_accesscnt, snnc->nfs_accesscnt, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* getatt/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snnp->nfs_getattcnt, snnc->nfs_getattcnt, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 	}
@@ -2849,14 +3190,15 @@ __print_funct_t svg_print_net_nfsd_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(11, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(11, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2865,47 +3207,47 @@ __print_funct_t svg_print_net_nfsd_stats(struct activity *a, int curr, int actio
 			     itv, spmin, spmax, g_fields);
 
 		/* scall/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_rpccnt, snndc->nfsd_rpccnt, itv),
 			 out, outsize, svg_p->restart);
 		/* badcall/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_rpcbad, snndc->nfsd_rpcbad, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* packet/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_netcnt, snndc->nfsd_netcnt, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* udp/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_netudpcnt, snndc->nfsd_netudpcnt, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* tcp/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_nettcpcnt, snndc->nfsd_nettcpcnt, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* hit/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_rchits, snndc->nfsd_rchits, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* miss/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_rcmisses, snndc->nfsd_rcmisses, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* sread/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_readcnt, snndc->nfsd_readcnt, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* swrite/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_writecnt, snndc->nfsd_writecnt, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* saccess/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_accesscnt, snndc->nfsd_accesscnt, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 		/* sgetatt/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snndp->nfsd_getattcnt, snndc->nfsd_getattcnt, itv),
 			 out + 10, outsize + 10, svg_p->restart);
 	}
@@ -2948,14 +3290,15 @@ __print_funct_t svg_print_net_sock_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 5, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(6, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(6, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -2963,27 +3306,27 @@ __print_funct_t svg_print_net_sock_stats(struct activity *a, int curr, int actio
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], NULL,
 			     itv, spmin, spmax, g_fields);
 		/* totsck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->sock_inuse,
 			  out, outsize, svg_p->restart);
 		/* tcpsck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->tcp_inuse,
 			  out + 1, outsize + 1, svg_p->restart);
 		/* udpsck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->udp_inuse,
 			  out + 2, outsize + 2, svg_p->restart);
 		/* rawsck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->raw_inuse,
 			  out + 3, outsize + 3, svg_p->restart);
 		/* ip-frag */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->frag_inuse,
 			  out + 4, outsize + 4, svg_p->restart);
 		/* tcp-tw */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->tcp_tw,
 			  out + 5, outsize + 5, svg_p->restart);
 	}
@@ -3028,14 +3371,15 @@ __print_funct_t svg_print_net_ip_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(8, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(8, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3044,35 +3388,35 @@ __print_funct_t svg_print_net_ip_stats(struct activity *a, int curr, int action,
 			     itv, spmin, spmax, g_fields);
 
 		/* irec/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InReceives, snic->InReceives, itv),
 			 out, outsize, svg_p->restart);
 		/* fwddgm/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->ForwDatagrams, snic->ForwDatagrams, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* idel/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InDelivers, snic->InDelivers, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* orq/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutRequests, snic->OutRequests, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* asmrq/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->ReasmReqds, snic->ReasmReqds, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* asmok/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->ReasmOKs, snic->ReasmOKs, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* fragok/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->FragOKs, snic->FragOKs, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* fragcrt/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->FragCreates, snic->FragCreates, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 	}
@@ -3118,14 +3462,15 @@ __print_funct_t svg_print_net_eip_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(8, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(8, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3134,35 +3479,35 @@ __print_funct_t svg_print_net_eip_stats(struct activity *a, int curr, int action
 			     itv, spmin, spmax, g_fields);
 
 		/* ihdrerr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InHdrErrors, sneic->InHdrErrors, itv),
 			 out, outsize, svg_p->restart);
 		/* iadrerr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InAddrErrors, sneic->InAddrErrors, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* iukwnpr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InUnknownProtos, sneic->InUnknownProtos, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* idisc/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InDiscards, sneic->InDiscards, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* odisc/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutDiscards, sneic->OutDiscards, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* onort/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutNoRoutes, sneic->OutNoRoutes, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* asmf/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->ReasmFails, sneic->ReasmFails, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* fragf/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->FragFails, sneic->FragFails, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 	}
@@ -3210,14 +3555,15 @@ __print_funct_t svg_print_net_icmp_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(14, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(14, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3226,59 +3572,59 @@ __print_funct_t svg_print_net_icmp_stats(struct activity *a, int curr, int actio
 			     itv, spmin, spmax, g_fields);
 
 		/* imsg/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InMsgs, snic->InMsgs, itv),
 			 out, outsize, svg_p->restart);
 		/* omsg/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutMsgs, snic->OutMsgs, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* iech/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InEchos, snic->InEchos, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* iechr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InEchoReps, snic->InEchoReps, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* oech/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutEchos, snic->OutEchos, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* oechr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutEchoReps, snic->OutEchoReps, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* itm/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InTimestamps, snic->InTimestamps, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* itmr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InTimestampReps, snic->InTimestampReps, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* otm/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutTimestamps, snic->OutTimestamps, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* otmr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutTimestampReps, snic->OutTimestampReps, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 		/* iadrmk/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InAddrMasks, snic->InAddrMasks, itv),
 			 out + 10, outsize + 10, svg_p->restart);
 		/* iadrmkr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InAddrMaskReps, snic->InAddrMaskReps, itv),
 			 out + 11, outsize + 11, svg_p->restart);
 		/* oadrmk/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutAddrMasks, snic->OutAddrMasks, itv),
 			 out + 12, outsize + 12, svg_p->restart);
 		/* oadrmkr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutAddrMaskReps, snic->OutAddrMaskReps, itv),
 			 out + 13, outsize + 13, svg_p->restart);
 	}
@@ -3329,14 +3675,15 @@ __print_funct_t svg_print_net_eicmp_stats(struct activity *a, int curr, int acti
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(12, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(12, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3345,51 +3692,51 @@ __print_funct_t svg_print_net_eicmp_stats(struct activity *a, int curr, int acti
 			     itv, spmin, spmax, g_fields);
 
 		/* ierr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InErrors, sneic->InErrors, itv),
 			 out, outsize, svg_p->restart);
 		/* oerr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutErrors, sneic->OutErrors, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* idstunr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InDestUnreachs, sneic->InDestUnreachs, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* odstunr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutDestUnreachs, sneic->OutDestUnreachs, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* itmex/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InTimeExcds, sneic->InTimeExcds, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* otmex/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutTimeExcds, sneic->OutTimeExcds, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* iparmpb/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InParmProbs, sneic->InParmProbs, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* oparmpb/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutParmProbs, sneic->OutParmProbs, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* isrcq/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InSrcQuenchs, sneic->InSrcQuenchs, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* osrcq/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutSrcQuenchs, sneic->OutSrcQuenchs, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 		/* iredir/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InRedirects, sneic->InRedirects, itv),
 			 out + 10, outsize + 10, svg_p->restart);
 		/* oredir/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutRedirects, sneic->OutRedirects, itv),
 			 out + 11, outsize + 11, svg_p->restart);
 	}
@@ -3433,14 +3780,15 @@ __print_funct_t svg_print_net_tcp_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(4, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(4, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3449,19 +3797,19 @@ __print_funct_t svg_print_net_tcp_stats(struct activity *a, int curr, int action
 			     itv, spmin, spmax, g_fields);
 
 		/* active/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sntp->ActiveOpens, sntc->ActiveOpens, itv),
 			 out, outsize, svg_p->restart);
 		/* passive/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sntp->PassiveOpens, sntc->PassiveOpens, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* iseg/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sntp->InSegs, sntc->InSegs, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* oseg/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sntp->OutSegs, sntc->OutSegs, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 	}
@@ -3505,14 +3853,15 @@ __print_funct_t svg_print_net_etcp_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(5, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(5, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3521,23 +3870,23 @@ __print_funct_t svg_print_net_etcp_stats(struct activity *a, int curr, int actio
 			     itv, spmin, spmax, g_fields);
 
 		/* atmptf/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snetp->AttemptFails, snetc->AttemptFails, itv),
 			 out, outsize, svg_p->restart);
 		/* estres/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snetp->EstabResets, snetc->EstabResets, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* retrans/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snetp->RetransSegs, snetc->RetransSegs, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* isegerr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snetp->InErrs, snetc->InErrs, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* orsts/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snetp->OutRsts, snetc->OutRsts, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 	}
@@ -3581,14 +3930,15 @@ __print_funct_t svg_print_net_udp_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(4, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(4, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3597,19 +3947,19 @@ __print_funct_t svg_print_net_udp_stats(struct activity *a, int curr, int action
 			     itv, spmin, spmax, g_fields);
 
 		/* idgm/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->InDatagrams, snuc->InDatagrams, itv),
 			 out, outsize, svg_p->restart);
 		/* odgm/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->OutDatagrams, snuc->OutDatagrams, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* noport/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->NoPorts, snuc->NoPorts, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* idgmerr/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->InErrors, snuc->InErrors, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 	}
@@ -3651,14 +4001,15 @@ __print_funct_t svg_print_net_sock6_stats(struct activity *a, int curr, int acti
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(4, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(4, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3666,19 +4017,19 @@ __print_funct_t svg_print_net_sock6_stats(struct activity *a, int curr, int acti
 		save_extrema(a->gtypes_nr, (void *) a->buf[curr], NULL,
 			     itv, spmin, spmax, g_fields);
 		/* tcp6sck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->tcp6_inuse,
 			  out, outsize, svg_p->restart);
 		/* udp6sck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->udp6_inuse,
 			  out + 1, outsize + 1, svg_p->restart);
 		/* raw6sck */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->raw6_inuse,
 			  out + 2, outsize + 2, svg_p->restart);
 		/* ip6-frag */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) snsc->frag6_inuse,
 			  out + 3, outsize + 3, svg_p->restart);
 	}
@@ -3726,14 +4077,15 @@ __print_funct_t svg_print_net_ip6_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(10, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(10, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3742,43 +4094,43 @@ __print_funct_t svg_print_net_ip6_stats(struct activity *a, int curr, int action
 			     itv, spmin, spmax, g_fields);
 
 		/* irec6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InReceives6, snic->InReceives6, itv),
 			 out, outsize, svg_p->restart);
 		/* fwddgm6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutForwDatagrams6, snic->OutForwDatagrams6, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* idel6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InDelivers6, snic->InDelivers6, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* orq6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutRequests6, snic->OutRequests6, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* asmrq6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->ReasmReqds6, snic->ReasmReqds6, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* asmok6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->ReasmOKs6, snic->ReasmOKs6, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* imcpck6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InMcastPkts6, snic->InMcastPkts6, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* omcpck6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutMcastPkts6, snic->OutMcastPkts6, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* fragok6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->FragOKs6, snic->FragOKs6, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* fragcr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->FragCreates6, snic->FragCreates6, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 	}
@@ -3827,14 +4179,15 @@ __print_funct_t svg_print_net_eip6_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(11, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(11, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3843,47 +4196,47 @@ __print_funct_t svg_print_net_eip6_stats(struct activity *a, int curr, int actio
 			     itv, spmin, spmax, g_fields);
 
 		/* ihdrer6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InHdrErrors6, sneic->InHdrErrors6, itv),
 			 out, outsize, svg_p->restart);
 		/* iadrer6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InAddrErrors6, sneic->InAddrErrors6, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* iukwnp6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InUnknownProtos6, sneic->InUnknownProtos6, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* i2big6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InTooBigErrors6, sneic->InTooBigErrors6, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* idisc6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InDiscards6, sneic->InDiscards6, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* odisc6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutDiscards6, sneic->OutDiscards6, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* inort6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InNoRoutes6, sneic->InNoRoutes6, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* onort6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutNoRoutes6, sneic->OutNoRoutes6, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* asmf6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->ReasmFails6, sneic->ReasmFails6, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* fragf6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->FragFails6, sneic->FragFails6, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 		/* itrpck6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InTruncatedPkts6, sneic->InTruncatedPkts6, itv),
 			 out + 10, outsize + 10, svg_p->restart);
 	}
@@ -3933,14 +4286,15 @@ __print_funct_t svg_print_net_icmp6_stats(struct activity *a, int curr, int acti
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(17, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(17, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -3949,71 +4303,71 @@ __print_funct_t svg_print_net_icmp6_stats(struct activity *a, int curr, int acti
 			     itv, spmin, spmax, g_fields);
 
 		/* imsg6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InMsgs6, snic->InMsgs6, itv),
 			 out, outsize, svg_p->restart);
 		/* omsg6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutMsgs6, snic->OutMsgs6, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* iech6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InEchos6, snic->InEchos6, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* iechr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InEchoReplies6, snic->InEchoReplies6, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* oechr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutEchoReplies6, snic->OutEchoReplies6, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* igmbq6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InGroupMembQueries6, snic->InGroupMembQueries6, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* igmbr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InGroupMembResponses6, snic->InGroupMembResponses6, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* ogmbr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutGroupMembResponses6, snic->OutGroupMembResponses6, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* igmbrd6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InGroupMembReductions6, snic->InGroupMembReductions6, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* ogmbrd6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutGroupMembReductions6, snic->OutGroupMembReductions6, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 		/* irtsol6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InRouterSolicits6, snic->InRouterSolicits6, itv),
 			 out + 10, outsize + 10, svg_p->restart);
 		/* ortsol6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutRouterSolicits6, snic->OutRouterSolicits6, itv),
 			 out + 11, outsize + 11, svg_p->restart);
 		/* irtad6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InRouterAdvertisements6, snic->InRouterAdvertisements6, itv),
 			 out + 12, outsize + 12, svg_p->restart);
 		/* inbsol6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InNeighborSolicits6, snic->InNeighborSolicits6, itv),
 			 out + 13, outsize + 13, svg_p->restart);
 		/* onbsol6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutNeighborSolicits6, snic->OutNeighborSolicits6, itv),
 			 out + 14, outsize + 14, svg_p->restart);
 		/* inbad6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->InNeighborAdvertisements6, snic->InNeighborAdvertisements6, itv),
 			 out + 15, outsize + 15, svg_p->restart);
 		/* onbad6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snip->OutNeighborAdvertisements6, snic->OutNeighborAdvertisements6, itv),
 			 out + 16, outsize + 16, svg_p->restart);
 	}
@@ -4064,14 +4418,15 @@ __print_funct_t svg_print_net_eicmp6_stats(struct activity *a, int curr, int act
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(11, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(11, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4080,47 +4435,47 @@ __print_funct_t svg_print_net_eicmp6_stats(struct activity *a, int curr, int act
 			     itv, spmin, spmax, g_fields);
 
 		/* ierr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InErrors6, sneic->InErrors6, itv),
 			 out, outsize, svg_p->restart);
 		/* idtunr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InDestUnreachs6, sneic->InDestUnreachs6, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* odtunr6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutDestUnreachs6, sneic->OutDestUnreachs6, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* itmex6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InTimeExcds6, sneic->InTimeExcds6, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 		/* otmex6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutTimeExcds6, sneic->OutTimeExcds6, itv),
 			 out + 4, outsize + 4, svg_p->restart);
 		/* iprmpb6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InParmProblems6, sneic->InParmProblems6, itv),
 			 out + 5, outsize + 5, svg_p->restart);
 		/* oprmpb6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutParmProblems6, sneic->OutParmProblems6, itv),
 			 out + 6, outsize + 6, svg_p->restart);
 		/* iredir6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InRedirects6, sneic->InRedirects6, itv),
 			 out + 7, outsize + 7, svg_p->restart);
 		/* oredir6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutRedirects6, sneic->OutRedirects6, itv),
 			 out + 8, outsize + 8, svg_p->restart);
 		/* ipck2b6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->InPktTooBigs6, sneic->InPktTooBigs6, itv),
 			 out + 9, outsize + 9, svg_p->restart);
 		/* opck2b6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(sneip->OutPktTooBigs6, sneic->OutPktTooBigs6, itv),
 			 out + 10, outsize + 10, svg_p->restart);
 	}
@@ -4164,14 +4519,15 @@ __print_funct_t svg_print_net_udp6_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 
 	if (action & F_BEGIN) {
 		/*
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(4, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(4, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4180,19 +4536,19 @@ __print_funct_t svg_print_net_udp6_stats(struct activity *a, int curr, int actio
 			     itv, spmin, spmax, g_fields);
 
 		/* idgm6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->InDatagrams6, snuc->InDatagrams6, itv),
 			 out, outsize, svg_p->restart);
 		/* odgm6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->OutDatagrams6, snuc->OutDatagrams6, itv),
 			 out + 1, outsize + 1, svg_p->restart);
 		/* noport6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->NoPorts6, snuc->NoPorts6, itv),
 			 out + 2, outsize + 2, svg_p->restart);
 		/* idgmer6/s */
-		lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lnappend(SVG_TIMETAG(svg_p, record_hdr),
 			 S_VALUE(snup->InErrors6, snuc->InErrors6, itv),
 			 out + 3, outsize + 3, svg_p->restart);
 	}
@@ -4232,7 +4588,7 @@ __print_funct_t svg_print_pwr_cpufreq_stats(struct activity *a, int curr, int ac
 	char *g_title[] = {"MHz"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char item_name[8];
 	int i;
 
@@ -4241,7 +4597,8 @@ __print_funct_t svg_print_pwr_cpufreq_stats(struct activity *a, int curr, int ac
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4262,7 +4619,7 @@ __print_funct_t svg_print_pwr_cpufreq_stats(struct activity *a, int curr, int ac
 			 */
 
 			/* MHz */
-			recappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			recappend(SVG_TIMETAG(svg_p, record_hdr),
 				  ((double) spp->cpufreq) / 100,
 				  ((double) spc->cpufreq) / 100,
 				  out + i, outsize + i, svg_p->restart, svg_p->dt,
@@ -4335,7 +4692,7 @@ __print_funct_t svg_print_pwr_fan_stats(struct activity *a, int curr, int action
 	char *g_title[] = {"~rpm"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char item_name[MAX_SENSORS_DEV_LEN + 8];
 	int i;
 
@@ -4344,7 +4701,8 @@ __print_funct_t svg_print_pwr_fan_stats(struct activity *a, int curr, int action
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4355,7 +4713,7 @@ __print_funct_t svg_print_pwr_fan_stats(struct activity *a, int curr, int action
 			spp = (struct stats_pwr_fan *) ((char *) a->buf[!curr] + i * a->msize);
 
 			/* rpm */
-			recappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			recappend(SVG_TIMETAG(svg_p, record_hdr),
 				  (double) spp->rpm,
 				  (double) spc->rpm,
 				  out + i, outsize + i, svg_p->restart, svg_p->dt,
@@ -4414,7 +4772,7 @@ __print_funct_t svg_print_pwr_temp_stats(struct activity *a, int curr, int actio
 			   "%temp"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char item_name[MAX_SENSORS_DEV_LEN + 8];
 	int i;
 	double tval;
@@ -4424,7 +4782,8 @@ __print_funct_t svg_print_pwr_temp_stats(struct activity *a, int curr, int actio
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(2 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(2 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4451,11 +4810,11 @@ __print_funct_t svg_print_pwr_temp_stats(struct activity *a, int curr, int actio
 			}
 
 			/* degC */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 (double) spc->temp,
 				 out + 2 * i, outsize + 2 * i, svg_p->restart);
 			/* %temp */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0, tval,
 				 out + 2 * i + 1, outsize + 2 * i + 1, svg_p->dt);
 		}
@@ -4512,7 +4871,7 @@ __print_funct_t svg_print_pwr_in_stats(struct activity *a, int curr, int action,
 			   "%in"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char item_name[MAX_SENSORS_DEV_LEN + 8];
 	int i;
 	double tval;
@@ -4522,7 +4881,8 @@ __print_funct_t svg_print_pwr_in_stats(struct activity *a, int curr, int action,
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(2 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(2 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4549,11 +4909,11 @@ __print_funct_t svg_print_pwr_in_stats(struct activity *a, int curr, int action,
 			}
 
 			/* inV */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 (double) spc->in,
 				 out + 2 * i, outsize + 2 * i, svg_p->restart);
 			/* %in */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0, tval,
 				 out + 2 * i + 1, outsize + 2 * i + 1, svg_p->dt);
 		}
@@ -4612,7 +4972,7 @@ __print_funct_t svg_print_huge_stats(struct activity *a, int curr, int action, s
 	int g_fields[] = {0, 5, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	double tval;
 
 	if (action & F_BEGIN) {
@@ -4622,7 +4982,8 @@ __print_funct_t svg_print_huge_stats(struct activity *a, int curr, int action, s
 		 * Allocate one additional array (#5) to save min/max
 		 * values for tlhkb (unused).
 		 */
-		out = allocate_graph_lines(6, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(6, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4645,23 +5006,23 @@ __print_funct_t svg_print_huge_stats(struct activity *a, int curr, int action, s
 		}
 
 		/* kbhugfree */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) smc->frhkb,
 			  out, outsize, svg_p->restart);
 		/* hugused */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) smc->tlhkb - smc->frhkb,
 			  out + 1, outsize + 1, svg_p->restart);
 		/* kbhugrsvd */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) smc->rsvdhkb,
 			  out + 2, outsize + 2, svg_p->restart);
 		/* kbhugsurp */
-		lniappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		lniappend(SVG_TIMETAG(svg_p, record_hdr),
 			  (unsigned long long) smc->surphkb,
 			  out + 3, outsize + 3, svg_p->restart);
 		/* %hugused */
-		brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+		brappend(SVG_TIMETAG(svg_p, record_hdr),
 			 0.0, tval,
 			 out + 4, outsize + 4, svg_p->dt);
 	}
@@ -4707,7 +5068,7 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
 			   "%Iused"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char *item_name;
 	double tval;
 	int i, k, pos, restart;
@@ -4720,7 +5081,8 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
                  * out + 7 will contain the filesystem name,
 		 * out + 8 will contain the mount point.
 		 */
-		out = allocate_graph_lines(9 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(9 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4845,35 +5207,35 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
 			}
 
 			/* MBfsfree */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 (double) sfc->f_bfree / 1024 / 1024,
 				 out + pos, outsize + pos, restart);
 			/* MBfsused */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 (double) (sfc->f_blocks - sfc->f_bfree) / 1024 / 1024,
 				 out + pos + 1, outsize + pos + 1, restart);
 			/* %ufsused */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0,
 				 sfc->f_blocks ?
 				 SP_VALUE(sfc->f_bavail, sfc->f_blocks, sfc->f_blocks) : 0.0,
 				 out + pos + 2, outsize + pos + 2, svg_p->dt);
 			/* %fsused */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0,
 				 sfc->f_blocks ?
 				 SP_VALUE(sfc->f_bfree, sfc->f_blocks, sfc->f_blocks) : 0.0,
 				 out + pos + 3, outsize + pos + 3, svg_p->dt);
 			/* Ifree */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 ((double) sfc->f_ffree) / 1000,
 				 out + pos + 4, outsize + pos + 4, restart);
 			/* Iused */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 ((double) (sfc->f_files - sfc->f_ffree)) / 1000,
 				 out + pos + 5, outsize + pos + 5, restart);
 			/* %Iused */
-			brappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			brappend(SVG_TIMETAG(svg_p, record_hdr),
 				 0.0,
 				 sfc->f_files ?
 				 SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files) : 0.0,
@@ -4946,7 +5308,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char *item_name;
 	int i, j, j0, k, found, pos, restart, *unregistered;
 
@@ -4959,7 +5321,8 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 		 * has either still not been registered, or has been unregistered
 		 * (outsize + 4).
 		 */
-		out = allocate_graph_lines(5 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(5 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -4969,7 +5332,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * 5 + 4;
+			unregistered = &(outsize + k * 5 + 4)->alloc;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -5008,7 +5371,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 				}
 
 				pos = k * 5;
-				unregistered = outsize + pos + 4;
+				unregistered = &(outsize + pos + 4)->alloc;
 
 				/* Look for corresponding structure in previous iteration */
 				j = i;
@@ -5057,26 +5420,26 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 				itv, spmin + pos, spmax + pos, g_fields);
 
 			/* fch_rxf/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sfcp->f_rxframes, sfcc->f_rxframes, itv),
 				 out + pos, outsize + pos, restart);
 			/* fch_txf/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sfcp->f_txframes, sfcc->f_txframes, itv),
 				 out + pos + 1, outsize + pos + 1, restart);
 			/* fch_rxw/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sfcp->f_rxwords, sfcc->f_rxwords, itv),
 				 out + pos + 2, outsize + pos + 2, restart);
 			/* fch_txw/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(sfcp->f_txwords, sfcc->f_txwords, itv),
 				 out + pos + 3, outsize + pos + 3, restart);
 		}
 
 		/* Mark interfaces not seen here as now unregistered */
 		for (k = 0; k < a->item_list_sz; k++) {
-			unregistered = outsize + k * 5 + 4;
+			unregistered = &(outsize + k * 5 + 4)->alloc;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -5132,7 +5495,7 @@ __print_funct_t svg_print_softnet_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_outsize *outsize;
 	char item_name[16];
 	unsigned char offline_cpu_bitmap[BITMAP_SIZE(NR_CPUS)] = {0};
 	int i, pos, restart;
@@ -5142,7 +5505,8 @@ __print_funct_t svg_print_softnet_stats(struct activity *a, int curr, int action
 		 * Allocate arrays that will contain the graphs data
 		 * and the min/max values.
 		 */
-		out = allocate_graph_lines(5 * a->item_list_sz, &outsize, &spmin, &spmax);
+		out = allocate_graph_lines(5 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
 	}
 
 	if (action & F_MAIN) {
@@ -5192,23 +5556,23 @@ __print_funct_t svg_print_softnet_stats(struct activity *a, int curr, int action
 				     itv, spmin + pos, spmax + pos, g_fields);
 
 			/* total/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(ssnp->processed, ssnc->processed, itv),
 				 out + pos, outsize + pos, restart);
 			/* dropd/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(ssnp->dropped, ssnc->dropped, itv),
 				 out + pos + 1, outsize + pos + 1, restart);
 			/* squeezd/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(ssnp->time_squeeze, ssnc->time_squeeze, itv),
 				 out + pos + 2, outsize + pos + 2, restart);
 			/* rx_rps/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(ssnp->received_rps, ssnc->received_rps, itv),
 				 out + pos + 3, outsize + pos + 3, restart);
 			/* flw_lim/s */
-			lnappend(record_hdr->ust_time - svg_p->ust_time_ref,
+			lnappend(SVG_TIMETAG(svg_p, record_hdr),
 				 S_VALUE(ssnp->flow_limit, ssnc->flow_limit, itv),
 				 out + pos + 4, outsize + pos + 4, restart);
 		}
@@ -5242,3 +5606,282 @@ __print_funct_t svg_print_softnet_stats(struct activity *a, int curr, int action
 		free_graphs(out, outsize, spmin, spmax);
 	}
 }
+
+/*
+ ***************************************************************************
+ * Display sadc own collection cost statistics in SVG.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @action	Action expected from current function.
+ * @svg_p	SVG specific parameters: Current graph number (.@graph_no),
+ * 		flag indicating that a restart record has been previously
+ * 		found (.@restart) and time used for the X axis origin
+ * 		(@ust_time_ref).
+ * @itv		Interval of time in 1/100th of a second (only with F_MAIN action).
+ * @record_hdr	Pointer on record header of current stats sample.
+ ***************************************************************************
+ */
+__print_funct_t svg_print_self_stats(struct activity *a, int curr, int action, struct svg_parm *svg_p,
+				     unsigned long long itv, struct record_header *record_hdr)
+{
+	struct stats_self *sscc, *sscp;
+	int group[] = {2, 2};
+	int g_type[] = {SVG_LINE_GRAPH, SVG_LINE_GRAPH};
+	char *title[] = {"Collection cost statistics (1)", "Collection cost statistics (2)"};
+	char *g_title[] = {"rdtime", "rdcpu",
+			   "cnttime", "cntcpu"};
+	static double *spmin, *spmax;
+	static char **out;
+	static struct svg_outsize *outsize;
+	char *item_name, *name;
+	double tval[4];
+	int i, j, j0, k, m, found, pos;
+
+	if (action & F_BEGIN) {
+		/*
+		 * Allocate arrays (#0..3) that will contain the graphs data
+		 * and the min/max values.
+		 * Also allocate one additional array (#4) that will contain
+		 * activity name.
+		 */
+		out = allocate_graph_lines(5 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
+	}
+
+	if (action & F_MAIN) {
+		/* For each activity */
+		for (i = 0; i < a->nr[curr]; i++) {
+
+			found = FALSE;
+			sscc = (struct stats_self *) ((char *) a->buf[curr] + i * a->msize);
+
+			if ((name = get_activity_name(act, sscc->id)) == NULL)
+				continue;
+
+			/* Look for corresponding graph */
+			for (k = 0; k < a->item_list_sz; k++) {
+				item_name = *(out + k * 5 + 4);
+				if (!strcmp(name, item_name))
+					/* Graph found! */
+					break;
+			}
+			if (k == a->item_list_sz) {
+				/* Graph not found: Look for first free entry */
+				for (k = 0; k < a->item_list_sz; k++) {
+					item_name = *(out + k * 5 + 4);
+					if (!strcmp(item_name, ""))
+						break;
+				}
+				if (k == a->item_list_sz)
+					/* No free graph entry: Ignore it (should never happen) */
+					continue;
+			}
+
+			pos = k * 5;
+
+			if (a->nr[!curr] > 0) {
+				/* Look for corresponding structure in previous iteration */
+				j = i;
+
+				if (j >= a->nr[!curr]) {
+					j = a->nr[!curr] - 1;
+				}
+
+				j0 = j;
+
+				do {
+					sscp = (struct stats_self *) ((char *) a->buf[!curr] + j * a->msize);
+					if (sscc->id == sscp->id) {
+						found = TRUE;
+						break;
+					}
+					if (++j >= a->nr[!curr]) {
+						j = 0;
+					}
+				}
+				while (j != j0);
+			}
+
+			if (!found)
+				continue;
+
+			item_name = *(out + pos + 4);
+			if (!item_name[0]) {
+				/* Save activity name */
+				strncpy(item_name, name, CHUNKSIZE);
+				item_name[CHUNKSIZE - 1] = '\0';
+			}
+
+			tval[0] = E_VALUE(sscp->read_wall, sscc->read_wall, sscp->nr_read, sscc->nr_read);
+			tval[1] = E_VALUE(sscp->read_cpu,  sscc->read_cpu,  sscp->nr_read, sscc->nr_read);
+			tval[2] = (double) sscc->count_wall;
+			tval[3] = (double) sscc->count_cpu;
+
+			for (m = 0; m < 4; m++) {
+				/* Look for min/max values */
+				if (tval[m] > *(spmax + pos + m)) {
+					*(spmax + pos + m) = tval[m];
+				}
+				if (tval[m] < *(spmin + pos + m)) {
+					*(spmin + pos + m) = tval[m];
+				}
+				/* rdtime, rdcpu, cnttime, cntcpu */
+				lnappend(SVG_TIMETAG(svg_p, record_hdr),
+					 tval[m],
+					 out + pos + m, outsize + pos + m, svg_p->restart);
+			}
+		}
+	}
+
+	if (action & F_END) {
+		for (i = 0; i < a->item_list_sz; i++) {
+
+			/* Check if there is something to display */
+			pos = i * 5;
+			if (!**(out + pos))
+				continue;
+
+			item_name = *(out + pos + 4);
+			draw_activity_graphs(a->g_nr, g_type,
+					     title, g_title, item_name, group,
+					     spmin + pos, spmax + pos, out + pos, outsize + pos,
+					     svg_p, record_hdr, FALSE, a->id, i);
+		}
+
+		/* Free remaining structures */
+		free_graphs(out, outsize, spmin, spmax);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Display cgroup statistics in SVG.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @action	Action expected from current function.
+ * @svg_p	SVG specific parameters: Current graph number (.@graph_no),
+ * 		flag indicating that a restart record has been previously
+ * 		found (.@restart) and time used for the X axis origin
+ * 		(@ust_time_ref).
+ * @itv		Interval of time in 1/100th of a second (only with F_MAIN action).
+ * @record_hdr	Pointer on record header of current stats sample.
+ ***************************************************************************
+ */
+__print_funct_t svg_print_cgroup_stats(struct activity *a, int curr, int action, struct svg_parm *svg_p,
+				       unsigned long long itv, struct record_header *record_hdr)
+{
+	struct stats_cgroup *scgc, *scgp;
+	int group[] = {4, 3, 2, 2};
+	int g_type[] = {SVG_LINE_GRAPH, SVG_LINE_GRAPH, SVG_LINE_GRAPH, SVG_LINE_GRAPH};
+	char *title[] = {"Cgroup CPU utilization", "Cgroup memory utilization",
+			 "Cgroup I/O statistics (1)", "Cgroup I/O statistics (2)"};
+	char *g_title[] = {"%usr", "%system", "%cpu", "%thrtl",
+			   "kbmem", "kbanon", "kbfile",
+			   "rkB/s", "wkB/s",
+			   "rio/s", "wio/s"};
+	static double *spmin, *spmax;
+	static char **out;
+	static struct svg_outsize *outsize;
+	char *item_name;
+	double tval[11];
+	int i, k, m, pos;
+
+	if (action & F_BEGIN) {
+		/*
+		 * Allocate arrays (#0..10) that will contain the graphs data
+		 * and the min/max values.
+		 * Also allocate one additional array (#11) that will contain
+		 * cgroup name.
+		 */
+		out = allocate_graph_lines(12 * a->item_list_sz, &outsize, &spmin, &spmax,
+					   svg_p->dec_xfactor);
+	}
+
+	if (action & F_MAIN) {
+		/* Index cgroups from previous sample by name */
+		index_cgroups(a, !curr);
+
+		/* For each cgroup */
+		for (i = 0; i < a->nr[curr]; i++) {
+
+			scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+
+			/* Look for corresponding graph */
+			for (k = 0; k < a->item_list_sz; k++) {
+				item_name = *(out + k * 12 + 11);
+				if (!strcmp(scgc->cg_name, item_name))
+					/* Graph found! */
+					break;
+			}
+			if (k == a->item_list_sz) {
+				/* Graph not found: Look for first free entry */
+				for (k = 0; k < a->item_list_sz; k++) {
+					item_name = *(out + k * 12 + 11);
+					if (!strcmp(item_name, ""))
+						break;
+				}
+				if (k == a->item_list_sz)
+					/* No free graph entry: Ignore it (should never happen) */
+					continue;
+			}
+
+			pos = k * 12;
+			scgp = get_prev_cgroup(a, !curr, scgc);
+
+			item_name = *(out + pos + 11);
+			if (!item_name[0]) {
+				/* Save cgroup name */
+				strncpy(item_name, scgc->cg_name, CHUNKSIZE);
+				item_name[CHUNKSIZE - 1] = '\0';
+			}
+
+			tval[0]  = S_VALUE(scgp->user_usec,      scgc->user_usec,      itv) / 10000;
+			tval[1]  = S_VALUE(scgp->system_usec,    scgc->system_usec,    itv) / 10000;
+			tval[2]  = S_VALUE(scgp->usage_usec,     scgc->usage_usec,     itv) / 10000;
+			tval[3]  = S_VALUE(scgp->throttled_usec, scgc->throttled_usec, itv) / 10000;
+			tval[4]  = (double) scgc->mem_current / 1024;
+			tval[5]  = (double) scgc->mem_anon / 1024;
+			tval[6]  = (double) scgc->mem_file / 1024;
+			tval[7]  = S_VALUE(scgp->io_rbytes, scgc->io_rbytes, itv) / 1024;
+			tval[8]  = S_VALUE(scgp->io_wbytes, scgc->io_wbytes, itv) / 1024;
+			tval[9]  = S_VALUE(scgp->io_rios,   scgc->io_rios,   itv);
+			tval[10] = S_VALUE(scgp->io_wios,   scgc->io_wios,   itv);
+
+			for (m = 0; m < 11; m++) {
+				/* Look for min/max values */
+				if (tval[m] > *(spmax + pos + m)) {
+					*(spmax + pos + m) = tval[m];
+				}
+				if (tval[m] < *(spmin + pos + m)) {
+					*(spmin + pos + m) = tval[m];
+				}
+				lnappend(SVG_TIMETAG(svg_p, record_hdr),
+					 tval[m],
+					 out + pos + m, outsize + pos + m, svg_p->restart);
+			}
+		}
+	}
+
+	if (action & F_END) {
+		for (i = 0; i < a->item_list_sz; i++) {
+
+			/* Check if there is something to display */
+			pos = i * 12;
+			if (!**(out + pos))
+				continue;
+
+			item_name = *(out + pos + 11);
+			draw_activity_graphs(a->g_nr, g_type,
+					     title, g_title, item_name, group,
+					     spmin + pos, spmax + pos, out + pos, outsize + pos,
+					     svg_p, record_hdr, FALSE, a->id, i);
+		}
+
+		/* Free remaining structures */
+		free_graphs(out, outsize, spmin, spmax);
+	}
+}
@@ -0,0 +1,12 @@
+/*
+ * sysstat: System performance tools for Linux
+ * (C) 1999-2019 by Sebastien Godard (sysstat <at> orange.fr)
+ */
+
+#ifndef _VERSION_H
+#define _VERSION_H
+
+/* sysstat version number */
+#define VERSION	"12.1.4"
+
+#endif  /* _VERSION_H */
@@ -36,6 +36,7 @@
 #endif
 
 extern unsigned int flags;
+extern struct activity *act[];
 
 /*
  ***************************************************************************
@@ -611,6 +612,39 @@ __print_funct_t xml_print_queue_stats(struct activity *a, int curr, int tab,
 		sqc->procs_blocked);
 }
 
+/*
+ ***************************************************************************
+ * Display pressure stall information in XML.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @tab		Indentation in XML output.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t xml_print_psi_stats(struct activity *a, int curr, int tab,
+				    unsigned long long itv)
+{
+	struct stats_psi
+		*spc = (struct stats_psi *) a->buf[curr],
+		*spp = (struct stats_psi *) a->buf[!curr];
+
+	xprintf(tab, "<psi "
+		"scpu=\"%.2f\" "
+		"fcpu=\"%.2f\" "
+		"smem=\"%.2f\" "
+		"fmem=\"%.2f\" "
+		"sio=\"%.2f\" "
+		"fio=\"%.2f\"/>",
+		S_VALUE(spp->some_cpu_total, spc->some_cpu_total, itv) / 10000,
+		S_VALUE(spp->full_cpu_total, spc->full_cpu_total, itv) / 10000,
+		S_VALUE(spp->some_mem_total, spc->some_mem_total, itv) / 10000,
+		S_VALUE(spp->full_mem_total, spc->full_mem_total, itv) / 10000,
+		S_VALUE(spp->some_io_total, spc->some_io_total, itv) / 10000,
+		S_VALUE(spp->full_io_total, spc->full_io_total, itv) / 10000);
+}
+
 /*
  ***************************************************************************
  * Display serial lines statistics in XML.
@@ -2106,7 +2140,8 @@ __print_funct_t xml_print_filesystem_stats(struct activity *a, int curr, int tab
 			"ufsused-percent=\"%.2f\" "
 			"Ifree=\"%llu\" "
 			"Iused=\"%llu\" "
-			"Iused-percent=\"%.2f\"/>",
+			"Iused-percent=\"%.2f\" "
+			"stale=\"%u\"/>",
 			DISPLAY_MOUNT(a->opt_flags) ? "mountp" : "fsname",
 			DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name,
 			(double) sfc->f_bfree / 1024 / 1024,
@@ -2119,7 +2154,8 @@ __print_funct_t xml_print_filesystem_stats(struct activity *a, int curr, int tab
 			sfc->f_ffree,
 			sfc->f_files - sfc->f_ffree,
 			sfc->f_files ? SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files)
-				     : 0.0);
+				     : 0.0,
+			sfc->stale);
 	}
 
 	xprintf(--tab, "</filesystems>");
@@ -2272,3 +2308,128 @@ close_xml_markup:
 		xml_markup_network(tab, CLOSE_XML_MARKUP);
 	}
 }
+
+/*
+ ***************************************************************************
+ * Display sadc own collection cost statistics in XML.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @tab		Indentation in XML output.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t xml_print_self_stats(struct activity *a, int curr, int tab,
+				     unsigned long long itv)
+{
+	int i, j, j0, found;
+	struct stats_self *sscc, *sscp;
+	char *name;
+
+	xprintf(tab++, "<collection-cost>");
+
+	for (i = 0; i < a->nr[curr]; i++) {
+
+		found = FALSE;
+		sscc = (struct stats_self *) ((char *) a->buf[curr] + i * a->msize);
+
+		if ((name = get_activity_name(act, sscc->id)) == NULL)
+			continue;
+
+		if (a->nr[!curr] > 0) {
+			/* Look for corresponding structure in previous iteration */
+			j = i;
+
+			if (j >= a->nr[!curr]) {
+				j = a->nr[!curr] - 1;
+			}
+
+			j0 = j;
+
+			do {
+				sscp = (struct stats_self *) ((char *) a->buf[!curr] + j * a->msize);
+				if (sscc->id == sscp->id) {
+					found = TRUE;
+					break;
+				}
+				if (++j >= a->nr[!curr]) {
+					j = 0;
+				}
+			}
+			while (j != j0);
+		}
+
+		if (!found)
+			continue;
+
+		xprintf(tab, "<activity name=\"%s\" "
+			"rdtime=\"%.2f\" "
+			"rdcpu=\"%.2f\" "
+			"cnttime=\"%.2f\" "
+			"cntcpu=\"%.2f\"/>",
+			name,
+			E_VALUE(sscp->read_wall, sscc->read_wall, sscp->nr_read, sscc->nr_read),
+			E_VALUE(sscp->read_cpu,  sscc->read_cpu,  sscp->nr_read, sscc->nr_read),
+			(double) sscc->count_wall,
+			(double) sscc->count_cpu);
+	}
+
+	xprintf(--tab, "</collection-cost>");
+}
+
+/*
+ ***************************************************************************
+ * Display cgroup statistics in XML.
+ *
+ * IN:
+ * @a		Activity structure with statistics.
+ * @curr	Index in array for current sample statistics.
+ * @tab		Indentation in XML output.
+ * @itv		Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+__print_funct_t xml_print_cgroup_stats(struct activity *a, int curr, int tab,
+				       unsigned long long itv)
+{
+	int i;
+	struct stats_cgroup *scgc, *scgp;
+
+	/* Index cgroups from previous sample by name */
+	index_cgroups(a, !curr);
+
+	xprintf(tab++, "<cgroups>");
+
+	for (i = 0; i < a->nr[curr]; i++) {
+
+		scgc = (struct stats_cgroup *) ((char *) a->buf[curr] + i * a->msize);
+		scgp = get_prev_cgroup(a, !curr, scgc);
+
+		xprintf(tab, "<cgroup name=\"%s\" "
+			"usr=\"%.2f\" "
+			"system=\"%.2f\" "
+			"cpu=\"%.2f\" "
+			"thrtl=\"%.2f\" "
+			"kbmem=\"%llu\" "
+			"kbanon=\"%llu\" "
+			"kbfile=\"%llu\" "
+			"rkB=\"%.2f\" "
+			"wkB=\"%.2f\" "
+			"rio=\"%.2f\" "
+			"wio=\"%.2f\"/>",
+			scgc->cg_name,
+			S_VALUE(scgp->user_usec,      scgc->user_usec,      itv) / 10000,
+			S_VALUE(scgp->system_usec,    scgc->system_usec,    itv) / 10000,
+			S_VALUE(scgp->usage_usec,     scgc->usage_usec,     itv) / 10000,
+			S_VALUE(scgp->throttled_usec, scgc->throttled_usec, itv) / 10000,
+			scgc->mem_current / 1024,
+			scgc->mem_anon / 1024,
+			scgc->mem_file / 1024,
+			S_VALUE(scgp->io_rbytes, scgc->io_rbytes, itv) / 1024,
+			S_VALUE(scgp->io_wbytes, scgc->io_wbytes, itv) / 1024,
+			S_VALUE(scgp->io_rios,   scgc->io_rios,   itv),
+			S_VALUE(scgp->io_wios,   scgc->io_wios,   itv));
+	}
+
+	xprintf(--tab, "</cgroups>");
+}